@@ -149,6 +149,9 @@ static void BM_EngineRunBatchWindowSumFeature5Window5(
     EngineRunBatchWindowSumFeature5Window5(&state, BENCHMARK, state.range(0),
                                            state.range(1));
 }
+static void BM_EngineRunBatchLastJoin(benchmark::State& state) {  // NOLINT
+    EngineRunBatchLastJoin(&state, BENCHMARK, state.range(0), state.range(1));
+}
 
 // request engine simple bm
 BENCHMARK(BM_EngineRequestSimpleSelectVarchar);
@@ -275,6 +278,11 @@ BENCHMARK(BM_EngineRunBatchWindowMultiAggWindow25Feature25)
     ->Args({100, 100})
     ->Args({1000, 1000})
     ->Args({10000, 10000});
+BENCHMARK(BM_EngineRunBatchLastJoin)
+    ->Args({1000, 1000})
+    ->Args({10000, 10000})
+    ->Args({100000, 100000})
+    ->Args({1000000, 1000000});
 
 // batch engine window bm exclude current time
 BENCHMARK(BM_EngineRunBatchWindowSumFeature1ExcludeCurrentTime)
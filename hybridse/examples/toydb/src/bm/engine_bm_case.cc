@@ -306,6 +306,64 @@ void EngineRunBatchWindowSumFeature5Window5(benchmark::State* state, MODE mode,
         std::to_string(limit_cnt) + ";";
     EngineBatchMode(sql, mode, limit_cnt, size, state);
 }
+// t1 LAST JOIN t2 on col1, which is not indexed in t2
+void EngineRunBatchLastJoin(benchmark::State* state, MODE mode,
+                            int64_t left_size,
+                            int64_t right_size) {  // NOLINT
+    InitializeNativeTarget();
+    InitializeNativeTargetAsmPrinter();
+    auto catalog = vm::BuildOnePkTableStorage(left_size);
+    type::TableDef table_def;
+    std::vector<Row> buffer;
+    CaseDataMock::BuildOnePkTableData(table_def, buffer, right_size);
+    table_def.set_name("t2");
+    ::hybridse::type::IndexDef* index = table_def.add_indexes();
+    index->set_name("index1");
+    index->add_first_keys("col0");
+    index->set_second_key("col5");
+    std::shared_ptr<storage::Table> table(
+        new storage::Table(2, 1, table_def));
+    table->Init();
+    std::shared_ptr<tablet::TabletTableHandler> handler(
+        new tablet::TabletTableHandler(table_def.columns(), table_def.name(),
+                                       table_def.catalog(), table_def.indexes(),
+                                       table));
+    if (!handler->Init() || !catalog->AddTable(handler)) {
+        FAIL();
+    }
+    for (auto row : buffer) {
+        table->Put(reinterpret_cast<char*>(row.buf()), row.size());
+    }
+    const std::string sql =
+        "SELECT t1.col1, t1.col5, t2.col4 FROM t1 LAST JOIN t2 "
+        "ORDER BY t2.col5 ON t1.col1 = t2.col1;";
+    Engine engine(catalog);
+    BatchRunSession session;
+    base::Status query_status;
+    if (!engine.Get(sql, "db", session, query_status)) {
+        FAIL() << query_status;
+    }
+    std::ostringstream runner_oss;
+    session.GetCompileInfo()->DumpClusterJob(runner_oss, "");
+    LOG(INFO) << "runner plan:\n" << runner_oss.str() << std::endl;
+    switch (mode) {
+        case BENCHMARK: {
+            for (auto _ : *state) {
+                std::vector<hybridse::codec::Row> outputs;
+                benchmark::DoNotOptimize(session.Run(outputs));
+            }
+            break;
+        }
+        case TEST: {
+            std::vector<hybridse::codec::Row> outputs;
+            if (0 != session.Run(outputs)) {
+                FAIL();
+            }
+            ASSERT_EQ(static_cast<uint64_t>(left_size), outputs.size());
+            break;
+        }
+    }
+}
 void EngineRunBatchWindowMultiAggWindow25Feature25(benchmark::State* state,
                                                    MODE mode, int64_t limit_cnt,
                                                    int64_t size) {  // NOLINT
@@ -52,6 +52,9 @@ void EngineRunBatchWindowSumFeature1(benchmark::State* state, MODE mode,
 void EngineRunBatchWindowSumFeature5Window5(benchmark::State* state, MODE mode,
                                             int64_t limit_cnt,
                                             int64_t size);  // NOLINT
+void EngineRunBatchLastJoin(benchmark::State* state, MODE mode,
+                            int64_t left_size,
+                            int64_t right_size);  // NOLINT
 void EngineRunBatchWindowMultiAggWindow25Feature25(benchmark::State* state,
                                                    MODE mode, int64_t limit_cnt,
                                                    int64_t size);  // NOLINT
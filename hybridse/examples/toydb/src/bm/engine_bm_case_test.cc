@@ -68,6 +68,11 @@ TEST_F(EngineBMCaseTest, EngineRunBatchWindowSumFeature1_TEST) {
     EngineRunBatchWindowSumFeature1(nullptr, TEST, 100L, 100L);
     EngineRunBatchWindowSumFeature1(nullptr, TEST, 1000L, 1000L);
 }
+TEST_F(EngineBMCaseTest, EngineRunBatchLastJoin_TEST) {
+    EngineRunBatchLastJoin(nullptr, TEST, 10L, 1000L);
+    EngineRunBatchLastJoin(nullptr, TEST, 1000L, 1000L);
+    EngineRunBatchLastJoin(nullptr, TEST, 1000L, 10L);
+}
 TEST_F(EngineBMCaseTest, EngineRunBatchWindowSumFeature5Window5_TEST) {
     EngineRunBatchWindowSumFeature5Window5(nullptr, TEST, 100L, 100L);
 }
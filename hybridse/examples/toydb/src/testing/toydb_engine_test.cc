@@ -35,6 +35,20 @@ TEST_P(EngineTest, TestRequestEngine) {
         LOG(INFO) << "Skip mode " << sql_case.mode();
     }
 }
+// the same cases with the request window columns pruned, they must give the same results
+TEST_P(EngineTest, TestRequestEngineWithWindowColumnPruning) {
+    auto& sql_case = GetParam();
+    EngineOptions options;
+    options.SetEnableWindowColumnPruning(true);
+    LOG(INFO) << "ID: " << sql_case.id() << ", DESC: " << sql_case.desc();
+    if (!boost::contains(sql_case.mode(), "request-unsupport") &&
+        !boost::contains(sql_case.mode(), "performance-sensitive-unsupport") &&
+        !boost::contains(sql_case.mode(), "rtidb-unsupport")) {
+        EngineCheck(sql_case, options, kRequestMode);
+    } else {
+        LOG(INFO) << "Skip mode " << sql_case.mode();
+    }
+}
 TEST_P(EngineTest, TestBatchEngine) {
     auto& sql_case = GetParam();
     EngineOptions options;
@@ -75,6 +89,21 @@ TEST_P(EngineTest, TestClusterRequestEngine) {
         LOG(INFO) << "Skip mode " << sql_case.mode();
     }
 }
+TEST_P(EngineTest, TestClusterRequestEngineWithWindowColumnPruning) {
+    auto& sql_case = GetParam();
+    EngineOptions options;
+    options.SetClusterOptimized(true);
+    options.SetEnableWindowColumnPruning(true);
+    LOG(INFO) << "ID: " << sql_case.id() << ", DESC: " << sql_case.desc();
+    if (!boost::contains(sql_case.mode(), "request-unsupport") &&
+        !boost::contains(sql_case.mode(), "rtidb-unsupport") &&
+        !boost::contains(sql_case.mode(), "performance-sensitive-unsupport") &&
+        !boost::contains(sql_case.mode(), "cluster-unsupport")) {
+        EngineCheck(sql_case, options, kRequestMode);
+    } else {
+        LOG(INFO) << "Skip mode " << sql_case.mode();
+    }
+}
 TEST_P(EngineTest, TestClusterBatchRequestEngine) {
     auto& sql_case = GetParam();
     EngineOptions options;
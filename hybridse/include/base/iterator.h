@@ -91,6 +91,19 @@ class AbstractIterator {
 
     /// Move to the beginning of the dataset.
     virtual void SeekToFirst() = 0;
+
+    /// Move to the element at `pos`, the position of the first element is 0.
+    /// if there is no element at `pos`, set position to the end.
+    /// It steps from the beginning by default.
+    virtual void SeekToPosition(uint64_t pos) {
+        SeekToFirst();
+        while (pos-- > 0 && Valid()) {
+            Next();
+        }
+    }
+
+    /// Return whether SeekToPosition() is faster than stepping from the beginning
+    virtual bool IsPositionSeekable() const { return false; }
 };
 /// \brief An iterator over a key-value pairs dataset
 /// \tparam K key type of elements
@@ -103,6 +116,25 @@ class Iterator : public AbstractIterator<K, V, V&> {};
 /// \tparam V value type of elements
 template <class K, class V>
 class ConstIterator : public hybridse::base::AbstractIterator<K, V, const V&> {
+ public:
+    /// Copy at most `cap` elements from the current position into `values`,
+    /// with their NULL flags into `is_null`, and move past them. The value of
+    /// a NULL element is left unspecified.
+    /// Return the number of elements copied, less than `cap` only if the
+    /// iteration reaches the end.
+    /// Override this if elements can be fetched without stepping one by one.
+    virtual uint32_t NextBatch(V* values, bool* is_null, uint32_t cap) {
+        uint32_t cnt = 0;
+        while (cnt < cap && this->Valid()) {
+            is_null[cnt] = this->IsValueNull();
+            if (!is_null[cnt]) {
+                values[cnt] = this->GetValue();
+            }
+            this->Next();
+            cnt++;
+        }
+        return cnt;
+    }
 };
 }  // namespace base
 }  // namespace hybridse
@@ -532,6 +532,17 @@ class ColumnIterator : public ConstIterator<uint64_t, V> {
     const uint64_t &GetKey() const override { return row_iter_->GetKey(); }
     bool IsSeekable() const override { return row_iter_->IsSeekable(); }
 
+    // decode the field and its null flag of each row in one pass
+    uint32_t NextBatch(V *values, bool *is_null, uint32_t cap) override {
+        uint32_t cnt = 0;
+        while (cnt < cap && row_iter_->Valid()) {
+            column_impl_->GetField(row_iter_->GetValue(), values + cnt, is_null + cnt);
+            row_iter_->Next();
+            cnt++;
+        }
+        return cnt;
+    }
+
  protected:
     std::unique_ptr<RowIterator> row_iter_;
     const ColumnImpl<V> *column_impl_;
@@ -565,6 +576,10 @@ class NonNullColumnIterator : public ColumnIterator<V> {
         NextNonNull();
     }
 
+    uint32_t NextBatch(V *values, bool *is_null, uint32_t cap) override {
+        return ConstIterator<uint64_t, V>::NextBatch(values, is_null, cap);
+    }
+
  private:
     void NextNonNull(bool current_key_only = false) {
         if (!this->row_iter_ || !this->row_iter_->Valid()) {
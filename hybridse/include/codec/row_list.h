@@ -96,8 +96,12 @@ class ListV {
         if (!iter) {
             return AtOut<V>::Null();
         }
-        while (pos-- > 0 && iter->Valid()) {
-            iter->Next();
+        if (iter->IsPositionSeekable()) {
+            iter->SeekToPosition(pos);
+        } else {
+            while (pos-- > 0 && iter->Valid()) {
+                iter->Next();
+            }
         }
 
         if (iter->Valid() && !iter->IsValueNull()) {
@@ -17,6 +17,8 @@
 #ifndef HYBRIDSE_INCLUDE_VM_ENGINE_H_
 #define HYBRIDSE_INCLUDE_VM_ENGINE_H_
 
+#include <atomic>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -165,6 +167,10 @@ class RunSession {
     /// Return if this run session support printing debug information.
     bool IsDebug() { return is_debug_; }
 
+    /// Time the runners while running a query and accumulate it into the runners of the compiled plan,
+    /// see CompileInfo::DumpClusterJob. Only the request mode and batch mode runs are timed.
+    void EnableProfile() { is_profile_ = true; }
+
     /// Bind this run session with specific procedure
     void SetSpName(const std::string& sp_name) { sp_name_ = sp_name; }
     /// Return the engine mode of this run session
@@ -184,6 +190,7 @@ class RunSession {
     std::shared_ptr<hybridse::vm::CompileInfo> compile_info_;
     hybridse::vm::EngineMode engine_mode_;
     bool is_debug_;
+    bool is_profile_ = false;
     std::string sp_name_;
     std::shared_ptr<const std::unordered_map<std::string, std::string>> options_ = nullptr;
 
@@ -331,6 +338,12 @@ struct ExplainOutput {
     std::set<std::pair<std::string, std::string>> dependent_tables;
 };
 
+/// The counters of the compiling result cache
+struct EngineCacheStats {
+    uint64_t invalidations = 0;  ///< The tables and functions invalidated
+    uint64_t recompiles = 0;     ///< The cached results found stale and compiled again
+};
+
 
 /// \brief An engine is responsible to compile SQL on the specific Catalog.
 ///
@@ -420,6 +433,16 @@ class Engine {
     /// \brief Clear engine's compiling result cache
     void ClearCacheLocked(const std::string& db);
 
+    /// \brief Invalidate the cached compiling results which read the table, e.g. the table is dropped or its
+    /// indexes changed. The results are recompiled on next use, the others are kept.
+    void InvalidateTable(const std::string& db, const std::string& table);
+
+    /// \brief Invalidate the cached compiling results which may call the function
+    void InvalidateFunction(const std::string& name);
+
+    /// \brief Get the counters of the compiling result cache
+    EngineCacheStats GetCacheStats() const;
+
     /// \brief Get engine's options
     EngineOptions GetEngineOptions();
 
@@ -446,6 +469,9 @@ class Engine {
                            std::shared_ptr<CompileInfo> info,
                            base::Status& status);  // NOLINT
 
+    // whether a table or function the cached info depends on is invalidated after it is compiled, must hold mu_
+    bool IsStaleCache(const std::shared_ptr<CompileInfo>& info);
+
     bool Explain(const std::string& sql, const std::string& db,
                  EngineMode engine_mode, const codec::Schema& parameter_schema,
                  const std::set<size_t>& common_column_indices,
@@ -454,6 +480,14 @@ class Engine {
     EngineOptions options_;
     base::SpinMutex mu_;
     EngineLRUCache lru_cache_;
+
+    // bumped by every invalidation. a table or function maps to the epoch it is invalidated last time, so a cached
+    // result is stale if any of its dependencies has an epoch later than the one it is compiled in. guarded by mu_
+    uint64_t cache_epoch_ = 0;
+    std::map<std::pair<std::string, std::string>, uint64_t> table_epochs_;
+    std::map<std::string, uint64_t> function_epochs_;
+    std::atomic<uint64_t> cache_invalidations_{0};
+    std::atomic<uint64_t> cache_recompiles_{0};
 };
 
 /// \brief Local tablet is responsible to run a task locally.
@@ -522,6 +522,8 @@ class MemPartitionHandler : public PartitionHandler, public std::enable_shared_f
     RowIterator* GetRawIterator() override { return nullptr; }
     std::unique_ptr<WindowIterator> GetWindowIterator() override;
     bool AddRow(const std::string& key, uint64_t ts, const Row& row);
+    // append all rows of a key at once, keys added in descending order are inserted at the end without a search
+    bool AddSegment(const std::string& key, MemTimeTable&& rows);
     void Sort(const bool is_asc);
     void Reverse();
     void Print();
@@ -546,6 +548,59 @@ class MemPartitionHandler : public PartitionHandler, public std::enable_shared_f
     OrderType order_type_;
 };
 
+// Group rows by partition key before they are moved into a MemPartitionHandler.
+// Keys are hashed into an open addressing table, so that every row costs a hash probe instead of a tree insertion
+// with a string key. A single fixed-width key (int, bool, date, timestamp) is compared as an int64 and its string
+// form is only built the first time the key is seen. The tree of the output is built once from the sorted keys.
+class MemHashPartitioner {
+ public:
+    explicit MemHashPartitioner(size_t expected_key_cnt = 16);
+    ~MemHashPartitioner() {}
+
+    void AddRow(const std::string& key, uint64_t ts, const Row& row);
+    // `gen_key` returns the string key, it is called only if the key is new
+    template <typename GenKey>
+    void AddRow(int64_t key, bool is_null, GenKey&& gen_key, uint64_t ts, const Row& row) {
+        bool inserted = false;
+        Group* group = FindOrInsert(key, is_null, &inserted);
+        if (inserted) {
+            group->key = gen_key();
+        }
+        group->rows.emplace_back(ts, row);
+    }
+    // move all groups into `output` and reset the partitioner
+    void Flush(MemPartitionHandler* output);
+    // the same as Flush(output), but keys are prefixed by `prefix + "|"`, also if `prefix` is empty
+    void Flush(const std::string& prefix, MemPartitionHandler* output);
+    size_t GetKeyCnt() const { return groups_.size(); }
+
+ private:
+    struct Group {
+        uint64_t hash;
+        int64_t fixed_key;
+        bool is_null;
+        std::string key;
+        MemTimeTable rows;
+    };
+    Group* FindOrInsert(int64_t key, bool is_null, bool* inserted);
+    Group* FindOrInsert(const std::string& key, bool* inserted);
+    // return the slot of `hash`, `match` tells whether a group is the one being searched
+    template <typename Match>
+    size_t Probe(uint64_t hash, Match&& match) const {
+        size_t slot = hash & (slots_.size() - 1);
+        while (slots_[slot] != EMPTY_SLOT && !match(groups_[slots_[slot]])) {
+            slot = (slot + 1) & (slots_.size() - 1);
+        }
+        return slot;
+    }
+    Group* Insert(size_t slot, uint64_t hash);
+    void Grow();
+
+    static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+    std::vector<uint32_t> slots_;
+    std::vector<Group> groups_;
+};
+
 class ConcatTableHandler : public MemTimeTableHandler {
  public:
     ConcatTableHandler(std::shared_ptr<TableHandler> left, size_t left_slices,
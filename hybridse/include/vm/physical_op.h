@@ -1655,6 +1655,12 @@ class PhysicalRequestAggUnionNode : public PhysicalOpNode {
     void set_out_request_row(bool flag) { output_request_row_ = flag; }
     const RequestWindowOp &window() const { return window_; }
 
+    // add a coarser pre-aggregation level after the producers of request, raw and aggr.
+    // the levels are ordered from the finest to the coarsest, `aggr` is the finest one
+    void AddAggrLevel(PhysicalPartitionProviderNode *aggr) { AddProducer(aggr); }
+    // the number of pre-aggregation levels, including `aggr`
+    size_t GetAggrLevelCnt() const { return producers_.size() - 2; }
+
     base::Status WithNewChildren(node::NodeManager *nm,
                                  const std::vector<PhysicalOpNode *> &children,
                                  PhysicalOpNode **out) override {
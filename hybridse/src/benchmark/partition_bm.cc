@@ -0,0 +1,83 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "vm/mem_catalog.h"
+
+namespace hybridse {
+namespace bm {
+
+// group state.range(0) rows into state.range(1) int64 keys
+static void BM_MemPartitionHandlerStringKey(benchmark::State& state) {  // NOLINT
+    codec::Row row;
+    for (auto _ : state) {
+        vm::MemPartitionHandler output;
+        for (int64_t i = 0; i < state.range(0); i++) {
+            output.AddRow(std::to_string(i % state.range(1)), i, row);
+        }
+        benchmark::DoNotOptimize(output.GetCount());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_MemHashPartitionerStringKey(benchmark::State& state) {  // NOLINT
+    codec::Row row;
+    for (auto _ : state) {
+        vm::MemPartitionHandler output;
+        vm::MemHashPartitioner partitioner;
+        for (int64_t i = 0; i < state.range(0); i++) {
+            partitioner.AddRow(std::to_string(i % state.range(1)), i, row);
+        }
+        partitioner.Flush(&output);
+        benchmark::DoNotOptimize(output.GetCount());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_MemHashPartitionerFixedKey(benchmark::State& state) {  // NOLINT
+    codec::Row row;
+    for (auto _ : state) {
+        vm::MemPartitionHandler output;
+        vm::MemHashPartitioner partitioner;
+        for (int64_t i = 0; i < state.range(0); i++) {
+            int64_t key = i % state.range(1);
+            partitioner.AddRow(
+                key, false, [key]() { return std::to_string(key); }, i, row);
+        }
+        partitioner.Flush(&output);
+        benchmark::DoNotOptimize(output.GetCount());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_MemPartitionHandlerStringKey)
+    ->Args({1000000, 100})
+    ->Args({1000000, 100000})
+    ->Args({10000000, 1000000});
+BENCHMARK(BM_MemHashPartitionerStringKey)
+    ->Args({1000000, 100})
+    ->Args({1000000, 100000})
+    ->Args({10000000, 1000000});
+BENCHMARK(BM_MemHashPartitionerFixedKey)
+    ->Args({1000000, 100})
+    ->Args({1000000, 100000})
+    ->Args({10000000, 1000000});
+}  // namespace bm
+}  // namespace hybridse
+
+BENCHMARK_MAIN();
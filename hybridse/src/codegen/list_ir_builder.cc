@@ -194,6 +194,44 @@ Status ListIRBuilder::BuildIteratorNext(::llvm::Value* iterator,
     return Status::OK();
 }
 
+Status ListIRBuilder::BuildIteratorNextBatch(
+    ::llvm::Value* iterator, const node::TypeNode* elem_type,
+    bool elem_nullable, ::llvm::Value* values, ::llvm::Value* is_null,
+    ::llvm::Value* cap, ::llvm::Value** output) {
+    CHECK_TRUE(nullptr != iterator, kCodegenError,
+               "fail to codegen iter.next_batch(): iterator is null");
+
+    ::llvm::Type* v1_type = nullptr;
+    CHECK_TRUE(
+        GetLlvmType(block_, elem_type, &v1_type), kCodegenError,
+        "fail to codegen iterator.next_batch(): invalid value type of iterator");
+    CHECK_TRUE(!TypeIRBuilder::IsStructPtr(v1_type), kCodegenError,
+               "fail to codegen iterator.next_batch(): unsupported value type ",
+               elem_type->GetName());
+
+    ::llvm::Type* iter_ref_type = NULL;
+    CHECK_TRUE(
+        GetLlvmIteratorType(block_->getModule(), elem_type, &iter_ref_type),
+        kCodegenError, "fail to get iterator ref type");
+
+    ::llvm::IRBuilder<> builder(block_);
+    ::llvm::Type* bool_ty = ::llvm::Type::getInt1Ty(builder.getContext());
+    ::llvm::Type* i32_ty = ::llvm::Type::getInt32Ty(builder.getContext());
+    ::std::string fn_name = (elem_nullable ? "next_nullable_batch.iterator_"
+                                           : "next_batch.iterator_") +
+                            elem_type->GetName();
+    auto iter_next_batch_fn_ty = ::llvm::FunctionType::get(
+        i32_ty,
+        {iter_ref_type->getPointerTo(), v1_type->getPointerTo(),
+         bool_ty->getPointerTo(), i32_ty},
+        false);
+    ::llvm::FunctionCallee callee = block_->getModule()->getOrInsertFunction(
+        fn_name, iter_next_batch_fn_ty);
+
+    *output = builder.CreateCall(callee, {iterator, values, is_null, cap});
+    return Status::OK();
+}
+
 Status ListIRBuilder::BuildIteratorDelete(::llvm::Value* iterator,
                                           const node::TypeNode* elem_type,
                                           ::llvm::Value** output) {
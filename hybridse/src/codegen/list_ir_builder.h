@@ -42,6 +42,13 @@ class ListIRBuilder {
     Status BuildIteratorNext(::llvm::Value* iterator,
                              const node::TypeNode* elem_type,
                              bool elem_nullable, NativeValue* output);
+    // fill `values` and `is_null` with at most `cap` elements, output the
+    // number of elements fetched, which is less than `cap` only at the end
+    Status BuildIteratorNextBatch(::llvm::Value* iterator,
+                                  const node::TypeNode* elem_type,
+                                  bool elem_nullable, ::llvm::Value* values,
+                                  ::llvm::Value* is_null, ::llvm::Value* cap,
+                                  ::llvm::Value** output);
     Status BuildIteratorDelete(::llvm::Value* iterator,
                                const node::TypeNode* elem_type,
                                ::llvm::Value** output);
@@ -37,6 +37,9 @@ namespace codegen {
 
 using TypeNodeVec = std::vector<const node::TypeNode*>;
 
+// number of list elements fetched at a time by udaf loops
+static const int32_t UDAF_BATCH_SIZE = 64;
+
 UdfIRBuilder::UdfIRBuilder(CodeGenContext* ctx, node::ExprNode* frame_arg,
                            const node::FrameNode* frame)
     : ctx_(ctx), frame_arg_(frame_arg), frame_(frame) {}
@@ -634,88 +637,106 @@ Status UdfIRBuilder::BuildUdafCall(
         }
     }
 
-    CHECK_STATUS(ctx_->CreateWhile(
-        [&](::llvm::Value** has_next) {
-            // enter
-            auto enter_block = ctx_->GetCurrentBlock();
-            builder.SetInsertPoint(enter_block);
-            ListIRBuilder iter_enter_builder(enter_block, nullptr);
-            for (size_t i = 0; i < input_num; ++i) {
-                ::llvm::Value* cur_has_next = nullptr;
-                CHECK_STATUS(iter_enter_builder.BuildIteratorHasNext(
-                                 iterators[i], elem_types[i], &cur_has_next),
-                             status.str());
-                if (*has_next == nullptr) {
-                    *has_next = cur_has_next;
-                } else {
-                    *has_next = builder.CreateAnd(cur_has_next, *has_next);
-                }
+    // update states with one element of each input
+    auto build_update = [&](const std::vector<NativeValue>& elems) -> Status {
+        UdfIRBuilder sub_udf_builder(ctx_, frame_arg_, frame_);
+
+        std::vector<NativeValue> cur_state_values;
+        std::vector<NativeValue> update_args;
+        for (size_t i = 0; i < state_num; ++i) {
+            if (TypeIRBuilder::IsStructPtr(states_storage[i]->getType())) {
+                cur_state_values.push_back(
+                    NativeValue::Create(states_storage[i]));
+            } else {
+                auto load_raw =
+                    ctx_->GetBuilder()->CreateLoad(states_storage[i]);
+                cur_state_values.push_back(NativeValue::Create(load_raw));
             }
-            return Status::OK();
-        },
-        [&]() {
-            // iter body
-            auto body_begin_block = ctx_->GetCurrentBlock();
-            ListIRBuilder iter_next_builder(body_begin_block, nullptr);
-            UdfIRBuilder sub_udf_builder(ctx_, frame_arg_, frame_);
+        }
+        if (state_num > 1) {
+            update_args.push_back(NativeValue::CreateTuple(cur_state_values));
+        } else {
+            update_args.push_back(cur_state_values[0]);
+        }
+        for (size_t i = 0; i < input_num; ++i) {
+            update_args.push_back(elems[i]);
+        }
 
-            std::vector<NativeValue> cur_state_values;
-            std::vector<NativeValue> update_args;
+        NativeValue update_value;
+        std::vector<const node::TypeNode*> update_arg_types;
+        update_arg_types.push_back(state_type);
+        for (size_t i = 0; i < input_num; ++i) {
+            update_arg_types.push_back(elem_types[i]);
+        }
+        CHECK_TRUE(fn->update_func() != nullptr, kCodegenError);
+        CHECK_STATUS(sub_udf_builder.BuildCall(fn->update_func(),
+                                               update_arg_types, update_args,
+                                               &update_value));
+
+        builder.SetInsertPoint(ctx_->GetCurrentBlock());
+        if (update_value.IsTuple()) {
+            CHECK_TRUE(update_value.GetFieldNum() == state_num, kCodegenError);
             for (size_t i = 0; i < state_num; ++i) {
-                if (TypeIRBuilder::IsStructPtr(states_storage[i]->getType())) {
-                    cur_state_values.push_back(
-                        NativeValue::Create(states_storage[i]));
-                } else {
-                    auto load_raw =
-                        ctx_->GetBuilder()->CreateLoad(states_storage[i]);
-                    cur_state_values.push_back(NativeValue::Create(load_raw));
+                NativeValue sub = update_value.GetField(i);
+                ::llvm::Value* raw_update = sub.GetValue(ctx_);
+                if (TypeIRBuilder::IsStructPtr(raw_update->getType())) {
+                    raw_update = builder.CreateLoad(raw_update);
                 }
+                builder.CreateStore(raw_update, states_storage[i]);
             }
-            if (state_num > 1) {
-                update_args.push_back(
-                    NativeValue::CreateTuple(cur_state_values));
-            } else {
-                update_args.push_back(cur_state_values[0]);
-            }
-            for (size_t i = 0; i < input_num; ++i) {
-                NativeValue next_val;
-                CHECK_STATUS(iter_next_builder.BuildIteratorNext(
-                    iterators[i], elem_types[i], elem_nullable[i], &next_val));
-                update_args.push_back(next_val);
+        } else {
+            ::llvm::Value* raw_update = update_value.GetValue(ctx_);
+            if (TypeIRBuilder::IsStructPtr(raw_update->getType())) {
+                raw_update = builder.CreateLoad(raw_update);
             }
+            builder.CreateStore(raw_update, states_storage[0]);
+        }
+        return Status::OK();
+    };
 
-            NativeValue update_value;
-            std::vector<const node::TypeNode*> update_arg_types;
-            update_arg_types.push_back(state_type);
-            for (size_t i = 0; i < input_num; ++i) {
-                update_arg_types.push_back(elem_types[i]);
-            }
-            CHECK_TRUE(fn->update_func() != nullptr, kCodegenError);
-            CHECK_STATUS(sub_udf_builder.BuildCall(fn->update_func(),
-                                                   update_arg_types,
-                                                   update_args, &update_value));
-
-            builder.SetInsertPoint(ctx_->GetCurrentBlock());
-            if (update_value.IsTuple()) {
-                CHECK_TRUE(update_value.GetFieldNum() == state_num,
-                           kCodegenError);
-                for (size_t i = 0; i < state_num; ++i) {
-                    NativeValue sub = update_value.GetField(i);
-                    ::llvm::Value* raw_update = sub.GetValue(ctx_);
-                    if (TypeIRBuilder::IsStructPtr(raw_update->getType())) {
-                        raw_update = builder.CreateLoad(raw_update);
+    bool batch_iterable = true;
+    for (size_t i = 0; i < input_num; ++i) {
+        batch_iterable = batch_iterable && IsBatchIterable(elem_types[i]);
+    }
+    if (batch_iterable) {
+        CHECK_STATUS(BuildUdafBatchLoop(iterators, elem_types, elem_nullable,
+                                        build_update));
+    } else {
+        CHECK_STATUS(ctx_->CreateWhile(
+            [&](::llvm::Value** has_next) {
+                // enter
+                auto enter_block = ctx_->GetCurrentBlock();
+                builder.SetInsertPoint(enter_block);
+                ListIRBuilder iter_enter_builder(enter_block, nullptr);
+                for (size_t i = 0; i < input_num; ++i) {
+                    ::llvm::Value* cur_has_next = nullptr;
+                    CHECK_STATUS(iter_enter_builder.BuildIteratorHasNext(
+                                     iterators[i], elem_types[i],
+                                     &cur_has_next),
+                                 status.str());
+                    if (*has_next == nullptr) {
+                        *has_next = cur_has_next;
+                    } else {
+                        *has_next = builder.CreateAnd(cur_has_next, *has_next);
                     }
-                    builder.CreateStore(raw_update, states_storage[i]);
                 }
-            } else {
-                ::llvm::Value* raw_update = update_value.GetValue(ctx_);
-                if (TypeIRBuilder::IsStructPtr(raw_update->getType())) {
-                    raw_update = builder.CreateLoad(raw_update);
+                return Status::OK();
+            },
+            [&]() {
+                // iter body
+                auto body_begin_block = ctx_->GetCurrentBlock();
+                ListIRBuilder iter_next_builder(body_begin_block, nullptr);
+                std::vector<NativeValue> elems;
+                for (size_t i = 0; i < input_num; ++i) {
+                    NativeValue next_val;
+                    CHECK_STATUS(iter_next_builder.BuildIteratorNext(
+                        iterators[i], elem_types[i], elem_nullable[i],
+                        &next_val));
+                    elems.push_back(next_val);
                 }
-                builder.CreateStore(raw_update, states_storage[0]);
-            }
-            return Status::OK();
-        }));
+                return build_update(elems);
+            }));
+    }
 
     builder.SetInsertPoint(ctx_->GetCurrentBlock());
     std::vector<NativeValue> final_state_values;
@@ -752,6 +773,112 @@ Status UdfIRBuilder::BuildUdafCall(
     return Status::OK();
 }
 
+bool UdfIRBuilder::IsBatchIterable(const node::TypeNode* elem_type) {
+    switch (elem_type->base()) {
+        case node::kBool:
+        case node::kInt16:
+        case node::kInt32:
+        case node::kInt64:
+        case node::kFloat:
+        case node::kDouble:
+            return true;
+        default:
+            return false;
+    }
+}
+
+Status UdfIRBuilder::BuildUdafBatchLoop(
+    const std::vector<::llvm::Value*>& iterators,
+    const std::vector<const node::TypeNode*>& elem_types,
+    const std::vector<int>& elem_nullable,
+    const std::function<Status(const std::vector<NativeValue>&)>& build_update) {
+    size_t input_num = iterators.size();
+    auto builder = ctx_->GetBuilder();
+    ::llvm::Type* bool_ty = builder->getInt1Ty();
+    ::llvm::Type* i32_ty = builder->getInt32Ty();
+    ::llvm::Value* batch_size = builder->getInt32(UDAF_BATCH_SIZE);
+
+    // batch buffers on stack, filled by the iterators then consumed by a
+    // tight loop without calls into the iterators
+    std::vector<::llvm::Value*> values_bufs(input_num);
+    std::vector<::llvm::Value*> is_null_bufs(input_num);
+    for (size_t i = 0; i < input_num; ++i) {
+        ::llvm::Type* elem_llvm_ty = nullptr;
+        CHECK_TRUE(GetLlvmType(ctx_->GetModule(), elem_types[i], &elem_llvm_ty),
+                   kCodegenError,
+                   "Fail to get llvm type for " + elem_types[i]->GetName());
+        values_bufs[i] = CreateAllocaAtHead(builder, elem_llvm_ty,
+                                            "batch_values_alloca", batch_size);
+        is_null_bufs[i] = CreateAllocaAtHead(builder, bool_ty,
+                                             "batch_is_null_alloca", batch_size);
+    }
+    ::llvm::Value* batch_cnt_ptr =
+        CreateAllocaAtHead(builder, i32_ty, "batch_cnt_alloca");
+    ::llvm::Value* batch_idx_ptr =
+        CreateAllocaAtHead(builder, i32_ty, "batch_idx_alloca");
+    // a full batch means there may be more elements
+    builder->CreateStore(batch_size, batch_cnt_ptr);
+
+    return ctx_->CreateWhile(
+        [&](::llvm::Value** has_next) {
+            *has_next = builder->CreateICmpEQ(
+                builder->CreateLoad(batch_cnt_ptr), batch_size);
+            return Status::OK();
+        },
+        [&]() {
+            ListIRBuilder iter_batch_builder(ctx_->GetCurrentBlock(), nullptr);
+            ::llvm::Value* batch_cnt = nullptr;
+            for (size_t i = 0; i < input_num; ++i) {
+                ::llvm::Value* cur_cnt = nullptr;
+                CHECK_STATUS(iter_batch_builder.BuildIteratorNextBatch(
+                    iterators[i], elem_types[i], elem_nullable[i],
+                    values_bufs[i], is_null_bufs[i], batch_size, &cur_cnt));
+                // stop at the shortest input, as the element-wise loop does
+                if (batch_cnt == nullptr) {
+                    batch_cnt = cur_cnt;
+                } else {
+                    batch_cnt = builder->CreateSelect(
+                        builder->CreateICmpSLT(cur_cnt, batch_cnt), cur_cnt,
+                        batch_cnt);
+                }
+            }
+            builder->CreateStore(batch_cnt, batch_cnt_ptr);
+            builder->CreateStore(builder->getInt32(0), batch_idx_ptr);
+
+            return ctx_->CreateWhile(
+                [&](::llvm::Value** has_next) {
+                    *has_next = builder->CreateICmpSLT(
+                        builder->CreateLoad(batch_idx_ptr),
+                        builder->CreateLoad(batch_cnt_ptr));
+                    return Status::OK();
+                },
+                [&]() {
+                    ::llvm::Value* idx = builder->CreateLoad(batch_idx_ptr);
+                    std::vector<NativeValue> elems;
+                    for (size_t i = 0; i < input_num; ++i) {
+                        ::llvm::Value* value = builder->CreateLoad(
+                            builder->CreateInBoundsGEP(values_bufs[i], idx));
+                        if (elem_nullable[i]) {
+                            ::llvm::Value* is_null = builder->CreateLoad(
+                                builder->CreateInBoundsGEP(is_null_bufs[i],
+                                                           idx));
+                            elems.push_back(
+                                NativeValue::CreateWithFlag(value, is_null));
+                        } else {
+                            elems.push_back(NativeValue::Create(value));
+                        }
+                    }
+                    CHECK_STATUS(build_update(elems));
+                    builder->SetInsertPoint(ctx_->GetCurrentBlock());
+                    builder->CreateStore(
+                        builder->CreateAdd(builder->CreateLoad(batch_idx_ptr),
+                                           builder->getInt32(1)),
+                        batch_idx_ptr);
+                    return Status::OK();
+                });
+        });
+}
+
 Status UdfIRBuilder::BuildVariadicUdfCall(const node::VariadicUdfDefNode* fn,
                                           const std::vector<const node::TypeNode*>& arg_types,
                                           const std::vector<NativeValue>& args,
@@ -17,6 +17,7 @@
 #ifndef HYBRIDSE_SRC_CODEGEN_UDF_IR_BUILDER_H_
 #define HYBRIDSE_SRC_CODEGEN_UDF_IR_BUILDER_H_
 
+#include <functional>
 #include <vector>
 #include "base/fe_status.h"
 #include "codegen/expr_ir_builder.h"
@@ -91,6 +92,18 @@ class UdfIRBuilder {
                                   ::llvm::IRBuilder<>* builder, size_t* pos_idx,
                                   NativeValue* output);
 
+    // whether list elements of the type can be fetched in batches
+    static bool IsBatchIterable(const node::TypeNode* elem_type);
+
+    // iterate the inputs batch by batch and update the udaf states with
+    // `build_update` for each element in a batch
+    Status BuildUdafBatchLoop(
+        const std::vector<::llvm::Value*>& iterators,
+        const std::vector<const node::TypeNode*>& elem_types,
+        const std::vector<int>& elem_nullable,
+        const std::function<Status(const std::vector<NativeValue>&)>&
+            build_update);
+
     Status BuildLlvmCall(const node::FnDefNode* fn,
                          ::llvm::FunctionCallee callee,
                          const std::vector<const node::TypeNode*>& arg_types,
@@ -15,12 +15,16 @@
  */
 #include "passes/physical/long_window_optimized.h"
 
+#include <algorithm>
+#include <cctype>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "vm/engine.h"
 #include "vm/physical_op.h"
@@ -160,19 +164,27 @@ bool LongWindowOptimized::OptimizeWithPreAggr(vm::PhysicalAggregationNode* in, i
         return false;
     }
 
-    // TODO(zhanghao): optimize the selection of the best pre-aggregation tables
-    auto table = catalog_->GetTable(table_infos[0].aggr_db, table_infos[0].aggr_table);
+    // only the ROWS_RANGE window without maxsize and filter can merge multiple levels, see RequestAggUnionRunner
+    int64_t window_size = -1;
+    const auto* frame = req_union_op->window().range_.frame();
+    if (frame != nullptr && frame->frame_type() == node::kFrameRowsRange && frame->frame_maxsize() == 0 &&
+        filter_col.empty() && frame->GetHistoryRangeStart() != INT64_MIN) {
+        window_size = -frame->GetHistoryRangeStart();
+    }
+    auto levels = SelectAggrLevels(table_infos, window_size);
+    const auto& table_info = table_infos[levels.front()];
+    auto table = catalog_->GetTable(table_info.aggr_db, table_info.aggr_table);
     if (!table) {
-        LOG(ERROR) << "Fail to get table handler for pre-aggregation table " << table_infos[0].aggr_db << "."
-                   << table_infos[0].aggr_table;
+        LOG(ERROR) << "Fail to get table handler for pre-aggregation table " << table_info.aggr_db << "."
+                   << table_info.aggr_table;
         return false;
     }
 
     vm::PhysicalTableProviderNode* aggr = nullptr;
     auto status = plan_ctx_->CreateOp<vm::PhysicalTableProviderNode>(&aggr, table);
     if (!status.isOK()) {
-        LOG(ERROR) << "Fail to create PhysicalTableProviderNode for pre-aggregation table " << table_infos[0].aggr_db
-                   << "." << table_infos[0].aggr_table << ": " << status;
+        LOG(ERROR) << "Fail to create PhysicalTableProviderNode for pre-aggregation table " << table_info.aggr_db
+                   << "." << table_info.aggr_table << ": " << status;
         return false;
     }
 
@@ -226,6 +238,13 @@ bool LongWindowOptimized::OptimizeWithPreAggr(vm::PhysicalAggregationNode* in, i
         LOG(ERROR) << "Fail to create PhysicalRequestAggUnionNode: " << status;
         return false;
     }
+    for (size_t i = 1; i < levels.size(); i++) {
+        auto level = CreateAggrLevel(table_infos[levels[i]]);
+        if (level == nullptr) {
+            return false;
+        }
+        request_aggr_union->AddAggrLevel(level);
+    }
 
     vm::PhysicalReduceAggregationNode* reduce_aggr = nullptr;
     auto condition = in->having_condition_.condition();
@@ -253,6 +272,121 @@ bool LongWindowOptimized::OptimizeWithPreAggr(vm::PhysicalAggregationNode* in, i
     return true;
 }
 
+vm::PhysicalPartitionProviderNode* LongWindowOptimized::CreateAggrLevel(const vm::AggrTableInfo& table_info) {
+    auto table = catalog_->GetTable(table_info.aggr_db, table_info.aggr_table);
+    if (!table) {
+        LOG(ERROR) << "Fail to get table handler for pre-aggregation table " << table_info.aggr_db << "."
+                   << table_info.aggr_table;
+        return nullptr;
+    }
+    if (table->GetIndex().size() != 1) {
+        LOG(ERROR) << "PreAggregation table index size != 1";
+        return nullptr;
+    }
+    vm::PhysicalTableProviderNode* aggr = nullptr;
+    auto status = plan_ctx_->CreateOp<vm::PhysicalTableProviderNode>(&aggr, table);
+    if (!status.isOK()) {
+        LOG(ERROR) << "Fail to create PhysicalTableProviderNode for pre-aggregation table " << table_info.aggr_db
+                   << "." << table_info.aggr_table << ": " << status;
+        return nullptr;
+    }
+    // the segments of coarser levels are read by key directly, no window is generated for them
+    vm::PhysicalPartitionProviderNode* partition = nullptr;
+    status = plan_ctx_->CreateOp<vm::PhysicalPartitionProviderNode>(&partition, aggr,
+                                                                     table->GetIndex().cbegin()->first);
+    if (!status.isOK()) {
+        LOG(ERROR) << "Fail to create PhysicalPartitionProviderNode for pre-aggregation table "
+                   << table_info.aggr_db << "." << table_info.aggr_table << ": " << status;
+        return nullptr;
+    }
+    return partition;
+}
+
+bool LongWindowOptimized::ParseTimeBucket(const std::string& bucket_size, int64_t* size) {
+    std::string bucket = boost::trim_copy(bucket_size);
+    if (bucket.size() < 2) {
+        return false;
+    }
+    int64_t unit = 0;
+    switch (std::tolower(bucket.back())) {
+        case 's':
+            unit = 1000;
+            break;
+        case 'm':
+            unit = 1000 * 60;
+            break;
+        case 'h':
+            unit = 1000 * 60 * 60;
+            break;
+        case 'd':
+            unit = 1000 * 60 * 60 * 24;
+            break;
+        default:
+            return false;
+    }
+    int64_t num = 0;
+    if (!absl::SimpleAtoi(bucket.substr(0, bucket.size() - 1), &num) || num <= 0) {
+        return false;
+    }
+    *size = num * unit;
+    return true;
+}
+
+std::vector<size_t> LongWindowOptimized::SelectAggrLevels(const std::vector<vm::AggrTableInfo>& table_infos,
+                                                          int64_t window_size) {
+    // (bucket size, index of table_infos) of the time buckets, from the finest to the coarsest
+    std::vector<std::pair<int64_t, size_t>> buckets;
+    for (size_t i = 0; i < table_infos.size(); i++) {
+        int64_t size = 0;
+        if (ParseTimeBucket(table_infos[i].bucket_size, &size)) {
+            buckets.emplace_back(size, i);
+        }
+    }
+    if (buckets.empty()) {
+        return {0};
+    }
+    std::stable_sort(buckets.begin(), buckets.end());
+    if (window_size <= 0) {
+        return {buckets[0].second};
+    }
+    // cost[j]: the buckets merged for the edges below level j when the selected levels end with level j
+    std::vector<int64_t> cost(buckets.size(), INT64_MAX);
+    std::vector<size_t> prev(buckets.size(), 0);
+    cost[0] = 0;
+    size_t best = 0;
+    int64_t best_total = window_size / buckets[0].first;
+    for (size_t j = 1; j < buckets.size(); j++) {
+        int64_t size = buckets[j].first;
+        if (size > window_size) {
+            break;
+        }
+        for (size_t i = 0; i < j; i++) {
+            int64_t fine = buckets[i].first;
+            if (cost[i] == INT64_MAX || size == fine || size % fine != 0) {
+                continue;
+            }
+            int64_t edge = cost[i] + 2 * (size / fine - 1);
+            if (edge < cost[j]) {
+                cost[j] = edge;
+                prev[j] = i;
+            }
+        }
+        if (cost[j] != INT64_MAX && cost[j] + window_size / size < best_total) {
+            best_total = cost[j] + window_size / size;
+            best = j;
+        }
+    }
+    std::vector<size_t> levels;
+    for (size_t j = best;; j = prev[j]) {
+        levels.push_back(buckets[j].second);
+        if (j == 0) {
+            break;
+        }
+    }
+    std::reverse(levels.begin(), levels.end());
+    return levels;
+}
+
 bool LongWindowOptimized::VerifySingleAggregation(vm::PhysicalProjectNode* op) { return op->project().size() == 1; }
 
 std::string LongWindowOptimized::ConcatExprList(std::vector<node::ExprNode*> exprs, const std::string& delimiter) {
@@ -39,10 +39,25 @@ class LongWindowOptimized : public TransformUpPysicalPass {
         absl::string_view filter_col_name;
     };
 
+    // parse a time bucket size like `1d` into milliseconds, return false for rows bucket or illegal size
+    static bool ParseTimeBucket(const std::string& bucket_size, int64_t* size);
+
+    // Select the pre-aggregation levels for a window spanning `window_size` ms, it returns the indexes of
+    // `table_infos` from the finest level to the coarsest one.
+    // A window is covered by the buckets of the coarsest selected level first and its remaining edges by the finer
+    // levels, so the levels are chosen to minimize the estimated buckets merged per request:
+    //   window_size / top_bucket + sum(2 * (bucket / prev_bucket - 1))
+    // Only time buckets which are multiples of each other can be merged together, the finest time level is
+    // returned alone if the window size is unknown (e.g. not a ROWS_RANGE window).
+    static std::vector<size_t> SelectAggrLevels(const std::vector<vm::AggrTableInfo>& table_infos,
+                                                int64_t window_size);
+
  private:
     bool Transform(PhysicalOpNode* in, PhysicalOpNode** output) override;
     bool VerifySingleAggregation(vm::PhysicalProjectNode* op);
     bool OptimizeWithPreAggr(vm::PhysicalAggregationNode* in, int idx, PhysicalOpNode** output);
+    // create the partition provider of a coarser pre-aggregation level
+    vm::PhysicalPartitionProviderNode* CreateAggrLevel(const vm::AggrTableInfo& table_info);
 
     static std::string ConcatExprList(std::vector<node::ExprNode*> exprs, const std::string& delimiter = ",");
 
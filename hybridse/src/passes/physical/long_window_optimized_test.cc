@@ -0,0 +1,89 @@
+/*
+ * Copyright 2022 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "passes/physical/long_window_optimized.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace hybridse {
+namespace passes {
+
+class LongWindowOptimizedTest : public ::testing::Test {};
+
+static std::vector<vm::AggrTableInfo> MakeTableInfos(const std::vector<std::string>& bucket_sizes) {
+    std::vector<vm::AggrTableInfo> table_infos;
+    for (const auto& bucket_size : bucket_sizes) {
+        vm::AggrTableInfo info;
+        info.aggr_table = "pre_" + bucket_size;
+        info.bucket_size = bucket_size;
+        table_infos.push_back(info);
+    }
+    return table_infos;
+}
+
+static constexpr int64_t HOUR = 60 * 60 * 1000;
+static constexpr int64_t DAY = 24 * HOUR;
+
+TEST_F(LongWindowOptimizedTest, ParseTimeBucket) {
+    int64_t size = 0;
+    ASSERT_TRUE(LongWindowOptimized::ParseTimeBucket("10s", &size));
+    ASSERT_EQ(10000, size);
+    ASSERT_TRUE(LongWindowOptimized::ParseTimeBucket(" 3m", &size));
+    ASSERT_EQ(180000, size);
+    ASSERT_TRUE(LongWindowOptimized::ParseTimeBucket("1H", &size));
+    ASSERT_EQ(HOUR, size);
+    ASSERT_TRUE(LongWindowOptimized::ParseTimeBucket("30d", &size));
+    ASSERT_EQ(30 * DAY, size);
+    // rows bucket or illegal size
+    ASSERT_FALSE(LongWindowOptimized::ParseTimeBucket("1000", &size));
+    ASSERT_FALSE(LongWindowOptimized::ParseTimeBucket("d", &size));
+    ASSERT_FALSE(LongWindowOptimized::ParseTimeBucket("0d", &size));
+    ASSERT_FALSE(LongWindowOptimized::ParseTimeBucket("1w", &size));
+}
+
+TEST_F(LongWindowOptimizedTest, SelectAggrLevels) {
+    // the levels are returned from the finest to the coarsest whatever the order of tables
+    auto table_infos = MakeTableInfos({"1d", "30d", "1h"});
+    ASSERT_EQ(std::vector<size_t>({2, 0, 1}), LongWindowOptimized::SelectAggrLevels(table_infos, 365 * DAY));
+    // the 30d buckets cannot cover a 40d window better than the 1d buckets
+    ASSERT_EQ(std::vector<size_t>({2, 0}), LongWindowOptimized::SelectAggrLevels(table_infos, 40 * DAY));
+    // short window merges the finest buckets only
+    ASSERT_EQ(std::vector<size_t>({2}), LongWindowOptimized::SelectAggrLevels(table_infos, 20 * HOUR));
+    // unknown window size
+    ASSERT_EQ(std::vector<size_t>({2}), LongWindowOptimized::SelectAggrLevels(table_infos, -1));
+
+    // levels which are not multiples of each other are not merged together
+    table_infos = MakeTableInfos({"1h", "90m", "1d"});
+    ASSERT_EQ(std::vector<size_t>({0, 2}), LongWindowOptimized::SelectAggrLevels(table_infos, 100 * DAY));
+
+    // rows bucket
+    table_infos = MakeTableInfos({"1000"});
+    ASSERT_EQ(std::vector<size_t>({0}), LongWindowOptimized::SelectAggrLevels(table_infos, 365 * DAY));
+    table_infos = MakeTableInfos({"1000", "1d"});
+    ASSERT_EQ(std::vector<size_t>({1}), LongWindowOptimized::SelectAggrLevels(table_infos, 365 * DAY));
+}
+
+}  // namespace passes
+}  // namespace hybridse
+
+int main(int argc, char** argv) {
+    ::testing::GTEST_FLAG(color) = "yes";
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
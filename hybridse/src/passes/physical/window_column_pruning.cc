@@ -26,17 +26,41 @@ namespace passes {
 
 using hybridse::common::kPlanError;
 using hybridse::vm::ColumnProjects;
+using hybridse::vm::kAggregation;
+using hybridse::vm::kPhysicalOpDataProvider;
 using hybridse::vm::kPhysicalOpProject;
+using hybridse::vm::kPhysicalOpRequestUnion;
+using hybridse::vm::kProviderTypeRequest;
 using hybridse::vm::kWindowAggregation;
+using hybridse::vm::PhysicalDataProviderNode;
 using hybridse::vm::PhysicalProjectNode;
+using hybridse::vm::PhysicalRequestUnionNode;
 using hybridse::vm::PhysicalSimpleProjectNode;
+using hybridse::vm::SchemasContext;
 
 Status WindowColumnPruning::Apply(PhysicalPlanContext* ctx,
                                   PhysicalOpNode* input, PhysicalOpNode** out) {
     cache_.clear();
+    consumer_cnt_.clear();
+    std::set<size_t> visited;
+    CountConsumers(input, &visited);
     return DoApply(ctx, input, out);
 }
 
+void WindowColumnPruning::CountConsumers(PhysicalOpNode* input,
+                                         std::set<size_t>* visited) {
+    if (input == nullptr || !visited->insert(input->node_id()).second) {
+        return;
+    }
+    for (auto dependent : input->GetDependents()) {
+        if (dependent == nullptr) {
+            continue;
+        }
+        consumer_cnt_[dependent->node_id()]++;
+        CountConsumers(dependent, visited);
+    }
+}
+
 Status WindowColumnPruning::DoApply(PhysicalPlanContext* ctx,
                                     PhysicalOpNode* input,
                                     PhysicalOpNode** out) {
@@ -66,6 +90,20 @@ Status WindowColumnPruning::DoApply(PhysicalPlanContext* ctx,
     switch (input->GetOpType()) {
         case kPhysicalOpProject: {
             auto project_op = dynamic_cast<PhysicalProjectNode*>(input);
+            if (project_op->project_type_ == kAggregation &&
+                project_op->GetProducer(0)->GetOpType() ==
+                    kPhysicalOpRequestUnion) {
+                // keep the window unpruned if its columns can't be resolved
+                Status status = ProcessRequestWindow(
+                    ctx, dynamic_cast<PhysicalAggregationNode*>(project_op),
+                    out);
+                if (!status.isOK()) {
+                    DLOG(WARNING) << "Skip request window column pruning: "
+                                  << status;
+                    *out = input;
+                }
+                break;
+            }
             if (project_op->project_type_ != kWindowAggregation) {
                 break;
             }
@@ -198,5 +236,143 @@ Status WindowColumnPruning::ProcessWindow(PhysicalPlanContext* ctx,
     return Status::OK();
 }
 
+static Status ResolveColumnIndex(const SchemasContext* schemas_ctx,
+                                 const node::ExprNode* col_expr,
+                                 size_t* schema_idx, size_t* col_idx) {
+    switch (col_expr->GetExprType()) {
+        case node::kExprColumnRef: {
+            auto col = dynamic_cast<const node::ColumnRefNode*>(col_expr);
+            CHECK_STATUS(
+                schemas_ctx->ResolveColumnRefIndex(col, schema_idx, col_idx));
+            break;
+        }
+        case node::kExprColumnId: {
+            auto col = dynamic_cast<const node::ColumnIdNode*>(col_expr);
+            CHECK_STATUS(schemas_ctx->ResolveColumnIndexByID(
+                col->GetColumnID(), schema_idx, col_idx));
+            break;
+        }
+        default:
+            FAIL_STATUS(kPlanError, "Unknown column expression: ",
+                        col_expr->GetExprString());
+    }
+    return Status::OK();
+}
+
+static bool IsRequestProvider(const PhysicalOpNode* node) {
+    return node->GetOpType() == kPhysicalOpDataProvider &&
+           dynamic_cast<const PhysicalDataProviderNode*>(node)
+                   ->provider_type_ == kProviderTypeRequest;
+}
+
+// Request mode window: AGGREGATION <- REQUEST_UNION(request, table).
+// Both the request row and the window rows read from the table are
+// projected to the referenced columns, so that the window buffer only
+// holds compact rows instead of the whole (maybe very wide) table rows.
+Status WindowColumnPruning::ProcessRequestWindow(
+    PhysicalPlanContext* ctx, PhysicalAggregationNode* agg_op,
+    PhysicalOpNode** out) {
+    auto union_op =
+        dynamic_cast<PhysicalRequestUnionNode*>(agg_op->GetProducer(0));
+    if (union_op == nullptr || !union_op->window_unions().Empty() ||
+        union_op->instance_not_in_window() ||
+        !union_op->output_request_row() ||
+        consumer_cnt_[union_op->node_id()] > 1) {
+        return Status::OK();
+    }
+    auto request = union_op->GetProducer(0);
+    auto table = union_op->GetProducer(1);
+    if (!IsRequestProvider(request) ||
+        table->GetOpType() != kPhysicalOpDataProvider ||
+        IsRequestProvider(table) ||
+        !PhysicalOpNode::IsSameSchema(request->GetOutputSchema(),
+                                      table->GetOutputSchema())) {
+        return Status::OK();
+    }
+    auto request_schema = request->schemas_ctx();
+    auto union_schema = union_op->schemas_ctx();
+    if (request_schema->GetSchemaSourceSize() != 1 ||
+        union_schema->GetSchemaSourceSize() != 1 ||
+        table->schemas_ctx()->GetSchemaSourceSize() != 1) {
+        return Status::OK();
+    }
+
+    std::set<size_t> col_idxs;
+    size_t schema_idx;
+    size_t col_idx;
+    // window op depends on the request input
+    std::vector<const node::ExprNode*> window_columns;
+    union_op->window().ResolvedRelatedColumns(&window_columns);
+    for (const auto col_expr : window_columns) {
+        CHECK_STATUS(ResolveColumnIndex(request_schema, col_expr, &schema_idx,
+                                        &col_idx));
+        col_idxs.insert(col_idx);
+    }
+
+    // projection and having condition depend on the union output
+    std::vector<const node::ExprNode*> depend_columns;
+    const auto& projects = agg_op->project();
+    std::vector<const node::ExprNode*> exprs;
+    for (size_t i = 0; i < projects.size(); ++i) {
+        exprs.push_back(projects.GetExpr(i));
+    }
+    if (agg_op->having_condition_.ValidCondition()) {
+        exprs.push_back(agg_op->having_condition_.condition());
+    }
+    for (auto expr : exprs) {
+        std::vector<const node::ExprNode*> expr_depend_columns;
+        CHECK_STATUS(union_schema->ResolveExprDependentColumns(
+            expr, &expr_depend_columns));
+        std::copy(expr_depend_columns.begin(), expr_depend_columns.end(),
+                  std::back_inserter(depend_columns));
+    }
+    for (const auto col_expr : depend_columns) {
+        CHECK_STATUS(ResolveColumnIndex(union_schema, col_expr, &schema_idx,
+                                        &col_idx));
+        col_idxs.insert(col_idx);
+    }
+    if (col_idxs.empty() ||
+        col_idxs.size() == request->GetOutputSchema()->size()) {
+        return Status::OK();
+    }
+
+    // request and table share the same schema, project them in the same
+    // column order so that the union keeps a single row layout
+    ColumnProjects request_projects;
+    ColumnProjects table_projects;
+    auto request_source = request_schema->GetSchemaSource(0);
+    auto table_source = table->schemas_ctx()->GetSchemaSource(0);
+    for (auto idx : col_idxs) {
+        request_projects.Add(
+            request_source->GetColumnName(idx),
+            ctx->node_manager()->MakeColumnIdNode(
+                request_source->GetColumnID(idx)),
+            nullptr);
+        table_projects.Add(table_source->GetColumnName(idx),
+                           ctx->node_manager()->MakeColumnIdNode(
+                               table_source->GetColumnID(idx)),
+                           nullptr);
+    }
+    PhysicalSimpleProjectNode* pruned_request = nullptr;
+    CHECK_STATUS(ctx->CreateOp<PhysicalSimpleProjectNode>(
+        &pruned_request, request, request_projects));
+    PhysicalSimpleProjectNode* pruned_table = nullptr;
+    CHECK_STATUS(ctx->CreateOp<PhysicalSimpleProjectNode>(
+        &pruned_table, table, table_projects));
+
+    PhysicalRequestUnionNode* new_union_op = nullptr;
+    CHECK_STATUS(ctx->CreateOp<PhysicalRequestUnionNode>(
+        &new_union_op, pruned_request, pruned_table, union_op->window(),
+        union_op->instance_not_in_window(), union_op->exclude_current_time(),
+        union_op->output_request_row()));
+    PhysicalAggregationNode* new_agg_op = nullptr;
+    CHECK_STATUS(ctx->CreateOp<PhysicalAggregationNode>(
+        &new_agg_op, new_union_op, projects,
+        agg_op->having_condition_.condition()));
+    new_agg_op->SetLimitCnt(agg_op->GetLimitCnt());
+    *out = new_agg_op;
+    return Status::OK();
+}
+
 }  // namespace passes
 }  // namespace hybridse
@@ -15,6 +15,7 @@
  */
 
 #include <map>
+#include <set>
 
 #include "passes/physical/physical_pass.h"
 #include "vm/physical_op.h"
@@ -26,6 +27,7 @@ namespace hybridse {
 namespace passes {
 
 using hybridse::base::Status;
+using hybridse::vm::PhysicalAggregationNode;
 using hybridse::vm::PhysicalWindowAggrerationNode;
 
 class WindowColumnPruning : public PhysicalPass {
@@ -39,8 +41,14 @@ class WindowColumnPruning : public PhysicalPass {
     Status ProcessWindow(PhysicalPlanContext* ctx,
                          PhysicalWindowAggrerationNode* input,
                          PhysicalOpNode** out);
+    Status ProcessRequestWindow(PhysicalPlanContext* ctx,
+                                PhysicalAggregationNode* input,
+                                PhysicalOpNode** out);
+    void CountConsumers(PhysicalOpNode* input, std::set<size_t>* visited);
 
     std::map<size_t, PhysicalOpNode*> cache_;
+    // node id -> number of consumers in the original plan
+    std::map<size_t, size_t> consumer_cnt_;
 };
 
 }  // namespace passes
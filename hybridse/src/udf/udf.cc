@@ -1420,6 +1420,39 @@ void next_nullable_iterator(int8_t *input, V *v, bool *is_null) {
     return;
 }
 
+template <class V>
+int32_t next_batch_iterator(int8_t *input, V *values, bool *is_null, int32_t cap) {
+    ::hybridse::codec::IteratorRef *iter_ref =
+        (::hybridse::codec::IteratorRef *)(input);
+    ConstIterator<uint64_t, V> *iter =
+        (ConstIterator<uint64_t, V> *)(iter_ref->iterator);
+    uint32_t cnt = iter->NextBatch(values, is_null, cap);
+    // elements are declared not nullable, give NULL the default value
+    for (uint32_t i = 0; i < cnt; ++i) {
+        if (is_null[i]) {
+            values[i] = V();
+        }
+    }
+    return cnt;
+}
+
+template <class V>
+int32_t next_nullable_batch_iterator(int8_t *input, V *values, bool *is_null, int32_t cap) {
+    ::hybridse::codec::IteratorRef *iter_ref =
+        (::hybridse::codec::IteratorRef *)(input);
+    ConstIterator<uint64_t, Nullable<V>> *iter =
+        (ConstIterator<uint64_t, Nullable<V>> *)(iter_ref->iterator);
+    int32_t cnt = 0;
+    while (cnt < cap && iter->Valid()) {
+        auto &nullable_value = iter->GetValue();
+        values[cnt] = nullable_value.value();
+        is_null[cnt] = nullable_value.is_null();
+        iter->Next();
+        cnt++;
+    }
+    return cnt;
+}
+
 template <class V>
 bool next_struct_iterator(int8_t *input, V *v) {
     ::hybridse::codec::IteratorRef *iter_ref =
@@ -1635,6 +1668,32 @@ void RegisterNativeUdfToModule(UdfLibrary* lib) {
         "next_nullable", bool_ty, {iter_string_ty},
         reinterpret_cast<void *>(v1::next_nullable_iterator<StringRef>));
 
+    RegisterMethodInternal("next_batch", i32_ty, {iter_i16_ty},
+                   reinterpret_cast<void *>(v1::next_batch_iterator<int16_t>));
+    RegisterMethodInternal("next_batch", i32_ty, {iter_i32_ty},
+                   reinterpret_cast<void *>(v1::next_batch_iterator<int32_t>));
+    RegisterMethodInternal("next_batch", i32_ty, {iter_i64_ty},
+                   reinterpret_cast<void *>(v1::next_batch_iterator<int64_t>));
+    RegisterMethodInternal("next_batch", i32_ty, {iter_bool_ty},
+                   reinterpret_cast<void *>(v1::next_batch_iterator<bool>));
+    RegisterMethodInternal("next_batch", i32_ty, {iter_float_ty},
+                   reinterpret_cast<void *>(v1::next_batch_iterator<float>));
+    RegisterMethodInternal("next_batch", i32_ty, {iter_double_ty},
+                   reinterpret_cast<void *>(v1::next_batch_iterator<double>));
+
+    RegisterMethodInternal("next_nullable_batch", i32_ty, {iter_i16_ty},
+                   reinterpret_cast<void *>(v1::next_nullable_batch_iterator<int16_t>));
+    RegisterMethodInternal("next_nullable_batch", i32_ty, {iter_i32_ty},
+                   reinterpret_cast<void *>(v1::next_nullable_batch_iterator<int32_t>));
+    RegisterMethodInternal("next_nullable_batch", i32_ty, {iter_i64_ty},
+                   reinterpret_cast<void *>(v1::next_nullable_batch_iterator<int64_t>));
+    RegisterMethodInternal("next_nullable_batch", i32_ty, {iter_bool_ty},
+                   reinterpret_cast<void *>(v1::next_nullable_batch_iterator<bool>));
+    RegisterMethodInternal("next_nullable_batch", i32_ty, {iter_float_ty},
+                   reinterpret_cast<void *>(v1::next_nullable_batch_iterator<float>));
+    RegisterMethodInternal("next_nullable_batch", i32_ty, {iter_double_ty},
+                   reinterpret_cast<void *>(v1::next_nullable_batch_iterator<double>));
+
     RegisterMethodInternal("has_next", bool_ty, {iter_i16_ty},
                    reinterpret_cast<void *>(v1::has_next<int16_t>));
     RegisterMethodInternal("has_next", bool_ty, {iter_i32_ty},
@@ -291,6 +291,12 @@ V next_iterator(int8_t *input);
 template <class V>
 void next_nullable_iterator(int8_t *input, V *v, bool *is_null);
 
+template <class V>
+int32_t next_batch_iterator(int8_t *input, V *values, bool *is_null, int32_t cap);
+
+template <class V>
+int32_t next_nullable_batch_iterator(int8_t *input, V *values, bool *is_null, int32_t cap);
+
 template <class V>
 void delete_iterator(int8_t *input);
 
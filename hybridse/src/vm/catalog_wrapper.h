@@ -51,6 +51,8 @@ class IteratorProjectWrapper : public RowIterator {
     void Seek(const uint64_t& k) override { iter_->Seek(k); }
     void SeekToFirst() override { iter_->SeekToFirst(); }
     bool IsSeekable() const override { return iter_->IsSeekable(); }
+    void SeekToPosition(uint64_t pos) override { iter_->SeekToPosition(pos); }
+    bool IsPositionSeekable() const override { return iter_->IsPositionSeekable(); }
     std::unique_ptr<RowIterator> iter_;
     const Row& parameter_;
     const ProjectFun* fun_;
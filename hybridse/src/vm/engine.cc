@@ -16,6 +16,9 @@
 
 #include "vm/engine.h"
 
+#include <algorithm>
+#include <cctype>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -146,6 +149,32 @@ bool Engine::IsCompatibleCache(RunSession& session,  // NOLINT
     return true;
 }
 
+// the lower case identifiers followed by '(' in the sql, a superset of the functions it calls
+static std::set<std::string> CalledFunctions(const std::string& sql) {
+    std::set<std::string> names;
+    size_t i = 0;
+    while (i < sql.size()) {
+        if (!std::isalpha(static_cast<unsigned char>(sql[i])) && sql[i] != '_') {
+            i++;
+            continue;
+        }
+        size_t start = i;
+        while (i < sql.size() && (std::isalnum(static_cast<unsigned char>(sql[i])) || sql[i] == '_')) {
+            i++;
+        }
+        size_t end = i;
+        while (i < sql.size() && std::isspace(static_cast<unsigned char>(sql[i]))) {
+            i++;
+        }
+        if (i < sql.size() && sql[i] == '(') {
+            std::string name = sql.substr(start, end - start);
+            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+            names.insert(std::move(name));
+        }
+    }
+    return names;
+}
+
 bool Engine::Get(const std::string& sql, const std::string& db, RunSession& session,
                  base::Status& status) {  // NOLINT (runtime/references)
     std::shared_ptr<CompileInfo> cached_info = GetCacheLocked(db, sql, session.engine_mode());
@@ -161,6 +190,12 @@ bool Engine::Get(const std::string& sql, const std::string& db, RunSession& sess
     DLOG(INFO) << "Compile Engine ...";
     status = base::Status::OK();
     std::shared_ptr<SqlCompileInfo> info = std::make_shared<SqlCompileInfo>();
+    auto& cache_dep = info->get_cache_dependency();
+    {
+        // the invalidations from now on make the result stale
+        std::lock_guard<base::SpinMutex> lock(mu_);
+        cache_dep.epoch = cache_epoch_;
+    }
     auto& sql_context = info->get_sql_context();
     sql_context.sql = sql;
     sql_context.db = db;
@@ -202,6 +237,10 @@ bool Engine::Get(const std::string& sql, const std::string& db, RunSession& sess
             return false;
         }
     }
+    if (sql_context.physical_plan != nullptr) {
+        internal::GetDependentTables(sql_context.physical_plan, &cache_dep.tables);
+    }
+    cache_dep.functions = CalledFunctions(sql);
 
     SetCacheLocked(db, sql, session.engine_mode(), info);
     session.SetCompileInfo(info);
@@ -337,6 +376,51 @@ void Engine::ClearCacheLocked(const std::string& db) {
     }
 }
 
+void Engine::InvalidateTable(const std::string& db, const std::string& table) {
+    std::lock_guard<base::SpinMutex> lock(mu_);
+    table_epochs_[{db, table}] = ++cache_epoch_;
+    cache_invalidations_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Engine::InvalidateFunction(const std::string& name) {
+    std::string lower_name = name;
+    std::transform(lower_name.begin(), lower_name.end(), lower_name.begin(), ::tolower);
+    std::lock_guard<base::SpinMutex> lock(mu_);
+    function_epochs_[lower_name] = ++cache_epoch_;
+    cache_invalidations_.fetch_add(1, std::memory_order_relaxed);
+}
+
+EngineCacheStats Engine::GetCacheStats() const {
+    EngineCacheStats stats;
+    stats.invalidations = cache_invalidations_.load(std::memory_order_relaxed);
+    stats.recompiles = cache_recompiles_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool Engine::IsStaleCache(const std::shared_ptr<CompileInfo>& info) {
+    auto sql_info = std::dynamic_pointer_cast<SqlCompileInfo>(info);
+    if (!sql_info) {
+        return false;
+    }
+    const auto& dep = sql_info->get_cache_dependency();
+    if (dep.epoch == cache_epoch_) {
+        return false;
+    }
+    for (const auto& table : dep.tables) {
+        auto it = table_epochs_.find(table);
+        if (it != table_epochs_.end() && it->second > dep.epoch) {
+            return true;
+        }
+    }
+    for (const auto& function : dep.functions) {
+        auto it = function_epochs_.find(function);
+        if (it != function_epochs_.end() && it->second > dep.epoch) {
+            return true;
+        }
+    }
+    return false;
+}
+
 EngineOptions Engine::GetEngineOptions() {
     return options_;
 }
@@ -361,9 +445,13 @@ std::shared_ptr<CompileInfo> Engine::GetCacheLocked(const std::string& db, const
     auto value = lru.get(sql);
     if (value == boost::none) {
         return nullptr;
-    } else {
-        return value.value();
     }
+    if (IsStaleCache(value.value())) {
+        // the caller compiles it again and replaces the entry
+        cache_recompiles_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return value.value();
 }
 
 bool Engine::SetCacheLocked(const std::string& db, const std::string& sql, EngineMode engine_mode,
@@ -378,7 +466,7 @@ bool Engine::SetCacheLocked(const std::string& db, const std::string& sql, Engin
     }
     auto& lru = db_iter->second;
     auto value = lru.get(sql);
-    if (value == boost::none || engine_mode == kBatchRequestMode) {
+    if (value == boost::none || engine_mode == kBatchRequestMode || IsStaleCache(value.value())) {
         lru.insert(sql, info);
         return true;
     } else {
@@ -483,6 +571,9 @@ int32_t RequestRunSession::Run(const uint32_t task_id, const Row& in_row, Row* o
     }
     DLOG(INFO) << "Request Row Run with task_id " << task_id;
     RunnerContext ctx(info->get_sql_context().cluster_job, row, sp_name_, is_debug_);
+    if (is_profile_) {
+        ctx.EnableProfile();
+    }
     auto output = task->RunWithCache(ctx);
     if (!output) {
         LOG(WARNING) << "Run request plan output is null";
@@ -541,6 +632,9 @@ int32_t BatchRunSession::Run(std::vector<Row>& rows, uint64_t limit) {
 int32_t BatchRunSession::Run(const Row& parameter_row, std::vector<Row>& rows, uint64_t limit) {
     auto& sql_ctx = std::dynamic_pointer_cast<SqlCompileInfo>(compile_info_)->get_sql_context();
     RunnerContext ctx(sql_ctx.cluster_job, parameter_row, is_debug_);
+    if (is_profile_) {
+        ctx.EnableProfile();
+    }
     auto output = sql_ctx.cluster_job->GetTask(0).GetRoot()->RunWithCache(ctx);
     if (!output) {
         DLOG(INFO) << "Run batch plan output is empty";
@@ -85,6 +85,59 @@ TEST_F(EngineCompileTest, EngineLRUCacheTest) {
 }
 
 
+TEST_F(EngineCompileTest, EngineCacheInvalidationTest) {
+    auto catalog = BuildSimpleCatalog();
+    hybridse::type::Database db;
+    db.set_name("simple_db");
+    hybridse::type::TableDef table_def;
+    sqlcase::CaseSchemaMock::BuildTableDef(table_def);
+    table_def.set_name("t1");
+    AddTable(db, table_def);
+    hybridse::type::TableDef table_def2;
+    sqlcase::CaseSchemaMock::BuildTableDef(table_def2);
+    table_def2.set_name("t2");
+    AddTable(db, table_def2);
+    catalog->AddDatabase(db);
+
+    EngineOptions options;
+    options.SetCompileOnly(true);
+    Engine engine(catalog, options);
+
+    std::string sql = "select col1, col2 from t1;";
+    std::string sql2 = "select abs(col1) as c1 from t2;";
+    base::Status get_status;
+    BatchRunSession bsession1;
+    ASSERT_TRUE(engine.Get(sql, "simple_db", bsession1, get_status)) << get_status;
+    BatchRunSession bsession2;
+    ASSERT_TRUE(engine.Get(sql2, "simple_db", bsession2, get_status)) << get_status;
+
+    // only the sql reading t1 is compiled again
+    engine.InvalidateTable("simple_db", "t1");
+    BatchRunSession bsession3;
+    ASSERT_TRUE(engine.Get(sql, "simple_db", bsession3, get_status)) << get_status;
+    ASSERT_NE(bsession1.GetCompileInfo().get(), bsession3.GetCompileInfo().get());
+    BatchRunSession bsession4;
+    ASSERT_TRUE(engine.Get(sql2, "simple_db", bsession4, get_status)) << get_status;
+    ASSERT_EQ(bsession2.GetCompileInfo().get(), bsession4.GetCompileInfo().get());
+    // the recompiled result is cached again
+    BatchRunSession bsession5;
+    ASSERT_TRUE(engine.Get(sql, "simple_db", bsession5, get_status)) << get_status;
+    ASSERT_EQ(bsession3.GetCompileInfo().get(), bsession5.GetCompileInfo().get());
+
+    // only the sql calling the function is compiled again
+    engine.InvalidateFunction("ABS");
+    BatchRunSession bsession6;
+    ASSERT_TRUE(engine.Get(sql2, "simple_db", bsession6, get_status)) << get_status;
+    ASSERT_NE(bsession2.GetCompileInfo().get(), bsession6.GetCompileInfo().get());
+    BatchRunSession bsession7;
+    ASSERT_TRUE(engine.Get(sql, "simple_db", bsession7, get_status)) << get_status;
+    ASSERT_EQ(bsession3.GetCompileInfo().get(), bsession7.GetCompileInfo().get());
+
+    auto stats = engine.GetCacheStats();
+    ASSERT_EQ(2u, stats.invalidations);
+    ASSERT_EQ(2u, stats.recompiles);
+}
+
 TEST_F(EngineCompileTest, EngineWithParameterizedLRUCacheTest) {
     // Build Simple Catalog
     auto catalog = BuildSimpleCatalog();
@@ -497,6 +550,34 @@ TEST_F(EngineCompileTest, RouterTest) {
         ASSERT_EQ(explain_output.router.GetMainTable(), "t1");
         ASSERT_EQ(explain_output.router.GetRouterCol(), "col2");
     }
+    {
+        // the window column pruning wraps both inputs of the request union with a simple project, the route of the
+        // cluster plan stays the same
+        std::string sql =
+            "select col2, sum(col1) over w1 from t1 \n"
+            "window w1 as (partition by col2 \n"
+            "order by col5 rows between 3 preceding and current row);";
+        for (auto mode : {kRequestMode, kBatchRequestMode}) {
+            for (bool pruning : {false, true}) {
+                EngineOptions options;
+                options.SetCompileOnly(true);
+                options.SetClusterOptimized(true);
+                options.SetEnableWindowColumnPruning(pruning);
+                Engine engine(catalog, options);
+                ExplainOutput explain_output;
+                codec::Schema empty_parameter_schema;
+                base::Status status;
+                ASSERT_TRUE(
+                    engine.Explain(sql, "simple_db", mode, empty_parameter_schema, &explain_output, &status));
+                if (mode == kRequestMode) {
+                    ASSERT_EQ(pruning, explain_output.physical_plan.find("SIMPLE_PROJECT") != std::string::npos)
+                        << explain_output.physical_plan;
+                }
+                ASSERT_EQ(explain_output.router.GetMainTable(), "t1");
+                ASSERT_EQ(explain_output.router.GetRouterCol(), "col2");
+            }
+        }
+    }
 }
 
 TEST_F(EngineCompileTest, ExplainBatchRequestTest) {
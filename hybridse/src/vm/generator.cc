@@ -60,6 +60,7 @@ std::shared_ptr<PartitionHandler> PartitionGenerator::Partition(
     }
     iter->SeekToFirst();
     output_partitions->SetOrderType(table->GetOrderType());
+    MemHashPartitioner partitioner;
     while (iter->Valid()) {
         auto segment_iter = iter->GetValue();
         if (!segment_iter) {
@@ -69,12 +70,12 @@ std::shared_ptr<PartitionHandler> PartitionGenerator::Partition(
         auto segment_key = iter->GetKey().ToString();
         segment_iter->SeekToFirst();
         while (segment_iter->Valid()) {
-            std::string keys = key_gen_.Gen(segment_iter->GetValue(), parameter);
-            output_partitions->AddRow(segment_key + "|" + keys,
-                                      segment_iter->GetKey(),
-                                      segment_iter->GetValue());
+            if (!AddRow(&partitioner, segment_iter->GetKey(), segment_iter->GetValue(), parameter)) {
+                return std::shared_ptr<PartitionHandler>();
+            }
             segment_iter->Next();
         }
+        partitioner.Flush(segment_key, output_partitions.get());
         iter->Next();
     }
     return output_partitions;
@@ -100,15 +101,34 @@ std::shared_ptr<PartitionHandler> PartitionGenerator::Partition(
         LOG(WARNING) << "Fail to group empty table: table is empty";
         return fail_ptr;
     }
+    MemHashPartitioner partitioner;
     iter->SeekToFirst();
     while (iter->Valid()) {
-        std::string keys = key_gen_.Gen(iter->GetValue(), parameter);
-        output_partitions->AddRow(keys, iter->GetKey(), iter->GetValue());
+        if (!AddRow(&partitioner, iter->GetKey(), iter->GetValue(), parameter)) {
+            return fail_ptr;
+        }
         iter->Next();
     }
+    partitioner.Flush(output_partitions.get());
     output_partitions->SetOrderType(table->GetOrderType());
     return output_partitions;
 }
+bool PartitionGenerator::AddRow(MemHashPartitioner* partitioner, uint64_t ts, const Row& row,
+                                const Row& parameter) {
+    if (!key_gen_.IsFixedKey()) {
+        partitioner->AddRow(key_gen_.Gen(row, parameter), ts, row);
+        return true;
+    }
+    int64_t key = 0;
+    bool is_null = true;
+    if (!key_gen_.GenFixed(row, parameter, &key, &is_null)) {
+        LOG(WARNING) << "Partition Fail: fail to gen key";
+        return false;
+    }
+    partitioner->AddRow(
+        key, is_null, [&]() { return key_gen_.Gen(row, parameter); }, ts, row);
+    return true;
+}
 std::shared_ptr<DataHandler> SortGenerator::Sort(
     std::shared_ptr<DataHandler> input, const bool reverse) {
     if (!input || !is_valid_ || !order_gen_.Valid()) {
@@ -362,6 +382,61 @@ Row JoinGenerator::RowLastJoinTable(const Row& left_row,
     return Row(left_slices_, left_row, right_slices_, Row());
 }
 
+void LastJoinHashTable::Add(const std::string& key, const Row& row) {
+    auto& rows = rows_[key];
+    if (first_only_ && !rows.empty()) {
+        return;
+    }
+    rows.push_back(row);
+}
+
+const std::vector<Row>* LastJoinHashTable::Find(const std::string& key) const {
+    auto iter = rows_.find(key);
+    if (iter == rows_.end()) {
+        return nullptr;
+    }
+    return &iter->second;
+}
+
+std::shared_ptr<LastJoinHashTable> JoinGenerator::BuildHashTable(std::shared_ptr<TableHandler> right,
+                                                                 const Row& parameter) {
+    auto hash_table = std::make_shared<LastJoinHashTable>(!condition_gen_.Valid());
+    // sort the whole table once, rows are appended to their buckets in the sorted order
+    right = right_sort_gen_.Sort(right, true);
+    if (!right) {
+        return hash_table;
+    }
+    auto right_iter = right->GetIterator();
+    if (!right_iter) {
+        return hash_table;
+    }
+    bool hash_by_key = left_key_gen_.Valid() && right_group_gen_.Valid();
+    right_iter->SeekToFirst();
+    while (right_iter->Valid()) {
+        const Row& right_row = right_iter->GetValue();
+        hash_table->Add(hash_by_key ? right_group_gen_.GetKey(right_row, parameter) : "", right_row);
+        right_iter->Next();
+    }
+    return hash_table;
+}
+
+Row JoinGenerator::RowLastJoinHashTable(const Row& left_row, const LastJoinHashTable& right, const Row& parameter) {
+    std::string left_key_str = "";
+    if (left_key_gen_.Valid() && right_group_gen_.Valid()) {
+        left_key_str = left_key_gen_.Gen(left_row, parameter);
+    }
+    auto right_rows = right.Find(left_key_str);
+    if (right_rows != nullptr) {
+        for (const auto& right_row : *right_rows) {
+            Row joined_row(left_slices_, left_row, right_slices_, right_row);
+            if (!condition_gen_.Valid() || condition_gen_.Gen(joined_row, parameter)) {
+                return joined_row;
+            }
+        }
+    }
+    return Row(left_slices_, left_row, right_slices_, Row());
+}
+
 std::pair<Row, bool> JoinGenerator::RowJoinIterator(const Row& left_row,
                                                     std::unique_ptr<codec::RowIterator>& right_iter,
                                                     const Row& parameter) {
@@ -406,13 +481,11 @@ bool JoinGenerator::TableJoin(std::shared_ptr<TableHandler> left,
         LOG(WARNING) << "Table Join with empty left table";
         return false;
     }
+    auto right_hash = BuildHashTable(right, parameter);
     left_iter->SeekToFirst();
     while (left_iter->Valid()) {
         const Row& left_row = left_iter->GetValue();
-        output->AddRow(
-            left_iter->GetKey(),
-            Runner::RowLastJoinTable(left_slices_, left_row, right_slices_,
-                                     right, parameter, right_sort_gen_, condition_gen_));
+        output->AddRow(left_iter->GetKey(), RowLastJoinHashTable(left_row, *right_hash, parameter));
         left_iter->Next();
     }
     return true;
@@ -461,6 +534,7 @@ bool JoinGenerator::PartitionJoin(std::shared_ptr<PartitionHandler> left,
         LOG(WARNING) << "fail to run last join: left iter empty";
         return false;
     }
+    auto right_hash = BuildHashTable(right, parameter);
     left_window_iter->SeekToFirst();
     while (left_window_iter->Valid()) {
         auto left_iter = left_window_iter->GetValue();
@@ -474,11 +548,7 @@ bool JoinGenerator::PartitionJoin(std::shared_ptr<PartitionHandler> left,
             const Row& left_row = left_iter->GetValue();
             auto key_str = std::string(
                 reinterpret_cast<const char*>(left_key.buf()), left_key.size());
-            output->AddRow(key_str, left_iter->GetKey(),
-                           Runner::RowLastJoinTable(
-                               left_slices_, left_row, right_slices_, right,
-                               parameter,
-                               right_sort_gen_, condition_gen_));
+            output->AddRow(key_str, left_iter->GetKey(), RowLastJoinHashTable(left_row, *right_hash, parameter));
             left_iter->Next();
         }
         left_window_iter->Next();
@@ -647,6 +717,78 @@ const std::string KeyGenerator::Gen(const Row& row, const Row& parameter) {
     return keys;
 }
 
+const bool KeyGenerator::IsFixedKey() const {
+    if (idxs_.size() != 1) {
+        return false;
+    }
+    switch (fn_schema_.Get(idxs_[0]).type()) {
+        case hybridse::type::kBool:
+        case hybridse::type::kInt16:
+        case hybridse::type::kInt32:
+        case hybridse::type::kInt64:
+        case hybridse::type::kTimestamp:
+        case hybridse::type::kDate:
+            return true;
+        default:
+            return false;
+    }
+}
+
+const bool KeyGenerator::GenFixed(const Row& row, const Row& parameter, int64_t* key, bool* is_null) {
+    *key = 0;
+    *is_null = true;
+    if (row.size() == 0) {
+        return true;
+    }
+    Row key_row = CoreAPI::RowProject(fn_, row, parameter, true);
+    int32_t pos = idxs_[0];
+    if (row_view_.IsNULL(key_row.buf(), pos)) {
+        return true;
+    }
+    ::hybridse::type::Type type = fn_schema_.Get(pos).type();
+    switch (type) {
+        case hybridse::type::kBool: {
+            bool buf = false;
+            if (row_view_.GetValue(key_row.buf(), pos, type, reinterpret_cast<void*>(&buf)) != 0) {
+                return false;
+            }
+            *key = buf ? 1 : 0;
+            break;
+        }
+        case hybridse::type::kInt16: {
+            int16_t buf = 0;
+            if (row_view_.GetValue(key_row.buf(), pos, type, reinterpret_cast<void*>(&buf)) != 0) {
+                return false;
+            }
+            *key = buf;
+            break;
+        }
+        case hybridse::type::kInt32:
+        case hybridse::type::kDate: {
+            int32_t buf = 0;
+            if (row_view_.GetValue(key_row.buf(), pos, type, reinterpret_cast<void*>(&buf)) != 0) {
+                return false;
+            }
+            *key = buf;
+            break;
+        }
+        case hybridse::type::kInt64:
+        case hybridse::type::kTimestamp: {
+            int64_t buf = 0;
+            if (row_view_.GetValue(key_row.buf(), pos, type, reinterpret_cast<void*>(&buf)) != 0) {
+                return false;
+            }
+            *key = buf;
+            break;
+        }
+        default: {
+            return false;
+        }
+    }
+    *is_null = false;
+    return true;
+}
+
 const int64_t OrderGenerator::Gen(const Row& row) {
     Row order_row = CoreAPI::RowProject(fn_, row, Row(), true);
     return Runner::GetColumnInt64(order_row.buf(), &row_view_, idxs_[0],
@@ -21,6 +21,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "vm/core_api.h"
@@ -108,6 +109,10 @@ class KeyGenerator : public FnGenerator {
     virtual ~KeyGenerator() {}
     const std::string Gen(const Row& row, const Row& parameter);
     const std::string GenConst(const Row& parameter);
+    // whether the key is a single fixed-width column that GenFixed supports
+    const bool IsFixedKey() const;
+    // gen the key of IsFixedKey as an int64, it is equal iff the string keys of Gen are equal
+    const bool GenFixed(const Row& row, const Row& parameter, int64_t* key, bool* is_null);
 };
 class OrderGenerator : public FnGenerator {
  public:
@@ -189,6 +194,8 @@ class PartitionGenerator {
     const std::string GetKey(const Row& row, const Row& parameter) { return key_gen_.Gen(row, parameter); }
 
  private:
+    bool AddRow(MemHashPartitioner* partitioner, uint64_t ts, const Row& row, const Row& parameter);
+
     KeyGenerator key_gen_;
 };
 class SortGenerator {
@@ -281,6 +288,23 @@ class RequestWindowGenertor {
     IndexSeekGenerator index_seek_gen_;
 };
 
+// Right table of a last join hashed by the join key. Rows of a key keep the order of the right sort, so that
+// every left row only visits the candidates of its own key. It is built once per run and probed by all left rows.
+class LastJoinHashTable {
+ public:
+    // only keep the first row of every key if `first_only` is set, e.g. there is no join condition
+    explicit LastJoinHashTable(bool first_only) : first_only_(first_only) {}
+    ~LastJoinHashTable() {}
+
+    void Add(const std::string& key, const Row& row);
+    const std::vector<Row>* Find(const std::string& key) const;
+    size_t GetKeyCnt() const { return rows_.size(); }
+
+ private:
+    bool first_only_;
+    std::unordered_map<std::string, std::vector<Row>> rows_;
+};
+
 class JoinGenerator : public std::enable_shared_from_this<JoinGenerator> {
  public:
     [[nodiscard]] static std::shared_ptr<JoinGenerator> Create(const Join& join, size_t left_slices,
@@ -302,6 +326,10 @@ class JoinGenerator : public std::enable_shared_from_this<JoinGenerator> {
                        std::shared_ptr<MemPartitionHandler>);  // NOLINT
 
     Row RowLastJoin(const Row& left_row, std::shared_ptr<DataHandler> right, const Row& parameter);
+
+    // build the hash table of an unindexed right table, rows are bucketed by the right key
+    std::shared_ptr<LastJoinHashTable> BuildHashTable(std::shared_ptr<TableHandler> right, const Row& parameter);
+    Row RowLastJoinHashTable(const Row& left_row, const LastJoinHashTable& right, const Row& parameter);
     Row RowLastJoinDropLeftSlices(const Row& left_row, std::shared_ptr<DataHandler> right, const Row& parameter);
 
     // lazy join, supports left join and last join
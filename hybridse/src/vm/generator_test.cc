@@ -0,0 +1,114 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vm/generator.h"
+
+#include <string>
+#include <vector>
+
+#include "codec/fe_row_codec.h"
+#include "gtest/gtest.h"
+
+namespace hybridse {
+namespace vm {
+using codec::Row;
+
+class LastJoinHashTableTest : public ::testing::Test {
+ public:
+    LastJoinHashTableTest() {}
+    ~LastJoinHashTableTest() {}
+
+ protected:
+    // Row(const std::string&) does not own the data, keep the values alive during the test
+    std::vector<std::string> values_ = {"r0", "r1", "r2", "r3", "r4", "r5"};
+};
+
+static std::vector<std::string> ToStrings(const std::vector<Row>* rows) {
+    std::vector<std::string> result;
+    if (rows != nullptr) {
+        for (const auto& row : *rows) {
+            result.push_back(row.ToString());
+        }
+    }
+    return result;
+}
+
+TEST_F(LastJoinHashTableTest, MultipleMatchesKeepOrder) {
+    LastJoinHashTable table(false);
+    table.Add("k1", Row(values_[0]));
+    table.Add("k2", Row(values_[1]));
+    table.Add("k1", Row(values_[2]));
+    table.Add("k1", Row(values_[3]));
+    ASSERT_EQ(2u, table.GetKeyCnt());
+    // the candidates of a key are probed in the order they are added, i.e. the order of the right sort
+    ASSERT_EQ(std::vector<std::string>({"r0", "r2", "r3"}), ToStrings(table.Find("k1")));
+    ASSERT_EQ(std::vector<std::string>({"r1"}), ToStrings(table.Find("k2")));
+}
+
+TEST_F(LastJoinHashTableTest, FirstOnly) {
+    LastJoinHashTable table(true);
+    table.Add("k1", Row(values_[0]));
+    table.Add("k1", Row(values_[1]));
+    table.Add("k2", Row(values_[2]));
+    table.Add("k1", Row(values_[3]));
+    ASSERT_EQ(2u, table.GetKeyCnt());
+    // without a join condition the first row of the sorted right table is the result of last join
+    ASSERT_EQ(std::vector<std::string>({"r0"}), ToStrings(table.Find("k1")));
+    ASSERT_EQ(std::vector<std::string>({"r2"}), ToStrings(table.Find("k2")));
+}
+
+TEST_F(LastJoinHashTableTest, MissingKey) {
+    LastJoinHashTable table(false);
+    ASSERT_EQ(nullptr, table.Find("k1"));
+    ASSERT_EQ(nullptr, table.Find(""));
+    table.Add("k1", Row(values_[0]));
+    ASSERT_EQ(nullptr, table.Find("k2"));
+    ASSERT_EQ(nullptr, table.Find("k"));
+    ASSERT_EQ(nullptr, table.Find(""));
+    ASSERT_EQ(1u, table.GetKeyCnt());
+}
+
+TEST_F(LastJoinHashTableTest, NullAndEmptyKey) {
+    // key generators encode null and empty string values with tokens, so they fall into their own buckets
+    LastJoinHashTable table(false);
+    table.Add(codec::NONETOKEN, Row(values_[0]));
+    table.Add(codec::EMPTY_STRING, Row(values_[1]));
+    table.Add("k1", Row(values_[2]));
+    table.Add(codec::NONETOKEN, Row(values_[3]));
+    table.Add("k1|" + codec::NONETOKEN, Row(values_[4]));
+    ASSERT_EQ(4u, table.GetKeyCnt());
+    ASSERT_EQ(std::vector<std::string>({"r0", "r3"}), ToStrings(table.Find(codec::NONETOKEN)));
+    ASSERT_EQ(std::vector<std::string>({"r1"}), ToStrings(table.Find(codec::EMPTY_STRING)));
+    ASSERT_EQ(std::vector<std::string>({"r4"}), ToStrings(table.Find("k1|" + codec::NONETOKEN)));
+    ASSERT_EQ(nullptr, table.Find(""));
+}
+
+TEST_F(LastJoinHashTableTest, NoKey) {
+    // all rows are in the bucket of the empty key if the join has no key
+    LastJoinHashTable table(false);
+    for (size_t i = 0; i < values_.size(); i++) {
+        table.Add("", Row(values_[i]));
+    }
+    ASSERT_EQ(1u, table.GetKeyCnt());
+    ASSERT_EQ(values_, ToStrings(table.Find("")));
+}
+
+}  // namespace vm
+}  // namespace hybridse
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
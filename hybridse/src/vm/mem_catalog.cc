@@ -18,6 +18,8 @@
 
 #include <algorithm>
 
+#include "base/fe_hash.h"
+
 namespace hybridse {
 namespace vm {
 
@@ -201,6 +203,15 @@ bool MemPartitionHandler::AddRow(const std::string& key, uint64_t ts,
     }
     return true;
 }
+bool MemPartitionHandler::AddSegment(const std::string& key, MemTimeTable&& rows) {
+    auto iter = partitions_.emplace_hint(partitions_.end(), key, MemTimeTable());
+    if (iter->second.empty()) {
+        iter->second = std::move(rows);
+    } else {
+        iter->second.insert(iter->second.end(), rows.begin(), rows.end());
+    }
+    return true;
+}
 std::unique_ptr<WindowIterator> MemPartitionHandler::GetWindowIterator() {
     return std::unique_ptr<WindowIterator>(
         new MemWindowIterator(&partitions_, schema_));
@@ -239,6 +250,97 @@ void MemPartitionHandler::Print() {
     }
 }
 
+static inline uint64_t HashFixedKey(int64_t key, bool is_null) {
+    return base::MurmurHash64A(&key, sizeof(key), is_null ? 0x2c9277b5 : 0xe17a1465);
+}
+
+MemHashPartitioner::MemHashPartitioner(size_t expected_key_cnt) : slots_(), groups_() {
+    size_t slot_cnt = 16;
+    while (slot_cnt < expected_key_cnt * 2) {
+        slot_cnt <<= 1;
+    }
+    slots_.assign(slot_cnt, EMPTY_SLOT);
+    groups_.reserve(expected_key_cnt);
+}
+
+void MemHashPartitioner::AddRow(const std::string& key, uint64_t ts, const Row& row) {
+    bool inserted = false;
+    Group* group = FindOrInsert(key, &inserted);
+    if (inserted) {
+        group->key = key;
+    }
+    group->rows.emplace_back(ts, row);
+}
+
+MemHashPartitioner::Group* MemHashPartitioner::FindOrInsert(int64_t key, bool is_null, bool* inserted) {
+    uint64_t hash = HashFixedKey(key, is_null);
+    size_t slot = Probe(hash, [&](const Group& group) {
+        return group.hash == hash && group.fixed_key == key && group.is_null == is_null;
+    });
+    *inserted = slots_[slot] == EMPTY_SLOT;
+    if (!*inserted) {
+        return &groups_[slots_[slot]];
+    }
+    Group* group = Insert(slot, hash);
+    group->fixed_key = key;
+    group->is_null = is_null;
+    return group;
+}
+
+MemHashPartitioner::Group* MemHashPartitioner::FindOrInsert(const std::string& key, bool* inserted) {
+    uint64_t hash = base::MurmurHash64A(key.data(), key.size(), 0xe17a1465);
+    size_t slot = Probe(hash, [&](const Group& group) { return group.hash == hash && group.key == key; });
+    *inserted = slots_[slot] == EMPTY_SLOT;
+    if (!*inserted) {
+        return &groups_[slots_[slot]];
+    }
+    return Insert(slot, hash);
+}
+
+MemHashPartitioner::Group* MemHashPartitioner::Insert(size_t slot, uint64_t hash) {
+    slots_[slot] = groups_.size();
+    groups_.push_back(Group{hash, 0, false, "", MemTimeTable()});
+    Group* group = &groups_.back();
+    // keep the load factor under 0.5
+    if (groups_.size() * 2 > slots_.size()) {
+        Grow();
+    }
+    return group;
+}
+
+void MemHashPartitioner::Grow() {
+    slots_.assign(slots_.size() * 2, EMPTY_SLOT);
+    for (uint32_t idx = 0; idx < groups_.size(); idx++) {
+        size_t slot = groups_[idx].hash & (slots_.size() - 1);
+        while (slots_[slot] != EMPTY_SLOT) {
+            slot = (slot + 1) & (slots_.size() - 1);
+        }
+        slots_[slot] = idx;
+    }
+}
+
+void MemHashPartitioner::Flush(const std::string& prefix, MemPartitionHandler* output) {
+    for (auto& group : groups_) {
+        group.key = prefix + "|" + group.key;
+    }
+    Flush(output);
+}
+
+void MemHashPartitioner::Flush(MemPartitionHandler* output) {
+    // MemSegmentMap is in descending order of keys, sort the distinct keys once so that every segment is
+    // appended at the end of the tree
+    std::vector<uint32_t> order(groups_.size());
+    for (uint32_t idx = 0; idx < order.size(); idx++) {
+        order[idx] = idx;
+    }
+    std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) { return groups_[a].key > groups_[b].key; });
+    for (auto idx : order) {
+        output->AddSegment(groups_[idx].key, std::move(groups_[idx].rows));
+    }
+    groups_.clear();
+    std::fill(slots_.begin(), slots_.end(), EMPTY_SLOT);
+}
+
 RowIterator* MemTableHandler::GetRawIterator() {
     return new MemTableIterator(&table_, schema_);
 }
@@ -15,6 +15,8 @@
  */
 
 #include "vm/mem_catalog.h"
+#include <algorithm>
+#include <functional>
 #include "gtest/gtest.h"
 #include "vm/catalog_wrapper.h"
 #include "testing/test_base.h"
@@ -421,6 +423,83 @@ TEST_F(MemCataLogTest, mem_partition_test) {
     }
 }
 
+TEST_F(MemCataLogTest, mem_hash_partitioner_test) {
+    std::vector<Row> rows;
+    ::hybridse::type::TableDef table;
+    BuildRows(table, rows);
+    vm::MemPartitionHandler partition_handler("t1", "temp", &(table.columns()));
+    vm::MemHashPartitioner partitioner(2);
+
+    // fixed-width keys, the string key is built once per key
+    int gen_cnt = 0;
+    uint64_t ts = 1;
+    for (int i = 0; i < 100; i++) {
+        int64_t key = i % 10;
+        partitioner.AddRow(
+            key, key == 0,
+            [&]() {
+                gen_cnt++;
+                return key == 0 ? std::string("null") : "k" + std::to_string(key);
+            },
+            ts++, rows[i % rows.size()]);
+    }
+    ASSERT_EQ(10, gen_cnt);
+    ASSERT_EQ(10u, partitioner.GetKeyCnt());
+    partitioner.Flush(&partition_handler);
+    ASSERT_EQ(0u, partitioner.GetKeyCnt());
+
+    // string keys are prefixed by the segment key
+    partitioner.AddRow("group1", ts++, rows[0]);
+    partitioner.AddRow("group1", ts++, rows[1]);
+    partitioner.Flush("seg", &partition_handler);
+    ASSERT_EQ(11u, partition_handler.GetCount());
+
+    // an empty segment key still gets the separator, like `segment_key + "|" + key`
+    partitioner.AddRow("group2", ts++, rows[2]);
+    partitioner.Flush("", &partition_handler);
+    ASSERT_EQ(12u, partition_handler.GetCount());
+
+    auto window_iter = partition_handler.GetWindowIterator();
+    window_iter->SeekToFirst();
+    std::vector<std::string> keys;
+    while (window_iter->Valid()) {
+        keys.push_back(window_iter->GetKey().ToString());
+        window_iter->Next();
+    }
+    std::vector<std::string> sorted_keys = keys;
+    std::sort(sorted_keys.begin(), sorted_keys.end(), std::greater<std::string>());
+    ASSERT_EQ(sorted_keys, keys);
+
+    window_iter->Seek("k3");
+    ASSERT_TRUE(window_iter->Valid());
+    ASSERT_EQ("k3", window_iter->GetKey().ToString());
+    auto iter = window_iter->GetValue();
+    iter->SeekToFirst();
+    uint64_t expect_ts = 4;
+    uint64_t cnt = 0;
+    while (iter->Valid()) {
+        ASSERT_EQ(expect_ts, iter->GetKey());
+        expect_ts += 10;
+        cnt++;
+        iter->Next();
+    }
+    ASSERT_EQ(10u, cnt);
+
+    window_iter->Seek("seg|group1");
+    ASSERT_TRUE(window_iter->Valid());
+    ASSERT_EQ("seg|group1", window_iter->GetKey().ToString());
+    iter = window_iter->GetValue();
+    iter->SeekToFirst();
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_TRUE(iter->GetValue().buf() == rows[0].buf());
+
+    window_iter->Seek("|group2");
+    ASSERT_TRUE(window_iter->Valid());
+    ASSERT_EQ("|group2", window_iter->GetKey().ToString());
+    window_iter->Seek("group2");
+    ASSERT_TRUE(!window_iter->Valid() || window_iter->GetKey().ToString() != "group2");
+}
+
 TEST_F(MemCataLogTest, mem_row_handler_test) {
     std::vector<Row> rows;
     ::hybridse::type::TableDef table;
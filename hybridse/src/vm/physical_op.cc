@@ -1370,7 +1370,7 @@ void PhysicalRequestAggUnionNode::Print(std::ostream& output, const std::string&
 }
 
 void PhysicalRequestAggUnionNode::PrintChildren(std::ostream& output, const std::string& tab) const {
-    if (3 != producers_.size() || nullptr == producers_[0] || nullptr == producers_[1] || nullptr == producers_[2]) {
+    if (3 > producers_.size() || nullptr == producers_[0] || nullptr == producers_[1] || nullptr == producers_[2]) {
         LOG(WARNING) << "fail to print PhysicalRequestAggUnionNode children";
         return;
     }
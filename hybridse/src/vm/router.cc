@@ -28,6 +28,10 @@ bool Router::IsWindowNode(const PhysicalOpNode* physical_node) {
     if (physical_node->GetOpType() == kPhysicalOpRequestUnion) {
         if (physical_node->GetProducerCnt() > 0) {
             auto node = physical_node->GetProducer(0);
+            // the request row may be pruned by a simple project
+            if (node != nullptr && node->GetOpType() == kPhysicalOpSimpleProject) {
+                node = node->GetProducer(0);
+            }
             if (node != nullptr &&
                 node->GetOpType() == kPhysicalOpDataProvider) {
                 auto provider_node =
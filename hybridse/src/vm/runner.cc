@@ -16,6 +16,8 @@
 
 #include "vm/runner.h"
 
+#include <algorithm>
+#include <chrono>  // NOLINT
 #include <memory>
 #include <string>
 #include <vector>
@@ -338,6 +340,21 @@ std::shared_ptr<DataHandlerList> Runner::BatchRequestRun(RunnerContext& ctx) {
     }
     return outputs;
 }
+void Runner::RecordProfile(uint64_t self_ns) {
+    profile_cnt_.fetch_add(1, std::memory_order_relaxed);
+    profile_total_ns_.fetch_add(self_ns, std::memory_order_relaxed);
+    uint64_t max_ns = profile_max_ns_.load(std::memory_order_relaxed);
+    while (self_ns > max_ns && !profile_max_ns_.compare_exchange_weak(max_ns, self_ns, std::memory_order_relaxed)) {
+    }
+}
+void Runner::PrintProfileInfo(std::ostream& output) const {
+    uint64_t cnt = GetProfileCnt();
+    if (cnt == 0) {
+        return;
+    }
+    output << " (profiled=" << cnt << ", avg_us=" << GetProfileTotalNs() / cnt / 1000.0
+           << ", max_us=" << GetProfileMaxNs() / 1000.0 << ")";
+}
 std::shared_ptr<DataHandler> Runner::RunWithCache(RunnerContext& ctx) {
     if (need_cache_) {
         auto cached = ctx.GetCache(id_);
@@ -351,7 +368,20 @@ std::shared_ptr<DataHandler> Runner::RunWithCache(RunnerContext& ctx) {
         inputs[idx - 1] = producers_[idx - 1]->RunWithCache(ctx);
     }
 
-    auto res = Run(ctx, inputs);
+    std::shared_ptr<DataHandler> res;
+    if (ctx.is_profile()) {
+        // the runners run inside Run, e.g. the window unions, count their time by themselves
+        uint64_t outer_child_ns = ctx.profile_child_ns();
+        ctx.set_profile_child_ns(0);
+        auto start = std::chrono::steady_clock::now();
+        res = Run(ctx, inputs);
+        uint64_t elapsed_ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        RecordProfile(elapsed_ns - std::min(elapsed_ns, ctx.profile_child_ns()));
+        ctx.set_profile_child_ns(outer_child_ns + elapsed_ns);
+    } else {
+        res = Run(ctx, inputs);
+    }
     if (ctx.is_debug()) {
         std::ostringstream oss;
         oss << "RUNNER TYPE: " << RunnerTypeName(type_) << ", ID: " << id_ << "\n";
@@ -834,9 +864,12 @@ std::shared_ptr<DataHandler> JoinRunner::Run(RunnerContext& ctx,
         return join_gen_->LazyJoin(left, right, parameter);
     }
 
+    // the right table isn't partitioned by an index, hash it by the join key once instead of
+    // grouping it into sorted segments
+    bool hash_right = kTableHandler == right->GetHandlerType() && !join_gen_->index_key_gen_.Valid();
     switch (left->GetHandlerType()) {
         case kTableHandler: {
-            if (join_gen_->right_group_gen_.Valid()) {
+            if (join_gen_->right_group_gen_.Valid() && !hash_right) {
                 right = join_gen_->right_group_gen_.Partition(right, parameter);
             }
             if (!right) {
@@ -868,7 +901,7 @@ std::shared_ptr<DataHandler> JoinRunner::Run(RunnerContext& ctx,
             return output_table;
         }
         case kPartitionHandler: {
-            if (join_gen_->right_group_gen_.Valid()) {
+            if (join_gen_->right_group_gen_.Valid() && !hash_right) {
                 right = join_gen_->right_group_gen_.Partition(right, parameter);
             }
             if (!right) {
@@ -1543,6 +1576,11 @@ std::shared_ptr<DataHandler> RequestAggUnionRunner::Run(
     auto agg_segment = std::dynamic_pointer_cast<PartitionHandler>(union_inputs[1])->GetSegment(key);
     if (agg_segment) {
         union_segments.emplace_back(agg_segment);
+        // the coarser pre-aggregation levels follow the finest one
+        for (size_t i = 3; i < inputs.size(); i++) {
+            auto agg_level = std::dynamic_pointer_cast<PartitionHandler>(inputs[i]);
+            union_segments.emplace_back(agg_level ? agg_level->GetSegment(key) : nullptr);
+        }
     }
 
     if (ctx.is_debug()) {
@@ -1571,10 +1609,10 @@ std::shared_ptr<DataHandler> RequestAggUnionRunner::Run(
 std::shared_ptr<TableHandler> RequestAggUnionRunner::RequestUnionWindow(
     const Row& request, std::vector<std::shared_ptr<TableHandler>> union_segments, int64_t ts_gen,
     const WindowRange& window_range, const bool output_request_row, const bool exclude_current_time) const {
-    // TOOD(zhanghao): for now, we only support AggUnion with 1 base table and 1 agg table
+    // union_segments: the base segment, then the agg segments from the finest level to the coarsest one
     size_t unions_cnt = union_segments.size();
-    if (unions_cnt != 2) {
-        LOG(ERROR) << "Not support of RequestAggUnion with more than 2 unions";
+    if (unions_cnt < 2) {
+        LOG(ERROR) << "Not support of RequestAggUnion with less than 2 unions";
         return nullptr;
     }
 
@@ -1720,6 +1758,15 @@ std::shared_ptr<TableHandler> RequestAggUnionRunner::RequestUnionWindow(
     }
 
     auto window_table = std::make_shared<MemTimeTableHandler>();
+    // the multiple levels of agg table only cover the range window, the rows/maxsize window and filtered buckets
+    // need the counting below so that they are merged from the finest level only
+    if (unions_cnt > 2 && cond_ == nullptr && max_size == 0 &&
+        window_range.frame_type_ == Window::WindowFrameType::kFrameRowsRange) {
+        UnionAggLevels(union_segments, unions_cnt - 1, start, end, update_base_aggregator, update_agg_aggregator);
+        window_table->AddRow(start, aggregator->Output());
+        DLOG(INFO) << "REQUEST AGG UNION with " << unions_cnt - 1 << " levels";
+        return window_table;
+    }
     auto base_it = union_segments[0]->GetIterator();
     if (!base_it) {
         LOG(INFO) << "Base window is empty.";
@@ -1747,6 +1794,9 @@ std::shared_ptr<TableHandler> RequestAggUnionRunner::RequestUnionWindow(
     // when start_base > end_base, step 2 skipped, fallback as
     // | start .. | end_base .. end |
     // | <-----------------   iterate order (end to start)
+    //
+    // end_base, the ts_end of the latest flushed agg record, is the watermark of the agg table. the agg table may
+    // lag behind the base table (e.g. updated asynchronously by tablet), the rows newer than it are read from base
     std::optional<int64_t> end_base = start;
     std::optional<int64_t> start_base = {};
     if (agg_it) {
@@ -1937,6 +1987,69 @@ std::shared_ptr<TableHandler> RequestAggUnionRunner::RequestUnionWindow(
     return window_table;
 }
 
+void RequestAggUnionRunner::UnionAggLevels(const std::vector<std::shared_ptr<TableHandler>>& union_segments,
+                                           size_t level, int64_t start, int64_t end,
+                                           const std::function<void(const Row&)>& update_base,
+                                           const std::function<void(const Row&)>& update_agg) const {
+    if (start > end) {
+        return;
+    }
+    if (level == 0) {
+        auto base_it = union_segments[0]->GetIterator();
+        if (!base_it) {
+            return;
+        }
+        base_it->Seek(end);
+        while (base_it->Valid() && static_cast<int64_t>(base_it->GetKey()) >= start) {
+            update_base(base_it->GetValue());
+            base_it->Next();
+        }
+        return;
+    }
+    auto agg_it = union_segments[level] ? union_segments[level]->GetIterator() : nullptr;
+    if (!agg_it) {
+        UnionAggLevels(union_segments, level - 1, start, end, update_base, update_agg);
+        return;
+    }
+    // merge the buckets of this level inside [start, end], the buckets are aligned to the bucket size, so they are
+    // contiguous and only the latest one may exceed `end`. the ranges not covered are left to the finer levels:
+    // | start .. | covered_start ... covered_end | .. end |
+    const auto agg_row_parser = producers_[2]->row_parser();
+    std::optional<int64_t> covered_start;
+    std::optional<int64_t> covered_end;
+    int64_t prev_ts_start = INT64_MAX;
+    agg_it->Seek(end);
+    while (agg_it->Valid()) {
+        int64_t ts_start = agg_it->GetKey();
+        if (ts_start < start) {
+            break;
+        }
+        if (prev_ts_start == ts_start) {
+            DLOG(INFO) << "Found duplicate entries in agg table for ts_start = " << ts_start;
+            agg_it->Next();
+            continue;
+        }
+        prev_ts_start = ts_start;
+        const Row& row = agg_it->GetValue();
+        int64_t ts_end = -1;
+        agg_row_parser->GetValue(row, "ts_end", type::Type::kTimestamp, &ts_end);
+        if (ts_end <= end) {
+            if (!covered_end.has_value()) {
+                covered_end = ts_end;
+            }
+            covered_start = ts_start;
+            update_agg(row);
+        }
+        agg_it->Next();
+    }
+    if (!covered_end.has_value()) {
+        UnionAggLevels(union_segments, level - 1, start, end, update_base, update_agg);
+        return;
+    }
+    UnionAggLevels(union_segments, level - 1, covered_end.value() + 1, end, update_base, update_agg);
+    UnionAggLevels(union_segments, level - 1, start, covered_start.value() - 1, update_base, update_agg);
+}
+
 std::string RequestAggUnionRunner::PrintEvalValue(const absl::StatusOr<std::optional<bool>>& val) {
     std::ostringstream os;
     if (!val.ok()) {
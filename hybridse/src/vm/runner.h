@@ -17,6 +17,8 @@
 #ifndef HYBRIDSE_SRC_VM_RUNNER_H_
 #define HYBRIDSE_SRC_VM_RUNNER_H_
 
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <set>
 #include <string>
@@ -134,6 +136,7 @@ class Runner : public node::NodeBase<Runner> {
                        std::set<int32_t>* visited_ids) const {  // NOLINT
         PrintRunnerInfo(output, tab);
         PrintCacheInfo(output);
+        PrintProfileInfo(output);
         if (nullptr != visited_ids &&
             visited_ids->find(id_) != visited_ids->cend()) {
             output << "\n";
@@ -222,6 +225,12 @@ class Runner : public node::NodeBase<Runner> {
         return row_parser_.get();
     }
 
+    /// Record the time of a profiled run, excluding the runners run inside it
+    void RecordProfile(uint64_t self_ns);
+    uint64_t GetProfileCnt() const { return profile_cnt_.load(std::memory_order_relaxed); }
+    uint64_t GetProfileTotalNs() const { return profile_total_ns_.load(std::memory_order_relaxed); }
+    uint64_t GetProfileMaxNs() const { return profile_max_ns_.load(std::memory_order_relaxed); }
+
  protected:
     bool is_lazy_;
 
@@ -235,8 +244,14 @@ class Runner : public node::NodeBase<Runner> {
         }
     }
 
+    void PrintProfileInfo(std::ostream& output) const;
+
     bool need_cache_;
     bool need_batch_cache_;
+    // the profiled runs of all the requests running the plan
+    std::atomic<uint64_t> profile_cnt_ = 0;
+    std::atomic<uint64_t> profile_total_ns_ = 0;
+    std::atomic<uint64_t> profile_max_ns_ = 0;
     std::vector<Runner*> producers_;
     const vm::SchemasContext* output_schemas_;
     std::unique_ptr<RowParser> row_parser_ = nullptr;
@@ -589,6 +604,11 @@ class RequestAggUnionRunner : public Runner {
     static std::string PrintEvalValue(const absl::StatusOr<std::optional<bool>>& val);
 
  private:
+    // aggregate [start, end] with the agg segments of `level` and the finer levels, down to the base rows
+    void UnionAggLevels(const std::vector<std::shared_ptr<TableHandler>>& union_segments, size_t level,
+                        int64_t start, int64_t end, const std::function<void(const Row&)>& update_base,
+                        const std::function<void(const Row&)>& update_agg) const;
+
     enum AggType {
         kSum,
         kCount,
@@ -747,6 +767,7 @@ class ProxyRequestRunner : public Runner {
                        std::set<int32_t>* visited_ids) const {  // NOLINT
         PrintRunnerInfo(output, tab);
         PrintCacheInfo(output);
+        PrintProfileInfo(output);
         if (nullptr != index_input_) {
             output << "\n    " << tab << "proxy_index_input:\n";
             index_input_->Print(output, "    " + tab + "+-", nullptr);
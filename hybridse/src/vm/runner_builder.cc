@@ -587,6 +587,18 @@ ClusterTask RunnerBuilder::BuildRequestAggUnionTask(PhysicalOpNode* node, Status
         return fail;
     }
     auto op = dynamic_cast<const PhysicalRequestAggUnionNode*>(node);
+    // the coarser pre-aggregation levels, their segments are read by key in RequestAggUnionRunner::Run
+    std::vector<ClusterTask> agg_level_tasks;
+    for (size_t level = 1; level < op->GetAggrLevelCnt(); level++) {
+        auto agg_level_task = Build(node->producers().at(2 + level), status);
+        if (!agg_level_task.IsValid()) {
+            status.msg = "fail to build agg_table level input runner";
+            status.code = common::kExecutionPlanError;
+            LOG(WARNING) << status;
+            return fail;
+        }
+        agg_level_tasks.push_back(agg_level_task);
+    }
     RequestAggUnionRunner* runner =
         CreateRunner<RequestAggUnionRunner>(id_++, node->schemas_ctx(), op->GetLimitCnt(), op->window().range_,
                                             op->exclude_current_time(), op->output_request_row(), op->project_);
@@ -596,8 +608,11 @@ ClusterTask RunnerBuilder::BuildRequestAggUnionTask(PhysicalOpNode* node, Status
         runner->AddWindowUnion(op->window_, base_table);
         runner->AddWindowUnion(op->agg_window_, agg_table);
     }
-    auto task = RegisterTask(
-        node, MultipleInherit({&request_task, &base_table_task, &agg_table_task}, runner, index_key, kRightBias));
+    std::vector<const ClusterTask*> children = {&request_task, &base_table_task, &agg_table_task};
+    for (const auto& agg_level_task : agg_level_tasks) {
+        children.push_back(&agg_level_task);
+    }
+    auto task = RegisterTask(node, MultipleInherit(children, runner, index_key, kRightBias));
     if (!runner->InitAggregator()) {
         return fail;
     } else {
@@ -71,6 +71,12 @@ class RunnerContext {
     void SetRequest(const hybridse::codec::Row& request);
     void SetRequests(const std::vector<hybridse::codec::Row>& requests);
     bool is_debug() const { return is_debug_; }
+    /// Time the runners in this run and record it into them
+    void EnableProfile() { is_profile_ = true; }
+    bool is_profile() const { return is_profile_; }
+    /// The time spent in the runners run inside the running one, in nanoseconds
+    uint64_t profile_child_ns() const { return profile_child_ns_; }
+    void set_profile_child_ns(uint64_t ns) { profile_child_ns_ = ns; }
 
     const std::string& sp_name() { return sp_name_; }
     std::shared_ptr<DataHandler> GetCache(int64_t id) const;
@@ -87,6 +93,8 @@ class RunnerContext {
     hybridse::codec::Row parameter_;
     size_t idx_;
     const bool is_debug_;
+    bool is_profile_ = false;
+    uint64_t profile_child_ns_ = 0;
     // TODO(chenjing): optimize
     std::map<int64_t, std::shared_ptr<DataHandler>> cache_;
     std::map<int64_t, std::shared_ptr<DataHandlerList>> batch_cache_;
@@ -512,6 +512,23 @@ TEST_F(RunnerTest, RunnerPrintDataMemTimeTableTest) {
         LOG(INFO) << oss.str();
     }
 }
+
+TEST_F(RunnerTest, RunnerProfileTest) {
+    RequestRunner runner(1, nullptr);
+    {
+        std::ostringstream oss;
+        runner.Print(oss, "", nullptr);
+        ASSERT_EQ(std::string::npos, oss.str().find("profiled"));
+    }
+    runner.RecordProfile(2000);
+    runner.RecordProfile(4000);
+    ASSERT_EQ(2u, runner.GetProfileCnt());
+    ASSERT_EQ(6000u, runner.GetProfileTotalNs());
+    ASSERT_EQ(4000u, runner.GetProfileMaxNs());
+    std::ostringstream oss;
+    runner.Print(oss, "", nullptr);
+    ASSERT_TRUE(absl::StrContains(oss.str(), "(profiled=2, avg_us=3, max_us=4)")) << oss.str();
+}
 }  // namespace vm
 }  // namespace hybridse
 
@@ -152,7 +152,8 @@ Status SqlCompiler::BuildRequestModePhysicalPlan(SqlContext* ctx, const ::hybrid
                                                  PhysicalOpNode** output) {
     vm::RequestModeTransformer transformer(&ctx->nm, ctx->db, cl_, &ctx->parameter_types, llvm_module, library, {},
                                            ctx->is_cluster_optimized, false, ctx->enable_expr_optimize,
-                                           enable_request_performance_sensitive, ctx->options.get(), ctx->index_hints);
+                                           enable_request_performance_sensitive, ctx->options.get(), ctx->index_hints,
+                                           ctx->enable_window_column_pruning);
     if (ctx->options && ctx->options->count(LONG_WINDOWS)) {
         transformer.AddPass(passes::kPassSplitAggregationOptimized);
         transformer.AddPass(passes::kPassLongWindowOptimized);
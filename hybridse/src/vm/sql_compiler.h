@@ -18,7 +18,9 @@
 #define HYBRIDSE_SRC_VM_SQL_COMPILER_H_
 
 #include <memory>
+#include <set>
 #include <string>
+#include <utility>
 
 #include "base/fe_status.h"
 #include "llvm/IR/Module.h"
@@ -37,6 +39,16 @@ namespace vm {
 
 using hybridse::base::Status;
 
+// what a cached compiling result depends on
+struct CacheDependency {
+    // the cache epoch of the engine when compiling starts
+    uint64_t epoch = 0;
+    // the (db, table) pairs the plan reads
+    std::set<std::pair<std::string, std::string>> tables;
+    // the lower case names which may be functions called in the sql
+    std::set<std::string> functions;
+};
+
 class SqlCompileInfo : public CompileInfo {
  public:
     SqlCompileInfo() : sql_ctx() {}
@@ -74,8 +86,11 @@ class SqlCompileInfo : public CompileInfo {
     }
     static SqlCompileInfo* CastFrom(CompileInfo* node) { return dynamic_cast<SqlCompileInfo*>(node); }
 
+    CacheDependency& get_cache_dependency() { return cache_dep_; }
+
  private:
     hybridse::vm::SqlContext sql_ctx;
+    CacheDependency cache_dep_;
 };
 
 class SqlCompiler {
@@ -423,6 +423,42 @@ TEST_F(SqlCompilerTest, TestEnableWindowParalled) {
     CompilerCheck(simple_catalog, sql_case, {}, kBatchMode, true, false);
     CompilerCheck(simple_catalog, sql_case, {}, kBatchMode, true, true);
 }
+TEST_F(SqlCompilerTest, TestRequestWindowColumnPruning) {
+    hybridse::type::TableDef t1;
+    SqlCase::ExtractTableDef({"col0 string", "col1 int", "col2 bigint", "col3 double", "col4 string", "col5 timestamp"},
+                             {"index0:col0:col5"}, t1);
+    t1.set_name("t1");
+    hybridse::type::Database db;
+    db.set_name("db");
+    AddTable(db, t1);
+    auto catalog = BuildSimpleCatalog(db);
+    std::string sql =
+        "select col0, sum(col2) over w1 as w1_col2_sum from t1 "
+        "window w1 as (partition by col0 order by col5 rows between 10 preceding and current row);";
+
+    auto compile = [&](bool enable_window_column_pruning) {
+        SqlCompiler sql_compiler(catalog);
+        SqlContext sql_context;
+        sql_context.sql = sql;
+        sql_context.db = "db";
+        sql_context.engine_mode = kRequestMode;
+        sql_context.enable_window_column_pruning = enable_window_column_pruning;
+        base::Status status;
+        EXPECT_TRUE(sql_compiler.Compile(sql_context, status)) << status;
+        std::ostringstream oss;
+        if (sql_context.physical_plan != nullptr) {
+            sql_context.physical_plan->Print(oss, "");
+        }
+        EXPECT_EQ(2, sql_context.schema.size());
+        return oss.str();
+    };
+    std::string plan = compile(false);
+    ASSERT_EQ(std::string::npos, plan.find("-> col2")) << plan;
+    // request row and window rows only keep col0, col2 and col5
+    std::string pruned_plan = compile(true);
+    ASSERT_NE(std::string::npos, pruned_plan.find("-> col2")) << pruned_plan;
+    ASSERT_EQ(std::string::npos, pruned_plan.find("-> col3")) << pruned_plan;
+}
 TEST_P(SqlCompilerTest, CompileBatchModeEnableWindowParalledTest) {
     if (boost::contains(GetParam().mode(), "batch-unsupport")) {
         LOG(INFO) << "Skip sql case: batch unsupport";
@@ -2353,9 +2353,10 @@ RequestModeTransformer::RequestModeTransformer(node::NodeManager* node_manager,
                                                const bool cluster_optimized, const bool enable_batch_request_opt,
                                                bool enable_expr_opt, bool performance_sensitive,
                                                const std::unordered_map<std::string, std::string>* options,
-                                               std::shared_ptr<IndexHintHandler> hints)
+                                               std::shared_ptr<IndexHintHandler> hints,
+                                               bool enable_window_column_pruning)
     : BatchModeTransformer(node_manager, db, catalog, parameter_types, module, library, cluster_optimized,
-                           enable_expr_opt, true, false, options, hints),
+                           enable_expr_opt, true, enable_window_column_pruning, options, hints),
       enable_batch_request_opt_(enable_batch_request_opt),
       performance_sensitive_(performance_sensitive) {
     batch_request_info_.common_column_indices = common_column_indices;
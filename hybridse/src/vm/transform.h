@@ -287,7 +287,7 @@ class RequestModeTransformer : public BatchModeTransformer {
                            const std::set<size_t>& common_column_indices, const bool cluster_optimized,
                            const bool enable_batch_request_opt, bool enable_expr_opt, bool performance_sensitive = true,
                            const std::unordered_map<std::string, std::string>* options = nullptr,
-                           std::shared_ptr<IndexHintHandler> = nullptr);
+                           std::shared_ptr<IndexHintHandler> = nullptr, bool enable_window_column_pruning = false);
     virtual ~RequestModeTransformer();
 
     const Schema& request_schema() const { return request_schema_; }
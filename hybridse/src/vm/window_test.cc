@@ -14,7 +14,9 @@
  * limitations under the License.
  */
 
+#include <memory>
 #include <utility>
+#include <vector>
 #include "codec/list_iterator_codec.h"
 #include "gtest/gtest.h"
 #include "proto/fe_type.pb.h"
@@ -198,6 +200,55 @@ TEST_F(WindowIteratorTest, MemColumnIteratorImplTest) {
     delete (column);
 }
 
+TEST_F(WindowIteratorTest, MemColumnIteratorNextBatchTest) {
+    // header, null bitmap and an int32 field
+    const uint32_t row_size = codec::v1::HEADER_LENGTH + 1 + 4;
+    MemTimeTableHandler table;
+    for (int32_t i = 0; i < 10; i++) {
+        int8_t* ptr = reinterpret_cast<int8_t*>(calloc(row_size, 1));
+        if (i % 3 == 0) {
+            *(ptr + codec::v1::HEADER_LENGTH) = 1;
+        } else {
+            *(reinterpret_cast<int32_t*>(ptr + codec::v1::HEADER_LENGTH + 1)) = i;
+        }
+        table.AddRow(i, Row(base::RefCountedSlice::Create(ptr, row_size)));
+    }
+
+    ColumnImpl<int32_t> column(&table, 0, 0, codec::v1::HEADER_LENGTH + 1);
+    auto impl = column.GetIterator();
+    int32_t values[4];
+    bool is_null[4];
+    int32_t expect = 0;
+    for (uint32_t expect_cnt : {4, 4, 2, 0}) {
+        ASSERT_EQ(expect_cnt, impl->NextBatch(values, is_null, 4));
+        for (uint32_t i = 0; i < expect_cnt; i++, expect++) {
+            ASSERT_EQ(expect % 3 == 0, is_null[i]);
+            if (!is_null[i]) {
+                ASSERT_EQ(expect, values[i]);
+            }
+        }
+    }
+    ASSERT_FALSE(impl->Valid());
+
+    // NULL values are skipped by non null column list
+    std::unique_ptr<codec::NonNullColumnList<int32_t>> non_null_column(column.GetAsNonNullColumnList());
+    auto non_null_impl = non_null_column->GetIterator();
+    ASSERT_EQ(6u, non_null_impl->NextBatch(values, is_null, 8));
+    std::vector<int32_t> expect_values = {1, 2, 4, 5, 7, 8};
+    for (uint32_t i = 0; i < expect_values.size(); i++) {
+        ASSERT_FALSE(is_null[i]);
+        ASSERT_EQ(expect_values[i], values[i]);
+    }
+
+    // elements of other lists are fetched one by one
+    std::vector<int> int_vec({1, 2, 3});
+    ArrayListV<int> list(&int_vec);
+    auto list_impl = list.GetIterator();
+    ASSERT_EQ(3u, list_impl->NextBatch(values, is_null, 4));
+    ASSERT_EQ(3, values[2]);
+    ASSERT_FALSE(is_null[2]);
+}
+
 TEST_F(WindowIteratorTest, MemGetColTest) {
     // prepare row buf
     MemTimeTableHandler table;
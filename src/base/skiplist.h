@@ -22,6 +22,9 @@
 
 #include <atomic>
 #include <iostream>
+#include <iterator>
+#include <new>
+#include <vector>
 
 #include "base/random.h"
 
@@ -40,17 +43,19 @@ struct DefaultComparator {
 };
 
 // Skiplist node , a thread safe structure
+// The node of an indexable list keeps a span counter for every level after the next pointers, in the same
+// allocation, so the size of the node itself does not change.
 template <class K, class V>
 class Node {
  public:
     // Set data reference and Node height
-    Node(const K& key, V& value, uint8_t height)  // NOLINT
+    Node(const K& key, V& value, uint8_t height, bool indexable = false)  // NOLINT
         : height_(height), key_(key), value_(value) {
-        nexts_ = new std::atomic<Node<K, V>*>[height];
+        InitLevels(indexable);
     }
 
-    Node(uint8_t height) : height_(height), key_(), value_() {  // NOLINT
-        nexts_ = new std::atomic<Node<K, V>*>[height];
+    explicit Node(uint8_t height, bool indexable = false) : height_(height), key_(), value_() {
+        InitLevels(indexable);
     }
 
     // Set the next node with memory barrier
@@ -77,20 +82,54 @@ class Node {
         return nexts_[level].load(std::memory_order_relaxed);
     }
 
+    // The number of nodes passed from this node to its next node of the level, it's meaningless if the next node
+    // is NULL. Only the nodes of an indexable list have the span counters
+    uint32_t GetSpan(uint8_t level) {
+        assert(level < height_ && level >= 0);
+        return Spans()[level].load(std::memory_order_relaxed);
+    }
+
+    void SetSpan(uint8_t level, uint32_t span) {
+        assert(level < height_ && level >= 0);
+        Spans()[level].store(span, std::memory_order_relaxed);
+    }
+
     V& GetValue() { return value_; }
 
     const K& GetKey() const { return key_; }
 
-    ~Node() { delete[] nexts_; }
+    ~Node() { delete[] reinterpret_cast<char*>(nexts_); }
 
  private:
+    void InitLevels(bool indexable) {
+        size_t size = sizeof(std::atomic<Node<K, V>*>) * height_;
+        if (indexable) {
+            size += sizeof(std::atomic<uint32_t>) * height_;
+        }
+        char* buf = new char[size];
+        nexts_ = reinterpret_cast<std::atomic<Node<K, V>*>*>(buf);
+        for (uint8_t i = 0; i < height_; i++) {
+            new (&nexts_[i]) std::atomic<Node<K, V>*>(NULL);
+        }
+        if (indexable) {
+            std::atomic<uint32_t>* spans = Spans();
+            for (uint8_t i = 0; i < height_; i++) {
+                new (&spans[i]) std::atomic<uint32_t>(0);
+            }
+        }
+    }
+
+    std::atomic<uint32_t>* Spans() { return reinterpret_cast<std::atomic<uint32_t>*>(nexts_ + height_); }
+
     uint8_t const height_;
     K const key_;
     V value_;
     std::atomic<Node<K, V>*>* nexts_;
 };
 
-template <class K, class V, class Comparator>
+// An indexable list keeps span counters on the levels, so the node at a position, the position of a key and the size
+// are found in O(log n). The positions that a reader gets while the list is modified are best-effort
+template <class K, class V, class Comparator, bool Indexable = false>
 class Skiplist {
  public:
     Skiplist(uint8_t max_height, uint8_t branch, const Comparator& compare)
@@ -101,7 +140,8 @@ class Skiplist {
           rand_(0xdeadbeef),
           head_(NULL),
           tail_(NULL) {
-        head_ = new Node<K, V>(MaxHeight);
+        // the head of an indexable list has an extra level whose span is the size of the list
+        head_ = new Node<K, V>(Indexable ? MaxHeight + 1 : MaxHeight, Indexable);
         for (uint8_t i = 0; i < head_->Height(); i++) {
             head_->SetNext(i, NULL);
         }
@@ -113,10 +153,13 @@ class Skiplist {
     uint8_t Insert(const K& key, V& value) {  // NOLINT
         uint8_t height = RandomHeight();
         Node<K, V>* pre[MaxHeight];
-        FindLessOrEqual(key, pre);
-        if (height > GetMaxHeight()) {
-            for (uint8_t i = GetMaxHeight(); i < height; i++) {
+        uint32_t ranks[MaxHeight];
+        FindLessOrEqual(key, pre, Indexable ? ranks : NULL);
+        uint8_t max_height = GetMaxHeight();
+        if (height > max_height) {
+            for (uint8_t i = max_height; i < height; i++) {
                 pre[i] = head_;
+                ranks[i] = 0;
             }
             max_height_.store(height, std::memory_order_relaxed);
         }
@@ -125,12 +168,83 @@ class Skiplist {
             tail_.store(node, std::memory_order_release);
         }
         for (uint8_t i = 0; i < height; i++) {
+            if (Indexable) {
+                // the rank of the new node is ranks[0] + 1
+                node->SetSpan(i, pre[i]->GetSpan(i) - (ranks[0] - ranks[i]));
+            }
             node->SetNextNoBarrier(i, pre[i]->GetNextNoBarrier(i));
             pre[i]->SetNext(i, node);
+            if (Indexable) {
+                pre[i]->SetSpan(i, ranks[0] - ranks[i] + 1);
+            }
+        }
+        if (Indexable) {
+            for (uint8_t i = height; i < max_height; i++) {
+                pre[i]->SetSpan(i, pre[i]->GetSpan(i) + 1);
+            }
+            SetSize(LoadSize() + 1);
         }
         return height;
     }
 
+    // Need external synchronized
+    // Append the sorted pairs of [begin, end) after the last node in a single linear pass, without a search from
+    // head for every node. The towers are built bottom-up: the i-th appended node gets one more level for every
+    // power of Branch that divides i, which is the shape that random heights converge to.
+    // The keys must be sorted and greater than the last key, otherwise nothing is appended and false is returned.
+    // The height of every appended node is pushed to heights if it's not NULL.
+    template <class It>
+    bool BulkAppend(It begin, It end, std::vector<uint8_t>* heights = NULL) {
+        if (begin == end) {
+            return true;
+        }
+        Node<K, V>* last = tail_.load(std::memory_order_relaxed);
+        if (last != NULL && compare_(begin->first, last->GetKey()) <= 0) {
+            return false;
+        }
+        for (It it = begin, next = std::next(begin); next != end; ++it, ++next) {
+            if (compare_(it->first, next->first) > 0) {
+                return false;
+            }
+        }
+        Node<K, V>* pre[MaxHeight];
+        uint32_t ranks[MaxHeight];
+        FindLast(pre, Indexable ? ranks : NULL);
+        uint8_t max_height = GetMaxHeight();
+        uint32_t size = Indexable ? LoadSize() : 0;
+        uint64_t pos = 0;
+        for (It it = begin; it != end; ++it) {
+            pos++;
+            uint8_t height = 1;
+            for (uint64_t i = pos; height < MaxHeight && i % Branch == 0; i /= Branch) {
+                height++;
+            }
+            V value = it->second;
+            Node<K, V>* node = NewNode(it->first, value, height);
+            if (height > max_height) {
+                max_height = height;
+                max_height_.store(height, std::memory_order_relaxed);
+            }
+            for (uint8_t i = 0; i < height; i++) {
+                node->SetNextNoBarrier(i, NULL);
+                pre[i]->SetNext(i, node);
+                if (Indexable) {
+                    pre[i]->SetSpan(i, size + pos - ranks[i]);
+                    ranks[i] = size + pos;
+                }
+                pre[i] = node;
+            }
+            tail_.store(node, std::memory_order_release);
+            if (heights != NULL) {
+                heights->push_back(height);
+            }
+        }
+        if (Indexable) {
+            SetSize(LoadSize() + pos);
+        }
+        return true;
+    }
+
     bool IsEmpty() {
         if (head_->GetNextNoBarrier(0) == NULL) {
             return true;
@@ -153,9 +267,18 @@ class Skiplist {
             return NULL;
         }
         for (uint8_t i = 0; i < result->Height(); i++) {
+            if (Indexable) {
+                pre[i]->SetSpan(i, pre[i]->GetSpan(i) + result->GetSpan(i) - 1);
+            }
             pre[i]->SetNextNoBarrier(i, result->GetNextNoBarrier(i));
             result->SetNextNoBarrier(i, NULL);
         }
+        if (Indexable) {
+            for (uint8_t i = result->Height(); i < GetMaxHeight(); i++) {
+                pre[i]->SetSpan(i, pre[i]->GetSpan(i) - 1);
+            }
+            SetSize(LoadSize() - 1);
+        }
         if (result == tail_) {
             pre[0] == head_ ? tail_.store(NULL, std::memory_order_relaxed)
                             : tail_.store(pre[0], std::memory_order_relaxed);
@@ -166,14 +289,18 @@ class Skiplist {
     // Split list two parts, the return part is just a linkedlist
     Node<K, V>* Split(const K& key) {
         Node<K, V>* pre[MaxHeight];
+        uint32_t ranks[MaxHeight];
         for (uint8_t i = 0; i < MaxHeight; i++) {
             pre[i] = NULL;
         }
-        Node<K, V>* target = FindLessOrEqual(key, pre);
+        Node<K, V>* target = FindLessOrEqual(key, pre, Indexable ? ranks : NULL);
         if (target == NULL) {
             return NULL;
         }
         tail_.store(target, std::memory_order_release);
+        if (Indexable) {
+            SetSize(ranks[0]);
+        }
         Node<K, V>* result = target->GetNextNoBarrier(0);
         for (uint8_t i = 0; i < MaxHeight; i++) {
             if (pre[i] == NULL) {
@@ -184,7 +311,11 @@ class Skiplist {
         return result;
     }
 
+    // Keep the first pos nodes and return the rest as a linkedlist
     Node<K, V>* SplitByPos(uint64_t pos) {
+        if (Indexable) {
+            return SplitAfterRank(pos);
+        }
         Node<K, V>* pos_node = head_->GetNext(0);
         for (uint64_t idx = 0; idx < pos; idx++) {
             if (pos_node == NULL) {
@@ -199,6 +330,14 @@ class Skiplist {
     }
 
     Node<K, V>* SplitByKeyOrPos(const K& key, uint64_t pos) {
+        if (Indexable) {
+            uint32_t size = LoadSize();
+            uint32_t key_pos = GetPosition(key);
+            if (key_pos < pos && key_pos < size) {
+                return Split(key);
+            }
+            return SplitAfterRank(pos);
+        }
         Node<K, V>* pos_node = head_->GetNext(0);
         for (uint64_t idx = 0; idx < pos; idx++) {
             if (pos_node == NULL) {  // doesnt find key or pos, just return
@@ -216,6 +355,12 @@ class Skiplist {
     }
 
     Node<K, V>* SplitByKeyAndPos(const K& key, uint64_t pos) {
+        if (Indexable) {
+            if (pos >= LoadSize()) {
+                return NULL;
+            }
+            return GetPosition(key) < pos ? SplitAfterRank(pos) : Split(key);
+        }
         Node<K, V>* pos_node = head_->GetNext(0);
         bool find_key = false;
         for (uint64_t idx = 0; idx < pos; idx++) {
@@ -254,6 +399,9 @@ class Skiplist {
     Node<K, V>* GetLast() { return tail_.load(std::memory_order_acquire); }
 
     uint32_t GetSize() {
+        if (Indexable) {
+            return LoadSize();
+        }
         uint32_t cnt = 0;
         Node<K, V>* node = head_->GetNext(0);
         while (node != NULL) {
@@ -277,6 +425,9 @@ class Skiplist {
             head_->SetNextNoBarrier(i, NULL);
         }
         tail_.store(NULL, std::memory_order_relaxed);
+        if (Indexable) {
+            SetSize(0);
+        }
 
         while (node != NULL) {
             cnt++;
@@ -304,7 +455,8 @@ class Skiplist {
         for (uint8_t i = 0; i < height; i++) {
             pre[i] = head_;
         }
-        if (height > GetMaxHeight()) {
+        uint8_t max_height = GetMaxHeight();
+        if (height > max_height) {
             max_height_.store(height, std::memory_order_relaxed);
         }
         Node<K, V>* node = NewNode(key, value, height);
@@ -312,15 +464,72 @@ class Skiplist {
             tail_.store(node, std::memory_order_release);
         }
         for (uint8_t i = 0; i < height; i++) {
+            if (Indexable) {
+                node->SetSpan(i, head_->GetSpan(i));
+            }
             node->SetNextNoBarrier(i, pre[i]->GetNextNoBarrier(i));
             pre[i]->SetNext(i, node);
+            if (Indexable) {
+                head_->SetSpan(i, 1);
+            }
+        }
+        if (Indexable) {
+            for (uint8_t i = height; i < max_height; i++) {
+                head_->SetSpan(i, head_->GetSpan(i) + 1);
+            }
+            SetSize(LoadSize() + 1);
         }
         return true;
     }
 
+    bool IsIndexable() const { return Indexable; }
+
+    // The node at pos, the position of the first node is 0. return NULL if pos is out of range.
+    // it's O(log n) in an indexable list, otherwise it steps from the first node
+    Node<K, V>* FindByPosition(uint64_t pos) {
+        if (!Indexable) {
+            Node<K, V>* node = head_->GetNext(0);
+            for (uint64_t idx = 0; idx < pos && node != NULL; idx++) {
+                node = node->GetNext(0);
+            }
+            return node;
+        }
+        uint64_t rank = 0;
+        Node<K, V>* node = head_;
+        for (int level = GetMaxHeight() - 1; level >= 0; level--) {
+            Node<K, V>* next = node->GetNext(level);
+            while (next != NULL && rank + node->GetSpan(level) <= pos + 1) {
+                rank += node->GetSpan(level);
+                node = next;
+                next = node->GetNext(level);
+            }
+            if (rank == pos + 1) {
+                return node;
+            }
+        }
+        return NULL;
+    }
+
+    // The number of nodes before key, that is the position of the first node not less than key.
+    // Need the span counters
+    uint32_t GetPosition(const K& key) {
+        assert(Indexable);
+        uint32_t rank = 0;
+        Node<K, V>* node = head_;
+        for (int level = GetMaxHeight() - 1; level >= 0; level--) {
+            Node<K, V>* next = node->GetNext(level);
+            while (next != NULL && compare_(next->GetKey(), key) < 0) {
+                rank += node->GetSpan(level);
+                node = next;
+                next = node->GetNext(level);
+            }
+        }
+        return rank;
+    }
+
     class Iterator {
      public:
-        Iterator(Skiplist<K, V, Comparator>* list) : node_(NULL), list_(list) {}  // NOLINT
+        Iterator(Skiplist<K, V, Comparator, Indexable>* list) : node_(NULL), list_(list) {}  // NOLINT
         ~Iterator() {}
 
         bool Valid() const { return node_ != NULL; }
@@ -352,11 +561,13 @@ class Skiplist {
 
         void SeekToLast() { node_ = list_->GetLast(); }
 
+        void SeekToPosition(uint64_t pos) { node_ = list_->FindByPosition(pos); }
+
         uint32_t GetSize() { return list_->GetSize(); }
 
      private:
         Node<K, V>* node_;
-        Skiplist<K, V, Comparator>* const list_;
+        Skiplist<K, V, Comparator, Indexable>* const list_;
     };
 
     // delete the iterator after it's used
@@ -364,7 +575,7 @@ class Skiplist {
 
  private:
     Node<K, V>* NewNode(const K& key, V& value, uint8_t height) {  // NOLINT
-        Node<K, V>* node = new Node<K, V>(key, value, height);
+        Node<K, V>* node = new Node<K, V>(key, value, height, Indexable);
         return node;
     }
 
@@ -376,16 +587,24 @@ class Skiplist {
         return height;
     }
 
-    Node<K, V>* FindLessOrEqual(const K& key, Node<K, V>** nodes) {
+    // the rank of nodes[level] is set to ranks[level] if ranks is not NULL, the rank of head_ is 0
+    Node<K, V>* FindLessOrEqual(const K& key, Node<K, V>** nodes, uint32_t* ranks = NULL) {
         assert(nodes != NULL);
         Node<K, V>* node = head_;
+        uint32_t rank = 0;
         uint8_t level = GetMaxHeight() - 1;
         while (true) {
             Node<K, V>* next = node->GetNext(level);
             if (IsAfterNode(key, next)) {
+                if (ranks != NULL) {
+                    rank += node->GetSpan(level);
+                }
                 node = next;
             } else {
                 nodes[level] = node;
+                if (ranks != NULL) {
+                    ranks[level] = rank;
+                }
                 if (level <= 0) {
                     return node;
                 }
@@ -427,12 +646,36 @@ class Skiplist {
         }
     }
 
+    // the last node of every level, head_ if the level is empty. the ranks are set like FindLessOrEqual
+    void FindLast(Node<K, V>** nodes, uint32_t* ranks = NULL) {
+        Node<K, V>* node = head_;
+        uint32_t rank = 0;
+        for (int level = MaxHeight - 1; level >= 0; level--) {
+            Node<K, V>* next = node->GetNext(level);
+            while (next != NULL) {
+                if (ranks != NULL) {
+                    rank += node->GetSpan(level);
+                }
+                node = next;
+                next = node->GetNext(level);
+            }
+            nodes[level] = node;
+            if (ranks != NULL) {
+                ranks[level] = rank;
+            }
+        }
+    }
+
     bool IsAfterNode(const K& key, const Node<K, V>* node) const {
         return (node != NULL) && (compare_(key, node->GetKey()) > 0);
     }
 
     uint8_t GetMaxHeight() const { return max_height_.load(std::memory_order_relaxed); }
 
+    uint32_t LoadSize() { return head_->GetSpan(MaxHeight); }
+
+    void SetSize(uint32_t size) { head_->SetSpan(MaxHeight, size); }
+
     Node<K, V>* SplitOnPosNode(uint64_t pos, Node<K, V>* pos_node) {
         Node<K, V>* node = head_;
         Node<K, V>* pre = head_;
@@ -441,6 +684,9 @@ class Skiplist {
         while (node != NULL) {
             if (cnt == pos) {
                 tail_.store(pre, std::memory_order_release);
+                if (Indexable) {
+                    SetSize(pos - 1);
+                }
                 for (uint8_t i = 0; i < pre->Height(); i++) {
                     pre->SetNext(i, NULL);
                 }
@@ -459,6 +705,33 @@ class Skiplist {
         return NULL;
     }
 
+    // keep the first cnt nodes and return the rest as a linkedlist, need the span counters
+    Node<K, V>* SplitAfterRank(uint64_t cnt) {
+        if (cnt >= LoadSize()) {
+            return NULL;
+        }
+        Node<K, V>* pre[MaxHeight];
+        uint8_t max_height = GetMaxHeight();
+        uint64_t rank = 0;
+        Node<K, V>* node = head_;
+        for (int level = max_height - 1; level >= 0; level--) {
+            Node<K, V>* next = node->GetNext(level);
+            while (next != NULL && rank + node->GetSpan(level) <= cnt) {
+                rank += node->GetSpan(level);
+                node = next;
+                next = node->GetNext(level);
+            }
+            pre[level] = node;
+        }
+        Node<K, V>* result = node->GetNextNoBarrier(0);
+        tail_.store(node == head_ ? NULL : node, std::memory_order_release);
+        SetSize(cnt);
+        for (uint8_t i = 0; i < max_height; i++) {
+            pre[i]->SetNext(i, NULL);
+        }
+        return result;
+    }
+
  private:
     uint8_t const MaxHeight;
     uint8_t const Branch;
@@ -16,7 +16,10 @@
 
 #include "base/skiplist.h"
 
+#include <algorithm>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/slice.h"
@@ -663,6 +666,238 @@ TEST_F(SkiplistTest, Duplicate) {
     ASSERT_FALSE(it->Valid());
 }
 
+TEST_F(SkiplistTest, BulkAppend) {
+    Comparator cmp;
+    for (auto height : vec) {
+        Skiplist<uint32_t, uint32_t, Comparator> sl(height, 4, cmp);
+        std::vector<std::pair<uint32_t, uint32_t>> rows;
+        for (uint32_t idx = 0; idx < 1000; idx++) {
+            rows.emplace_back(idx * 2, idx);
+        }
+        std::vector<uint8_t> heights;
+        ASSERT_TRUE(sl.BulkAppend(rows.begin(), rows.end(), &heights));
+        ASSERT_EQ(1000u, heights.size());
+        ASSERT_EQ(1000u, sl.GetSize());
+        ASSERT_EQ(1998u, sl.GetLast()->GetKey());
+        // the key must be greater than the last key
+        std::vector<std::pair<uint32_t, uint32_t>> overlap = {{1998, 1}, {2000, 2}};
+        ASSERT_FALSE(sl.BulkAppend(overlap.begin(), overlap.end()));
+        std::vector<std::pair<uint32_t, uint32_t>> unsorted = {{3000, 1}, {2500, 2}};
+        ASSERT_FALSE(sl.BulkAppend(unsorted.begin(), unsorted.end()));
+        ASSERT_EQ(1000u, sl.GetSize());
+        std::vector<std::pair<uint32_t, uint32_t>> more = {{2000, 1000}, {2002, 1001}};
+        ASSERT_TRUE(sl.BulkAppend(more.begin(), more.end()));
+        ASSERT_EQ(2002u, sl.GetLast()->GetKey());
+        // insert works on the bulk built list
+        for (uint32_t idx = 0; idx <= 1000; idx++) {
+            uint32_t key = idx * 2 + 1;
+            sl.Insert(key, idx);
+        }
+        uint32_t value = 0;
+        for (uint32_t key = 0; key <= 2002; key++) {
+            ASSERT_EQ(0, sl.Get(key, value));
+            ASSERT_EQ(key / 2, value);
+        }
+        std::unique_ptr<Skiplist<uint32_t, uint32_t, Comparator>::Iterator> it(sl.NewIterator());
+        it->Seek(1500);
+        ASSERT_TRUE(it->Valid());
+        ASSERT_EQ(1500u, it->GetKey());
+        uint32_t expect = 0;
+        for (it->SeekToFirst(); it->Valid(); it->Next()) {
+            ASSERT_EQ(expect++, it->GetKey());
+        }
+        ASSERT_EQ(2003u, expect);
+        sl.Clear();
+    }
+}
+
+TEST_F(SkiplistTest, BulkAppendHeight) {
+    Comparator cmp;
+    Skiplist<uint32_t, uint32_t, Comparator> sl(12, 4, cmp);
+    std::vector<std::pair<uint32_t, uint32_t>> rows;
+    for (uint32_t idx = 1; idx <= 64; idx++) {
+        rows.emplace_back(idx, idx);
+    }
+    std::vector<uint8_t> heights;
+    ASSERT_TRUE(sl.BulkAppend(rows.begin(), rows.end(), &heights));
+    ASSERT_EQ(1, heights[0]);
+    ASSERT_EQ(2, heights[3]);
+    ASSERT_EQ(3, heights[15]);
+    ASSERT_EQ(4, heights[63]);
+    uint32_t sum = 0;
+    for (auto height : heights) {
+        sum += height;
+    }
+    // 64 + 16 + 4 + 1
+    ASSERT_EQ(85u, sum);
+    sl.Clear();
+}
+
+TEST_F(SkiplistTest, BulkAppendMatchesInsert) {
+    DescComparator cmp;
+    const uint32_t cnt = 10000;
+    std::vector<std::pair<uint32_t, uint32_t>> rows;
+    rows.reserve(cnt);
+    for (uint32_t idx = cnt; idx > 0; idx--) {
+        rows.emplace_back(idx, idx * 2);
+    }
+    Skiplist<uint32_t, uint32_t, DescComparator> insert_sl(12, 4, cmp);
+    for (auto& row : rows) {
+        insert_sl.Insert(row.first, row.second);
+    }
+    Skiplist<uint32_t, uint32_t, DescComparator> bulk_sl(12, 4, cmp);
+    ASSERT_TRUE(bulk_sl.BulkAppend(rows.begin(), rows.end()));
+    ASSERT_EQ(insert_sl.GetSize(), bulk_sl.GetSize());
+    std::unique_ptr<Skiplist<uint32_t, uint32_t, DescComparator>::Iterator> insert_it(insert_sl.NewIterator());
+    std::unique_ptr<Skiplist<uint32_t, uint32_t, DescComparator>::Iterator> bulk_it(bulk_sl.NewIterator());
+    insert_it->SeekToFirst();
+    bulk_it->SeekToFirst();
+    while (insert_it->Valid()) {
+        ASSERT_TRUE(bulk_it->Valid());
+        ASSERT_EQ(insert_it->GetKey(), bulk_it->GetKey());
+        ASSERT_EQ(insert_it->GetValue(), bulk_it->GetValue());
+        insert_it->Next();
+        bulk_it->Next();
+    }
+    ASSERT_FALSE(bulk_it->Valid());
+    uint32_t value = 0;
+    for (uint32_t idx = 1; idx <= cnt; idx += 7) {
+        ASSERT_EQ(0, bulk_sl.Get(idx, value));
+        ASSERT_EQ(idx * 2, value);
+    }
+    insert_sl.Clear();
+    bulk_sl.Clear();
+}
+
+template <class K, class V>
+static void FreeNodes(Node<K, V>* node) {
+    while (node != NULL) {
+        Node<K, V>* tmp = node;
+        node = node->GetNext(0);
+        delete tmp;
+    }
+}
+
+// check the positions and the size of an indexable list against the keys it should have
+template <class C>
+static void CheckPositions(Skiplist<uint32_t, uint32_t, C, true>* sl, const std::vector<uint32_t>& keys) {
+    ASSERT_EQ(keys.size(), sl->GetSize());
+    std::unique_ptr<typename Skiplist<uint32_t, uint32_t, C, true>::Iterator> it(sl->NewIterator());
+    for (uint32_t pos = 0; pos < keys.size(); pos++) {
+        it->SeekToPosition(pos);
+        ASSERT_TRUE(it->Valid());
+        ASSERT_EQ(keys[pos], it->GetKey());
+        ASSERT_EQ(pos, sl->GetPosition(keys[pos]));
+    }
+    it->SeekToPosition(keys.size());
+    ASSERT_FALSE(it->Valid());
+}
+
+TEST_F(SkiplistTest, Indexable) {
+    Comparator cmp;
+    for (auto height : vec) {
+        Skiplist<uint32_t, uint32_t, Comparator, true> sl(height, 4, cmp);
+        ASSERT_EQ(24u, sizeof(sl));
+        ASSERT_TRUE(sl.IsIndexable());
+        std::vector<uint32_t> keys;
+        CheckPositions(&sl, keys);
+        std::vector<std::pair<uint32_t, uint32_t>> rows;
+        for (uint32_t idx = 1; idx <= 100; idx++) {
+            rows.emplace_back(idx * 10, idx);
+            keys.push_back(idx * 10);
+        }
+        ASSERT_TRUE(sl.BulkAppend(rows.begin(), rows.end()));
+        CheckPositions(&sl, keys);
+        for (uint32_t idx = 0; idx < 200; idx++) {
+            uint32_t key = (idx * 7919) % 1000 + 5;
+            if (std::find(keys.begin(), keys.end(), key) != keys.end()) {
+                continue;
+            }
+            sl.Insert(key, idx);
+            keys.insert(std::lower_bound(keys.begin(), keys.end(), key), key);
+        }
+        CheckPositions(&sl, keys);
+        for (uint32_t key = 1; key <= 4; key++) {
+            ASSERT_TRUE(sl.AddToFirst(5 - key, key));
+            keys.insert(keys.begin(), 5 - key);
+        }
+        CheckPositions(&sl, keys);
+        for (uint32_t idx = 0; idx < keys.size(); idx += 3) {
+            auto removed = sl.Remove(keys[idx]);
+            ASSERT_TRUE(removed != NULL);
+            delete removed;
+        }
+        std::vector<uint32_t> left;
+        for (uint32_t idx = 0; idx < keys.size(); idx++) {
+            if (idx % 3 != 0) {
+                left.push_back(keys[idx]);
+            }
+        }
+        keys.swap(left);
+        CheckPositions(&sl, keys);
+        auto node = sl.Split(keys[keys.size() / 2]);
+        ASSERT_TRUE(node != NULL);
+        FreeNodes(node);
+        keys.resize(keys.size() / 2);
+        CheckPositions(&sl, keys);
+        node = sl.SplitByPos(10);
+        ASSERT_TRUE(node != NULL);
+        ASSERT_EQ(keys[10], node->GetKey());
+        FreeNodes(node);
+        keys.resize(10);
+        CheckPositions(&sl, keys);
+        ASSERT_EQ(keys.back(), sl.GetLast()->GetKey());
+        ASSERT_TRUE(sl.SplitByPos(10) == NULL);
+        node = sl.SplitByKeyOrPos(100000, 5);
+        ASSERT_TRUE(node != NULL);
+        FreeNodes(node);
+        keys.resize(5);
+        CheckPositions(&sl, keys);
+        sl.Clear();
+        keys.clear();
+        CheckPositions(&sl, keys);
+        uint32_t value = 8;
+        sl.Insert(value, value);
+        keys.push_back(value);
+        CheckPositions(&sl, keys);
+        sl.Clear();
+    }
+}
+
+TEST_F(SkiplistTest, SeekToPosition) {
+    DescComparator cmp;
+    Skiplist<uint32_t, uint32_t, DescComparator> sl(12, 4, cmp);
+    Skiplist<uint32_t, uint32_t, DescComparator, true> indexable_sl(12, 4, cmp);
+    for (uint32_t idx = 0; idx < 1000; idx++) {
+        sl.Insert(idx, idx);
+        indexable_sl.Insert(idx, idx);
+    }
+    std::unique_ptr<Skiplist<uint32_t, uint32_t, DescComparator>::Iterator> it(sl.NewIterator());
+    std::unique_ptr<Skiplist<uint32_t, uint32_t, DescComparator, true>::Iterator> indexable_it(
+        indexable_sl.NewIterator());
+    for (uint32_t pos = 0; pos < 999; pos += 37) {
+        it->SeekToPosition(pos);
+        indexable_it->SeekToPosition(pos);
+        ASSERT_TRUE(it->Valid());
+        ASSERT_TRUE(indexable_it->Valid());
+        ASSERT_EQ(999 - pos, it->GetKey());
+        ASSERT_EQ(999 - pos, indexable_it->GetKey());
+        indexable_it->Next();
+        ASSERT_EQ(998 - pos, indexable_it->GetKey());
+    }
+    it->SeekToPosition(1000);
+    ASSERT_FALSE(it->Valid());
+    // the keys not less than 500 in the desc order
+    ASSERT_EQ(499u, indexable_sl.GetPosition(500));
+    ASSERT_EQ(sl.GetSize(), indexable_sl.GetSize());
+    auto node = indexable_sl.SplitByPos(100);
+    ASSERT_EQ(899u, node->GetKey());
+    ASSERT_EQ(100u, indexable_sl.GetSize());
+    FreeNodes(node);
+    sl.Clear();
+    indexable_sl.Clear();
+}
+
 }  // namespace base
 }  // namespace openmldb
 
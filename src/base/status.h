@@ -184,6 +184,9 @@ enum ReturnCode {
     kRPCRunError = 1002,
     kServerConnError = 1003,
     kRPCError = 1004,  // brpc controller error
+    kQueryDeadlineExceeded = 1005,
+    kQueryResultNotFound = 1006,
+    kQueryResultCacheFull = 1007,
 
     // auth
     kFlushPrivilegesFailed = 1100,  // brpc controller error
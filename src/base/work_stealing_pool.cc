@@ -0,0 +1,163 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/work_stealing_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace openmldb {
+namespace base {
+
+// the pool and the worker id of the current thread, so that tasks added by a worker go to its own deque
+static thread_local WorkStealingPool* current_pool = nullptr;
+static thread_local uint32_t current_worker = 0;
+
+WorkStealingPool::WorkStealingPool(const std::string& name, uint32_t thread_num, uint32_t max_pending)
+    : name_(name),
+      max_pending_(max_pending),
+      stop_(false),
+      next_worker_(0),
+      pending_(0),
+      sleeping_workers_(0),
+      waiting_producers_(0),
+      submitted_(name, "submitted"),
+      executed_(name, "executed"),
+      stolen_(name, "stolen"),
+      pending_status_(
+          name, "pending",
+          [](void* arg) -> uint64_t {
+              return static_cast<WorkStealingPool*>(arg)->pending_.load(std::memory_order_relaxed);
+          },
+          this) {
+    thread_num = std::max<uint32_t>(thread_num, 1);
+    for (uint32_t i = 0; i < thread_num; i++) {
+        workers_.emplace_back(std::make_unique<Worker>());
+    }
+    for (uint32_t i = 0; i < thread_num; i++) {
+        threads_.emplace_back(&WorkStealingPool::ThreadProc, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() { Stop(); }
+
+bool WorkStealingPool::AddTask(Task task) {
+    bool in_worker = current_pool == this;
+    if (max_pending_ > 0 && !in_worker && pending_.load() >= max_pending_) {
+        std::unique_lock<std::mutex> lock(mu_);
+        waiting_producers_.fetch_add(1);
+        space_cv_.wait(lock, [this] { return stop_.load() || pending_.load() < max_pending_; });
+        waiting_producers_.fetch_sub(1);
+    }
+    // the running tasks can still add subtasks when the pool is stopping, they are run before the workers exit
+    if (stop_.load() && !in_worker) {
+        return false;
+    }
+    if (in_worker) {
+        // run the subtasks of the current task first, they are likely to share its data
+        auto& worker = workers_[current_worker];
+        std::lock_guard<std::mutex> lock(worker->mu);
+        worker->tasks.push_front(std::move(task));
+    } else {
+        auto& worker = workers_[next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size()];
+        std::lock_guard<std::mutex> lock(worker->mu);
+        worker->tasks.push_back(std::move(task));
+    }
+    submitted_ << 1;
+    // the task must be in the deque before pending_ is visible to the sleeping workers
+    pending_.fetch_add(1);
+    if (sleeping_workers_.load() > 0) {
+        std::lock_guard<std::mutex> lock(mu_);
+        work_cv_.notify_one();
+    }
+    return true;
+}
+
+bool WorkStealingPool::Pop(uint32_t id, Task* task) {
+    {
+        auto& worker = workers_[id];
+        std::lock_guard<std::mutex> lock(worker->mu);
+        if (!worker->tasks.empty()) {
+            *task = std::move(worker->tasks.front());
+            worker->tasks.pop_front();
+            return true;
+        }
+    }
+    for (uint32_t i = 1; i < workers_.size(); i++) {
+        auto& victim = workers_[(id + i) % workers_.size()];
+        std::lock_guard<std::mutex> lock(victim->mu);
+        if (!victim->tasks.empty()) {
+            *task = std::move(victim->tasks.back());
+            victim->tasks.pop_back();
+            stolen_ << 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::ThreadProc(uint32_t id) {
+    current_pool = this;
+    current_worker = id;
+    while (true) {
+        Task task;
+        if (Pop(id, &task)) {
+            pending_.fetch_sub(1);
+            if (waiting_producers_.load() > 0) {
+                std::lock_guard<std::mutex> lock(mu_);
+                space_cv_.notify_one();
+            }
+            task();
+            executed_ << 1;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mu_);
+        if (stop_.load() && pending_.load() == 0) {
+            break;
+        }
+        sleeping_workers_.fetch_add(1);
+        work_cv_.wait(lock, [this] { return stop_.load() || pending_.load() > 0; });
+        sleeping_workers_.fetch_sub(1);
+    }
+    current_pool = nullptr;
+}
+
+void WorkStealingPool::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        stop_.store(true);
+        work_cv_.notify_all();
+        space_cv_.notify_all();
+    }
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads_.clear();
+}
+
+WorkStealingPoolStats WorkStealingPool::GetStats() const {
+    WorkStealingPoolStats stats;
+    stats.submitted = submitted_.get_value();
+    stats.executed = executed_.get_value();
+    stats.stolen = stolen_.get_value();
+    stats.pending = pending_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+}  // namespace base
+}  // namespace openmldb
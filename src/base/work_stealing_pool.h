@@ -0,0 +1,98 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_BASE_WORK_STEALING_POOL_H_
+#define SRC_BASE_WORK_STEALING_POOL_H_
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "bvar/bvar.h"
+
+namespace openmldb {
+namespace base {
+
+struct WorkStealingPoolStats {
+    uint64_t submitted = 0;
+    uint64_t executed = 0;
+    uint64_t stolen = 0;
+    uint64_t pending = 0;
+};
+
+// A thread pool with a task deque per worker. A worker takes tasks from the front of its own deque and steals from
+// the back of the others when its own is empty, so the workers rarely contend on one lock.
+// The counters are exposed as the bvars <name>_submitted, <name>_executed, <name>_stolen and <name>_pending while the
+// pool exists.
+// AddTask from outside the pool blocks while max_pending tasks are waiting, 0 means unbounded. Tasks added by the
+// workers never block, or the pool could wait on itself.
+class WorkStealingPool {
+ public:
+    using Task = std::function<void()>;
+
+    WorkStealingPool(const std::string& name, uint32_t thread_num, uint32_t max_pending);
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // return false if the pool is stopped
+    bool AddTask(Task task);
+
+    // run all the pending tasks and join the workers, AddTask from outside the pool fails after that
+    void Stop();
+
+    WorkStealingPoolStats GetStats() const;
+    const std::string& GetName() const { return name_; }
+
+ private:
+    struct Worker {
+        std::mutex mu;
+        std::deque<Task> tasks;
+    };
+
+    void ThreadProc(uint32_t id);
+    bool Pop(uint32_t id, Task* task);
+
+    const std::string name_;
+    const uint32_t max_pending_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+
+    std::atomic<bool> stop_;
+    std::atomic<uint32_t> next_worker_;
+    std::atomic<uint64_t> pending_;
+    std::atomic<uint32_t> sleeping_workers_;
+    std::atomic<uint32_t> waiting_producers_;
+    bvar::Adder<uint64_t> submitted_;
+    bvar::Adder<uint64_t> executed_;
+    bvar::Adder<uint64_t> stolen_;
+    bvar::PassiveStatus<uint64_t> pending_status_;
+
+    // only for sleeping and waking up
+    std::mutex mu_;
+    std::condition_variable work_cv_;
+    std::condition_variable space_cv_;
+};
+
+}  // namespace base
+}  // namespace openmldb
+#endif  // SRC_BASE_WORK_STEALING_POOL_H_
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/work_stealing_pool.h"
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace base {
+
+class WorkStealingPoolTest : public ::testing::Test {
+ public:
+    WorkStealingPoolTest() {}
+    ~WorkStealingPoolTest() {}
+};
+
+TEST_F(WorkStealingPoolTest, RunAll) {
+    std::atomic<uint64_t> sum(0);
+    {
+        WorkStealingPool pool("test", 4, 0);
+        for (uint64_t i = 1; i <= 10000; i++) {
+            ASSERT_TRUE(pool.AddTask([&sum, i] { sum.fetch_add(i); }));
+        }
+        pool.Stop();
+        auto stats = pool.GetStats();
+        ASSERT_EQ(10000u, stats.submitted);
+        ASSERT_EQ(10000u, stats.executed);
+        ASSERT_EQ(0u, stats.pending);
+        ASSERT_FALSE(pool.AddTask([] {}));
+    }
+    ASSERT_EQ(10000u * 10001 / 2, sum.load());
+}
+
+TEST_F(WorkStealingPoolTest, SubTask) {
+    std::atomic<uint64_t> cnt(0);
+    WorkStealingPool pool("test", 4, 8);
+    // a worker adding subtasks never blocks on max_pending
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(pool.AddTask([&pool, &cnt] {
+            for (int j = 0; j < 100; j++) {
+                pool.AddTask([&cnt] { cnt.fetch_add(1); });
+            }
+        }));
+    }
+    pool.Stop();
+    ASSERT_EQ(400u, cnt.load());
+}
+
+TEST_F(WorkStealingPoolTest, Steal) {
+    std::atomic<uint64_t> cnt(0);
+    WorkStealingPool pool("test", 4, 0);
+    // all the subtasks are in the deque of one worker, the others have to steal them
+    pool.AddTask([&pool, &cnt] {
+        for (int j = 0; j < 100; j++) {
+            pool.AddTask([&cnt] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                cnt.fetch_add(1);
+            });
+        }
+    });
+    pool.Stop();
+    ASSERT_EQ(100u, cnt.load());
+    ASSERT_GT(pool.GetStats().stolen, 0u);
+}
+
+TEST_F(WorkStealingPoolTest, ExposeStats) {
+    {
+        WorkStealingPool pool("test_expose", 2, 0);
+        std::atomic<bool> started(false);
+        pool.AddTask([&started] {
+            while (!started.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+        pool.AddTask([] {});
+        pool.AddTask([] {});
+        ASSERT_EQ("3", bvar::Variable::describe_exposed("test_expose_submitted"));
+        started.store(true);
+        pool.Stop();
+        auto stats = pool.GetStats();
+        ASSERT_EQ("3", bvar::Variable::describe_exposed("test_expose_executed"));
+        ASSERT_EQ(std::to_string(stats.stolen), bvar::Variable::describe_exposed("test_expose_stolen"));
+        ASSERT_EQ("0", bvar::Variable::describe_exposed("test_expose_pending"));
+    }
+    // hidden with the pool
+    ASSERT_EQ("", bvar::Variable::describe_exposed("test_expose_submitted"));
+}
+
+TEST_F(WorkStealingPoolTest, MaxPending) {
+    WorkStealingPool pool("test", 1, 2);
+    std::atomic<bool> started(false);
+    std::atomic<uint64_t> cnt(0);
+    pool.AddTask([&started] {
+        while (!started.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    std::thread producer([&pool, &cnt] {
+        for (int i = 0; i < 10; i++) {
+            pool.AddTask([&cnt] { cnt.fetch_add(1); });
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    // the producer is blocked
+    ASSERT_LE(pool.GetStats().pending, 2u);
+    started.store(true);
+    producer.join();
+    pool.Stop();
+    ASSERT_EQ(10u, cnt.load());
+}
+
+}  // namespace base
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
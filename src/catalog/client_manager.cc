@@ -16,6 +16,7 @@
 
 #include "catalog/client_manager.h"
 
+#include <limits>
 #include <utility>
 
 #include "codec/fe_schema_codec.h"
@@ -210,6 +211,50 @@ bool AsyncTablesHandler::SyncAllTableHandlers() {
     return true;
 }
 
+std::shared_ptr<::openmldb::client::TabletClient> TabletAccessor::GetClient() {
+    auto clients = std::atomic_load_explicit(&tablet_clients_, std::memory_order_acquire);
+    if (!clients || clients->empty()) {
+        return {};
+    }
+    size_t selected = 0;
+    int32_t min_inflight = (*clients)[0]->GetInflight();
+    for (size_t i = 1; i < clients->size() && min_inflight > 0; i++) {
+        int32_t inflight = (*clients)[i]->GetInflight();
+        if (inflight < min_inflight) {
+            selected = i;
+            min_inflight = inflight;
+        }
+    }
+    return (*clients)[selected];
+}
+
+int32_t TabletAccessor::GetInflight() {
+    auto clients = std::atomic_load_explicit(&tablet_clients_, std::memory_order_acquire);
+    int32_t inflight = 0;
+    if (clients) {
+        for (const auto& client : *clients) {
+            inflight += client->GetInflight();
+        }
+    }
+    return inflight;
+}
+
+bool TabletAccessor::UpdateClient(const std::string& endpoint) {
+    auto clients = std::make_shared<TabletClients>();
+    for (uint32_t i = 0; i < channel_num_; i++) {
+        auto client = std::make_shared<::openmldb::client::TabletClient>(name_, endpoint, auth_token_);
+        // the first channel stays in the default group, so a single channel accessor works as before
+        std::string connection_group = i == 0 ? "" : name_ + "#" + std::to_string(i);
+        if (client->Init(connection_group) != 0) {
+            return false;
+        }
+        clients->push_back(client);
+    }
+    std::atomic_store_explicit(&tablet_clients_, std::shared_ptr<const TabletClients>(clients),
+                               std::memory_order_release);
+    return true;
+}
+
 std::shared_ptr<::hybridse::vm::RowHandler> TabletAccessor::SubQuery(uint32_t task_id, const std::string& db,
                                                                      const std::string& sql,
                                                                      const ::hybridse::codec::Row& row,
@@ -489,6 +534,26 @@ std::vector<std::shared_ptr<TabletAccessor>> TableClientManager::GetTabletFollow
     return {};
 }
 
+std::shared_ptr<TabletAccessor> TableClientManager::GetTabletReplica(uint32_t pid) const {
+    auto partition_manager = GetPartitionClientManager(pid);
+    if (!partition_manager) {
+        return {};
+    }
+    auto selected = partition_manager->GetLeader();
+    int32_t min_inflight = selected ? selected->GetInflight() : std::numeric_limits<int32_t>::max();
+    for (const auto& follower : partition_manager->GetFollowers()) {
+        if (min_inflight == 0) {
+            break;
+        }
+        int32_t inflight = follower->GetInflight();
+        if (inflight < min_inflight) {
+            selected = follower;
+            min_inflight = inflight;
+        }
+    }
+    return selected;
+}
+
 std::shared_ptr<TabletsAccessor> TableClientManager::GetTablet(std::vector<uint32_t> pids) const {
     auto tablets_accessor = std::make_shared<TabletsAccessor>();
     for (size_t idx = 0; idx < pids.size(); idx++) {
@@ -554,7 +619,7 @@ bool ClientManager::UpdateClient(const std::map<std::string, std::string>& endpo
     for (const auto& kv : endpoint_map) {
         auto it = real_endpoint_map_.find(kv.first);
         if (it == real_endpoint_map_.end()) {
-            auto wrapper = std::make_shared<TabletAccessor>(kv.first, auth_token_);
+            auto wrapper = std::make_shared<TabletAccessor>(kv.first, auth_token_, channel_num_);
             if (!wrapper->UpdateClient(kv.second)) {
                 LOG(WARNING) << "add client failed. name " << kv.first << ", endpoint " << kv.second;
                 continue;
@@ -132,29 +132,32 @@ class AsyncTablesHandler : public ::hybridse::vm::MemTableHandler {
 
 class TabletAccessor : public ::hybridse::vm::Tablet {
  public:
+    using TabletClients = std::vector<std::shared_ptr<::openmldb::client::TabletClient>>;
+
+    // the accessor connects the tablet with channel_num channels, each of them has its own connection
     explicit TabletAccessor(const std::string& name,
-                            const openmldb::authn::AuthToken auth_token = openmldb::authn::ServiceToken{"default"})
-        : name_(name), tablet_client_(), auth_token_(auth_token) {}
+                            const openmldb::authn::AuthToken auth_token = openmldb::authn::ServiceToken{"default"},
+                            uint32_t channel_num = 1)
+        : name_(name), tablet_clients_(), auth_token_(auth_token), channel_num_(channel_num == 0 ? 1 : channel_num) {}
 
     TabletAccessor(const std::string& name, const std::shared_ptr<::openmldb::client::TabletClient>& client,
                    const openmldb::authn::AuthToken auth_token = openmldb::authn::ServiceToken{"default"})
-        : name_(name), tablet_client_(client), auth_token_(auth_token) {}
+        : name_(name),
+          tablet_clients_(std::make_shared<const TabletClients>(TabletClients{client})),
+          auth_token_(auth_token),
+          channel_num_(1) {}
 
-    std::shared_ptr<::openmldb::client::TabletClient> GetClient() {
-        return std::atomic_load_explicit(&tablet_client_, std::memory_order_relaxed);
-    }
+    // the client with the fewest requests in flight
+    std::shared_ptr<::openmldb::client::TabletClient> GetClient();
 
-    bool UpdateClient(const std::string& endpoint) {
-        auto client = std::make_shared<::openmldb::client::TabletClient>(name_, endpoint, auth_token_);
-        if (client->Init() != 0) {
-            return false;
-        }
-        std::atomic_store_explicit(&tablet_client_, client, std::memory_order_relaxed);
-        return true;
-    }
+    // the number of requests in flight of all the channels
+    int32_t GetInflight();
+
+    bool UpdateClient(const std::string& endpoint);
 
     bool UpdateClient(const std::shared_ptr<::openmldb::client::TabletClient>& client) {
-        std::atomic_store_explicit(&tablet_client_, client, std::memory_order_relaxed);
+        std::atomic_store_explicit(&tablet_clients_, std::make_shared<const TabletClients>(TabletClients{client}),
+                                   std::memory_order_release);
         return true;
     }
 
@@ -172,8 +175,11 @@ class TabletAccessor : public ::hybridse::vm::Tablet {
 
  private:
     std::string name_;
-    std::shared_ptr<::openmldb::client::TabletClient> tablet_client_;
+    // replaced as a whole when the endpoint changes, so readers never lock. stored with release and loaded with
+    // acquire, so a reader sees the channels initialized by the writer
+    std::shared_ptr<const TabletClients> tablet_clients_;
     const openmldb::authn::AuthToken auth_token_;
+    const uint32_t channel_num_;
 };
 
 class TabletsAccessor : public ::hybridse::vm::Tablet {
@@ -239,6 +245,10 @@ class TableClientManager {
 
     std::vector<std::shared_ptr<TabletAccessor>> GetTabletFollowers(uint32_t pid) const;
 
+    // the leader or a follower of the partition with the fewest requests in flight, for the reads that accept
+    // data lagging behind the leader
+    std::shared_ptr<TabletAccessor> GetTabletReplica(uint32_t pid) const;
+
     std::shared_ptr<TabletsAccessor> GetTablet(std::vector<uint32_t> pids) const;
 
  private:
@@ -247,8 +257,15 @@ class TableClientManager {
 
 class ClientManager {
  public:
-    explicit ClientManager(const openmldb::authn::AuthToken auth_token = openmldb::authn::ServiceToken{"default"})
-        : real_endpoint_map_(), clients_(), mu_(), rand_(0xdeadbeef), auth_token_(auth_token) {}
+    // the tablet accessors created by endpoints connect each tablet with channel_num channels
+    explicit ClientManager(const openmldb::authn::AuthToken auth_token = openmldb::authn::ServiceToken{"default"},
+                           uint32_t channel_num = 1)
+        : real_endpoint_map_(),
+          clients_(),
+          mu_(),
+          rand_(0xdeadbeef),
+          auth_token_(auth_token),
+          channel_num_(channel_num) {}
     std::shared_ptr<TabletAccessor> GetTablet(const std::string& name) const;
     std::shared_ptr<TabletAccessor> GetTablet() const;
     std::vector<std::shared_ptr<TabletAccessor>> GetAllTablet() const;
@@ -263,6 +280,7 @@ class ClientManager {
     mutable ::openmldb::base::SpinMutex mu_;
     mutable ::openmldb::base::Random rand_;
     const openmldb::authn::AuthToken auth_token_;
+    const uint32_t channel_num_;
 };
 
 }  // namespace catalog
@@ -16,6 +16,12 @@
 
 #include "catalog/client_manager.h"
 
+#include <chrono>  // NOLINT
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "brpc/server.h"
 #include "gtest/gtest.h"
 
 namespace openmldb {
@@ -23,6 +29,37 @@ namespace catalog {
 
 class ClientManagerTest : public ::testing::Test {};
 
+// holds the sub queries until Finish, so they stay in flight on the client
+class HoldQueryTablet : public ::openmldb::api::TabletServer {
+ public:
+    void SubQuery(::google::protobuf::RpcController* controller, const ::openmldb::api::QueryRequest* request,
+                  ::openmldb::api::QueryResponse* response, ::google::protobuf::Closure* done) override {
+        response->set_code(0);
+        std::lock_guard<std::mutex> lock(mu_);
+        held_.push_back(done);
+    }
+
+    size_t GetHeldCnt() {
+        std::lock_guard<std::mutex> lock(mu_);
+        return held_.size();
+    }
+
+    void Finish() {
+        std::vector<::google::protobuf::Closure*> held;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            held.swap(held_);
+        }
+        for (auto done : held) {
+            done->Run();
+        }
+    }
+
+ private:
+    std::mutex mu_;
+    std::vector<::google::protobuf::Closure*> held_;
+};
+
 TEST_F(ClientManagerTest, NormalTest) {
     ::openmldb::nameserver::TableInfo table_info;
     table_info.set_name("t1");
@@ -72,6 +109,108 @@ TEST_F(ClientManagerTest, NormalTest) {
               table_client_manager.GetPartitionClientManager(0)->GetLeader()->GetClient()->GetRealEndpoint());
 }
 
+TEST_F(ClientManagerTest, ChannelPoolTest) {
+    ::openmldb::nameserver::TableInfo table_info;
+    table_info.set_name("t1");
+    table_info.set_db("db1");
+    table_info.set_tid(1);
+    auto pt = table_info.add_table_partition();
+    pt->set_pid(0);
+    for (int j = 0; j < 2; j++) {
+        auto meta = pt->add_partition_meta();
+        meta->set_is_leader(j == 0);
+        meta->set_is_alive(true);
+        meta->set_endpoint("name" + std::to_string(j));
+    }
+    ::openmldb::storage::TableSt table_st(table_info);
+
+    ClientManager manager(::openmldb::authn::ServiceToken{"default"}, 3);
+    std::map<std::string, std::string> endpoint_map = {{"name0", "127.0.0.1:10001"}, {"name1", "127.0.0.1:10002"}};
+    ASSERT_TRUE(manager.UpdateClient(endpoint_map));
+    auto tablet = manager.GetTablet("name0");
+    ASSERT_TRUE(tablet);
+    auto client = tablet->GetClient();
+    ASSERT_TRUE(client);
+    ASSERT_EQ("name0", client->GetEndpoint());
+    ASSERT_EQ("127.0.0.1:10001", client->GetRealEndpoint());
+    ASSERT_EQ(0, tablet->GetInflight());
+
+    // the channels are rebuilt when the endpoint changes
+    endpoint_map["name0"] = "127.0.0.1:10003";
+    ASSERT_TRUE(manager.UpdateClient(endpoint_map));
+    ASSERT_EQ("127.0.0.1:10003", tablet->GetClient()->GetRealEndpoint());
+
+    // the leader serves the reads unless it is busier than the followers
+    TableClientManager table_client_manager(table_st, manager);
+    ASSERT_EQ("name0", table_client_manager.GetTabletReplica(0)->GetName());
+    ASSERT_FALSE(table_client_manager.GetTabletReplica(1));
+}
+
+TEST_F(ClientManagerTest, ChannelPoolBusyLeader) {
+    HoldQueryTablet leader_service;
+    brpc::Server server;
+    ASSERT_EQ(0, server.AddService(&leader_service, brpc::SERVER_DOESNT_OWN_SERVICE));
+    brpc::ServerOptions options;
+    ASSERT_EQ(0, server.Start("127.0.0.1:17627", &options));
+
+    ::openmldb::nameserver::TableInfo table_info;
+    table_info.set_name("t1");
+    table_info.set_db("db1");
+    table_info.set_tid(1);
+    auto pt = table_info.add_table_partition();
+    pt->set_pid(0);
+    for (int j = 0; j < 2; j++) {
+        auto meta = pt->add_partition_meta();
+        meta->set_is_leader(j == 0);
+        meta->set_is_alive(true);
+        meta->set_endpoint("name" + std::to_string(j));
+    }
+    ::openmldb::storage::TableSt table_st(table_info);
+    ClientManager manager(::openmldb::authn::ServiceToken{"default"}, 2);
+    std::map<std::string, std::string> endpoint_map = {{"name0", "127.0.0.1:17627"}, {"name1", "127.0.0.1:17628"}};
+    ASSERT_TRUE(manager.UpdateClient(endpoint_map));
+    TableClientManager table_client_manager(table_st, manager);
+    auto leader = manager.GetTablet("name0");
+    ASSERT_EQ("name0", table_client_manager.GetTabletReplica(0)->GetName());
+
+    // the requests go through the idle channels of the leader
+    std::vector<openmldb::RpcCallback<openmldb::api::QueryResponse>*> callbacks;
+    std::vector<std::shared_ptr<::openmldb::client::TabletClient>> used;
+    for (int i = 0; i < 2; i++) {
+        auto cntl = std::make_shared<brpc::Controller>();
+        cntl->set_timeout_ms(60000);
+        auto callback = new openmldb::RpcCallback<openmldb::api::QueryResponse>(
+            std::make_shared<openmldb::api::QueryResponse>(), cntl);
+        callback->Ref();
+        auto client = leader->GetClient();
+        used.push_back(client);
+        ::openmldb::api::QueryRequest request;
+        request.set_db("db1");
+        ASSERT_TRUE(client->SubQuery(request, callback));
+        callbacks.push_back(callback);
+    }
+    ASSERT_NE(used[0].get(), used[1].get());
+    ASSERT_EQ(2, leader->GetInflight());
+    // the follower is less busy and serves the reads
+    ASSERT_EQ("name1", table_client_manager.GetTabletReplica(0)->GetName());
+
+    while (leader_service.GetHeldCnt() < callbacks.size()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    leader_service.Finish();
+    for (auto callback : callbacks) {
+        while (!callback->IsDone()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_FALSE(callback->GetController()->Failed());
+        callback->UnRef();
+    }
+    ASSERT_EQ(0, leader->GetInflight());
+    ASSERT_EQ("name0", table_client_manager.GetTabletReplica(0)->GetName());
+    server.Stop(0);
+    server.Join();
+}
+
 }  // namespace catalog
 }  // namespace openmldb
 
@@ -118,6 +118,10 @@ std::vector<std::shared_ptr<TabletAccessor>> SDKTableHandler::GetTabletFollowers
     return table_client_manager_->GetTabletFollowers(pid);
 }
 
+std::shared_ptr<TabletAccessor> SDKTableHandler::GetTabletReplica(uint32_t pid) const {
+    return table_client_manager_->GetTabletReplica(pid);
+}
+
 bool SDKTableHandler::GetTablet(std::vector<std::shared_ptr<TabletAccessor>>* tablets) {
     if (tablets == nullptr) {
         return false;
@@ -154,6 +158,31 @@ bool SDKCatalog::Init(const std::vector<::openmldb::nameserver::TableInfo>& tabl
     return true;
 }
 
+bool SDKCatalog::Init(const SDKCatalog& base, const std::vector<::openmldb::nameserver::TableInfo>& changed,
+                      const std::vector<std::pair<std::string, std::string>>& removed, const Procedures& db_sp_map) {
+    tables_ = base.tables_;
+    for (const auto& [db, name] : removed) {
+        auto db_it = tables_.find(db);
+        if (db_it == tables_.end()) {
+            continue;
+        }
+        db_it->second.erase(name);
+        if (db_it->second.empty()) {
+            tables_.erase(db_it);
+        }
+    }
+    for (const auto& table_meta : changed) {
+        auto table = std::make_shared<SDKTableHandler>(table_meta, *client_manager_);
+        if (!table->Init()) {
+            LOG(WARNING) << "fail to init table " << table_meta.name();
+            return false;
+        }
+        tables_[table->GetDatabase()][table->GetName()] = table;
+    }
+    db_sp_map_ = db_sp_map;
+    return true;
+}
+
 std::shared_ptr<::hybridse::vm::TableHandler> SDKCatalog::GetTable(const std::string& db,
                                                                    const std::string& table_name) {
     auto db_it = tables_.find(db);
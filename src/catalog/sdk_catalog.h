@@ -82,6 +82,8 @@ class SDKTableHandler : public ::hybridse::vm::TableHandler {
 
     std::shared_ptr<TabletAccessor> GetTablet(uint32_t pid) const;
     std::vector<std::shared_ptr<TabletAccessor>> GetTabletFollowers(uint32_t pid) const;
+    // the leader or a follower of the partition, see TableClientManager::GetTabletReplica
+    std::shared_ptr<TabletAccessor> GetTabletReplica(uint32_t pid) const;
 
     bool GetTablet(std::vector<std::shared_ptr<TabletAccessor>>* tablets);
 
@@ -121,6 +123,10 @@ class SDKCatalog : public ::hybridse::vm::Catalog {
 
     bool Init(const std::vector<::openmldb::nameserver::TableInfo>& tables, const Procedures& db_sp_map);
 
+    // init with the table handlers of base, the removed tables are dropped and the changed tables get new handlers
+    bool Init(const SDKCatalog& base, const std::vector<::openmldb::nameserver::TableInfo>& changed,
+              const std::vector<std::pair<std::string, std::string>>& removed, const Procedures& db_sp_map);
+
     std::shared_ptr<::hybridse::type::Database> GetDatabase(const std::string& db) override {
         return std::shared_ptr<::hybridse::type::Database>();
     }
@@ -73,6 +73,26 @@ TEST_F(SDKCatalogTest, SdkSmokeTest) {
     std::cout << ss.str() << std::endl;*/
 }
 
+TEST_F(SDKCatalogTest, SdkDeltaInitTest) {
+    std::unique_ptr<TestArgs> t1(PrepareTable("t1", "db1"));
+    std::unique_ptr<TestArgs> t2(PrepareTable("t2", "db1"));
+    std::unique_ptr<TestArgs> t3(PrepareTable("t3", "db2"));
+    auto client_manager = std::make_shared<ClientManager>();
+    SDKCatalog base(client_manager);
+    Procedures procedures;
+    ASSERT_TRUE(base.Init({t1->meta, t2->meta, t3->meta}, procedures));
+
+    t2->meta.set_tid(2);
+    SDKCatalog catalog(client_manager);
+    ASSERT_TRUE(catalog.Init(base, {t2->meta}, {{"db2", "t3"}}, procedures));
+    // the unchanged handler is shared, the changed one is rebuilt and the removed one is gone
+    ASSERT_EQ(base.GetTable("db1", "t1"), catalog.GetTable("db1", "t1"));
+    ASSERT_NE(base.GetTable("db1", "t2"), catalog.GetTable("db1", "t2"));
+    ASSERT_EQ(2u, std::dynamic_pointer_cast<SDKTableHandler>(catalog.GetTable("db1", "t2"))->GetTid());
+    ASSERT_TRUE(base.GetTable("db2", "t3"));
+    ASSERT_FALSE(catalog.GetTable("db2", "t3"));
+}
+
 TEST_F(SDKCatalogTest, SdkWindowSmokeTest) {
     TestArgs* args = PrepareTable("t1", "db1");
     std::vector<::openmldb::nameserver::TableInfo> tables;
@@ -515,8 +515,9 @@ bool TabletCatalog::UpdateTableInfo(const ::openmldb::nameserver::TableInfo& tab
 }
 
 void TabletCatalog::Refresh(const std::vector<::openmldb::nameserver::TableInfo>& table_info_vec, uint64_t version,
-                            const Procedures& db_sp_map, bool* updated) {
-    *updated = false;
+                            const Procedures& db_sp_map,
+                            std::set<std::pair<std::string, std::string>>* updated_tables) {
+    updated_tables->clear();
     std::map<std::string, std::set<std::string>> table_map;
     for (const auto& table_info : table_info_vec) {
         const std::string& db_name = table_info.db();
@@ -527,7 +528,7 @@ void TabletCatalog::Refresh(const std::vector<::openmldb::nameserver::TableInfo>
         if (bool index_updated = false; !UpdateTableInfo(table_info, &index_updated)) {
             continue;
         } else if (index_updated) {
-            *updated = true;
+            updated_tables->emplace(db_name, table_name);
         }
         auto cur_db_it = table_map.find(db_name);
         if (cur_db_it == table_map.end()) {
@@ -542,6 +543,9 @@ void TabletCatalog::Refresh(const std::vector<::openmldb::nameserver::TableInfo>
         auto cur_db_it = table_map.find(db_it->first);
         if (cur_db_it == table_map.end()) {
             LOG(INFO) << "delete db from catalog. db: " << db_it->first;
+            for (const auto& kv : db_it->second) {
+                updated_tables->emplace(db_it->first, kv.first);
+            }
             db_it = tables_.erase(db_it);
             continue;
         }
@@ -549,8 +553,8 @@ void TabletCatalog::Refresh(const std::vector<::openmldb::nameserver::TableInfo>
             if (cur_db_it->second.find(table_it->first) == cur_db_it->second.end() &&
                 !table_it->second->HasLocalTable()) {
                 LOG(INFO) << "delete table from catalog. db: " << db_it->first << ", table: " << table_it->first;
+                updated_tables->emplace(db_it->first, table_it->first);
                 table_it = db_it->second.erase(table_it);
-                *updated = true;
                 continue;
             }
             ++table_it;
@@ -562,6 +566,45 @@ void TabletCatalog::Refresh(const std::vector<::openmldb::nameserver::TableInfo>
     LOG(INFO) << "refresh catalog. version " << version;
 }
 
+void TabletCatalog::RefreshDelta(const std::vector<::openmldb::nameserver::TableInfo>& changed,
+                                 const std::vector<std::pair<std::string, std::string>>& removed, uint64_t version,
+                                 const Procedures& db_sp_map,
+                                 std::set<std::pair<std::string, std::string>>* updated_tables) {
+    updated_tables->clear();
+    {
+        std::lock_guard<::openmldb::base::SpinMutex> spin_lock(mu_);
+        for (const auto& [db_name, table_name] : removed) {
+            auto db_it = tables_.find(db_name);
+            if (db_it == tables_.end()) {
+                continue;
+            }
+            auto table_it = db_it->second.find(table_name);
+            if (table_it != db_it->second.end() && !table_it->second->HasLocalTable()) {
+                LOG(INFO) << "delete table from catalog. db: " << db_name << ", table: " << table_name;
+                db_it->second.erase(table_it);
+                updated_tables->emplace(db_name, table_name);
+            }
+            if (db_it->second.empty()) {
+                LOG(INFO) << "delete db from catalog. db: " << db_name;
+                tables_.erase(db_it);
+            }
+        }
+    }
+    for (const auto& table_info : changed) {
+        if (table_info.db().empty()) {
+            continue;
+        }
+        if (bool index_updated = false; UpdateTableInfo(table_info, &index_updated) && index_updated) {
+            updated_tables->emplace(table_info.db(), table_info.name());
+        }
+    }
+    std::lock_guard<::openmldb::base::SpinMutex> spin_lock(mu_);
+    db_sp_map_ = db_sp_map;
+    version_.store(version, std::memory_order_relaxed);
+    LOG(INFO) << "refresh catalog with " << changed.size() << " tables changed and " << removed.size()
+              << " tables removed. version " << version;
+}
+
 bool TabletCatalog::UpdateClient(const std::map<std::string, std::string>& real_ep_map) {
     return client_manager_.UpdateClient(real_ep_map);
 }
@@ -646,6 +689,28 @@ std::unique_ptr<::hybridse::vm::RowIterator> TabletSegmentHandler::GetIterator()
 const uint64_t TabletSegmentHandler::GetCount() {
     auto iter = GetIterator();
     if (!iter) return 0;
+    if (iter->IsPositionSeekable()) {
+        // the rows not expired are a prefix of the segment, search the first position without a row
+        iter->SeekToFirst();
+        if (!iter->Valid()) return 0;
+        // the row at lo is valid and the one at hi is not
+        uint64_t lo = 0;
+        uint64_t hi = 1;
+        for (iter->SeekToPosition(hi); iter->Valid(); iter->SeekToPosition(hi)) {
+            lo = hi;
+            hi *= 2;
+        }
+        while (lo + 1 < hi) {
+            uint64_t mid = lo + (hi - lo) / 2;
+            iter->SeekToPosition(mid);
+            if (iter->Valid()) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        return hi;
+    }
     uint64_t cnt = 0;
     while (iter->Valid()) {
         cnt++;
@@ -19,6 +19,7 @@
 
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -72,9 +73,7 @@ class TabletSegmentHandler : public ::hybridse::vm::TableHandler {
     ::hybridse::vm::Row At(uint64_t pos) override {
         auto iter = GetIterator();
         if (!iter) return ::hybridse::vm::Row();
-        while (pos-- > 0 && iter->Valid()) {
-            iter->Next();
-        }
+        iter->SeekToPosition(pos);
         return iter->Valid() ? iter->GetValue() : ::hybridse::vm::Row();
     }
     const std::string GetHandlerTypeName() override { return "TabletSegmentHandler"; }
@@ -240,8 +239,14 @@ class TabletCatalog : public ::hybridse::vm::Catalog {
 
     bool DeleteDB(const std::string &db);
 
+    // updated_tables is set to the (db, table) pairs whose indexes changed or which are deleted
     void Refresh(const std::vector<::openmldb::nameserver::TableInfo> &table_info_vec, uint64_t version,
-                 const Procedures &db_sp_map, bool* updated);
+                 const Procedures &db_sp_map, std::set<std::pair<std::string, std::string>>* updated_tables);
+
+    // same as Refresh, but only with the tables changed and removed since the last refresh
+    void RefreshDelta(const std::vector<::openmldb::nameserver::TableInfo> &changed,
+                      const std::vector<std::pair<std::string, std::string>> &removed, uint64_t version,
+                      const Procedures &db_sp_map, std::set<std::pair<std::string, std::string>> *updated_tables);
 
     bool AddProcedure(const std::string &db, const std::string &sp_name,
                       const std::shared_ptr<hybridse::sdk::ProcedureInfo> &sp_info);
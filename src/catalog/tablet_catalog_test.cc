@@ -314,6 +314,32 @@ TEST_F(TabletCatalogTest, segment_handler_test) {
     }
 }
 
+TEST_F(TabletCatalogTest, segment_handler_position_test) {
+    TestArgs args = PrepareMultiPartitionTable("t1", 1);
+    auto handler = std::shared_ptr<TabletTableHandler>(
+        new TabletTableHandler(args.meta[0], std::shared_ptr<hybridse::vm::Tablet>()));
+    ClientManager client_manager;
+    ASSERT_TRUE(handler->Init(client_manager));
+    handler->AddTable(args.tables[0]);
+    auto partition = handler->GetPartition(args.idx_name);
+    auto segment = partition->GetSegment("pk100");
+    auto iter = segment->GetIterator();
+    ASSERT_TRUE(iter && iter->IsPositionSeekable());
+    ASSERT_EQ(5u, segment->GetCount());
+    uint64_t pos = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        ASSERT_EQ(iter->GetValue().ToString(), segment->At(pos).ToString());
+        pos++;
+    }
+    ASSERT_EQ(5u, pos);
+    iter->SeekToPosition(3);
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(1589780888001u, iter->GetKey());
+    iter->SeekToPosition(5);
+    ASSERT_FALSE(iter->Valid());
+    ASSERT_EQ(0, segment->At(5).size());
+}
+
 TEST_F(TabletCatalogTest, add_drop_test) {
     TestArgs args = PrepareTable("t1");
     std::shared_ptr<TabletCatalog> catalog(new TabletCatalog());
@@ -49,6 +49,8 @@ TabletClient::~TabletClient() {}
 
 int TabletClient::Init() { return client_.Init(); }
 
+int TabletClient::Init(const std::string& connection_group) { return client_.Init(connection_group); }
+
 bool TabletClient::Query(const std::string& db, const std::string& sql, const std::string& row, brpc::Controller* cntl,
                          openmldb::api::QueryResponse* response, const bool is_debug) {
     if (cntl == NULL || response == NULL) return false;
@@ -59,11 +61,15 @@ bool TabletClient::Query(const std::string& db, const std::string& sql, const st
     request.set_is_debug(is_debug);
     request.set_row_size(row.size());
     request.set_row_slices(1);
+    request.set_accept_compress_type(::openmldb::type::kSnappy);
     auto& io_buf = cntl->request_attachment();
     if (!codec::EncodeRpcRow(reinterpret_cast<const int8_t*>(row.data()), row.size(), &io_buf)) {
         LOG(WARNING) << "Encode row buffer failed";
         return false;
     }
+    if (cntl->timeout_ms() > 0) {
+        request.set_timeout_ms(cntl->timeout_ms());
+    }
     bool ok = client_.SendRequest(&::openmldb::api::TabletServer_Stub::Query, cntl, &request, response);
     if (!ok || response->code() != 0) {
         LOG(WARNING) << "fail to query tablet";
@@ -76,7 +82,8 @@ bool TabletClient::Query(const std::string& db, const std::string& sql,
                          hybridse::vm::EngineMode default_mode,
                          const std::vector<openmldb::type::DataType>& parameter_types,
                          const std::string& parameter_row,
-                         brpc::Controller* cntl, ::openmldb::api::QueryResponse* response, const bool is_debug) {
+                         brpc::Controller* cntl, ::openmldb::api::QueryResponse* response, const bool is_debug,
+                         uint32_t page_byte_size) {
     if (cntl == NULL || response == NULL) return false;
     ::openmldb::api::QueryRequest request;
     request.set_sql(sql);
@@ -85,6 +92,8 @@ bool TabletClient::Query(const std::string& db, const std::string& sql,
     request.set_is_debug(is_debug);
     request.set_parameter_row_size(parameter_row.size());
     request.set_parameter_row_slices(1);
+    request.set_page_byte_size(page_byte_size);
+    request.set_accept_compress_type(::openmldb::type::kSnappy);
     for (auto& type : parameter_types) {
         request.add_parameter_types(type);
     }
@@ -93,6 +102,9 @@ bool TabletClient::Query(const std::string& db, const std::string& sql,
         LOG(WARNING) << "Encode parameter buffer failed";
         return false;
     }
+    if (cntl->timeout_ms() > 0) {
+        request.set_timeout_ms(cntl->timeout_ms());
+    }
     bool ok = client_.SendRequest(&::openmldb::api::TabletServer_Stub::Query, cntl, &request, response);
 
     if (!ok || response->code() != 0) {
@@ -102,6 +114,39 @@ bool TabletClient::Query(const std::string& db, const std::string& sql,
     return true;
 }
 
+bool TabletClient::FetchQueryResult(const std::string& db, uint64_t result_id, uint32_t page_byte_size,
+                                    brpc::Controller* cntl, ::openmldb::api::QueryResponse* response) {
+    if (cntl == NULL || response == NULL) return false;
+    ::openmldb::api::QueryRequest request;
+    request.set_db(db);
+    request.set_is_batch(true);
+    request.set_result_id(result_id);
+    request.set_page_byte_size(page_byte_size);
+    request.set_accept_compress_type(::openmldb::type::kSnappy);
+    bool ok = client_.SendRequest(&::openmldb::api::TabletServer_Stub::Query, cntl, &request, response);
+    if (!ok || response->code() != 0) {
+        LOG(WARNING) << "fail to fetch query result " << result_id;
+        return false;
+    }
+    return true;
+}
+
+bool TabletClient::ReleaseQueryResult(const std::string& db, uint64_t result_id, brpc::Controller* cntl,
+                                      ::openmldb::api::QueryResponse* response) {
+    if (cntl == NULL || response == NULL) return false;
+    ::openmldb::api::QueryRequest request;
+    request.set_db(db);
+    request.set_is_batch(true);
+    request.set_result_id(result_id);
+    request.set_release_result(true);
+    bool ok = client_.SendRequest(&::openmldb::api::TabletServer_Stub::Query, cntl, &request, response);
+    if (!ok || response->code() != 0) {
+        LOG(WARNING) << "fail to release query result " << result_id;
+        return false;
+    }
+    return true;
+}
+
 /**
  * Utility function to encode row batch data into rpc attachment buffer
  */
@@ -149,6 +194,9 @@ bool TabletClient::SQLBatchRequestQuery(const std::string& db, const std::string
     if (!EncodeRowBatch(row_batch, &request, &io_buf)) {
         return false;
     }
+    if (cntl->timeout_ms() > 0) {
+        request.set_timeout_ms(cntl->timeout_ms());
+    }
 
     bool ok = client_.SendRequest(&::openmldb::api::TabletServer_Stub::SQLBatchRequestQuery, cntl, &request, response);
     if (!ok || response->code() != ::openmldb::base::kOk) {
@@ -1205,12 +1253,16 @@ bool TabletClient::CallProcedure(const std::string& db, const std::string& sp_na
     request.set_is_procedure(true);
     request.set_row_size(row.size());
     request.set_row_slices(1);
+    request.set_accept_compress_type(::openmldb::type::kSnappy);
     cntl->set_timeout_ms(timeout_ms);
     auto& io_buf = cntl->request_attachment();
     if (!codec::EncodeRpcRow(reinterpret_cast<const int8_t*>(row.data()), row.size(), &io_buf)) {
         LOG(WARNING) << "encode row buf failed";
         return false;
     }
+    if (cntl->timeout_ms() > 0) {
+        request.set_timeout_ms(cntl->timeout_ms());
+    }
     bool ok = client_.SendRequest(&::openmldb::api::TabletServer_Stub::Query, cntl, &request, response);
     if (!ok || response->code() != 0) {
         LOG(WARNING) << "fail to query tablet";
@@ -1255,6 +1307,9 @@ bool TabletClient::CallSQLBatchRequestProcedure(const std::string& db, const std
     if (!EncodeRowBatch(row_batch, &request, &io_buf)) {
         return false;
     }
+    if (cntl->timeout_ms() > 0) {
+        request.set_timeout_ms(cntl->timeout_ms());
+    }
 
     bool ok = client_.SendRequest(&::openmldb::api::TabletServer_Stub::SQLBatchRequestQuery, cntl, &request, response);
     if (!ok || response->code() != ::openmldb::base::kOk) {
@@ -1300,6 +1355,7 @@ base::Status TabletClient::CallSQLBatchRequestProcedure(const std::string& db, c
     request.set_is_debug(is_debug);
     request.set_common_slices(0);
     request.set_non_common_slices(1);
+    request.set_timeout_ms(timeout_ms);
     cntl->set_timeout_ms(timeout_ms);
     if (!ParseBatchRequestMeta(meta, data, &request)) {
         return {base::ReturnCode::kError, "parse meta data failed"};
@@ -1337,6 +1393,7 @@ base::Status TabletClient::CallSQLBatchRequestProcedure(
         return {base::ReturnCode::kError, "append to iobuf error"};
     }
     callback->GetController()->set_timeout_ms(timeout_ms);
+    request.set_timeout_ms(timeout_ms);
     if (!client_.SendRequest(&::openmldb::api::TabletServer_Stub::SQLBatchRequestQuery, callback->GetController().get(),
                              &request, callback->GetResponse().get(), callback)) {
         return {base::ReturnCode::kError, "stub is null"};
@@ -1371,12 +1428,14 @@ bool TabletClient::CallProcedure(const std::string& db, const std::string& sp_na
     request.set_is_procedure(true);
     request.set_row_size(row.size());
     request.set_row_slices(1);
+    request.set_accept_compress_type(::openmldb::type::kSnappy);
     auto& io_buf = callback->GetController()->request_attachment();
     if (!codec::EncodeRpcRow(reinterpret_cast<const int8_t*>(row.data()), row.size(), &io_buf)) {
         LOG(WARNING) << "Encode row buf failed";
         return false;
     }
     callback->GetController()->set_timeout_ms(timeout_ms);
+    request.set_timeout_ms(timeout_ms);
     return client_.SendRequest(&::openmldb::api::TabletServer_Stub::Query, callback->GetController().get(), &request,
                                callback->GetResponse().get(), callback);
 }
@@ -1399,6 +1458,7 @@ bool TabletClient::CallSQLBatchRequestProcedure(
     }
 
     callback->GetController()->set_timeout_ms(timeout_ms);
+    request.set_timeout_ms(timeout_ms);
     return client_.SendRequest(&::openmldb::api::TabletServer_Stub::SQLBatchRequestQuery,
                                callback->GetController().get(), &request, callback->GetResponse().get(), callback);
 }
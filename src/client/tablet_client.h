@@ -56,6 +56,12 @@ class TabletClient : public Client {
 
     int Init() override;
 
+    // init with a channel in the connection group, see RpcClient::Init
+    int Init(const std::string& connection_group);
+
+    // the number of requests sent by the client and not finished yet
+    int32_t GetInflight() const { return client_.GetInflight(); }
+
     base::Status CreateTable(const ::openmldb::api::TableMeta& table_meta);
 
     base::Status TruncateTable(uint32_t tid, uint32_t pid);
@@ -64,9 +70,19 @@ class TabletClient : public Client {
                                     const openmldb::common::VersionPair& pair,
                                     std::string& msg);  // NOLINT
 
+    // page_byte_size > 0 asks the tablet to send the result of a batch query in pages
     bool Query(const std::string& db, const std::string& sql, hybridse::vm::EngineMode default_mode,
                const std::vector<openmldb::type::DataType>& parameter_types, const std::string& parameter_row,
-               brpc::Controller* cntl, ::openmldb::api::QueryResponse* response, const bool is_debug = false);
+               brpc::Controller* cntl, ::openmldb::api::QueryResponse* response, const bool is_debug = false,
+               uint32_t page_byte_size = 0);
+
+    // fetch the next page of a paged query result
+    bool FetchQueryResult(const std::string& db, uint64_t result_id, uint32_t page_byte_size, brpc::Controller* cntl,
+                          ::openmldb::api::QueryResponse* response);
+
+    // drop the pages of a paged query result which are not fetched yet
+    bool ReleaseQueryResult(const std::string& db, uint64_t result_id, brpc::Controller* cntl,
+                            ::openmldb::api::QueryResponse* response);
 
     bool Query(const std::string& db, const std::string& sql, const std::string& row, brpc::Controller* cntl,
                ::openmldb::api::QueryResponse* response, const bool is_debug = false);
@@ -18,6 +18,7 @@
 
 #include <unistd.h>
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <limits>
@@ -25,6 +26,8 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "absl/algorithm/container.h"
 #include "absl/cleanup/cleanup.h"
@@ -2021,6 +2024,93 @@ TEST_P(DBSDKTest, DeployLongWindowsWithExcludeCurrentRow) {
     ASSERT_TRUE(ok);
 }
 
+TEST_P(DBSDKTest, DeployLongWindowsMultiLevel) {
+    auto cli = GetParam();
+    cs = cli->cs;
+    sr = cli->sr;
+    ::hybridse::sdk::Status status;
+    sr->ExecuteSQL("SET @@execute_mode='online';", &status);
+    std::string base_table = "t_lw" + GenRand();
+    std::string base_db = "d_lw" + GenRand();
+    ASSERT_TRUE(sr->CreateDB(base_db, &status)) << status.msg;
+    std::string ddl = "create table " + base_table +
+                      "(col1 string, col3 timestamp, i64_col bigint,"
+                      " index(key=col1, ts=col3, abs_ttl=0, ttl_type=absolute));";
+    ASSERT_TRUE(sr->ExecuteDDL(base_db, ddl, &status)) << status.msg;
+    ASSERT_TRUE(sr->RefreshCatalog());
+    sr->ExecuteSQL(base_db, "use " + base_db + ";", &status);
+    ASSERT_TRUE(status.IsOK()) << status.msg;
+
+    // the same window merged from 30d, 1d and 1h buckets, from 1h buckets only and from the base table only
+    std::string select_sql = " select col1, sum(i64_col) over w1 as w1_sum, count(i64_col) over w1 as w1_cnt,"
+                             " max(i64_col) over w1 as w1_max from " +
+                             base_table +
+                             " WINDOW w1 AS (PARTITION BY col1 ORDER BY col3"
+                             " ROWS_RANGE BETWEEN 100d PRECEDING AND CURRENT ROW);";
+    std::vector<std::string> deployments = {"lw_multi", "lw_single", "lw_none"};
+    sr->ExecuteSQL(base_db, "deploy lw_multi options(long_windows='w1:1h|1d|30d')" + select_sql, &status);
+    ASSERT_TRUE(status.IsOK()) << status.msg;
+    sr->ExecuteSQL(base_db, "deploy lw_single options(long_windows='w1:1h')" + select_sql, &status);
+    ASSERT_TRUE(status.IsOK()) << status.msg;
+    sr->ExecuteSQL(base_db, "deploy lw_none" + select_sql, &status);
+    ASSERT_TRUE(status.IsOK()) << status.msg;
+
+    // about 156 days of rows, the timestamps are aligned to none of the buckets
+    const int64_t hour = 3600 * 1000l;
+    const int64_t day = 24 * hour;
+    const int64_t ts0 = 1600000000123l;
+    const int64_t step = 5 * hour + 13 * 60 * 1000 + 7 * 1000;
+    std::vector<std::pair<int64_t, int64_t>> rows;
+    for (int i = 0; i < 720; i++) {
+        rows.emplace_back(ts0 + i * step, (i * 37) % 101);
+        for (const std::string key : {"k1", "k2"}) {
+            std::string insert = absl::StrCat("insert into ", base_table, " values('", key, "', ", rows.back().first,
+                                              ", ", key == "k1" ? rows.back().second : 1000, ");");
+            ASSERT_TRUE(sr->ExecuteInsert(base_db, insert, &status)) << status.msg;
+        }
+    }
+
+    // the window bounds fall inside the coarse buckets, and the last one needs the unflushed buckets
+    std::vector<int64_t> req_ts_list = {ts0 + 120 * day + 37 * 60 * 1000 + 13 * 1000, ts0 + 101 * day + 11 * hour,
+                                        ts0 + 50 * day, ts0 + 153 * day + 17 * 1000, rows.back().first + hour};
+    for (int64_t req_ts : req_ts_list) {
+        int64_t exp_sum = 5;
+        int64_t exp_cnt = 1;
+        int64_t exp_max = 5;
+        for (const auto& [ts, val] : rows) {
+            if (ts >= req_ts - 100 * day && ts <= req_ts) {
+                exp_sum += val;
+                exp_cnt++;
+                exp_max = std::max(exp_max, val);
+            }
+        }
+        for (const auto& deployment : deployments) {
+            auto req = sr->GetRequestRowByProcedure(base_db, deployment, &status);
+            ASSERT_TRUE(status.IsOK()) << status.msg;
+            ASSERT_TRUE(req->Init(strlen("k1")));
+            ASSERT_TRUE(req->AppendString("k1"));
+            ASSERT_TRUE(req->AppendTimestamp(req_ts));
+            ASSERT_TRUE(req->AppendInt64(5));
+            ASSERT_TRUE(req->Build());
+            auto res = sr->CallProcedure(base_db, deployment, req, &status);
+            ASSERT_TRUE(status.IsOK()) << status.msg;
+            ASSERT_EQ(1, res->Size());
+            ASSERT_TRUE(res->Next());
+            ASSERT_EQ("k1", res->GetStringUnsafe(0));
+            ASSERT_EQ(exp_sum, res->GetInt64Unsafe(1)) << deployment << " " << req_ts;
+            ASSERT_EQ(exp_cnt, res->GetInt64Unsafe(2)) << deployment << " " << req_ts;
+            ASSERT_EQ(exp_max, res->GetInt64Unsafe(3)) << deployment << " " << req_ts;
+        }
+    }
+
+    for (const auto& deployment : deployments) {
+        sr->ExecuteSQL(base_db, "drop deployment " + deployment + ";", &status);
+        ASSERT_TRUE(status.IsOK()) << status.msg;
+    }
+    ASSERT_TRUE(sr->ExecuteDDL(base_db, "drop table " + base_table + ";", &status)) << status.msg;
+    ASSERT_TRUE(sr->DropDB(base_db, &status)) << status.msg;
+}
+
 TEST_P(DBSDKTest, DeployLongWindowsExecuteSum) {
     auto cli = GetParam();
     cs = cli->cs;
@@ -172,6 +172,29 @@ class RowView {
 
     int32_t GetInteger(const int8_t* row, uint32_t idx, ::openmldb::type::DataType type, int64_t* val) const;
 
+    // decode the values of the fixed size column idx of rows into vals, the null values are skipped.
+    // return the number of the null values, or -1 if the column is not of type or a row is invalid
+    template <typename T>
+    int32_t GetValues(const std::vector<const int8_t*>& rows, uint32_t idx, ::openmldb::type::DataType type,
+                      std::vector<T>* vals) const {
+        if ((int32_t)idx >= schema_.size() || schema_.Get(idx).data_type() != type) {
+            return -1;
+        }
+        uint32_t offset = offset_vec_.at(idx);
+        int32_t null_cnt = 0;
+        for (const int8_t* row : rows) {
+            if (row == NULL || GetSize(row) <= HEADER_LENGTH) {
+                return -1;
+            }
+            if (IsNULL(row, idx)) {
+                null_cnt++;
+                continue;
+            }
+            vals->push_back(*(reinterpret_cast<const T*>(row + offset)));
+        }
+        return null_cnt;
+    }
+
     int32_t GetValue(const int8_t* row, uint32_t idx, char** val, uint32_t* length) const;
 
     int32_t GetStrValue(const int8_t* row, uint32_t idx, std::string* val) const;
@@ -16,6 +16,8 @@
 
 #include "codec/sql_rpc_row_codec.h"
 
+#include <snappy.h>
+
 namespace openmldb {
 namespace codec {
 
@@ -105,5 +107,30 @@ bool EncodeRpcRow(const int8_t* buf, size_t size, butil::IOBuf* io_buf) {
     return true;
 }
 
+bool CompressRpcRows(butil::IOBuf* buf) {
+    // the null fields and the small numbers of wide rows are mostly zero bytes, which snappy packs well
+    std::string raw = buf->to_string();
+    std::string compressed;
+    ::snappy::Compress(raw.data(), raw.size(), &compressed);
+    if (compressed.size() >= raw.size()) {
+        return false;
+    }
+    buf->clear();
+    buf->append(compressed);
+    return true;
+}
+
+bool UncompressRpcRows(butil::IOBuf* buf) {
+    std::string compressed = buf->to_string();
+    std::string raw;
+    if (!::snappy::Uncompress(compressed.data(), compressed.size(), &raw)) {
+        LOG(WARNING) << "Uncompress rows of size " << compressed.size() << " failed";
+        return false;
+    }
+    buf->clear();
+    buf->append(raw);
+    return true;
+}
+
 }  // namespace codec
 }  // namespace openmldb
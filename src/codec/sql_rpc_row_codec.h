@@ -37,6 +37,12 @@ bool EncodeRpcRow(const hybridse::codec::Row& row, butil::IOBuf* buf, size_t* to
 
 bool EncodeRpcRow(const int8_t* buf, size_t size, butil::IOBuf* io_buf);
 
+// compress the rows in buf with snappy in place, buf is left as is and false is returned if it does not shrink
+bool CompressRpcRows(butil::IOBuf* buf);
+
+// uncompress the rows in buf compressed by CompressRpcRows in place
+bool UncompressRpcRows(butil::IOBuf* buf);
+
 }  // namespace codec
 }  // namespace openmldb
 #endif  // SRC_CODEC_SQL_RPC_ROW_CODEC_H_
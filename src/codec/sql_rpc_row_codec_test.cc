@@ -123,6 +123,41 @@ TEST_F(SqlRpcRowCodecTest, TestMultiSlice) {
     ASSERT_EQ(0, decoded.size(3));
 }
 
+TEST_F(SqlRpcRowCodecTest, TestCompressRows) {
+    hybridse::codec::Schema schema;
+    for (int i = 0; i < 100; i++) {
+        auto column = schema.Add();
+        column->set_name("col_" + std::to_string(i));
+        column->set_type(hybridse::type::kDouble);
+    }
+    hybridse::codec::RowBuilder builder(schema);
+    uint32_t row_size = builder.CalTotalLength(0);
+    butil::IOBuf iobuf;
+    for (int i = 0; i < 10; i++) {
+        std::string buf(row_size, '\0');
+        builder.SetBuffer(reinterpret_cast<int8_t*>(&buf[0]), row_size);
+        for (int j = 0; j < 100; j++) {
+            if (j % 2 == 0) {
+                builder.AppendNULL();
+            } else {
+                builder.AppendDouble(i * j);
+            }
+        }
+        ASSERT_TRUE(EncodeRpcRow(reinterpret_cast<const int8_t*>(buf.data()), buf.size(), &iobuf));
+    }
+    std::string raw = iobuf.to_string();
+    ASSERT_TRUE(CompressRpcRows(&iobuf));
+    ASSERT_LT(iobuf.size(), raw.size());
+    ASSERT_TRUE(UncompressRpcRows(&iobuf));
+    ASSERT_EQ(raw, iobuf.to_string());
+
+    // the buf is left as is if it does not shrink
+    butil::IOBuf small;
+    small.append("ab");
+    ASSERT_FALSE(CompressRpcRows(&small));
+    ASSERT_EQ("ab", small.to_string());
+}
+
 }  // namespace codec
 }  // namespace openmldb
 
@@ -56,6 +56,10 @@ DEFINE_uint32(name_server_task_concurrency, 2, "config the concurrency of name_s
 DEFINE_uint32(name_server_task_concurrency_for_replica_cluster, 2,
               "config the concurrency of name_server_task for replica cluster");
 DEFINE_uint32(name_server_task_max_concurrency, 8, "config the max concurrency of name_server_task");
+DEFINE_uint32(name_server_op_parallelism, 1,
+              "config the max number of independent ops running at the same time in one task queue");
+DEFINE_uint32(name_server_op_concurrency_per_tablet, 4,
+              "config the max number of ops running on one tablet at the same time, 0 means unlimited");
 DEFINE_int32(name_server_task_wait_time, 1000, "config the time of task wait. unit is milliseconds");
 DEFINE_uint32(name_server_op_execute_timeout, 2 * 60 * 60 * 1000,
               "config the timeout of nameserver op. unit is milliseconds");
@@ -64,10 +68,21 @@ DEFINE_int32(max_op_num, 10000, "config the max op num");
 DEFINE_uint32(partition_num, 8, "config the default partition_num");
 DEFINE_uint32(replica_num, 3, "config the default replica_num. if set 3, there is one leader and two followers");
 DEFINE_uint32(system_table_replica_num, 1, "config the default replica_num of system table.");
+DEFINE_bool(enable_load_aware_placement, false,
+            "place new partitions by the memory usage and partition count of tablets instead of partition count only");
+DEFINE_bool(enable_auto_rebalance, false, "enable or disable rebalancing partitions by the memory usage of tablets");
+DEFINE_uint32(auto_rebalance_interval, 10 * 60 * 1000, "config the interval of auto rebalance. unit is milliseconds");
+DEFINE_double(auto_rebalance_threshold, 0.2,
+              "rebalance if the memory spread between tablets exceeds threshold * average memory of tablets");
+DEFINE_uint32(auto_rebalance_max_op_num, 2, "config the max number of migrate/changeleader ops in one rebalance");
 DEFINE_int32(gc_interval, 120, "the gc interval of tablet every two hour");
 DEFINE_int32(disk_gc_interval, 120, "the rocksdb gc interval of tablet");
 DEFINE_int32(gc_pool_size, 2, "the size of tablet gc thread pool");
 DEFINE_int32(gc_safe_offset, 1, "the safe offset of tablet gc in minute");
+DEFINE_uint64(gc_incremental_max_keys, 0,
+              "the max number of keys swept per index and segment in one incremental gc tick of a memory table, "
+              "0 means sweeping the whole table in one go");
+DEFINE_uint32(gc_incremental_tick_ms, 200, "the interval between two incremental gc ticks of a memory table");
 DEFINE_uint64(gc_on_table_recover_count, 10000000, "make a gc on recover count");
 DEFINE_uint32(gc_deleted_pk_version_delta, 2, "config the gc version delta");
 DEFINE_double(mem_release_rate, 5, "specify memory release rate, which should be in 0 ~ 10");
@@ -76,13 +91,49 @@ DEFINE_int32(io_pool_size, 2, "the size of tablet io task thread pool");
 DEFINE_bool(use_name, false, "enable or disable use server name");
 DEFINE_string(data_dir, "./data", "the path of data dir");
 DEFINE_bool(enable_distsql, false, "enable or disable distribute sql");
+DEFINE_bool(enable_window_column_pruning, false,
+            "enable or disable reading only the referenced columns into the windows of deployments");
 DEFINE_bool(enable_localtablet, true, "enable or disable local tablet opt when distribute sql circumstance");
 DEFINE_string(bucket_size, "1d", "the default bucket size in pre-aggr table");
+DEFINE_bool(enable_async_aggr_update, false,
+            "enable or disable updating the pre-aggr tables on dedicated threads instead of the put path");
+DEFINE_uint32(aggr_update_thread_num, 4, "the number of threads to update the pre-aggr tables asynchronously");
+DEFINE_uint64(aggr_update_max_pending, 100000,
+              "the max number of queued async pre-aggr updates, puts wait when it is reached. 0 means no limit");
 
 // scan configuration
 // max bytes size: write all even if scan result is too large, let it fail in client(receiver)
 DEFINE_uint32(scan_max_bytes_size, 0, "config the max size of scan bytes size, 0 means unlimit");
 DEFINE_uint32(scan_reserve_size, 1024, "config the size of vec reserve");
+// query admission configuration
+DEFINE_uint32(query_admission_max_slots, 0,
+              "the max slots of the queries running on a tablet, a deployment takes one slot and an ad-hoc query takes "
+              "slots by its estimated cost. 0 means no admission control");
+DEFINE_uint32(query_admission_adhoc_max_slots, 0,
+              "the max slots of the running ad-hoc queries, 0 means half of query_admission_max_slots");
+DEFINE_uint64(query_admission_rows_per_slot, 1000000,
+              "an ad-hoc query takes one more slot for every query_admission_rows_per_slot rows scanned or windows "
+              "built");
+DEFINE_uint32(request_coalesce_max_wait_ms, 0,
+              "the identical deployment requests arriving at the same time share one execution, a request waits the "
+              "running one at most the time and then executes by itself. only the deployments whose tables have all "
+              "partitions on the tablet are coalesced. 0 means no coalescing");
+DEFINE_uint32(request_batch_window_us, 0,
+              "the single row requests of a deployment arriving in the window run in one batch request, a larger "
+              "window makes larger batches at the cost of latency. 0 means no batching");
+DEFINE_uint32(request_batch_max_size, 64, "a batch of deployment requests runs at once when it has the rows");
+DEFINE_uint32(result_compress_threshold, 0,
+              "the query result larger than the bytes is compressed with snappy if the client accepts it. 0 means no "
+              "compression");
+DEFINE_uint32(deploy_profile_sample_interval, 0,
+              "one of every the number of deployment requests records the time spent in each runner of its plan. 0 "
+              "means no profiling");
+// paged batch query result configuration
+DEFINE_uint32(query_result_max_pending, 64, "the max number of the paged batch query results kept on a tablet");
+DEFINE_uint64(query_result_max_pending_byte_size, 1073741824,
+              "the max bytes of the rows not sent yet of the paged batch query results on a tablet, 0 means unlimited");
+DEFINE_uint64(query_result_idle_timeout_ms, 60000,
+              "a paged batch query result is dropped if its next page is not fetched in the time");
 DEFINE_uint32(preview_limit_max_num, 1000, "config the max num of preview limit");
 DEFINE_uint32(preview_default_limit, 100, "config the default limit of preview");
 // binlog configuration
@@ -119,6 +170,15 @@ DEFINE_uint32(max_memory_mb, 0, "max memory limit");
 DEFINE_uint32(max_traverse_key_cnt, 0, "max traverse iter key cnt");
 DEFINE_uint32(max_traverse_cnt, 0, "max traverse iter loop cnt");
 DEFINE_uint32(traverse_cnt_limit, 1000, "limit traverse cnt");
+DEFINE_bool(enable_hot_key_sampling, false, "enable or disable sampling the routing key of deployment requests");
+DEFINE_uint32(hot_key_sketch_width, 4096, "the width of the count-min sketch of hot key sampling");
+DEFINE_uint32(hot_key_sketch_depth, 4, "the depth of the count-min sketch of hot key sampling");
+DEFINE_uint32(hot_key_decay_interval, 100000, "the sketch counters are halved every the number of sampled requests");
+DEFINE_uint32(hot_key_threshold, 32, "a key whose estimated count reaches the threshold is hot");
+DEFINE_uint32(hot_key_top_k, 16, "the number of hot keys kept for every deployment");
+DEFINE_uint64(window_cache_capacity, 0,
+              "the capacity of the window cache of hot keys in bytes. 0 means the window cache is disabled");
+DEFINE_uint32(window_cache_max_rows_per_key, 1000, "the key with more rows than this value will not be cached");
 DEFINE_string(ssd_root_path, "", "the root ssd path of db");
 DEFINE_string(hdd_root_path, "", "the root hdd path of db");
 
@@ -129,6 +189,11 @@ DEFINE_int32(retry_send_file_wait_time_ms, 3000, "conf the wait time when retry
 DEFINE_int32(stream_close_wait_time_ms, 1000, "the wait time before close stream. unit is milliseconds");
 DEFINE_uint32(stream_block_size, 1 * 1204 * 1024, "config the write/read block size in streaming");
 DEFINE_int32(stream_bandwidth_limit, 10 * 1204 * 1024, "the limit bandwidth. Byte/Second");
+DEFINE_uint32(stream_max_inflight_blocks, 1,
+              "the max number of blocks in flight when sending a file. if greater than 1, blocks are sent "
+              "pipelined with checksum");
+DEFINE_uint32(stream_send_file_concurrency, 1, "the number of files sent in parallel when sending a directory");
+DEFINE_string(stream_compression, "off", "Type of block compression in file sending, can be off, snappy");
 
 // if set 23, the task will execute 23:00 every day
 DEFINE_int32(make_snapshot_time, 23, "config the time to make snapshot");
@@ -163,6 +228,7 @@ DEFINE_uint32(max_col_display_length, 256, "config the max length of column disp
 DEFINE_uint32(load_table_batch, 30, "set laod table batch size");
 DEFINE_uint32(load_table_thread_num, 3, "set load tabale thread pool size");
 DEFINE_uint32(load_table_queue_size, 1000, "set load tabale queue size");
+DEFINE_uint32(bulk_load_thread_num, 4, "the number of threads to load the segments of a bulk load index region");
 
 // multiple data center
 DEFINE_uint32(get_replica_status_interval, 10000,
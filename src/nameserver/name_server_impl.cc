@@ -17,16 +17,19 @@
 #include "nameserver/name_server_impl.h"
 
 #include <algorithm>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <random>
 #include <set>
+#include <tuple>
 #include <vector>
 
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "absl/time/time.h"
+#include "nameserver/partition_planner.h"
 #include "nameserver/system_table.h"
 #include "sdk/db_sdk.h"
 #include "statistics/query_response_time/deploy_query_response_time.h"
@@ -68,6 +71,8 @@ DECLARE_uint32(tablet_heartbeat_timeout);
 DECLARE_uint32(tablet_offline_check_interval);
 DECLARE_uint32(get_table_status_interval);
 DECLARE_uint32(name_server_task_max_concurrency);
+DECLARE_uint32(name_server_op_parallelism);
+DECLARE_uint32(name_server_op_concurrency_per_tablet);
 DECLARE_uint32(check_binlog_sync_progress_delta);
 DECLARE_uint32(name_server_op_execute_timeout);
 DECLARE_uint32(get_replica_status_interval);
@@ -75,6 +80,11 @@ DECLARE_int32(make_snapshot_time);
 DECLARE_int32(make_snapshot_check_interval);
 DECLARE_bool(use_name);
 DECLARE_bool(enable_distsql);
+DECLARE_bool(enable_load_aware_placement);
+DECLARE_bool(enable_auto_rebalance);
+DECLARE_uint32(auto_rebalance_interval);
+DECLARE_double(auto_rebalance_threshold);
+DECLARE_uint32(auto_rebalance_max_op_num);
 
 namespace openmldb {
 namespace nameserver {
@@ -524,7 +534,11 @@ NameServerImpl::NameServerImpl()
       task_thread_pool_(FLAGS_name_server_task_pool_size),
       rand_(0xdeadbeef),
       startup_mode_(::openmldb::type::StartupMode::kStandalone),
-      user_access_manager_(GetSystemTableIterator()) {}
+      user_access_manager_(GetSystemTableIterator()),
+      op_recorder_("nameserver", "op"),
+      op_started_cnt_("nameserver_op_started_count"),
+      op_failed_cnt_("nameserver_op_failed_count"),
+      op_running_cnt_("nameserver_op_running_count", 0) {}
 
 NameServerImpl::~NameServerImpl() {
     running_.store(false, std::memory_order_release);
@@ -1606,26 +1620,24 @@ int NameServerImpl::UpdateTaskStatus(bool is_recover_op) {
                 }
                 // clear the task in offline tablet
                 for (const auto& op_list : task_vec_) {
-                    if (op_list.empty()) {
-                        continue;
-                    }
-                    std::shared_ptr<OPData> op_data = op_list.front();
-                    if (op_data->task_list_.empty()) {
-                        continue;
-                    }
-                    // update task status
-                    std::shared_ptr<Task> task = op_data->task_list_.front();
-                    if (task->task_info_->status() != ::openmldb::api::kDoing) {
-                        continue;
-                    }
-                    if (task->task_info_->has_endpoint() && task->task_info_->endpoint() == iter->first) {
-                        PDLOG(WARNING,
-                              "tablet is offline. update task status from[kDoing] to[kFailed]. "
-                              "op_id[%lu], task_type[%s] endpoint[%s]",
-                              op_data->op_info_.op_id(),
-                              ::openmldb::api::TaskType_Name(task->task_info_->task_type()).c_str(),
-                              iter->first.c_str());
-                        task->task_info_->set_status(::openmldb::api::kFailed);
+                    for (const auto& op_data : GetActiveOPs(op_list)) {
+                        if (op_data->task_list_.empty()) {
+                            continue;
+                        }
+                        // update task status
+                        std::shared_ptr<Task> task = op_data->task_list_.front();
+                        if (task->task_info_->status() != ::openmldb::api::kDoing) {
+                            continue;
+                        }
+                        if (task->task_info_->has_endpoint() && task->task_info_->endpoint() == iter->first) {
+                            PDLOG(WARNING,
+                                  "tablet is offline. update task status from[kDoing] to[kFailed]. "
+                                  "op_id[%lu], task_type[%s] endpoint[%s]",
+                                  op_data->op_info_.op_id(),
+                                  ::openmldb::api::TaskType_Name(task->task_info_->task_type()).c_str(),
+                                  iter->first.c_str());
+                            task->task_info_->set_status(::openmldb::api::kFailed);
+                        }
                     }
                 }
             } else {
@@ -1706,48 +1718,47 @@ int NameServerImpl::UpdateTaskStatusRemote(bool is_recover_op) {
 
 int NameServerImpl::UpdateTask(const std::list<std::shared_ptr<OPData>>& op_list, const std::string& endpoint,
                                bool is_recover_op, const ::openmldb::api::TaskStatusResponse& response) {
-    if (op_list.empty()) {
-        return -1;
-    }
-    std::shared_ptr<OPData> op_data = op_list.front();
-    if (op_data->task_list_.empty()) {
-        return -1;
-    }
-    std::shared_ptr<Task> task = op_data->task_list_.front();
-    if (task->task_info_->status() != ::openmldb::api::kDoing) {
-        return -1;
+    int updated = -1;
+    for (const auto& op_data : GetActiveOPs(op_list)) {
+        if (op_data->task_list_.empty()) {
+            continue;
+        }
+        std::shared_ptr<Task> task = op_data->task_list_.front();
+        if (task->task_info_->status() != ::openmldb::api::kDoing) {
+            continue;
+        }
+        task->UpdateTaskStatus(response.task(), endpoint, is_recover_op);
+        updated = 1;
     }
-    task->UpdateTaskStatus(response.task(), endpoint, is_recover_op);
-    return 1;
+    return updated;
 }
 
 int NameServerImpl::UpdateZKTaskStatus() {
     std::lock_guard<std::mutex> lock(mu_);
     for (const auto& op_list : task_vec_) {
-        if (op_list.empty()) {
-            continue;
-        }
-        std::shared_ptr<OPData> op_data = op_list.front();
-        if (op_data->task_list_.empty()) {
-            continue;
-        }
-        std::shared_ptr<Task> task = op_data->task_list_.front();
-        task->UpdateStatusFromSubTask();
-        if (task->GetStatus() == ::openmldb::api::kDone) {
-            uint32_t cur_task_index = op_data->op_info_.task_index();
-            op_data->op_info_.set_task_index(cur_task_index + 1);
-            std::string value;
-            op_data->op_info_.SerializeToString(&value);
-            std::string node = absl::StrCat(zk_path_.op_data_path_, "/", op_data->op_info_.op_id());
-            if (zk_client_->SetNodeValue(node, value)) {
-                PDLOG(INFO, "set zk status value success. node[%s] value[%s]", node.c_str(), value.c_str());
-                op_data->task_list_.pop_front();
+        for (const auto& op_data : GetActiveOPs(op_list)) {
+            if (op_data->task_list_.empty()) {
                 continue;
             }
-            // revert task index
-            op_data->op_info_.set_task_index(cur_task_index);
-            PDLOG(WARNING, "set zk status value failed! node[%s] op_id[%lu] op_type[%s] task_index[%u]", node.c_str(),
-                  op_data->GetOpId(), op_data->GetReadableType().c_str(), op_data->op_info_.task_index());
+            std::shared_ptr<Task> task = op_data->task_list_.front();
+            task->UpdateStatusFromSubTask();
+            if (task->GetStatus() == ::openmldb::api::kDone) {
+                uint32_t cur_task_index = op_data->op_info_.task_index();
+                op_data->op_info_.set_task_index(cur_task_index + 1);
+                std::string value;
+                op_data->op_info_.SerializeToString(&value);
+                std::string node = absl::StrCat(zk_path_.op_data_path_, "/", op_data->op_info_.op_id());
+                if (zk_client_->SetNodeValue(node, value)) {
+                    PDLOG(INFO, "set zk status value success. node[%s] value[%s]", node.c_str(), value.c_str());
+                    op_data->task_list_.pop_front();
+                    continue;
+                }
+                // revert task index
+                op_data->op_info_.set_task_index(cur_task_index);
+                PDLOG(WARNING, "set zk status value failed! node[%s] op_id[%lu] op_type[%s] task_index[%u]",
+                      node.c_str(), op_data->GetOpId(), op_data->GetReadableType().c_str(),
+                      op_data->op_info_.task_index());
+            }
         }
     }
     return 0;
@@ -1794,36 +1805,35 @@ int NameServerImpl::DeleteTask() {
     {
         std::lock_guard<std::mutex> lock(mu_);
         for (const auto& op_list : task_vec_) {
-            if (op_list.empty()) {
-                continue;
-            }
-            std::shared_ptr<OPData> op_data = op_list.front();
-            if (op_data->task_list_.empty()) {
-                done_task_vec.push_back(op_data->op_info_.op_id());
-                // for multi cluster -- leader cluster judge
-                if (op_data->op_info_.for_replica_cluster() == 1) {
-                    done_task_vec_remote.push_back(op_data->op_info_.op_id());
-                }
-                // for multi cluster -- replica cluster judge
-                if (op_data->op_info_.has_remote_op_id()) {
-                    UpdateTaskMapStatus(op_data->op_info_.remote_op_id(), op_data->op_info_.op_id(),
-                                        ::openmldb::api::TaskStatus::kDone);
-                }
-            } else {
-                std::shared_ptr<Task> task = op_data->task_list_.front();
-                if (task->task_info_->status() == ::openmldb::api::kFailed ||
-                    op_data->op_info_.task_status() == ::openmldb::api::kCanceled) {
+            for (const auto& op_data : GetActiveOPs(op_list)) {
+                if (op_data->task_list_.empty()) {
                     done_task_vec.push_back(op_data->op_info_.op_id());
                     // for multi cluster -- leader cluster judge
                     if (op_data->op_info_.for_replica_cluster() == 1) {
                         done_task_vec_remote.push_back(op_data->op_info_.op_id());
                     }
                     // for multi cluster -- replica cluster judge
-                    PDLOG(WARNING, "task failed or canceled. op_id[%lu], task_type[%s]", task->task_info_->op_id(),
-                          ::openmldb::api::TaskType_Name(task->task_info_->task_type()).c_str());
                     if (op_data->op_info_.has_remote_op_id()) {
                         UpdateTaskMapStatus(op_data->op_info_.remote_op_id(), op_data->op_info_.op_id(),
-                                            task->task_info_->status());
+                                            ::openmldb::api::TaskStatus::kDone);
+                    }
+                } else {
+                    std::shared_ptr<Task> task = op_data->task_list_.front();
+                    if (task->task_info_->status() == ::openmldb::api::kFailed ||
+                        op_data->op_info_.task_status() == ::openmldb::api::kCanceled) {
+                        done_task_vec.push_back(op_data->op_info_.op_id());
+                        // for multi cluster -- leader cluster judge
+                        if (op_data->op_info_.for_replica_cluster() == 1) {
+                            done_task_vec_remote.push_back(op_data->op_info_.op_id());
+                        }
+                        // for multi cluster -- replica cluster judge
+                        PDLOG(WARNING, "task failed or canceled. op_id[%lu], task_type[%s]",
+                              task->task_info_->op_id(),
+                              ::openmldb::api::TaskType_Name(task->task_info_->task_type()).c_str());
+                        if (op_data->op_info_.has_remote_op_id()) {
+                            UpdateTaskMapStatus(op_data->op_info_.remote_op_id(), op_data->op_info_.op_id(),
+                                                task->task_info_->status());
+                        }
                     }
                 }
             }
@@ -1921,6 +1931,7 @@ void NameServerImpl::DeleteTask(const std::vector<uint64_t>& done_task_vec) {
             }
             done_op_list_.push_back(op_data);
             task_vec_[index].erase(iter);
+            op_failed_cnt_ << 1;
             PDLOG(INFO, "delete op[%lu] in running op", op_id);
         } else {
             if (zk_client_->DeleteNode(node)) {
@@ -1929,6 +1940,8 @@ void NameServerImpl::DeleteTask(const std::vector<uint64_t>& done_task_vec) {
                 if (op_data->GetTaskStatus() == ::openmldb::api::kDoing) {
                     op_data->SetTaskStatus(::openmldb::api::kDone);
                     op_data->task_list_.clear();
+                    // start_time and end_time are in seconds
+                    op_recorder_ << (op_data->op_info_.end_time() - op_data->op_info_.start_time()) * 1000000;
                 }
                 done_op_list_.push_back(op_data);
                 task_vec_[index].erase(iter);
@@ -1940,6 +1953,134 @@ void NameServerImpl::DeleteTask(const std::vector<uint64_t>& done_task_vec) {
     }
 }
 
+std::vector<std::shared_ptr<OPData>> NameServerImpl::GetActiveOPs(
+    const std::list<std::shared_ptr<OPData>>& op_list) {
+    std::vector<std::shared_ptr<OPData>> active_ops;
+    for (auto iter = op_list.begin(); iter != op_list.end(); ++iter) {
+        if (iter == op_list.begin() || (*iter)->GetTaskStatus() == ::openmldb::api::kDoing) {
+            active_ops.push_back(*iter);
+        }
+    }
+    return active_ops;
+}
+
+std::vector<std::shared_ptr<OPData>> NameServerImpl::SelectRunnableOPs(
+    const std::list<std::shared_ptr<OPData>>& op_list, uint32_t parallelism, uint32_t concurrency_per_tablet,
+    std::map<std::string, uint32_t>* tablet_op_cnt) {
+    std::vector<std::shared_ptr<OPData>> ops;
+    // the first op always runs. the following ops run ahead only if they do not depend on the ops
+    // before them, i.e. they are in different partitions and are not the children of them.
+    // the first op takes a slot of parallelism even if it is failed or waiting to be deleted
+    std::set<std::tuple<std::string, std::string, uint32_t>> pending_partitions;
+    std::set<uint64_t> pending_ops;
+    for (auto iter = op_list.begin(); iter != op_list.end(); ++iter) {
+        const auto& op_data = *iter;
+        const auto& op_info = op_data->op_info_;
+        bool is_first = iter == op_list.begin();
+        bool is_running = op_data->GetTaskStatus() == ::openmldb::api::kDoing;
+        if (!is_first && !is_running) {
+            if (ops.size() >= parallelism) {
+                break;
+            }
+            bool can_run = op_info.pid() != INVALID_PID && op_info.for_replica_cluster() != 1 &&
+                           op_data->GetTaskStatus() == ::openmldb::api::kInited &&
+                           (!op_info.has_parent_id() || pending_ops.count(op_info.parent_id()) == 0) &&
+                           pending_partitions.count({op_info.db(), op_info.name(), op_info.pid()}) == 0;
+            std::set<std::string> endpoints;
+            if (can_run) {
+                endpoints = GetOPEndpoints(op_data);
+                for (const auto& endpoint : endpoints) {
+                    if (concurrency_per_tablet > 0 && (*tablet_op_cnt)[endpoint] >= concurrency_per_tablet) {
+                        can_run = false;
+                        break;
+                    }
+                }
+            }
+            if (!can_run) {
+                if (op_info.pid() == INVALID_PID) {
+                    // the op without pid works on the whole table, the ops after it must wait
+                    break;
+                }
+                pending_partitions.insert({op_info.db(), op_info.name(), op_info.pid()});
+                pending_ops.insert(op_info.op_id());
+                continue;
+            }
+            for (const auto& endpoint : endpoints) {
+                (*tablet_op_cnt)[endpoint]++;
+            }
+        }
+        ops.push_back(op_data);
+        if (op_info.pid() == INVALID_PID) {
+            break;
+        }
+        pending_partitions.insert({op_info.db(), op_info.name(), op_info.pid()});
+        pending_ops.insert(op_info.op_id());
+    }
+    return ops;
+}
+
+std::set<std::string> NameServerImpl::GetOPEndpoints(const std::shared_ptr<OPData>& op_data) {
+    std::set<std::string> endpoints;
+    std::function<void(const std::shared_ptr<Task>&)> collect = [&](const std::shared_ptr<Task>& task) {
+        if (!task->endpoint_.empty()) {
+            endpoints.insert(task->endpoint_);
+        }
+        if (task->task_info_ && task->task_info_->has_endpoint()) {
+            endpoints.insert(task->task_info_->endpoint());
+        }
+        for (const auto& sub_task : task->sub_task_) {
+            collect(sub_task);
+        }
+        for (const auto& seq_task : task->seq_task_) {
+            collect(seq_task);
+        }
+    };
+    for (const auto& task : op_data->task_list_) {
+        collect(task);
+    }
+    return endpoints;
+}
+
+void NameServerImpl::RunOPTask(const std::shared_ptr<OPData>& op_data, bool* need_wait) {
+    if (op_data->task_list_.empty() || op_data->GetTaskStatus() == ::openmldb::api::kFailed ||
+        op_data->GetTaskStatus() == ::openmldb::api::kCanceled) {
+        return;
+    }
+    if (op_data->GetTaskStatus() == ::openmldb::api::kInited) {
+        op_data->op_info_.set_start_time(::baidu::common::timer::now_time());
+        op_data->SetTaskStatus(::openmldb::api::kDoing);
+        std::string value;
+        op_data->op_info_.SerializeToString(&value);
+        std::string node = absl::StrCat(zk_path_.op_data_path_, "/", op_data->GetOpId());
+        if (!zk_client_->SetNodeValue(node, value)) {
+            PDLOG(WARNING, "set zk op status value failed. node[%s] value[%s]", node.c_str(), value.c_str());
+            op_data->SetTaskStatus(::openmldb::api::kInited);
+            return;
+        }
+        op_started_cnt_ << 1;
+    }
+    std::shared_ptr<Task> task = op_data->task_list_.front();
+    if (task->GetStatus() == ::openmldb::api::kFailed) {
+        PDLOG(WARNING, "task[%s] run failed, terminate op[%s]. op_id[%lu]", task->GetReadableType().c_str(),
+              task->GetReadableOpType().c_str(), task->GetOpId());
+    } else if (task->task_info_->status() == ::openmldb::api::kInited) {
+        DEBUGLOG("run task. opid[%lu] op_type[%s] task_type[%s]", task->GetOpId(), task->GetReadableOpType().c_str(),
+                 task->GetReadableType().c_str());
+        task_thread_pool_.AddTask(task->fun_);
+        task->SetStatus(::openmldb::api::kDoing);
+    } else if (task->GetStatus() == ::openmldb::api::kDoing) {
+        uint64_t cur_ts = ::baidu::common::timer::now_time();
+        if (cur_ts - op_data->op_info_.start_time() > FLAGS_name_server_op_execute_timeout / 1000) {
+            PDLOG(INFO,
+                  "The execution time of op is too long. opid[%lu] op_type[%s] cur task_type[%s] "
+                  "start_time[%lu] cur_time[%lu]",
+                  task->GetOpId(), task->GetReadableOpType().c_str(), task->GetReadableType().c_str(),
+                  op_data->op_info_.start_time(), cur_ts);
+            *need_wait = true;
+        }
+    }
+}
+
 void NameServerImpl::ProcessTask() {
     while (running_.load(std::memory_order_acquire)) {
         {
@@ -1958,50 +2099,36 @@ void NameServerImpl::ProcessTask() {
                     return;
                 }
             }
-
+            // the number of running ops on each tablet
+            std::map<std::string, uint32_t> tablet_op_cnt;
+            bool need_wait = false;
             for (const auto& op_list : task_vec_) {
-                if (op_list.empty()) {
-                    continue;
-                }
-                std::shared_ptr<OPData> op_data = op_list.front();
-                if (op_data->task_list_.empty() || op_data->GetTaskStatus() == ::openmldb::api::kFailed ||
-                    op_data->GetTaskStatus() == ::openmldb::api::kCanceled) {
-                    continue;
-                }
-                if (op_data->GetTaskStatus() == ::openmldb::api::kInited) {
-                    op_data->op_info_.set_start_time(::baidu::common::timer::now_time());
-                    op_data->SetTaskStatus(::openmldb::api::kDoing);
-                    std::string value;
-                    op_data->op_info_.SerializeToString(&value);
-                    std::string node = absl::StrCat(zk_path_.op_data_path_, "/", op_data->GetOpId());
-                    if (!zk_client_->SetNodeValue(node, value)) {
-                        PDLOG(WARNING, "set zk op status value failed. node[%s] value[%s]", node.c_str(),
-                              value.c_str());
-                        op_data->SetTaskStatus(::openmldb::api::kInited);
+                for (const auto& op_data : op_list) {
+                    if (op_data->GetTaskStatus() != ::openmldb::api::kDoing) {
                         continue;
                     }
-                }
-                std::shared_ptr<Task> task = op_data->task_list_.front();
-                if (task->GetStatus() == ::openmldb::api::kFailed) {
-                    PDLOG(WARNING, "task[%s] run failed, terminate op[%s]. op_id[%lu]", task->GetReadableType().c_str(),
-                          task->GetReadableOpType().c_str(), task->GetOpId());
-                } else if (task->task_info_->status() == ::openmldb::api::kInited) {
-                    DEBUGLOG("run task. opid[%lu] op_type[%s] task_type[%s]", task->GetOpId(),
-                             task->GetReadableOpType().c_str(), task->GetReadableType().c_str());
-                    task_thread_pool_.AddTask(task->fun_);
-                    task->SetStatus(::openmldb::api::kDoing);
-                } else if (task->GetStatus() == ::openmldb::api::kDoing) {
-                    uint64_t cur_ts = ::baidu::common::timer::now_time();
-                    if (cur_ts - op_data->op_info_.start_time() > FLAGS_name_server_op_execute_timeout / 1000) {
-                        PDLOG(INFO,
-                              "The execution time of op is too long. opid[%lu] op_type[%s] cur task_type[%s] "
-                              "start_time[%lu] cur_time[%lu]",
-                              task->GetOpId(), task->GetReadableOpType().c_str(), task->GetReadableType().c_str(),
-                              op_data->op_info_.start_time(), cur_ts);
-                        cv_.wait_for(lock, std::chrono::milliseconds(FLAGS_name_server_task_wait_time));
+                    for (const auto& endpoint : GetOPEndpoints(op_data)) {
+                        tablet_op_cnt[endpoint]++;
                     }
                 }
             }
+            for (const auto& op_list : task_vec_) {
+                for (const auto& op_data :
+                     SelectRunnableOPs(op_list, FLAGS_name_server_op_parallelism,
+                                       FLAGS_name_server_op_concurrency_per_tablet, &tablet_op_cnt)) {
+                    RunOPTask(op_data, &need_wait);
+                }
+            }
+            uint64_t running_op_cnt = 0;
+            for (const auto& op_list : task_vec_) {
+                running_op_cnt += std::count_if(op_list.begin(), op_list.end(), [](const auto& op_data) {
+                    return op_data->GetTaskStatus() == ::openmldb::api::kDoing;
+                });
+            }
+            op_running_cnt_.set_value(running_op_cnt);
+            if (need_wait) {
+                cv_.wait_for(lock, std::chrono::milliseconds(FLAGS_name_server_task_wait_time));
+            }
         }
         UpdateZKTaskStatus();
         DeleteTask();
@@ -2210,6 +2337,33 @@ int NameServerImpl::SetPartitionInfo(TableInfo& table_info) {
         PDLOG(WARNING, "replica_num less than 1 that is illegal, replica_num[%u]", replica_num);
         return -1;
     }
+    if (FLAGS_enable_load_aware_placement) {
+        PartitionPlanner planner;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            BuildPartitionPlannerUnlock(&planner);
+        }
+        for (uint32_t pid = 0; pid < partition_num; pid++) {
+            std::vector<std::string> endpoints;
+            uint32_t leader_idx = 0;
+            if (!planner.Place(replica_num, 0, &endpoints, &leader_idx)) {
+                PDLOG(WARNING, "place partition failed. name[%s] pid[%u] replica_num[%u]", table_info.name().c_str(),
+                      pid, replica_num);
+                table_info.clear_table_partition();
+                return -1;
+            }
+            TablePartition* table_partition = table_info.add_table_partition();
+            table_partition->set_pid(pid);
+            for (uint32_t idx = 0; idx < endpoints.size(); idx++) {
+                PartitionMeta* partition_meta = table_partition->add_partition_meta();
+                partition_meta->set_endpoint(endpoints[idx]);
+                partition_meta->set_is_leader(idx == leader_idx);
+            }
+        }
+        PDLOG(INFO, "set table partition by load ok. name[%s] partition_num[%u] replica_num[%u]",
+              table_info.name().c_str(), partition_num, replica_num);
+        return 0;
+    }
     std::map<std::string, uint64_t> endpoint_leader = endpoint_pid_bucked;
     {
         std::lock_guard<std::mutex> lock(mu_);
@@ -2277,6 +2431,88 @@ int NameServerImpl::SetPartitionInfo(TableInfo& table_info) {
     return 0;
 }
 
+void NameServerImpl::BuildPartitionPlannerUnlock(PartitionPlanner* planner) {
+    for (const auto& kv : tablets_) {
+        if (kv.second->Health()) {
+            planner->AddTablet(kv.first);
+        }
+    }
+    auto add_partitions = [planner](const TableInfos& table_infos) {
+        for (const auto& kv : table_infos) {
+            const auto& table_info = kv.second;
+            for (const auto& table_partition : table_info->table_partition()) {
+                for (const auto& partition_meta : table_partition.partition_meta()) {
+                    if (!partition_meta.is_alive()) {
+                        continue;
+                    }
+                    PartitionLoad load;
+                    load.db = table_info->db();
+                    load.name = table_info->name();
+                    load.pid = table_partition.pid();
+                    load.endpoint = partition_meta.endpoint();
+                    load.is_leader = partition_meta.is_leader();
+                    // the data and index bytes of the replica
+                    load.byte_size = partition_meta.record_byte_size();
+                    load.record_cnt = partition_meta.record_cnt();
+                    planner->AddPartition(load);
+                }
+            }
+        }
+    };
+    add_partitions(table_info_);
+    for (const auto& kv : db_table_info_) {
+        add_partitions(kv.second);
+    }
+}
+
+void NameServerImpl::SchedRebalance() {
+    if (!running_.load(std::memory_order_acquire)) {
+        return;
+    }
+    if (FLAGS_enable_auto_rebalance && !auto_failover_.load(std::memory_order_acquire) &&
+        mode_.load(std::memory_order_acquire) == kNORMAL) {
+        std::lock_guard<std::mutex> lock(mu_);
+        bool has_running_op = false;
+        for (const auto& op_list : task_vec_) {
+            if (!op_list.empty()) {
+                has_running_op = true;
+                break;
+            }
+        }
+        bool all_healthy = std::all_of(tablets_.begin(), tablets_.end(),
+                                       [](const auto& kv) { return kv.second->Health(); });
+        // do not rebalance while other ops (e.g. recover or previous rebalance) are running
+        if (!has_running_op && all_healthy) {
+            PartitionPlanner planner;
+            BuildPartitionPlannerUnlock(&planner);
+            auto actions = planner.PlanRebalance(FLAGS_auto_rebalance_threshold, FLAGS_auto_rebalance_max_op_num);
+            for (const auto& action : actions) {
+                if (IsExistActiveOp(action.db, action.name)) {
+                    continue;
+                }
+                if (action.type == RebalanceType::kMigrate) {
+                    if (CreateMigrateOP(action.src_endpoint, action.name, action.db, action.pid,
+                                        action.des_endpoint) < 0) {
+                        PDLOG(WARNING, "create rebalance migrate op failed. name[%s] pid[%u] src[%s] des[%s]",
+                              action.name.c_str(), action.pid, action.src_endpoint.c_str(),
+                              action.des_endpoint.c_str());
+                        break;
+                    }
+                } else if (CreateChangeLeaderOP(action.name, action.db, action.pid, action.des_endpoint, false) < 0) {
+                    PDLOG(WARNING, "create rebalance changeleader op failed. name[%s] pid[%u] candidate_leader[%s]",
+                          action.name.c_str(), action.pid, action.des_endpoint.c_str());
+                    break;
+                }
+                PDLOG(INFO, "rebalance %s. db[%s] name[%s] pid[%u] src[%s] des[%s] byte_size[%lu]",
+                      action.type == RebalanceType::kMigrate ? "migrate" : "changeleader", action.db.c_str(),
+                      action.name.c_str(), action.pid, action.src_endpoint.c_str(), action.des_endpoint.c_str(),
+                      action.byte_size);
+            }
+        }
+    }
+    task_thread_pool_.DelayTask(FLAGS_auto_rebalance_interval, boost::bind(&NameServerImpl::SchedRebalance, this));
+}
+
 base::Status NameServerImpl::CreateTableOnTablet(const std::shared_ptr<::openmldb::nameserver::TableInfo>& table_info,
                                                  bool is_leader, uint64_t term,
                                                  std::map<uint32_t, std::vector<std::string>>* endpoint_map) {
@@ -5683,6 +5919,7 @@ void NameServerImpl::OnLocked() {
                                 boost::bind(&NameServerImpl::CheckClusterInfo, this));
     task_thread_pool_.DelayTask(FLAGS_make_snapshot_check_interval,
                                 boost::bind(&NameServerImpl::SchedMakeSnapshot, this));
+    task_thread_pool_.DelayTask(FLAGS_auto_rebalance_interval, boost::bind(&NameServerImpl::SchedRebalance, this));
 }
 
 void NameServerImpl::OnLostLock() {
@@ -7251,11 +7488,10 @@ int NameServerImpl::UpdateEndpointTableAlive(const std::string& endpoint, bool i
 std::shared_ptr<OPData> NameServerImpl::FindRunningOP(uint64_t op_id) {
     std::lock_guard<std::mutex> lock(mu_);
     for (const auto& op_list : task_vec_) {
-        if (op_list.empty()) {
-            continue;
-        }
-        if (op_list.front()->op_info_.op_id() == op_id) {
-            return op_list.front();
+        for (const auto& op_data : GetActiveOPs(op_list)) {
+            if (op_data->op_info_.op_id() == op_id) {
+                return op_data;
+            }
         }
     }
     return std::shared_ptr<OPData>();
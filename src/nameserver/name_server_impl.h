@@ -32,11 +32,13 @@
 #include "auth/user_access_manager.h"
 #include "base/hash.h"
 #include "base/random.h"
+#include "bvar/bvar.h"
 #include "catalog/distribute_iterator.h"
 #include "client/ns_client.h"
 #include "client/tablet_client.h"
 #include "codec/schema_codec.h"
 #include "nameserver/cluster_info.h"
+#include "nameserver/partition_planner.h"
 #include "nameserver/system_table.h"
 #include "nameserver/task.h"
 #include "proto/name_server.pb.h"
@@ -366,6 +368,15 @@ class NameServerImpl : public NameServer {
                     Closure* done);
     bool IsAuthenticated(const std::string& host, const std::string& username, const std::string& password);
 
+    // select the ops in op_list which may run now: the first op, the running ops and at most parallelism ops in
+    // total. tablet_op_cnt holds the running ops on each tablet and is updated with the newly selected ops
+    static std::vector<std::shared_ptr<OPData>> SelectRunnableOPs(const std::list<std::shared_ptr<OPData>>& op_list,
+                                                                  uint32_t parallelism, uint32_t concurrency_per_tablet,
+                                                                  std::map<std::string, uint32_t>* tablet_op_cnt);
+
+    // the endpoints of tablets which the tasks of op_data run on
+    static std::set<std::string> GetOPEndpoints(const std::shared_ptr<OPData>& op_data);
+
  private:
 
     std::function<std::optional<std::pair<std::unique_ptr<::openmldb::catalog::FullTableIterator>,
@@ -611,6 +622,12 @@ class NameServerImpl : public NameServer {
     void RunSubTask(std::shared_ptr<Task> task);
     void RunSeqTask(std::shared_ptr<Task> task);
 
+    // the first op and the ops which have been started in op_list
+    static std::vector<std::shared_ptr<OPData>> GetActiveOPs(const std::list<std::shared_ptr<OPData>>& op_list);
+
+    // start op_data if it is inited and submit its current task. need to hold mu_
+    void RunOPTask(const std::shared_ptr<OPData>& op_data, bool* need_wait);
+
     // get tablet info
     std::shared_ptr<TabletInfo> GetTabletInfo(const std::string& endpoint);
 
@@ -645,6 +662,12 @@ class NameServerImpl : public NameServer {
 
     void SchedMakeSnapshot();
 
+    // plan and issue migrate/changeleader ops if the memory usage of tablets diverges
+    void SchedRebalance();
+
+    // collect the load of healthy tablets and alive partitions. need to hold mu_
+    void BuildPartitionPlannerUnlock(PartitionPlanner* planner);
+
     void MakeTablePartitionSnapshot(uint32_t pid, uint64_t end_offset,
                                     std::shared_ptr<::openmldb::nameserver::TableInfo> table_info);
 
@@ -748,6 +771,11 @@ class NameServerImpl : public NameServer {
         db_sp_info_map_;
     ::openmldb::type::StartupMode startup_mode_;
     openmldb::auth::UserAccessManager user_access_manager_;
+    // op metrics. op_recorder_ records the latency and throughput of finished ops
+    bvar::LatencyRecorder op_recorder_;
+    bvar::Adder<uint64_t> op_started_cnt_;
+    bvar::Adder<uint64_t> op_failed_cnt_;
+    bvar::Status<uint64_t> op_running_cnt_;
 };
 
 }  // namespace nameserver
@@ -1316,6 +1316,96 @@ TEST_F(NameServerImplTest, AddField) {
     server.Join();
 }
 
+std::shared_ptr<OPData> MakeOPData(uint64_t op_id, uint32_t pid, const std::string& endpoint,
+                                   ::openmldb::api::TaskStatus status, uint64_t parent_id = INVALID_PARENT_ID) {
+    auto op_data = std::make_shared<OPData>();
+    op_data->op_info_.set_op_id(op_id);
+    op_data->op_info_.set_op_type(::openmldb::api::OPType::kReAddReplicaOP);
+    op_data->op_info_.set_db("db1");
+    op_data->op_info_.set_name("t1");
+    op_data->op_info_.set_pid(pid);
+    op_data->op_info_.set_task_status(status);
+    op_data->op_info_.set_data("");
+    op_data->op_info_.set_task_index(0);
+    if (parent_id != INVALID_PARENT_ID) {
+        op_data->op_info_.set_parent_id(parent_id);
+    }
+    auto task_info = std::make_shared<::openmldb::api::TaskInfo>();
+    task_info->set_op_id(op_id);
+    task_info->set_op_type(::openmldb::api::OPType::kReAddReplicaOP);
+    task_info->set_task_type(::openmldb::api::TaskType::kLoadTable);
+    task_info->set_status(::openmldb::api::TaskStatus::kInited);
+    task_info->set_endpoint(endpoint);
+    op_data->task_list_.push_back(std::make_shared<Task>(endpoint, task_info));
+    return op_data;
+}
+
+std::vector<uint64_t> SelectOPIds(const std::list<std::shared_ptr<OPData>>& op_list, uint32_t parallelism,
+                                  uint32_t concurrency_per_tablet, std::map<std::string, uint32_t>* tablet_op_cnt) {
+    std::vector<uint64_t> op_ids;
+    for (const auto& op_data :
+         NameServerImpl::SelectRunnableOPs(op_list, parallelism, concurrency_per_tablet, tablet_op_cnt)) {
+        op_ids.push_back(op_data->GetOpId());
+    }
+    return op_ids;
+}
+
+TEST_F(NameServerImplTest, SelectRunnableOPs) {
+    std::list<std::shared_ptr<OPData>> op_list = {
+        MakeOPData(1, 0, "tb1", ::openmldb::api::kDoing),
+        MakeOPData(2, 1, "tb2", ::openmldb::api::kInited),
+        // the same partition as op 1
+        MakeOPData(3, 0, "tb3", ::openmldb::api::kInited),
+        // tb2 is busy with op 2
+        MakeOPData(4, 2, "tb2", ::openmldb::api::kInited),
+        // the child of op 3 which is waiting
+        MakeOPData(5, 3, "tb4", ::openmldb::api::kInited, 3),
+        MakeOPData(6, 4, "tb4", ::openmldb::api::kInited),
+        MakeOPData(7, 5, "tb5", ::openmldb::api::kInited),
+    };
+    // the old behaviour, only the first op runs
+    std::map<std::string, uint32_t> tablet_op_cnt = {{"tb1", 1}};
+    ASSERT_EQ(std::vector<uint64_t>({1}), SelectOPIds(op_list, 1, 1, &tablet_op_cnt));
+
+    tablet_op_cnt = {{"tb1", 1}};
+    ASSERT_EQ(std::vector<uint64_t>({1, 2, 6}), SelectOPIds(op_list, 3, 1, &tablet_op_cnt));
+    ASSERT_EQ(1u, tablet_op_cnt["tb2"]);
+    ASSERT_EQ(1u, tablet_op_cnt["tb4"]);
+
+    // no limit per tablet
+    tablet_op_cnt = {{"tb1", 1}};
+    ASSERT_EQ(std::vector<uint64_t>({1, 2, 4, 6, 7}), SelectOPIds(op_list, 10, 0, &tablet_op_cnt));
+
+    // the running ops are always selected and count against parallelism
+    for (const auto& op_data : op_list) {
+        if (op_data->GetOpId() == 2 || op_data->GetOpId() == 6) {
+            op_data->SetTaskStatus(::openmldb::api::kDoing);
+        }
+    }
+    tablet_op_cnt = {{"tb1", 1}, {"tb2", 1}, {"tb4", 1}};
+    ASSERT_EQ(std::vector<uint64_t>({1, 2, 6}), SelectOPIds(op_list, 3, 1, &tablet_op_cnt));
+    tablet_op_cnt = {{"tb1", 1}, {"tb2", 1}, {"tb4", 1}};
+    ASSERT_EQ(std::vector<uint64_t>({1, 2, 6, 7}), SelectOPIds(op_list, 4, 1, &tablet_op_cnt));
+
+    // a failed first op still takes a slot until it is deleted
+    op_list = {
+        MakeOPData(1, 0, "tb1", ::openmldb::api::kFailed),
+        MakeOPData(2, 1, "tb2", ::openmldb::api::kInited),
+        MakeOPData(3, 2, "tb3", ::openmldb::api::kInited),
+    };
+    tablet_op_cnt.clear();
+    ASSERT_EQ(std::vector<uint64_t>({1, 2}), SelectOPIds(op_list, 2, 1, &tablet_op_cnt));
+
+    // the op without pid is a barrier
+    op_list = {
+        MakeOPData(1, 0, "tb1", ::openmldb::api::kDoing),
+        MakeOPData(2, INVALID_PID, "tb2", ::openmldb::api::kInited),
+        MakeOPData(3, 2, "tb3", ::openmldb::api::kInited),
+    };
+    tablet_op_cnt = {{"tb1", 1}};
+    ASSERT_EQ(std::vector<uint64_t>({1}), SelectOPIds(op_list, 3, 1, &tablet_op_cnt));
+}
+
 }  // namespace nameserver
 }  // namespace openmldb
 
@@ -0,0 +1,245 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "nameserver/partition_planner.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace openmldb {
+namespace nameserver {
+
+void PartitionPlanner::AddTablet(const std::string& endpoint) { tablets_.emplace(endpoint, TabletLoad()); }
+
+void PartitionPlanner::AddPartition(const PartitionLoad& load) {
+    auto iter = tablets_.find(load.endpoint);
+    if (iter == tablets_.end()) {
+        return;
+    }
+    TabletLoad& tablet = iter->second;
+    tablet.partition_cnt++;
+    tablet.byte_size += load.byte_size;
+    tablet.record_cnt += load.record_cnt;
+    if (load.is_leader) {
+        tablet.leader_cnt++;
+        tablet.leader_byte_size += load.byte_size;
+    }
+    total_partition_cnt_++;
+    total_byte_size_ += load.byte_size;
+    partitions_.push_back(load);
+}
+
+double PartitionPlanner::Score(const TabletLoad& load) const {
+    double score = static_cast<double>(load.partition_cnt) / std::max<uint64_t>(total_partition_cnt_, 1);
+    if (total_byte_size_ > 0) {
+        score += memory_weight_ * static_cast<double>(load.byte_size) / total_byte_size_;
+    }
+    return score;
+}
+
+bool PartitionPlanner::Place(uint32_t replica_num, uint64_t byte_size, std::vector<std::string>* endpoints,
+                             uint32_t* leader_idx) {
+    if (endpoints == nullptr || leader_idx == nullptr || replica_num == 0 || replica_num > tablets_.size()) {
+        return false;
+    }
+    if (byte_size == 0 && total_partition_cnt_ > 0) {
+        byte_size = total_byte_size_ / total_partition_cnt_;
+    }
+    std::vector<std::pair<double, std::string>> candidates;
+    candidates.reserve(tablets_.size());
+    for (const auto& kv : tablets_) {
+        candidates.emplace_back(Score(kv.second), kv.first);
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    endpoints->clear();
+    *leader_idx = 0;
+    const TabletLoad* leader_load = nullptr;
+    for (uint32_t idx = 0; idx < replica_num; idx++) {
+        const std::string& endpoint = candidates[idx].second;
+        const TabletLoad& load = tablets_[endpoint];
+        if (leader_load == nullptr || load.leader_cnt < leader_load->leader_cnt ||
+            (load.leader_cnt == leader_load->leader_cnt && load.leader_byte_size < leader_load->leader_byte_size)) {
+            leader_load = &load;
+            *leader_idx = idx;
+        }
+        endpoints->push_back(endpoint);
+    }
+    for (uint32_t idx = 0; idx < endpoints->size(); idx++) {
+        TabletLoad& load = tablets_[endpoints->at(idx)];
+        load.partition_cnt++;
+        load.byte_size += byte_size;
+        if (idx == *leader_idx) {
+            load.leader_cnt++;
+            load.leader_byte_size += byte_size;
+        }
+        total_partition_cnt_++;
+        total_byte_size_ += byte_size;
+    }
+    return true;
+}
+
+bool PartitionPlanner::HasReplica(const PartitionKey& key, const std::string& endpoint) const {
+    for (const auto& partition : partitions_) {
+        if (partition.endpoint == endpoint && partition.pid == std::get<2>(key) && partition.name == std::get<1>(key) &&
+            partition.db == std::get<0>(key)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PartitionPlanner::PlanMigrate(double threshold, std::set<PartitionKey>* planned, RebalanceAction* action) {
+    if (tablets_.size() < 2 || total_byte_size_ == 0) {
+        return false;
+    }
+    auto max_iter = tablets_.begin();
+    auto min_iter = tablets_.begin();
+    for (auto iter = tablets_.begin(); iter != tablets_.end(); ++iter) {
+        if (iter->second.byte_size > max_iter->second.byte_size) {
+            max_iter = iter;
+        }
+        if (iter->second.byte_size < min_iter->second.byte_size) {
+            min_iter = iter;
+        }
+    }
+    double avg = static_cast<double>(total_byte_size_) / tablets_.size();
+    uint64_t diff = max_iter->second.byte_size - min_iter->second.byte_size;
+    if (diff <= threshold * avg) {
+        return false;
+    }
+    // leader cannot be migrated, so only followers are candidates. the best one moves half of the spread
+    PartitionLoad* best = nullptr;
+    uint64_t best_distance = UINT64_MAX;
+    for (auto& partition : partitions_) {
+        if (partition.endpoint != max_iter->first || partition.is_leader || partition.byte_size == 0 ||
+            partition.byte_size >= diff) {
+            continue;
+        }
+        PartitionKey key(partition.db, partition.name, partition.pid);
+        if (planned->count(key) > 0 || HasReplica(key, min_iter->first)) {
+            continue;
+        }
+        uint64_t distance = partition.byte_size * 2 > diff ? partition.byte_size * 2 - diff
+                                                           : diff - partition.byte_size * 2;
+        if (distance < best_distance) {
+            best_distance = distance;
+            best = &partition;
+        }
+    }
+    if (best == nullptr) {
+        return false;
+    }
+    action->type = RebalanceType::kMigrate;
+    action->db = best->db;
+    action->name = best->name;
+    action->pid = best->pid;
+    action->src_endpoint = max_iter->first;
+    action->des_endpoint = min_iter->first;
+    action->byte_size = best->byte_size;
+    planned->emplace(best->db, best->name, best->pid);
+    max_iter->second.partition_cnt--;
+    max_iter->second.byte_size -= best->byte_size;
+    max_iter->second.record_cnt -= std::min(max_iter->second.record_cnt, best->record_cnt);
+    min_iter->second.partition_cnt++;
+    min_iter->second.byte_size += best->byte_size;
+    min_iter->second.record_cnt += best->record_cnt;
+    best->endpoint = min_iter->first;
+    return true;
+}
+
+bool PartitionPlanner::PlanChangeLeader(double threshold, std::set<PartitionKey>* planned,
+                                        RebalanceAction* action) {
+    if (tablets_.size() < 2) {
+        return false;
+    }
+    uint64_t total_leader_byte_size = 0;
+    auto max_iter = tablets_.begin();
+    for (auto iter = tablets_.begin(); iter != tablets_.end(); ++iter) {
+        total_leader_byte_size += iter->second.leader_byte_size;
+        if (iter->second.leader_byte_size > max_iter->second.leader_byte_size) {
+            max_iter = iter;
+        }
+    }
+    if (total_leader_byte_size == 0) {
+        return false;
+    }
+    double avg = static_cast<double>(total_leader_byte_size) / tablets_.size();
+    PartitionLoad* best_leader = nullptr;
+    PartitionLoad* best_follower = nullptr;
+    uint64_t best_distance = UINT64_MAX;
+    for (auto& leader : partitions_) {
+        if (leader.endpoint != max_iter->first || !leader.is_leader || leader.byte_size == 0) {
+            continue;
+        }
+        if (planned->count(PartitionKey(leader.db, leader.name, leader.pid)) > 0) {
+            continue;
+        }
+        for (auto& follower : partitions_) {
+            if (follower.is_leader || follower.pid != leader.pid || follower.name != leader.name ||
+                follower.db != leader.db) {
+                continue;
+            }
+            const TabletLoad& load = tablets_[follower.endpoint];
+            uint64_t diff = max_iter->second.leader_byte_size - load.leader_byte_size;
+            if (diff <= threshold * avg || leader.byte_size >= diff) {
+                continue;
+            }
+            uint64_t distance = leader.byte_size * 2 > diff ? leader.byte_size * 2 - diff
+                                                            : diff - leader.byte_size * 2;
+            if (distance < best_distance) {
+                best_distance = distance;
+                best_leader = &leader;
+                best_follower = &follower;
+            }
+        }
+    }
+    if (best_leader == nullptr) {
+        return false;
+    }
+    action->type = RebalanceType::kChangeLeader;
+    action->db = best_leader->db;
+    action->name = best_leader->name;
+    action->pid = best_leader->pid;
+    action->src_endpoint = best_leader->endpoint;
+    action->des_endpoint = best_follower->endpoint;
+    action->byte_size = best_leader->byte_size;
+    planned->emplace(best_leader->db, best_leader->name, best_leader->pid);
+    TabletLoad& follower_load = tablets_[best_follower->endpoint];
+    max_iter->second.leader_cnt--;
+    max_iter->second.leader_byte_size -= best_leader->byte_size;
+    follower_load.leader_cnt++;
+    follower_load.leader_byte_size += best_leader->byte_size;
+    best_leader->is_leader = false;
+    best_follower->is_leader = true;
+    return true;
+}
+
+std::vector<RebalanceAction> PartitionPlanner::PlanRebalance(double threshold, uint32_t max_action) {
+    std::vector<RebalanceAction> actions;
+    std::set<PartitionKey> planned;
+    while (actions.size() < max_action) {
+        RebalanceAction action;
+        if (!PlanMigrate(threshold, &planned, &action) && !PlanChangeLeader(threshold, &planned, &action)) {
+            break;
+        }
+        actions.push_back(std::move(action));
+    }
+    return actions;
+}
+
+}  // namespace nameserver
+}  // namespace openmldb
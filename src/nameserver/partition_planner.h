@@ -0,0 +1,108 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_NAMESERVER_PARTITION_PLANNER_H_
+#define SRC_NAMESERVER_PARTITION_PLANNER_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace openmldb {
+namespace nameserver {
+
+// the load of one replica of a partition, collected from PartitionMeta
+struct PartitionLoad {
+    std::string db;
+    std::string name;
+    uint32_t pid = 0;
+    std::string endpoint;
+    bool is_leader = false;
+    // PartitionMeta::record_byte_size, UpdateTableStatusFun sets it to record_byte_size + record_idx_byte_size of the
+    // TableStatus reported by the tablet
+    uint64_t byte_size = 0;
+    uint64_t record_cnt = 0;
+};
+
+// the aggregated load of one tablet
+struct TabletLoad {
+    uint64_t partition_cnt = 0;
+    uint64_t leader_cnt = 0;
+    uint64_t byte_size = 0;
+    uint64_t leader_byte_size = 0;
+    uint64_t record_cnt = 0;
+};
+
+enum class RebalanceType { kMigrate = 1, kChangeLeader = 2 };
+
+struct RebalanceAction {
+    RebalanceType type = RebalanceType::kMigrate;
+    std::string db;
+    std::string name;
+    uint32_t pid = 0;
+    // kMigrate: move the follower from src_endpoint to des_endpoint
+    // kChangeLeader: des_endpoint is the candidate leader, src_endpoint is the current leader
+    std::string src_endpoint;
+    std::string des_endpoint;
+    uint64_t byte_size = 0;
+};
+
+// PartitionPlanner models the memory footprint and partition distribution of healthy tablets.
+// It is used to place the replicas of new tables and to plan Migrate/ChangeLeader ops
+// when the memory usage of tablets diverges. The planner is not thread safe.
+class PartitionPlanner {
+ public:
+    // memory_weight is the weight of memory share relative to partition count share when scoring tablets
+    explicit PartitionPlanner(double memory_weight = 1.0) : memory_weight_(memory_weight) {}
+
+    void AddTablet(const std::string& endpoint);
+
+    // the replica on a tablet which is not added will be ignored
+    void AddPartition(const PartitionLoad& load);
+
+    // select replica_num distinct tablets for a new partition. endpoints[*leader_idx] is the leader.
+    // if byte_size is 0, the average byte size of existing partitions is used as the estimation
+    bool Place(uint32_t replica_num, uint64_t byte_size, std::vector<std::string>* endpoints, uint32_t* leader_idx);
+
+    // plan at most max_action actions. actions are generated only if the spread of memory (or leader memory)
+    // between the heaviest and lightest tablet exceeds threshold * average
+    std::vector<RebalanceAction> PlanRebalance(double threshold, uint32_t max_action);
+
+    double Score(const TabletLoad& load) const;
+
+    const std::map<std::string, TabletLoad>& GetTabletLoad() const { return tablets_; }
+
+    size_t TabletNum() const { return tablets_.size(); }
+
+ private:
+    using PartitionKey = std::tuple<std::string, std::string, uint32_t>;
+
+    bool PlanMigrate(double threshold, std::set<PartitionKey>* planned, RebalanceAction* action);
+    bool PlanChangeLeader(double threshold, std::set<PartitionKey>* planned, RebalanceAction* action);
+    bool HasReplica(const PartitionKey& key, const std::string& endpoint) const;
+
+    double memory_weight_;
+    uint64_t total_partition_cnt_ = 0;
+    uint64_t total_byte_size_ = 0;
+    std::map<std::string, TabletLoad> tablets_;
+    std::vector<PartitionLoad> partitions_;
+};
+
+}  // namespace nameserver
+}  // namespace openmldb
+#endif  // SRC_NAMESERVER_PARTITION_PLANNER_H_
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "nameserver/partition_planner.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace nameserver {
+
+class PartitionPlannerTest : public ::testing::Test {};
+
+PartitionLoad MakeLoad(const std::string& name, uint32_t pid, const std::string& endpoint, bool is_leader,
+                       uint64_t byte_size) {
+    PartitionLoad load;
+    load.db = "db1";
+    load.name = name;
+    load.pid = pid;
+    load.endpoint = endpoint;
+    load.is_leader = is_leader;
+    load.byte_size = byte_size;
+    return load;
+}
+
+TEST_F(PartitionPlannerTest, PlaceByPartitionCount) {
+    PartitionPlanner planner;
+    planner.AddTablet("tb1");
+    planner.AddTablet("tb2");
+    planner.AddTablet("tb3");
+    std::map<std::string, uint32_t> replica_cnt;
+    std::map<std::string, uint32_t> leader_cnt;
+    for (uint32_t pid = 0; pid < 6; pid++) {
+        std::vector<std::string> endpoints;
+        uint32_t leader_idx = 0;
+        ASSERT_TRUE(planner.Place(2, 0, &endpoints, &leader_idx));
+        ASSERT_EQ(2u, endpoints.size());
+        ASSERT_NE(endpoints[0], endpoints[1]);
+        for (const auto& endpoint : endpoints) {
+            replica_cnt[endpoint]++;
+        }
+        leader_cnt[endpoints[leader_idx]]++;
+    }
+    for (const auto& kv : replica_cnt) {
+        ASSERT_EQ(4u, kv.second);
+    }
+    for (const auto& kv : leader_cnt) {
+        ASSERT_EQ(2u, kv.second);
+    }
+    std::vector<std::string> endpoints;
+    uint32_t leader_idx = 0;
+    ASSERT_FALSE(planner.Place(4, 0, &endpoints, &leader_idx));
+}
+
+TEST_F(PartitionPlannerTest, PlaceByMemory) {
+    PartitionPlanner planner;
+    planner.AddTablet("tb1");
+    planner.AddTablet("tb2");
+    planner.AddTablet("tb3");
+    // tb1 holds the same number of partitions but much more memory
+    planner.AddPartition(MakeLoad("t1", 0, "tb1", true, 1000));
+    planner.AddPartition(MakeLoad("t1", 1, "tb2", true, 10));
+    planner.AddPartition(MakeLoad("t1", 2, "tb3", true, 10));
+    std::vector<std::string> endpoints;
+    uint32_t leader_idx = 0;
+    ASSERT_TRUE(planner.Place(2, 0, &endpoints, &leader_idx));
+    for (const auto& endpoint : endpoints) {
+        ASSERT_NE("tb1", endpoint);
+    }
+}
+
+TEST_F(PartitionPlannerTest, RebalanceMigrate) {
+    PartitionPlanner planner;
+    planner.AddTablet("tb1");
+    planner.AddTablet("tb2");
+    planner.AddTablet("tb3");
+    planner.AddPartition(MakeLoad("t1", 0, "tb1", true, 100));
+    planner.AddPartition(MakeLoad("t1", 0, "tb2", false, 100));
+    planner.AddPartition(MakeLoad("t1", 1, "tb2", true, 100));
+    planner.AddPartition(MakeLoad("t1", 1, "tb1", false, 100));
+    planner.AddPartition(MakeLoad("t2", 0, "tb2", true, 50));
+    planner.AddPartition(MakeLoad("t2", 0, "tb1", false, 50));
+    auto actions = planner.PlanRebalance(0.2, 1);
+    ASSERT_EQ(1u, actions.size());
+    ASSERT_EQ(RebalanceType::kMigrate, actions[0].type);
+    ASSERT_EQ("tb3", actions[0].des_endpoint);
+    ASSERT_EQ("t1", actions[0].name);
+    ASSERT_EQ(1u, actions[0].pid);
+    ASSERT_EQ("tb1", actions[0].src_endpoint);
+
+    // balanced cluster needs no action
+    PartitionPlanner balanced;
+    balanced.AddTablet("tb1");
+    balanced.AddTablet("tb2");
+    balanced.AddPartition(MakeLoad("t1", 0, "tb1", true, 100));
+    balanced.AddPartition(MakeLoad("t1", 0, "tb2", false, 100));
+    balanced.AddPartition(MakeLoad("t1", 1, "tb2", true, 100));
+    balanced.AddPartition(MakeLoad("t1", 1, "tb1", false, 100));
+    ASSERT_TRUE(balanced.PlanRebalance(0.2, 10).empty());
+}
+
+TEST_F(PartitionPlannerTest, RebalanceChangeLeader) {
+    PartitionPlanner planner;
+    planner.AddTablet("tb1");
+    planner.AddTablet("tb2");
+    // memory is balanced but all leaders are in tb1
+    planner.AddPartition(MakeLoad("t1", 0, "tb1", true, 100));
+    planner.AddPartition(MakeLoad("t1", 0, "tb2", false, 100));
+    planner.AddPartition(MakeLoad("t1", 1, "tb1", true, 100));
+    planner.AddPartition(MakeLoad("t1", 1, "tb2", false, 100));
+    auto actions = planner.PlanRebalance(0.2, 10);
+    ASSERT_EQ(1u, actions.size());
+    ASSERT_EQ(RebalanceType::kChangeLeader, actions[0].type);
+    ASSERT_EQ("tb1", actions[0].src_endpoint);
+    ASSERT_EQ("tb2", actions[0].des_endpoint);
+    const auto& loads = planner.GetTabletLoad();
+    ASSERT_EQ(1u, loads.at("tb1").leader_cnt);
+    ASSERT_EQ(1u, loads.at("tb2").leader_cnt);
+}
+
+}  // namespace nameserver
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -37,6 +37,7 @@
 #include <brpc/retry_policy.h>
 #include <gflags/gflags.h>
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <thread>  // NOLINT
@@ -84,7 +85,8 @@ class RpcClient {
           log_id_(0),
           stub_(NULL),
           channel_(NULL),
-          client_authenticator_(auth_token) {}
+          client_authenticator_(auth_token),
+          inflight_(std::make_shared<std::atomic<int32_t>>(0)) {}
     RpcClient(const std::string& endpoint, bool use_sleep_policy,
               const openmldb::authn::AuthToken auth_token = openmldb::authn::ServiceToken{"default"})
         : endpoint_(endpoint),
@@ -92,19 +94,22 @@ class RpcClient {
           log_id_(0),
           stub_(NULL),
           channel_(NULL),
-          client_authenticator_(auth_token) {}
+          client_authenticator_(auth_token),
+          inflight_(std::make_shared<std::atomic<int32_t>>(0)) {}
     ~RpcClient() {
         delete channel_;
         delete stub_;
     }
 
-    int Init() {
+    // the channels in different connection groups to the same endpoint do not share connections
+    int Init(const std::string& connection_group = "") {
         channel_ = new brpc::Channel();
         brpc::ChannelOptions options;
         if (use_sleep_policy_) {
             options.retry_policy = &sleep_retry_policy;
         }
         options.auth = &client_authenticator_;
+        options.connection_group = connection_group;
 
         if (channel_->Init(endpoint_.c_str(), "", &options) != 0) {
             return -1;
@@ -120,7 +125,7 @@ class RpcClient {
             PDLOG(WARNING, "stub is null. client must be init before send request");
             return false;
         }
-        (stub_->*func)(cntl, request, response, callback);
+        CallMethod(func, cntl, request, response, callback);
         return true;
     }
 
@@ -131,7 +136,7 @@ class RpcClient {
             PDLOG(WARNING, "stub is null. client must be init before send request");
             return false;
         }
-        (stub_->*func)(cntl, request, response, NULL);
+        CallMethod(func, cntl, request, response, static_cast<Callback*>(NULL));
         if (!cntl->Failed()) {
             return true;
         }
@@ -153,7 +158,7 @@ class RpcClient {
             PDLOG(WARNING, "stub is null. client must be init before send request");
             return false;
         }
-        (stub_->*func)(&cntl, request, response, NULL);
+        CallMethod(func, &cntl, request, response, static_cast<Callback*>(NULL));
         if (!cntl.Failed()) {
             return true;
         }
@@ -187,7 +192,7 @@ class RpcClient {
             PDLOG(WARNING, "stub is null. client must be init before send request");
             return {base::ReturnCode::kServerConnError, "stub is null"};
         }
-        (stub_->*func)(&cntl, request, response, NULL);
+        CallMethod(func, &cntl, request, response, static_cast<Callback*>(NULL));
         if (!cntl.Failed()) {
             return {};
         }
@@ -211,7 +216,7 @@ class RpcClient {
             PDLOG(WARNING, "stub is null. client must be init before send request");
             return false;
         }
-        (stub_->*func)(&cntl, request, response, NULL);
+        CallMethod(func, &cntl, request, response, static_cast<Callback*>(NULL));
         if (cntl.Failed()) {
             PDLOG(WARNING, "request error. %s", cntl.ErrorText().c_str());
             return false;
@@ -229,11 +234,43 @@ class RpcClient {
             PDLOG(WARNING, "stub is null. client must be init before send request");
             return false;
         }
-        (stub_->*func)(cntl, request, response, callback);
+        CallMethod(func, cntl, request, response, callback);
         return true;
     }
 
+    // the number of requests sent by the client and not finished yet
+    int32_t GetInflight() const { return inflight_->load(std::memory_order_relaxed); }
+
  private:
+    // runs the callback of an async request after counting it finished
+    class InflightClosure : public google::protobuf::Closure {
+     public:
+        InflightClosure(const std::shared_ptr<std::atomic<int32_t>>& inflight, google::protobuf::Closure* done)
+            : inflight_(inflight), done_(done) {}
+
+        void Run() override {
+            inflight_->fetch_sub(1, std::memory_order_relaxed);
+            done_->Run();
+            delete this;
+        }
+
+     private:
+        std::shared_ptr<std::atomic<int32_t>> inflight_;
+        google::protobuf::Closure* done_;
+    };
+
+    template <class Request, class Response, class Callback>
+    void CallMethod(void (T::*func)(google::protobuf::RpcController*, const Request*, Response*, Callback*),
+                    brpc::Controller* cntl, const Request* request, Response* response, Callback* callback) {
+        inflight_->fetch_add(1, std::memory_order_relaxed);
+        if (callback == NULL) {
+            (stub_->*func)(cntl, request, response, NULL);
+            inflight_->fetch_sub(1, std::memory_order_relaxed);
+        } else {
+            (stub_->*func)(cntl, request, response, new InflightClosure(inflight_, callback));
+        }
+    }
+
     std::string endpoint_;
     std::string auth_str_;
     bool use_sleep_policy_;
@@ -241,6 +278,8 @@ class RpcClient {
     T* stub_;
     brpc::Channel* channel_;
     authn::BRPCAuthenticator client_authenticator_;
+    // shared with the callbacks of the async requests, which may finish after the client is gone
+    std::shared_ptr<std::atomic<int32_t>> inflight_;
 };
 
 template <class Response>
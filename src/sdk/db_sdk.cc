@@ -190,13 +190,17 @@ ClusterSDK::ClusterSDK(const std::shared_ptr<SQLRouterOptions>& options)
       leader_path_(options->zk_path + "/leader"),
       taskmanager_leader_path_(options->zk_path + "/taskmanager/leader"),
       zk_client_(nullptr),
-      pool_(1) {
+      pool_(1),
+      table_nodes_(table_root_path_),
+      sp_nodes_(sp_root_path_) {
     if (!options->user.empty()) {
         client_manager_ = std::make_shared<::openmldb::catalog::ClientManager>(
-            authn::UserToken{options->user, codec::Encrypt(options->password)});
+            authn::UserToken{options->user, codec::Encrypt(options->password)}, options->tablet_channel_num);
     } else {
-        client_manager_ = std::make_shared<::openmldb::catalog::ClientManager>();
+        client_manager_ = std::make_shared<::openmldb::catalog::ClientManager>(
+            openmldb::authn::ServiceToken{"default"}, options->tablet_channel_num);
     }
+    read_from_follower_ = options->read_from_follower;
     catalog_ = std::make_shared<catalog::SDKCatalog>(client_manager_);
 }
 
@@ -319,85 +323,93 @@ bool ClusterSDK::GetTaskManagerAddress(std::string* endpoint, std::string* real_
     return true;
 }
 
-// TODO(hw): refactor
-bool ClusterSDK::UpdateCatalog(const std::vector<std::string>& table_datas, const std::vector<std::string>& sp_datas) {
-    std::vector<::openmldb::nameserver::TableInfo> tables;
-    std::map<std::string, std::map<std::string, std::shared_ptr<::openmldb::nameserver::TableInfo>>> mapping;
-    auto new_catalog = std::make_shared<::openmldb::catalog::SDKCatalog>(client_manager_);
-    for (const auto& table_data : table_datas) {
-        if (table_data.empty()) continue;
-        std::string value;
-        bool ok = zk_client_->GetNodeValue(table_root_path_ + "/" + table_data, value);
-        if (!ok) {
-            LOG(WARNING) << "fail to get table data " << table_root_path_ << "/" << table_data;
-            continue;
+bool ClusterSDK::UpdateCatalog() {
+    std::lock_guard<std::mutex> refresh_lock(refresh_mu_);
+    // nothing is read yet, build the catalog from scratch
+    bool full = table_nodes_.Size() == 0;
+    std::map<std::string, std::string> changed_table_nodes;
+    std::vector<std::string> removed_table_nodes;
+    std::map<std::string, std::string> changed_sp_nodes;
+    std::vector<std::string> removed_sp_nodes;
+    if (!table_nodes_.Refresh(zk_client_, &changed_table_nodes, &removed_table_nodes) ||
+        !sp_nodes_.Refresh(zk_client_, &changed_sp_nodes, &removed_sp_nodes)) {
+        // the nodes read are not applied, start over
+        ResetCatalogCache();
+        return false;
+    }
+    std::vector<std::pair<std::string, std::string>> removed;
+    for (const auto& node : removed_table_nodes) {
+        auto it = node_tables_.find(node);
+        if (it != node_tables_.end()) {
+            removed.emplace_back(it->second->db(), it->second->name());
+            node_tables_.erase(it);
         }
-        std::shared_ptr<::openmldb::nameserver::TableInfo> table_info(new ::openmldb::nameserver::TableInfo());
-        ok = table_info->ParseFromString(value);
-        if (!ok) {
+    }
+    std::vector<::openmldb::nameserver::TableInfo> changed;
+    for (const auto& [node, value] : changed_table_nodes) {
+        auto table_info = std::make_shared<::openmldb::nameserver::TableInfo>();
+        if (!table_info->ParseFromString(value)) {
             LOG(WARNING) << "fail to parse table proto with " << value;
             continue;
         }
-        DLOG(INFO) << "parse table " << table_info->name() << " ok";
-        tables.push_back(*(table_info));
-        auto it = mapping.find(table_info->db());
-        if (it == mapping.end()) {
-            std::map<std::string, std::shared_ptr<::openmldb::nameserver::TableInfo>> table_in_db;
-            table_in_db.insert(std::make_pair(table_info->name(), table_info));
-            mapping.insert(std::make_pair(table_info->db(), table_in_db));
-        } else {
-            it->second.insert(std::make_pair(table_info->name(), table_info));
-        }
         DLOG(INFO) << "load table info with name " << table_info->name() << " in db " << table_info->db();
+        changed.push_back(*table_info);
+        node_tables_[node] = table_info;
     }
 
-    Procedures db_sp_map;
-    for (const auto& node : sp_datas) {
-        if (node.empty()) continue;
-        std::string value;
-        bool ok = zk_client_->GetNodeValue(sp_root_path_ + "/" + node, value);
-        if (!ok) {
-            LOG(WARNING) << "fail to get procedure data. node: " << node;
-            continue;
-        }
+    for (const auto& node : removed_sp_nodes) {
+        node_procedures_.erase(node);
+    }
+    for (const auto& [node, value] : changed_sp_nodes) {
         std::string uncompressed;
         ::snappy::Uncompress(value.c_str(), value.length(), &uncompressed);
         ::openmldb::api::ProcedureInfo sp_info_pb;
-        ok = sp_info_pb.ParseFromString(uncompressed);
-        if (!ok) {
+        if (!sp_info_pb.ParseFromString(uncompressed)) {
             LOG(WARNING) << "fail to parse procedure proto. node: " << node << " value: " << value;
             continue;
         }
-        DLOG(INFO) << "parse procedure " << sp_info_pb.sp_name() << " ok";
         auto sp_info = std::make_shared<openmldb::catalog::ProcedureInfoImpl>(sp_info_pb);
-        if (!sp_info) {
-            LOG(WARNING) << "convert procedure info failed, sp_name: " << sp_info_pb.sp_name()
-                         << " db: " << sp_info_pb.db_name();
-            continue;
-        }
-        auto it = db_sp_map.find(sp_info->GetDbName());
-        if (it == db_sp_map.end()) {
-            std::map<std::string, std::shared_ptr<hybridse::sdk::ProcedureInfo>> sp_in_db = {
-                {sp_info->GetSpName(), sp_info}};
-            db_sp_map.insert(std::make_pair(sp_info->GetDbName(), sp_in_db));
-        } else {
-            it->second.insert(std::make_pair(sp_info->GetSpName(), sp_info));
-        }
         DLOG(INFO) << "load procedure info with sp name " << sp_info->GetSpName() << " in db " << sp_info->GetDbName();
+        node_procedures_[node] = sp_info;
     }
-    if (!new_catalog->Init(tables, db_sp_map)) {
+    Procedures db_sp_map;
+    for (const auto& kv : node_procedures_) {
+        db_sp_map[kv.second->GetDbName()][kv.second->GetSpName()] = kv.second;
+    }
+    std::map<std::string, std::map<std::string, std::shared_ptr<::openmldb::nameserver::TableInfo>>> mapping;
+    for (const auto& kv : node_tables_) {
+        mapping[kv.second->db()][kv.second->name()] = kv.second;
+    }
+
+    // the handlers of the unchanged tables are shared with the current catalog
+    auto new_catalog = std::make_shared<::openmldb::catalog::SDKCatalog>(client_manager_);
+    bool ok = full ? new_catalog->Init(changed, db_sp_map)
+                   : new_catalog->Init(*GetCatalog(), changed, removed, db_sp_map);
+    if (!ok) {
         LOG(WARNING) << "fail to init catalog";
+        ResetCatalogCache();
         return false;
     }
+    if (!full) {
+        LOG(INFO) << "refresh catalog with " << changed.size() << " tables changed and " << removed.size()
+                  << " tables removed";
+    }
     {
         std::lock_guard<::openmldb::base::SpinMutex> lock(mu_);
         table_to_tablets_ = mapping;
-        catalog_ = new_catalog;
+        SetCatalog(new_catalog);
     }
     engine_->UpdateCatalog(new_catalog);
     return true;
 }
 
+void ClusterSDK::ResetCatalogCache() {
+    table_nodes_.Clear();
+    sp_nodes_.Clear();
+    node_tables_.clear();
+    node_procedures_.clear();
+}
+
 bool ClusterSDK::InitTabletClient() {
     std::vector<std::string> tablets;
     bool ok = zk_client_->GetNodes(tablets);
@@ -423,30 +435,9 @@ bool ClusterSDK::BuildCatalog() {
     if (!InitTabletClient()) {
         return false;
     }
-
-    std::vector<std::string> table_datas;
-    if (zk_client_->IsExistNode(table_root_path_) == 0) {
-        bool ok = zk_client_->GetChildren(table_root_path_, table_datas);
-        if (!ok) {
-            LOG(WARNING) << "fail to get table list with path " << table_root_path_;
-            return false;
-        }
-    } else {
-        LOG(INFO) << "no tables in db";
-    }
-    std::vector<std::string> sp_datas;
-    if (zk_client_->IsExistNode(sp_root_path_) == 0) {
-        bool ok = zk_client_->GetChildren(sp_root_path_, sp_datas);
-        if (!ok) {
-            LOG(WARNING) << "fail to get procedure list with path " << sp_root_path_;
-            return false;
-        }
-    } else {
-        LOG(INFO) << "no procedures in db";
-    }
     // The empty database can't be find if we only get table datas, but database no notify, so we get alldbs from
     // nameserver in GetAllDbs()
-    return UpdateCatalog(table_datas, sp_datas);
+    return UpdateCatalog();
 }
 
 std::vector<std::string> DBSDK::GetAllDbs() {
@@ -557,9 +548,9 @@ std::shared_ptr<::openmldb::catalog::TabletAccessor> DBSDK::GetTablet(const std:
             uint32_t pid_num = sdk_table_handler->GetPartitionNum();
             uint32_t pid = 0;
             if (pid_num > 0) {
-                pid = rand_.Uniform(pid_num);
+                pid = next_pid_.fetch_add(1, std::memory_order_relaxed) % pid_num;
             }
-            return sdk_table_handler->GetTablet(pid);
+            return GetReadTablet(sdk_table_handler, pid);
         }
     }
     return {};
@@ -613,12 +604,20 @@ std::shared_ptr<::openmldb::catalog::TabletAccessor> DBSDK::GetTablet(const std:
             if (pid_num > 0) {
                 pid = ::openmldb::base::hash64(pk) % pid_num;
             }
-            return sdk_table_handler->GetTablet(pid);
+            return GetReadTablet(sdk_table_handler, pid);
         }
     }
     return {};
 }
 
+std::shared_ptr<::openmldb::catalog::TabletAccessor> DBSDK::GetReadTablet(
+    const ::openmldb::catalog::SDKTableHandler* sdk_table_handler, uint32_t pid) const {
+    if (read_from_follower_) {
+        return sdk_table_handler->GetTabletReplica(pid);
+    }
+    return sdk_table_handler->GetTablet(pid);
+}
+
 std::shared_ptr<hybridse::sdk::ProcedureInfo> DBSDK::GetProcedureInfo(const std::string& db, const std::string& sp_name,
                                                                       std::string* msg) {
     if (msg == nullptr) {
@@ -628,8 +627,7 @@ std::shared_ptr<hybridse::sdk::ProcedureInfo> DBSDK::GetProcedureInfo(const std:
         *msg = "db or sp_name is empty";
         return {};
     } else {
-        std::lock_guard<::openmldb::base::SpinMutex> lock(mu_);
-        auto sp = catalog_->GetProcedureInfo(db, sp_name);
+        auto sp = GetCatalog()->GetProcedureInfo(db, sp_name);
         if (!sp) {
             *msg = sp_name + " does not exist in " + db;
             return {};
@@ -643,8 +641,8 @@ std::vector<std::shared_ptr<hybridse::sdk::ProcedureInfo>> DBSDK::GetProcedureIn
     if (msg == nullptr) {
         return sp_infos;
     }
-    std::lock_guard<::openmldb::base::SpinMutex> lock(mu_);
-    auto& db_sp_map = catalog_->GetProcedures();
+    auto catalog = GetCatalog();
+    auto& db_sp_map = catalog->GetProcedures();
     for (const auto& db_kv : db_sp_map) {
         for (const auto& sp_kv : db_kv.second) {
             sp_infos.push_back(sp_kv.second);
@@ -722,7 +720,7 @@ bool StandAloneSDK::BuildCatalog() {
     {
         std::lock_guard<::openmldb::base::SpinMutex> lock(mu_);
         table_to_tablets_ = mapping;
-        catalog_ = new_catalog;
+        SetCatalog(new_catalog);
     }
     engine_->UpdateCatalog(new_catalog);
     return true;
@@ -19,6 +19,7 @@
 
 #include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 #include <utility>
 #include <vector>
@@ -33,6 +34,7 @@
 #include "sdk/options.h"
 #include "vm/catalog.h"
 #include "vm/engine.h"
+#include "zk/zk_children_cache.h"
 #include "zk/zk_client.h"
 
 namespace openmldb::sdk {
@@ -71,9 +73,9 @@ class DBSDK {
 
     inline uint64_t GetClusterVersion() { return cluster_version_.load(std::memory_order_relaxed); }
 
+    // the catalog is replaced as a whole on refresh, so the requests read it without locking
     inline std::shared_ptr<::openmldb::catalog::SDKCatalog> GetCatalog() {
-        std::lock_guard<::openmldb::base::SpinMutex> lock(mu_);
-        return catalog_;
+        return std::atomic_load_explicit(&catalog_, std::memory_order_acquire);
     }
     inline ::hybridse::vm::Engine* GetEngine() { return engine_; }
 
@@ -118,10 +120,19 @@ class DBSDK {
     virtual bool BuildCatalog() = 0;
     static std::string GetFunSignature(const openmldb::common::ExternalFun& fun);
     bool InitExternalFun();
+    // replace the catalog read by GetCatalog, callers hold mu_ to keep it in step with table_to_tablets_
+    void SetCatalog(const std::shared_ptr<::openmldb::catalog::SDKCatalog>& catalog) {
+        std::atomic_store_explicit(&catalog_, catalog, std::memory_order_release);
+    }
+    // the tablet to read the partition from, a follower may serve it if read_from_follower_ is set
+    std::shared_ptr<::openmldb::catalog::TabletAccessor> GetReadTablet(
+        const ::openmldb::catalog::SDKTableHandler* sdk_table_handler, uint32_t pid) const;
 
  protected:
     std::atomic<uint64_t> cluster_version_{0};
-    ::openmldb::base::Random rand_{0xdeadbeef};
+    // spreads the requests without a routing key over the partitions
+    std::atomic<uint32_t> next_pid_{0};
+    bool read_from_follower_ = false;
 
     ::openmldb::base::SpinMutex mu_;
     std::shared_ptr<::openmldb::catalog::ClientManager> client_manager_;
@@ -159,7 +170,9 @@ class ClusterSDK : public DBSDK {
 
  private:
     bool GetRealEndpointFromZk(const std::string& endpoint, std::string* real_endpoint);
-    bool UpdateCatalog(const std::vector<std::string>& table_datas, const std::vector<std::string>& sp_datas);
+    bool UpdateCatalog();
+    // forget the table and procedure nodes read, the next refresh rebuilds the whole catalog. must hold refresh_mu_
+    void ResetCatalogCache();
     bool InitTabletClient();
     void WatchNotify();
     void CheckZk();
@@ -179,6 +192,13 @@ class ClusterSDK : public DBSDK {
     // if failed, just retry
     ::openmldb::zk::ZkClient* zk_client_;
     ::baidu::common::ThreadPool pool_;
+
+    // a refresh reads only the table and procedure nodes changed since the last one, guarded by refresh_mu_
+    std::mutex refresh_mu_;
+    ::openmldb::zk::ZkChildrenCache table_nodes_;
+    ::openmldb::zk::ZkChildrenCache sp_nodes_;
+    std::map<std::string, std::shared_ptr<::openmldb::nameserver::TableInfo>> node_tables_;
+    std::map<std::string, std::shared_ptr<::hybridse::sdk::ProcedureInfo>> node_procedures_;
 };
 
 class StandAloneSDK : public DBSDK {
@@ -186,10 +206,12 @@ class StandAloneSDK : public DBSDK {
     explicit StandAloneSDK(const std::shared_ptr<StandaloneOptions> options) : options_(options) {
         if (!options->user.empty()) {
             client_manager_ = std::make_shared<::openmldb::catalog::ClientManager>(
-                authn::UserToken{options->user, codec::Encrypt(options->password)});
+                authn::UserToken{options->user, codec::Encrypt(options->password)}, options->tablet_channel_num);
         } else {
-            client_manager_ = std::make_shared<::openmldb::catalog::ClientManager>();
+            client_manager_ = std::make_shared<::openmldb::catalog::ClientManager>(
+                openmldb::authn::ServiceToken{"default"}, options->tablet_channel_num);
         }
+        read_from_follower_ = options->read_from_follower;
         catalog_ = std::make_shared<catalog::SDKCatalog>(client_manager_);
     }
 
@@ -16,11 +16,18 @@
 
 #include <gflags/gflags.h>
 
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "absl/strings/str_cat.h"
 #include "benchmark/benchmark.h"
 #include "sdk/mini_cluster.h"
 #include "sdk/mini_cluster_bm.h"
+#include "sdk/sql_router.h"
 DECLARE_bool(enable_distsql);
 DECLARE_bool(enable_localtablet);
+DECLARE_uint32(request_batch_window_us);
 ::openmldb::sdk::MiniCluster* mc;
 #define DEFINE_BATCH_REQUEST_CASE(NAME, PATH, CASE_ID)                         \
     static void BM_BatchRequest_##NAME(benchmark::State& state) {              \
@@ -51,6 +58,87 @@ const char* DEFAULT_YAML_PATH = "cases/benchmark/batch_request_benchmark.yaml";
 DEFINE_BATCH_REQUEST_CASE(TwoWindow, DEFAULT_YAML_PATH, "0");
 DEFINE_BATCH_REQUEST_CASE(CommonWindow, DEFAULT_YAML_PATH, "1");
 
+// concurrent single row calls of a deployment, which the tablet runs in batches if request_batch_window_us is set
+const char* MICRO_BATCH_DB = "micro_batch_db";
+const char* MICRO_BATCH_DEPLOYMENT = "micro_batch_deploy";
+const int MICRO_BATCH_KEY_NUM = 100;
+std::shared_ptr<::openmldb::sdk::SQLRouter> micro_batch_router;
+
+static bool PrepareMicroBatchDeployment() {
+    ::openmldb::sdk::SQLRouterOptions sql_opt;
+    sql_opt.zk_cluster = mc->GetZkCluster();
+    sql_opt.zk_path = mc->GetZkPath();
+    micro_batch_router = ::openmldb::sdk::NewClusterSQLRouter(sql_opt);
+    if (!micro_batch_router) {
+        return false;
+    }
+    hybridse::sdk::Status status;
+    micro_batch_router->CreateDB(MICRO_BATCH_DB, &status);
+    std::string ddl =
+        "create table t1 (c1 string, c3 int, c4 bigint, c7 timestamp, index(key=c1, ts=c7, ttl=0, ttl_type=latest));";
+    if (!micro_batch_router->ExecuteDDL(MICRO_BATCH_DB, ddl, &status)) {
+        return false;
+    }
+    micro_batch_router->RefreshCatalog();
+    for (int key = 0; key < MICRO_BATCH_KEY_NUM; key++) {
+        for (int ts = 1; ts <= 100; ts++) {
+            std::string sql = absl::StrCat("insert into t1 values ('key", key, "', ", ts, ", ", ts * 10L, ", ",
+                                           1590738990000L + ts, ");");
+            if (!micro_batch_router->ExecuteInsert(MICRO_BATCH_DB, sql, &status)) {
+                return false;
+            }
+        }
+    }
+    std::string deploy = absl::StrCat(
+        "deploy ", MICRO_BATCH_DEPLOYMENT,
+        " select c1, sum(c4) over w1 as w1_c4_sum, count(c3) over w1 as w1_c3_cnt from t1 "
+        "window w1 as (partition by t1.c1 order by t1.c7 rows between 100 preceding and current row);");
+    micro_batch_router->ExecuteSQL(MICRO_BATCH_DB, deploy, &status);
+    return status.IsOK();
+}
+
+static void BM_DeploymentMicroBatch(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        FLAGS_request_batch_window_us = state.range(0);
+    }
+    if (!micro_batch_router) {
+        state.SkipWithError("the deployment is not prepared");
+        return;
+    }
+    hybridse::sdk::Status status;
+    auto request_row = micro_batch_router->GetRequestRowByProcedure(MICRO_BATCH_DB, MICRO_BATCH_DEPLOYMENT, &status);
+    if (!request_row) {
+        state.SkipWithError("fail to get the request row of the deployment");
+        return;
+    }
+    int64_t i = 0;
+    for (auto _ : state) {
+        std::string key = absl::StrCat("key", (state.thread_index() + i++) % MICRO_BATCH_KEY_NUM);
+        request_row->Init(key.size());
+        request_row->AppendString(key);
+        request_row->AppendInt32(1);
+        request_row->AppendInt64(10);
+        request_row->AppendTimestamp(1590738990000L + 101);
+        request_row->Build();
+        auto rs = micro_batch_router->CallProcedure(MICRO_BATCH_DB, MICRO_BATCH_DEPLOYMENT, request_row, &status);
+        if (!rs) {
+            state.SkipWithError("fail to call the deployment");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DeploymentMicroBatch)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgNames({"window_us"})
+    ->Arg(0)
+    ->Arg(200)
+    ->Arg(1000)
+    ->Threads(1)
+    ->Threads(16)
+    ->Threads(64)
+    ->UseRealTime();
+
 int main(int argc, char** argv) {
     ::google::ParseCommandLineFlags(&argc, &argv, true);
     ::openmldb::base::SetupGlog(true);
@@ -67,6 +155,9 @@ int main(int argc, char** argv) {
         mini_cluster.SetUp();
     }
     sleep(2);
+    if (!PrepareMicroBatchDeployment()) {
+        std::cout << "fail to prepare the deployment of micro batch benchmark" << std::endl;
+    }
     ::benchmark::RunSpecifiedBenchmarks();
     mini_cluster.Close();
 }
@@ -52,6 +52,8 @@ DEFINE_REQUEST_WINDOW_CASE(BM_SimpleWindowOutputLastJoinTable2, DEFAULT_YAML_PAT
 DEFINE_REQUEST_WINDOW_CASE(BM_SimpleWindowOutputLastJoinTable4, DEFAULT_YAML_PATH, "3");
 DEFINE_REQUEST_WINDOW_CASE(BM_LastJoin4WindowOutput, DEFAULT_YAML_PATH, "4");
 DEFINE_REQUEST_WINDOW_CASE(BM_LastJoin8WindowOutput, DEFAULT_YAML_PATH, "5");
+// run with --enable_window_column_pruning=true/false to compare reading the whole wide rows into the window
+DEFINE_REQUEST_WINDOW_CASE(BM_WideTableWindowOutput, DEFAULT_YAML_PATH, "6");
 
 int main(int argc, char** argv) {
     ::google::ParseCommandLineFlags(&argc, &argv, true);
@@ -29,6 +29,16 @@ struct BasicRouterOptions {
     uint32_t max_sql_cache_size = 50;
     // == gflag `request_timeout` default value(no gflags here cuz swig)
     uint32_t request_timeout = 60000;
+    // fetch the result of a batch query in pages of about the size, so that the whole result is never held in
+    // memory. 0 means the whole result in one response. With paging, ResultSet::Size() counts only the rows fetched
+    // so far, and dropping the result set before its end releases the rest on the tablet
+    uint32_t result_page_byte_size = 0;
+    // the number of channels to each tablet, each channel has its own connection and a request goes through the
+    // channel with the fewest requests in flight
+    uint32_t tablet_channel_num = 1;
+    // send the deployment and query requests to the leader or a follower of the partition, whichever has the fewest
+    // requests in flight. enable it only if reading the data lagging behind the leader is acceptable
+    bool read_from_follower = false;
     // default 0(INFO), INFO, WARNING, ERROR, and FATAL are 0, 1, 2, and 3
     int glog_level = 0;
     // empty means to stderr
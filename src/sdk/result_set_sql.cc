@@ -26,6 +26,7 @@
 #include "catalog/sdk_catalog.h"
 #include "codec/fe_schema_codec.h"
 #include "codec/row_codec.h"
+#include "codec/sql_rpc_row_codec.h"
 #include "glog/logging.h"
 #include "schema/schema_adapter.h"
 
@@ -77,6 +78,14 @@ std::shared_ptr<::hybridse::sdk::ResultSet> ResultSetSQL::MakeResultSet(
         *status = {::hybridse::common::StatusCode::kCmdError, "request error, fail to decodec schema"};
         return {};
     }
+    if (response->compress_type() == ::openmldb::type::kSnappy) {
+        if (!::openmldb::codec::UncompressRpcRows(&cntl->response_attachment())) {
+            *status = {::hybridse::common::StatusCode::kCmdError, "request error, fail to uncompress result"};
+            return {};
+        }
+        // the result set may be made again from the same response
+        response->clear_compress_type();
+    }
     auto rs = std::make_shared<openmldb::sdk::ResultSetSQL>(schema, response->count(), response->byte_size(), cntl);
     if (!rs->Init()) {
         *status = {::hybridse::common::StatusCode::kCmdError, "request error, ResultSetSQL init failed"};
@@ -150,6 +159,60 @@ std::shared_ptr<::hybridse::sdk::ResultSet> ResultSetSQL::MakeResultSet(
     return MakeResultSet(schema, records, status);
 }
 
+std::shared_ptr<::hybridse::sdk::ResultSet> PagedResultSetSQL::MakeResultSet(
+    const std::shared_ptr<::openmldb::api::QueryResponse>& response, const std::shared_ptr<brpc::Controller>& cntl,
+    PageFetcher fetcher, PageReleaser releaser, ::hybridse::sdk::Status* status) {
+    auto page = std::dynamic_pointer_cast<ResultSetSQL>(ResultSetSQL::MakeResultSet(response, cntl, status));
+    if (!page) {
+        if (!response->is_finish() && releaser) {
+            releaser(response->result_id());
+        }
+        return {};
+    }
+    auto rs = std::make_shared<PagedResultSetSQL>(page, response->result_id(), response->count(), std::move(fetcher),
+                                                  std::move(releaser));
+    rs->finished_ = response->is_finish();
+    return rs;
+}
+
+void PagedResultSetSQL::Release() {
+    if (finished_) {
+        return;
+    }
+    finished_ = true;
+    if (releaser_) {
+        releaser_(result_id_);
+    }
+}
+
+bool PagedResultSetSQL::Next() {
+    while (!page_->Next()) {
+        if (finished_) {
+            return false;
+        }
+        std::shared_ptr<::openmldb::api::QueryResponse> response;
+        std::shared_ptr<brpc::Controller> cntl;
+        if (!fetcher_(result_id_, &response, &cntl, &fetch_status_)) {
+            LOG(WARNING) << "fail to fetch the page " << page_idx_ + 1 << " of result " << result_id_ << ": "
+                         << fetch_status_.msg;
+            finished_ = true;
+            return false;
+        }
+        auto page = std::dynamic_pointer_cast<ResultSetSQL>(ResultSetSQL::MakeResultSet(response, cntl,
+                                                                                       &fetch_status_));
+        if (!page) {
+            finished_ = true;
+            return false;
+        }
+        // drop the previous page
+        page_ = page;
+        page_idx_++;
+        record_cnt_ += response->count();
+        finished_ = response->is_finish();
+    }
+    return true;
+}
+
 const bool ReadableResultSetSQL::GetAsString(uint32_t idx, std::string& val) {
     auto data_type = GetSchema()->GetColumnType(idx);
     switch (data_type) {
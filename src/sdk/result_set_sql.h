@@ -17,8 +17,10 @@
 #ifndef SRC_SDK_RESULT_SET_SQL_H_
 #define SRC_SDK_RESULT_SET_SQL_H_
 
+#include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "brpc/controller.h"
@@ -228,6 +230,86 @@ class MultipleResultSetSQL : public ::hybridse::sdk::ResultSet {
     std::shared_ptr<ResultSetSQL> result_set_base_;
 };
 
+// PagedResultSetSQL reads a batch query result which the tablet sends in pages, only the current page is kept.
+// It can not be reset once the first page is dropped, and Size is the count of the rows fetched so far.
+// The pages not fetched yet are released on the tablet when the result set is dropped before its last page.
+class PagedResultSetSQL : public ::hybridse::sdk::ResultSet {
+ public:
+    // fetch the next page of the result
+    using PageFetcher = std::function<bool(uint64_t result_id, std::shared_ptr<::openmldb::api::QueryResponse>*,
+                                           std::shared_ptr<brpc::Controller>*, ::hybridse::sdk::Status*)>;
+    // drop the pages not fetched yet
+    using PageReleaser = std::function<void(uint64_t result_id)>;
+
+    PagedResultSetSQL(const std::shared_ptr<ResultSetSQL>& page, uint64_t result_id, uint32_t record_cnt,
+                      PageFetcher fetcher, PageReleaser releaser)
+        : page_(page),
+          result_id_(result_id),
+          fetcher_(std::move(fetcher)),
+          releaser_(std::move(releaser)),
+          record_cnt_(record_cnt) {}
+    ~PagedResultSetSQL() { Release(); }
+
+    // response is the first page of the result
+    static std::shared_ptr<::hybridse::sdk::ResultSet> MakeResultSet(
+        const std::shared_ptr<::openmldb::api::QueryResponse>& response, const std::shared_ptr<brpc::Controller>& cntl,
+        PageFetcher fetcher, PageReleaser releaser, ::hybridse::sdk::Status* status);
+
+    // stop reading the result, Next returns false after the current page
+    void Release();
+
+    bool Reset() override { return page_idx_ == 0 && page_->Reset(); }
+
+    bool Next() override;
+
+    bool IsNULL(int index) override { return page_->IsNULL(index); }
+
+    bool GetString(uint32_t index, std::string* str) override { return page_->GetString(index, str); }
+
+    bool GetBool(uint32_t index, bool* result) override { return page_->GetBool(index, result); }
+
+    bool GetChar(uint32_t index, char* result) override { return page_->GetChar(index, result); }
+
+    bool GetInt16(uint32_t index, int16_t* result) override { return page_->GetInt16(index, result); }
+
+    bool GetInt32(uint32_t index, int32_t* result) override { return page_->GetInt32(index, result); }
+
+    bool GetInt64(uint32_t index, int64_t* result) override { return page_->GetInt64(index, result); }
+
+    bool GetFloat(uint32_t index, float* result) override { return page_->GetFloat(index, result); }
+
+    bool GetDouble(uint32_t index, double* result) override { return page_->GetDouble(index, result); }
+
+    bool GetDate(uint32_t index, int32_t* date) override { return page_->GetDate(index, date); }
+
+    bool GetDate(uint32_t index, int32_t* year, int32_t* month, int32_t* day) override {
+        return page_->GetDate(index, year, month, day);
+    }
+
+    bool GetTime(uint32_t index, int64_t* mills) override { return page_->GetTime(index, mills); }
+
+    const ::hybridse::sdk::Schema* GetSchema() override { return page_->GetSchema(); }
+
+    // the count of the rows fetched so far, not of the whole result
+    int32_t Size() override { return record_cnt_; }
+
+    int32_t GetDataLength() override { return 0; }
+    void CopyTo(hybridse::sdk::ByteArrayPtr buf) override {}
+
+    // the error of fetching a page, Next returns false on it
+    const ::hybridse::sdk::Status& GetFetchStatus() const { return fetch_status_; }
+
+ private:
+    std::shared_ptr<ResultSetSQL> page_;
+    uint64_t result_id_;
+    PageFetcher fetcher_;
+    PageReleaser releaser_;
+    uint32_t record_cnt_;
+    uint32_t page_idx_ = 0;
+    bool finished_ = false;
+    ::hybridse::sdk::Status fetch_status_;
+};
+
 class ReadableResultSetSQL : public ::hybridse::sdk::ResultSet {
  public:
     explicit ReadableResultSetSQL(const std::shared_ptr<::hybridse::sdk::ResultSet>& rs) : rs_(rs) {}
@@ -1202,13 +1202,38 @@ std::shared_ptr<::hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQLParamete
     cntl->set_timeout_ms(options_->request_timeout);
     DLOG(INFO) << "send query to tablet " << client->GetEndpoint();
     auto response = std::make_shared<::openmldb::api::QueryResponse>();
+    uint32_t page_byte_size = options_->result_page_byte_size;
     if (!client->Query(db, sql, GetDefaultEngineMode(), parameter_types, parameter ? parameter->GetRow() : "",
-                       cntl.get(), response.get(), options_->enable_debug)) {
+                       cntl.get(), response.get(), options_->enable_debug, page_byte_size)) {
         // rpc error is in cntl or response
         RPC_STATUS_AND_WARN(status, cntl, response, "Query rpc failed");
         return {};
     }
-    return ResultSetSQL::MakeResultSet(response, cntl, status);
+    if (response->is_finish()) {
+        return ResultSetSQL::MakeResultSet(response, cntl, status);
+    }
+    // the rest of the result is fetched from the same tablet page by page
+    uint32_t timeout = options_->request_timeout;
+    auto fetcher = [client, db, timeout, page_byte_size](
+                       uint64_t result_id, std::shared_ptr<::openmldb::api::QueryResponse>* page_response,
+                       std::shared_ptr<brpc::Controller>* page_cntl, ::hybridse::sdk::Status* status) {
+        *page_cntl = std::make_shared<::brpc::Controller>();
+        (*page_cntl)->set_timeout_ms(timeout);
+        *page_response = std::make_shared<::openmldb::api::QueryResponse>();
+        if (!client->FetchQueryResult(db, result_id, page_byte_size, page_cntl->get(), page_response->get())) {
+            RPC_STATUS_AND_WARN(status, (*page_cntl), (*page_response), "FetchQueryResult rpc failed");
+            return false;
+        }
+        return true;
+    };
+    // the tablet keeps the pages until they are fetched or expired, release them if the client stops early
+    auto releaser = [client, db, timeout](uint64_t result_id) {
+        ::brpc::Controller release_cntl;
+        release_cntl.set_timeout_ms(timeout);
+        ::openmldb::api::QueryResponse release_response;
+        client->ReleaseQueryResult(db, result_id, &release_cntl, &release_response);
+    };
+    return PagedResultSetSQL::MakeResultSet(response, cntl, std::move(fetcher), std::move(releaser), status);
 }
 
 std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQLBatchRequest(
@@ -4502,7 +4527,26 @@ hybridse::sdk::Status SQLClusterRouter::HandleLongWindows(
                         "new one"};
         }
 
+        // a long window can be pre-aggregated with multiple bucket sizes, e.g. `w1:1h|1d|30d`. each bucket size is a
+        // pre-aggr table updated together on put, and the planner merges them from the coarsest to the finest
+        openmldb::base::LongWindowInfos level_infos;
+        std::vector<size_t> levels;
         for (const auto& lw : long_window_infos) {
+            std::vector<std::string> buckets = absl::StrSplit(lw.bucket_size_, "|");
+            for (size_t level = 0; level < buckets.size(); level++) {
+                absl::StripAsciiWhitespace(&buckets[level]);
+                if (buckets.size() > 1 && (buckets[level].empty() || openmldb::base::IsNumber(buckets[level]))) {
+                    return {StatusCode::kSyntaxError,
+                            absl::StrCat("multiple bucket sizes of long window ", lw.window_name_,
+                                         " should be time buckets")};
+                }
+                level_infos.push_back(lw);
+                level_infos.back().bucket_size_ = buckets[level];
+                levels.push_back(level);
+            }
+        }
+        for (size_t i = 0; i < level_infos.size(); i++) {
+            const auto& lw = level_infos[i];
             if (absl::EndsWithIgnoreCase(lw.aggr_func_, "_where")) {
                 // TOOD(ace): *_where op only support for memory base table
                 if (tables[0].storage_mode() != common::StorageMode::kMemory) {
@@ -4530,7 +4574,7 @@ hybridse::sdk::Status SQLClusterRouter::HandleLongWindows(
             }
             // check if pre-aggr table exists
             ::hybridse::sdk::Status status;
-            bool is_exist = CheckPreAggrTableExist(base_table, base_db, lw, &status);
+            bool is_exist = CheckPreAggrTableExist(base_table, base_db, lw, levels[i] > 0, &status);
             if (!status.IsOK()) {
                 return status;
             }
@@ -4541,7 +4585,8 @@ hybridse::sdk::Status SQLClusterRouter::HandleLongWindows(
             std::string aggr_col = lw.aggr_col_ == "*" ? "" : lw.aggr_col_;
             auto aggr_table =
                 absl::StrCat("pre_", base_db, "_", deploy_node->Name(), "_", lw.window_name_, "_", lw.aggr_func_, "_",
-                             aggr_col, lw.filter_col_.empty() ? "" : "_" + lw.filter_col_);
+                             aggr_col, lw.filter_col_.empty() ? "" : "_" + lw.filter_col_,
+                             levels[i] > 0 ? "_" + lw.bucket_size_ : "");
             std::string insert_sql = absl::StrCat(
                 "insert into ", meta_db, ".", meta_table, " values('" + aggr_table, "', '", aggr_db, "', '", base_db,
                 "', '", base_table, "', '", lw.aggr_func_, "', '", lw.aggr_col_, "', '", lw.partition_col_, "', '",
@@ -4611,12 +4656,15 @@ hybridse::sdk::Status SQLClusterRouter::HandleLongWindows(
 }
 
 bool SQLClusterRouter::CheckPreAggrTableExist(const std::string& base_table, const std::string& base_db,
-                                              const openmldb::base::LongWindowInfo& lw,
+                                              const openmldb::base::LongWindowInfo& lw, bool match_bucket,
                                               ::hybridse::sdk::Status* status) {
     RET_FALSE_IF_NULL_AND_WARN(status, "output status is nullptr");
     std::string meta_db = openmldb::nameserver::INTERNAL_DB;
     std::string meta_table = openmldb::nameserver::PRE_AGG_META_NAME;
     std::string filter_cond = lw.filter_col_.empty() ? "" : " and filter_col = '" + lw.filter_col_ + "'";
+    if (match_bucket) {
+        absl::StrAppend(&filter_cond, " and bucket_size = '", lw.bucket_size_, "'");
+    }
     std::string meta_info =
         absl::StrCat("base_db = '", base_db, "' and base_table = '", base_table, "' and aggr_func = '", lw.aggr_func_,
                      "' and aggr_col = '", lw.aggr_col_, "' and partition_cols = '", lw.partition_col_,
@@ -399,8 +399,11 @@ class SQLClusterRouter : public SQLRouter {
                                             const std::set<std::pair<std::string, std::string>>& table_pair,
                                             const std::string& select_sql);
 
+    // the pre-aggr tables of a long window are identified without bucket size, except the coarser levels of a
+    // multi-level long window, which are identified with `match_bucket`
     bool CheckPreAggrTableExist(const std::string& base_table, const std::string& base_db,
-                                const openmldb::base::LongWindowInfo& lw, ::hybridse::sdk::Status* status);
+                                const openmldb::base::LongWindowInfo& lw, bool match_bucket,
+                                ::hybridse::sdk::Status* status);
 
     ///
     /// \brief Query all registered components, aka tablet, nameserver, task manager,
@@ -0,0 +1,205 @@
+/*
+ * Copyright 2022 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "statistics/hot_key/hot_key_sampler.h"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+namespace openmldb::statistics {
+
+CountMinSketch::CountMinSketch(uint32_t width, uint32_t depth)
+    : width_(std::max<uint32_t>(width, 1)),
+      depth_(std::max<uint32_t>(depth, 1)),
+      counters_(new std::atomic<uint32_t>[static_cast<size_t>(width_) * depth_]) {
+    for (size_t i = 0; i < static_cast<size_t>(width_) * depth_; i++) {
+        counters_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+uint32_t CountMinSketch::Add(uint64_t hash, uint32_t cnt) {
+    uint32_t estimate = std::numeric_limits<uint32_t>::max();
+    for (uint32_t row = 0; row < depth_; row++) {
+        uint32_t value = counters_[Pos(hash, row)].fetch_add(cnt, std::memory_order_relaxed) + cnt;
+        estimate = std::min(estimate, value);
+    }
+    return estimate;
+}
+
+uint32_t CountMinSketch::Estimate(uint64_t hash) const {
+    uint32_t estimate = std::numeric_limits<uint32_t>::max();
+    for (uint32_t row = 0; row < depth_; row++) {
+        estimate = std::min(estimate, counters_[Pos(hash, row)].load(std::memory_order_relaxed));
+    }
+    return estimate;
+}
+
+void CountMinSketch::Decay() {
+    for (size_t i = 0; i < static_cast<size_t>(width_) * depth_; i++) {
+        counters_[i].store(counters_[i].load(std::memory_order_relaxed) >> 1, std::memory_order_relaxed);
+    }
+}
+
+// see HotKeySampler::Record
+constexpr uint32_t RANK_LOCK_INTERVAL = 16;
+
+static void PrintHotKey(std::ostream& os, void* arg) { os << static_cast<HotKeySampler*>(arg)->Desc(); }
+
+HotKeySampler::HotKeySampler(const std::string& prefix, uint32_t width, uint32_t depth, uint64_t decay_interval,
+                             uint32_t hot_threshold, uint32_t top_k)
+    : decay_interval_(decay_interval),
+      hot_threshold_(std::max<uint32_t>(hot_threshold, 1)),
+      top_k_(top_k),
+      record_cnt_(0),
+      index_record_cnt_(0),
+      key_sketch_(width, depth),
+      deploy_key_sketch_(width, depth),
+      index_key_sketch_(width, depth),
+      top_keys_(),
+      mutex_(),
+      hot_key_status_(prefix, "hot_key", PrintHotKey, this) {}
+
+uint32_t HotKeySampler::Record(const std::string& deploy, std::string_view key) {
+    uint64_t cnt = record_cnt_.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (decay_interval_ > 0 && cnt % decay_interval_ == 0) {
+        Decay();
+    }
+    uint32_t estimate = key_sketch_.Add(Hash(key));
+    if (estimate < hot_threshold_ || top_k_ == 0) {
+        return estimate;
+    }
+    uint64_t deploy_hash = Hash(deploy);
+    uint32_t deploy_estimate = deploy_key_sketch_.Add(Hash(key) ^ (deploy_hash * 0x9E3779B97F4A7C15ULL));
+    // the sampler is on the request path, skip updating the ranking if another request is doing it.
+    // block every RANK_LOCK_INTERVAL observations of a key so that it cannot be starved under contention
+    if (!mutex_.TryLock()) {
+        if (deploy_estimate % RANK_LOCK_INTERVAL != 0) {
+            return estimate;
+        }
+        mutex_.Lock();
+    }
+    auto& keys = top_keys_[deploy];
+    auto iter = keys.find(std::string(key));
+    if (iter != keys.end()) {
+        iter->second = deploy_estimate;
+    } else if (keys.size() < top_k_) {
+        keys.emplace(std::string(key), deploy_estimate);
+    } else {
+        auto min_iter = std::min_element(keys.begin(), keys.end(),
+                                         [](const auto& a, const auto& b) { return a.second < b.second; });
+        if (min_iter->second < deploy_estimate) {
+            keys.erase(min_iter);
+            keys.emplace(std::string(key), deploy_estimate);
+        }
+    }
+    mutex_.Unlock();
+    return estimate;
+}
+
+bool HotKeySampler::RecordIndexKey(std::string_view key) {
+    uint64_t cnt = index_record_cnt_.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (decay_interval_ > 0 && cnt % decay_interval_ == 0) {
+        index_key_sketch_.Decay();
+    }
+    return index_key_sketch_.Add(Hash(key)) >= hot_threshold_;
+}
+
+void HotKeySampler::Decay() {
+    key_sketch_.Decay();
+    deploy_key_sketch_.Decay();
+    absl::MutexLock lock(&mutex_);
+    for (auto deploy_iter = top_keys_.begin(); deploy_iter != top_keys_.end();) {
+        auto& keys = deploy_iter->second;
+        for (auto iter = keys.begin(); iter != keys.end();) {
+            iter->second >>= 1;
+            if (iter->second < hot_threshold_) {
+                iter = keys.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+        if (keys.empty()) {
+            deploy_iter = top_keys_.erase(deploy_iter);
+        } else {
+            ++deploy_iter;
+        }
+    }
+}
+
+std::vector<std::pair<std::string, uint32_t>> HotKeySampler::GetTopKeys(const std::string& deploy) const {
+    std::vector<std::pair<std::string, uint32_t>> result;
+    {
+        absl::MutexLock lock(&mutex_);
+        auto iter = top_keys_.find(deploy);
+        if (iter == top_keys_.end()) {
+            return result;
+        }
+        result.assign(iter->second.begin(), iter->second.end());
+    }
+    std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+    return result;
+}
+
+void HotKeySampler::DeleteDeploy(const std::string& deploy) {
+    absl::MutexLock lock(&mutex_);
+    top_keys_.erase(deploy);
+}
+
+std::string HotKeySampler::Desc() const {
+    std::vector<std::string> deploys;
+    {
+        absl::MutexLock lock(&mutex_);
+        for (const auto& kv : top_keys_) {
+            deploys.push_back(kv.first);
+        }
+    }
+    std::sort(deploys.begin(), deploys.end());
+    std::stringstream ss;
+    for (const auto& deploy : deploys) {
+        ss << deploy << ":[";
+        bool first = true;
+        for (const auto& kv : GetTopKeys(deploy)) {
+            if (!first) {
+                ss << ",";
+            }
+            first = false;
+            ss << kv.first << "=" << kv.second;
+        }
+        ss << "] ";
+    }
+    return ss.str();
+}
+
+static uint64_t GetCacheHit(void* arg) { return static_cast<CacheMetric*>(arg)->GetStats().hit; }
+static uint64_t GetCacheMiss(void* arg) { return static_cast<CacheMetric*>(arg)->GetStats().miss; }
+static double GetCacheHitRate(void* arg) { return static_cast<CacheMetric*>(arg)->GetHitRate(); }
+static uint64_t GetCacheByteSize(void* arg) { return static_cast<CacheMetric*>(arg)->GetStats().byte_size; }
+
+CacheMetric::CacheMetric(const std::string& prefix, const std::string& name, StatsFunc func)
+    : func_(std::move(func)),
+      hit_(prefix, name + "_hit", GetCacheHit, this),
+      miss_(prefix, name + "_miss", GetCacheMiss, this),
+      hit_rate_(prefix, name + "_hit_rate", GetCacheHitRate, this),
+      byte_size_(prefix, name + "_byte_size", GetCacheByteSize, this) {}
+
+double CacheMetric::GetHitRate() const {
+    auto stats = GetStats();
+    uint64_t total = stats.hit + stats.miss;
+    return total == 0 ? 0.0 : static_cast<double>(stats.hit) / total;
+}
+
+}  // namespace openmldb::statistics
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2022 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_STATISTICS_HOT_KEY_HOT_KEY_SAMPLER_H_
+#define SRC_STATISTICS_HOT_KEY_HOT_KEY_SAMPLER_H_
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "bvar/bvar.h"
+
+namespace openmldb::statistics {
+
+// CountMinSketch estimates the frequency of keys with depth rows of width counters. The estimation never
+// underestimates, and overestimates by at most total / width with high probability. Counters are updated
+// with relaxed atomics, so concurrent updates may be lost occasionally, which is fine for sampling.
+class CountMinSketch {
+ public:
+    CountMinSketch(uint32_t width, uint32_t depth);
+
+    // add cnt to the key and return the estimated frequency after adding
+    uint32_t Add(uint64_t hash, uint32_t cnt = 1);
+
+    uint32_t Estimate(uint64_t hash) const;
+
+    // halve all counters, so that the sketch reflects the recent access pattern
+    void Decay();
+
+    uint32_t Width() const { return width_; }
+    uint32_t Depth() const { return depth_; }
+
+ private:
+    inline uint32_t Pos(uint64_t hash, uint32_t row) const {
+        // double hashing, derive depth positions from the two halves of one hash
+        uint32_t h1 = static_cast<uint32_t>(hash);
+        uint32_t h2 = static_cast<uint32_t>(hash >> 32) | 1;
+        return row * width_ + (h1 + row * h2) % width_;
+    }
+
+    uint32_t width_;
+    uint32_t depth_;
+    std::unique_ptr<std::atomic<uint32_t>[]> counters_;
+};
+
+// HotKeySampler tracks the hot keys of online deployments. Every request feeds its routing key, the
+// estimated frequency of a key is the number of requests in recent decay_interval records. A key is hot
+// if its estimated frequency reaches hot_threshold. The top_k hottest keys of each deployment are kept
+// and exposed as a bvar named <prefix>_hot_key.
+class HotKeySampler {
+ public:
+    HotKeySampler(const std::string& prefix, uint32_t width, uint32_t depth, uint64_t decay_interval,
+                  uint32_t hot_threshold, uint32_t top_k);
+    HotKeySampler(const HotKeySampler&) = delete;
+    HotKeySampler& operator=(const HotKeySampler&) = delete;
+    ~HotKeySampler() {}
+
+    // record one access of key by deployment(<db>.<name>). return the estimated frequency of the key
+    uint32_t Record(const std::string& deploy, std::string_view key) LOCKS_EXCLUDED(mutex_);
+
+    bool IsHot(std::string_view key) const { return Estimate(key) >= hot_threshold_; }
+
+    uint32_t Estimate(std::string_view key) const { return key_sketch_.Estimate(Hash(key)); }
+
+    // record one read of an index key, e.g. a miss of the window cache, and return true if the key is hot.
+    // index keys are counted apart from routing keys, as the key of a combined index never equals the
+    // routing key of a request
+    bool RecordIndexKey(std::string_view key);
+
+    // the hot keys of deployment, order by estimated frequency desc
+    std::vector<std::pair<std::string, uint32_t>> GetTopKeys(const std::string& deploy) const LOCKS_EXCLUDED(mutex_);
+
+    void DeleteDeploy(const std::string& deploy) LOCKS_EXCLUDED(mutex_);
+
+    std::string Desc() const LOCKS_EXCLUDED(mutex_);
+
+    uint64_t GetRecordCnt() const { return record_cnt_.load(std::memory_order_relaxed); }
+
+    static uint64_t Hash(std::string_view key) { return std::hash<std::string_view>()(key); }
+
+ private:
+    void Decay() LOCKS_EXCLUDED(mutex_);
+
+    const uint64_t decay_interval_;
+    const uint32_t hot_threshold_;
+    const uint32_t top_k_;
+    std::atomic<uint64_t> record_cnt_;
+    std::atomic<uint64_t> index_record_cnt_;
+    // frequency of key, used to decide whether a key is hot
+    CountMinSketch key_sketch_;
+    // frequency of <deploy, key>, used to rank the hot keys of one deployment
+    CountMinSketch deploy_key_sketch_;
+    // frequency of index key, used to admit keys to caches keyed by index key
+    CountMinSketch index_key_sketch_;
+    std::unordered_map<std::string, std::map<std::string, uint32_t>> top_keys_ GUARDED_BY(mutex_);
+    mutable absl::Mutex mutex_;  // protects top_keys_
+    bvar::PassiveStatus<std::string> hot_key_status_;
+};
+
+// CacheMetric exposes the counters of a cache as bvars: <prefix>_<name>_hit, <prefix>_<name>_miss,
+// <prefix>_<name>_hit_rate and <prefix>_<name>_byte_size
+class CacheMetric {
+ public:
+    struct Stats {
+        uint64_t hit = 0;
+        uint64_t miss = 0;
+        uint64_t byte_size = 0;
+    };
+    using StatsFunc = std::function<Stats()>;
+
+    CacheMetric(const std::string& prefix, const std::string& name, StatsFunc func);
+    CacheMetric(const CacheMetric&) = delete;
+    CacheMetric& operator=(const CacheMetric&) = delete;
+
+    Stats GetStats() const { return func_(); }
+
+    double GetHitRate() const;
+
+ private:
+    StatsFunc func_;
+    bvar::PassiveStatus<uint64_t> hit_;
+    bvar::PassiveStatus<uint64_t> miss_;
+    bvar::PassiveStatus<double> hit_rate_;
+    bvar::PassiveStatus<uint64_t> byte_size_;
+};
+
+}  // namespace openmldb::statistics
+
+#endif  // SRC_STATISTICS_HOT_KEY_HOT_KEY_SAMPLER_H_
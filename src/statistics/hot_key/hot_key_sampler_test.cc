@@ -0,0 +1,159 @@
+/*
+ * Copyright 2022 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "statistics/hot_key/hot_key_sampler.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "gflags/gflags.h"
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace statistics {
+
+class HotKeySamplerTest : public ::testing::Test {
+ public:
+    HotKeySamplerTest() = default;
+    ~HotKeySamplerTest() override = default;
+};
+
+TEST_F(HotKeySamplerTest, CountMinSketch) {
+    CountMinSketch sketch(1024, 4);
+    for (int i = 0; i < 1000; i++) {
+        sketch.Add(HotKeySampler::Hash(absl::StrCat("key", i)));
+    }
+    for (int i = 0; i < 100; i++) {
+        sketch.Add(HotKeySampler::Hash("hot"));
+    }
+    ASSERT_GE(sketch.Estimate(HotKeySampler::Hash("hot")), 100u);
+    // the error is bounded by total / width with high probability
+    ASSERT_LE(sketch.Estimate(HotKeySampler::Hash("hot")), 100u + 1100u / 1024 * 4);
+    ASSERT_LE(sketch.Estimate(HotKeySampler::Hash("cold")), 5u);
+    sketch.Decay();
+    ASSERT_GE(sketch.Estimate(HotKeySampler::Hash("hot")), 50u);
+    ASSERT_LE(sketch.Estimate(HotKeySampler::Hash("hot")), 55u);
+}
+
+TEST_F(HotKeySamplerTest, TopKeys) {
+    HotKeySampler sampler("hot_key_sampler_test_top", 4096, 4, 0, 10, 2);
+    for (int round = 0; round < 50; round++) {
+        sampler.Record("db.d1", "k1");
+        if (round % 2 == 0) {
+            sampler.Record("db.d1", "k2");
+            sampler.Record("db.d2", "k2");
+        }
+        if (round % 5 == 0) {
+            sampler.Record("db.d1", "k3");
+        }
+        sampler.Record("db.d1", absl::StrCat("cold", round));
+    }
+    ASSERT_TRUE(sampler.IsHot("k1"));
+    ASSERT_TRUE(sampler.IsHot("k2"));
+    ASSERT_TRUE(sampler.IsHot("k3"));
+    ASSERT_FALSE(sampler.IsHot("cold1"));
+    auto keys = sampler.GetTopKeys("db.d1");
+    ASSERT_EQ(2u, keys.size());
+    ASSERT_EQ("k1", keys[0].first);
+    ASSERT_EQ("k2", keys[1].first);
+    keys = sampler.GetTopKeys("db.d2");
+    ASSERT_EQ(1u, keys.size());
+    ASSERT_EQ("k2", keys[0].first);
+    ASSERT_NE(std::string::npos, sampler.Desc().find("db.d1:[k1="));
+    sampler.DeleteDeploy("db.d1");
+    ASSERT_TRUE(sampler.GetTopKeys("db.d1").empty());
+}
+
+TEST_F(HotKeySamplerTest, Decay) {
+    HotKeySampler sampler("hot_key_sampler_test_decay", 4096, 4, 100, 20, 4);
+    for (int i = 0; i < 99; i++) {
+        sampler.Record("db.d1", i < 40 ? "k1" : absl::StrCat("other", i));
+    }
+    ASSERT_TRUE(sampler.IsHot("k1"));
+    ASSERT_EQ(1u, sampler.GetTopKeys("db.d1").size());
+    // the 100th record halves the counters
+    sampler.Record("db.d1", "other");
+    ASSERT_EQ(20u, sampler.Estimate("k1"));
+    for (int i = 0; i < 100; i++) {
+        sampler.Record("db.d1", absl::StrCat("new", i));
+    }
+    ASSERT_FALSE(sampler.IsHot("k1"));
+    ASSERT_TRUE(sampler.GetTopKeys("db.d1").empty());
+}
+
+TEST_F(HotKeySamplerTest, IndexKey) {
+    HotKeySampler sampler("hot_key_sampler_test_index_key", 4096, 4, 100, 10, 4);
+    // the routing key of requests does not make the combined index key hot
+    for (int i = 0; i < 20; i++) {
+        sampler.Record("db.d1", "k1");
+    }
+    ASSERT_TRUE(sampler.IsHot("k1"));
+    for (int i = 0; i < 9; i++) {
+        ASSERT_FALSE(sampler.RecordIndexKey("k1|v1"));
+    }
+    ASSERT_TRUE(sampler.RecordIndexKey("k1|v1"));
+    ASSERT_FALSE(sampler.IsHot("k1|v1"));
+    // index keys decay like routing keys
+    for (int i = 0; i < 90; i++) {
+        sampler.RecordIndexKey(absl::StrCat("other", i));
+    }
+    ASSERT_FALSE(sampler.RecordIndexKey("k1|v1"));
+}
+
+TEST_F(HotKeySamplerTest, Concurrent) {
+    HotKeySampler sampler("hot_key_sampler_test_concurrent", 4096, 4, 0, 100, 4);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&sampler, t]() {
+            for (int i = 0; i < 10000; i++) {
+                sampler.Record(absl::StrCat("db.d", t), i % 2 == 0 ? "hot" : absl::StrCat("k", t, "_", i));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(40000u, sampler.GetRecordCnt());
+    ASSERT_GE(sampler.Estimate("hot"), 20000u);
+    for (int t = 0; t < 4; t++) {
+        auto keys = sampler.GetTopKeys(absl::StrCat("db.d", t));
+        ASSERT_FALSE(keys.empty());
+        ASSERT_EQ("hot", keys[0].first);
+    }
+}
+
+TEST_F(HotKeySamplerTest, CacheMetric) {
+    CacheMetric::Stats stats;
+    CacheMetric metric("hot_key_sampler_test", "cache", [&stats]() { return stats; });
+    ASSERT_EQ(0.0, metric.GetHitRate());
+    stats.hit = 3;
+    stats.miss = 1;
+    stats.byte_size = 100;
+    ASSERT_DOUBLE_EQ(0.75, metric.GetHitRate());
+    ASSERT_EQ("3", bvar::Variable::describe_exposed("hot_key_sampler_test_cache_hit"));
+    ASSERT_EQ("100", bvar::Variable::describe_exposed("hot_key_sampler_test_cache_byte_size"));
+}
+
+}  // namespace statistics
+}  // namespace openmldb
+
+int main(int argc, char* argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::google::ParseCommandLineFlags(&argc, &argv, true);
+    return RUN_ALL_TESTS();
+}
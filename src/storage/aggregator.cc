@@ -17,7 +17,9 @@
 #include "storage/aggregator.h"
 
 #include <algorithm>
+#include <future>
 #include <utility>
+#include <vector>
 
 #include "absl/strings/ascii.h"
 #include "absl/strings/match.h"
@@ -27,6 +29,8 @@
 #include "base/slice.h"
 #include "base/strings.h"
 #include "common/timer.h"
+#include "storage/index_organized_table.h"
+#include "storage/mem_table.h"
 #include "storage/table.h"
 
 DECLARE_bool(binlog_notify_on_put);
@@ -54,11 +58,61 @@ std::string AggrStatToString(AggrStat type) {
     return output;
 }
 
+// the rows rebuilding an aggr buffer are aggregated in batches of the size
+static constexpr size_t kRebuildBatchRows = 1024;
+
+// decode the non-null values of the aggr column of rows and reduce them with `reduce`, which runs before the values
+// are counted in non_null_cnt_
+template <typename T, typename F>
+static bool ReduceColumn(const codec::RowView& row_view, const std::vector<const int8_t*>& row_ptrs, uint32_t idx,
+                         DataType type, AggrBuffer* aggr_buffer, F reduce) {
+    std::vector<T> vals;
+    vals.reserve(row_ptrs.size());
+    if (row_view.GetValues(row_ptrs, idx, type, &vals) < 0) {
+        PDLOG(ERROR, "decode aggr column failed");
+        return false;
+    }
+    if (!vals.empty()) {
+        reduce(vals);
+        aggr_buffer->non_null_cnt_ += vals.size();
+    }
+    return true;
+}
+
+// the reductions are plain loops over the decoded values, which the compiler vectorizes for the integer sums and
+// min/max. the floating point sums add the values in order so that they equal the row by row updates
+template <typename T, typename S>
+static void SumValues(const std::vector<T>& vals, S* sum) {
+    S result = *sum;
+    for (T val : vals) {
+        result += val;
+    }
+    *sum = result;
+}
+
+template <typename T>
+static void MinValues(const std::vector<T>& vals, bool empty, T* min) {
+    T result = empty ? vals[0] : *min;
+    for (T val : vals) {
+        result = val < result ? val : result;
+    }
+    *min = result;
+}
+
+template <typename T>
+static void MaxValues(const std::vector<T>& vals, bool empty, T* max) {
+    T result = empty ? vals[0] : *max;
+    for (T val : vals) {
+        result = val > result ? val : result;
+    }
+    *max = result;
+}
+
 Aggregator::Aggregator(const ::openmldb::api::TableMeta& base_meta, std::shared_ptr<Table> base_table,
         const ::openmldb::api::TableMeta& aggr_meta, std::shared_ptr<Table> aggr_table,
         std::shared_ptr<LogReplicator> aggr_replicator,
         uint32_t index_pos, const std::string& aggr_col, const AggrType& aggr_type,
-        const std::string& ts_col, WindowType window_tpye, uint32_t window_size)
+        const std::string& ts_col, WindowType window_tpye, int64_t window_size)
     : base_table_schema_(base_meta.column_desc()),
       base_table_(base_table),
       aggr_table_schema_(aggr_meta.column_desc()),
@@ -382,17 +436,33 @@ bool Aggregator::RebuildAggrBuffer(const std::string& key, AggrBuffer* aggr_buff
     aggr_buffer->ts_end_ = ts_end;
     aggr_buffer->binlog_offset_ = binlog_offset;
     aggr_buffer->data_type_ = data_type;
+    // the rows of an uncompressed MemTable stay in place while the ticket is held. the other tables, e.g. the disk
+    // tables and the index organized tables, may decode a row into a buffer of the iterator, so their rows are
+    // aggregated one by one
+    bool rows_in_place = base_table_->GetStorageMode() == ::openmldb::common::kMemory &&
+                         base_table_->GetCompressType() == ::openmldb::type::kNoCompress &&
+                         std::dynamic_pointer_cast<MemTable>(base_table_) &&
+                         !std::dynamic_pointer_cast<IndexOrganizedTable>(base_table_);
+    size_t batch_rows = rows_in_place ? kRebuildBatchRows : 1;
+    std::vector<const int8_t*> row_ptrs;
+    row_ptrs.reserve(batch_rows);
     it->Seek(ts_end);
-    while (it->Valid()) {
-        if (it->GetKey() < static_cast<uint64_t>(ts_begin)) {
-            break;
+    while (true) {
+        bool valid = it->Valid() && it->GetKey() >= static_cast<uint64_t>(ts_begin);
+        if (valid) {
+            row_ptrs.push_back(reinterpret_cast<const int8_t*>(it->GetValue().data()));
         }
-        auto base_row_ptr = reinterpret_cast<const int8_t*>(it->GetValue().data());
-        if (!UpdateAggrVal(base_row_view_, base_row_ptr, aggr_buffer)) {
-            PDLOG(WARNING, "Failed to update aggr Val during rebuilding Extermum aggr buffer");
-            return false;
+        if (!row_ptrs.empty() && (!valid || row_ptrs.size() >= batch_rows)) {
+            if (!BatchUpdateAggrVal(base_row_view_, row_ptrs, aggr_buffer)) {
+                PDLOG(WARNING, "Failed to update aggr Val during rebuilding Extermum aggr buffer");
+                return false;
+            }
+            aggr_buffer->aggr_cnt_ += row_ptrs.size();
+            row_ptrs.clear();
+        }
+        if (!valid) {
+            break;
         }
-        aggr_buffer->aggr_cnt_++;
         it->Next();
     }
     return true;
@@ -732,6 +802,16 @@ bool Aggregator::UpdateFlushedBuffer(const std::string& key, const std::string&
     return true;
 }
 
+bool Aggregator::BatchUpdateAggrVal(const codec::RowView& row_view, const std::vector<const int8_t*>& row_ptrs,
+                                    AggrBuffer* aggr_buffer) {
+    for (auto row_ptr : row_ptrs) {
+        if (!UpdateAggrVal(row_view, row_ptr, aggr_buffer)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool Aggregator::CheckBufferFilled(int64_t cur_ts, int64_t buffer_end, int32_t buffer_cnt) {
     if (window_type_ == WindowType::kRowsRange && cur_ts > buffer_end) {
         return true;
@@ -745,7 +825,7 @@ SumAggregator::SumAggregator(const ::openmldb::api::TableMeta& base_meta, std::s
         const ::openmldb::api::TableMeta& aggr_meta, std::shared_ptr<Table> aggr_table,
         std::shared_ptr<LogReplicator> aggr_replicator,
         uint32_t index_pos, const std::string& aggr_col, const AggrType& aggr_type,
-        const std::string& ts_col, WindowType window_tpye, uint32_t window_size)
+        const std::string& ts_col, WindowType window_tpye, int64_t window_size)
     : Aggregator(base_meta, base_table, aggr_meta, aggr_table, aggr_replicator, index_pos,
             aggr_col, aggr_type, ts_col, window_tpye, window_size) {}
 
@@ -794,6 +874,33 @@ bool SumAggregator::UpdateAggrVal(const codec::RowView& row_view, const int8_t*
     return true;
 }
 
+bool SumAggregator::BatchUpdateAggrVal(const codec::RowView& row_view, const std::vector<const int8_t*>& row_ptrs,
+                                       AggrBuffer* aggr_buffer) {
+    auto& aggr_val = aggr_buffer->aggr_val_;
+    switch (aggr_col_type_) {
+        case DataType::kSmallInt:
+            return ReduceColumn<int16_t>(row_view, row_ptrs, aggr_col_idx_, aggr_col_type_, aggr_buffer,
+                                         [&aggr_val](const auto& vals) { SumValues(vals, &aggr_val.vlong); });
+        case DataType::kInt:
+            return ReduceColumn<int32_t>(row_view, row_ptrs, aggr_col_idx_, aggr_col_type_, aggr_buffer,
+                                         [&aggr_val](const auto& vals) { SumValues(vals, &aggr_val.vlong); });
+        case DataType::kTimestamp:
+        case DataType::kBigInt:
+            return ReduceColumn<int64_t>(row_view, row_ptrs, aggr_col_idx_, aggr_col_type_, aggr_buffer,
+                                         [&aggr_val](const auto& vals) { SumValues(vals, &aggr_val.vlong); });
+        case DataType::kFloat:
+            return ReduceColumn<float>(row_view, row_ptrs, aggr_col_idx_, aggr_col_type_, aggr_buffer,
+                                       [&aggr_val](const auto& vals) { SumValues(vals, &aggr_val.vfloat); });
+        case DataType::kDouble:
+            return ReduceColumn<double>(row_view, row_ptrs, aggr_col_idx_, aggr_col_type_, aggr_buffer,
+                                        [&aggr_val](const auto& vals) { SumValues(vals, &aggr_val.vdouble); });
+        default: {
+            PDLOG(ERROR, "Unsupported data type");
+            return false;
+        }
+    }
+}
+
 bool SumAggregator::EncodeAggrVal(const AggrBuffer& buffer, std::string* aggr_val) {
     switch (aggr_col_type_) {
         case DataType::kSmallInt:
@@ -861,7 +968,7 @@ MinMaxBaseAggregator::MinMaxBaseAggregator(const ::openmldb::api::TableMeta& bas
                                            std::shared_ptr<Table> aggr_table,
                                            std::shared_ptr<LogReplicator> aggr_replicator, uint32_t index_pos,
                                            const std::string& aggr_col, const AggrType& aggr_type,
-                                           const std::string& ts_col, WindowType window_tpye, uint32_t window_size)
+                                           const std::string& ts_col, WindowType window_tpye, int64_t window_size)
     : Aggregator(base_meta, base_table, aggr_meta, aggr_table, aggr_replicator, index_pos, aggr_col, aggr_type,
             ts_col, window_tpye, window_size) {}
 
@@ -967,7 +1074,7 @@ MinAggregator::MinAggregator(const ::openmldb::api::TableMeta& base_meta, std::s
         const ::openmldb::api::TableMeta& aggr_meta, std::shared_ptr<Table> aggr_table,
         std::shared_ptr<LogReplicator> aggr_replicator,
         uint32_t index_pos, const std::string& aggr_col, const AggrType& aggr_type,
-        const std::string& ts_col, WindowType window_tpye, uint32_t window_size)
+        const std::string& ts_col, WindowType window_tpye, int64_t window_size)
     : MinMaxBaseAggregator(base_meta, base_table, aggr_meta, aggr_table, aggr_replicator, index_pos,
             aggr_col, aggr_type, ts_col, window_tpye, window_size) {}
 
@@ -1046,11 +1153,49 @@ bool MinAggregator::UpdateAggrVal(const codec::RowView& row_view, const int8_t*
     return true;
 }
 
+bool MinAggregator::BatchUpdateAggrVal(const codec::RowView& row_view, const std::vector<const int8_t*>& row_ptrs,
+                                       AggrBuffer* aggr_buffer) {
+    auto& aggr_val = aggr_buffer->aggr_val_;
+    bool empty = aggr_buffer->AggrValEmpty();
+    switch (aggr_col_type_) {
+        case DataType::kSmallInt:
+            return ReduceColumn<int16_t>(row_view, row_ptrs, aggr_col_idx_, aggr_col_type_, aggr_buffer,
+                                         [&aggr_val, empty](const auto& vals) {
+                                             MinValues(vals, empty, &aggr_val.vsmallint);
+                                         });
+        case DataType::kDate:
+        case DataType::kInt:
+            return ReduceColumn<int32_t>(row_view, row_ptrs, aggr_col_idx_, aggr_col_type_, aggr_buffer,
+                                         [&aggr_val, empty](const auto& vals) {
+                                             MinValues(vals, empty, &aggr_val.vint);
+                                         });
+        case DataType::kTimestamp:
+        case DataType::kBigInt:
+            return ReduceColumn<int64_t>(row_view, row_ptrs, aggr_col_idx_, aggr_col_type_, aggr_buffer,
+                                         [&aggr_val, empty](const auto& vals) {
+                                             MinValues(vals, empty, &aggr_val.vlong);
+                                         });
+        case DataType::kFloat:
+            return ReduceColumn<float>(row_view, row_ptrs, aggr_col_idx_, aggr_col_type_, aggr_buffer,
+                                       [&aggr_val, empty](const auto& vals) {
+                                           MinValues(vals, empty, &aggr_val.vfloat);
+                                       });
+        case DataType::kDouble:
+            return ReduceColumn<double>(row_view, row_ptrs, aggr_col_idx_, aggr_col_type_, aggr_buffer,
+                                        [&aggr_val, empty](const auto& vals) {
+                                            MinValues(vals, empty, &aggr_val.vdouble);
+                                        });
+        default:
+            // the strings are compared row by row
+            return Aggregator::BatchUpdateAggrVal(row_view, row_ptrs, aggr_buffer);
+    }
+}
+
 MaxAggregator::MaxAggregator(const ::openmldb::api::TableMeta& base_meta, std::shared_ptr<Table> base_table,
         const ::openmldb::api::TableMeta& aggr_meta, std::shared_ptr<Table> aggr_table,
         std::shared_ptr<LogReplicator> aggr_replicator,
         uint32_t index_pos, const std::string& aggr_col, const AggrType& aggr_type,
-        const std::string& ts_col, WindowType window_tpye, uint32_t window_size)
+        const std::string& ts_col, WindowType window_tpye, int64_t window_size)
     : MinMaxBaseAggregator(base_meta, base_table, aggr_meta, aggr_table, aggr_replicator, index_pos,
             aggr_col, aggr_type, ts_col, window_tpye, window_size) {}
 
@@ -1129,11 +1274,49 @@ bool MaxAggregator::UpdateAggrVal(const codec::RowView& row_view, const int8_t*
     return true;
 }
 
+bool MaxAggregator::BatchUpdateAggrVal(const codec::RowView& row_view, const std::vector<const int8_t*>& row_ptrs,
+                                       AggrBuffer* aggr_buffer) {
+    auto& aggr_val = aggr_buffer->aggr_val_;
+    bool empty = aggr_buffer->AggrValEmpty();
+    switch (aggr_col_type_) {
+        case DataType::kSmallInt:
+            return ReduceColumn<int16_t>(row_view, row_ptrs, aggr_col_idx_, aggr_col_type_, aggr_buffer,
+                                         [&aggr_val, empty](const auto& vals) {
+                                             MaxValues(vals, empty, &aggr_val.vsmallint);
+                                         });
+        case DataType::kDate:
+        case DataType::kInt:
+            return ReduceColumn<int32_t>(row_view, row_ptrs, aggr_col_idx_, aggr_col_type_, aggr_buffer,
+                                         [&aggr_val, empty](const auto& vals) {
+                                             MaxValues(vals, empty, &aggr_val.vint);
+                                         });
+        case DataType::kTimestamp:
+        case DataType::kBigInt:
+            return ReduceColumn<int64_t>(row_view, row_ptrs, aggr_col_idx_, aggr_col_type_, aggr_buffer,
+                                         [&aggr_val, empty](const auto& vals) {
+                                             MaxValues(vals, empty, &aggr_val.vlong);
+                                         });
+        case DataType::kFloat:
+            return ReduceColumn<float>(row_view, row_ptrs, aggr_col_idx_, aggr_col_type_, aggr_buffer,
+                                       [&aggr_val, empty](const auto& vals) {
+                                           MaxValues(vals, empty, &aggr_val.vfloat);
+                                       });
+        case DataType::kDouble:
+            return ReduceColumn<double>(row_view, row_ptrs, aggr_col_idx_, aggr_col_type_, aggr_buffer,
+                                        [&aggr_val, empty](const auto& vals) {
+                                            MaxValues(vals, empty, &aggr_val.vdouble);
+                                        });
+        default:
+            // the strings are compared row by row
+            return Aggregator::BatchUpdateAggrVal(row_view, row_ptrs, aggr_buffer);
+    }
+}
+
 CountAggregator::CountAggregator(const ::openmldb::api::TableMeta& base_meta, std::shared_ptr<Table> base_table,
                                  const ::openmldb::api::TableMeta& aggr_meta, std::shared_ptr<Table> aggr_table,
                                  std::shared_ptr<LogReplicator> aggr_replicator, uint32_t index_pos,
                                  const std::string& aggr_col, const AggrType& aggr_type, const std::string& ts_col,
-                                 WindowType window_tpye, uint32_t window_size)
+                                 WindowType window_tpye, int64_t window_size)
     : Aggregator(base_meta, base_table, aggr_meta, aggr_table, aggr_replicator, index_pos, aggr_col, aggr_type,
             ts_col, window_tpye, window_size) {
     if (aggr_col == "*") {
@@ -1164,11 +1347,25 @@ bool CountAggregator::UpdateAggrVal(const codec::RowView& row_view, const int8_t
     return true;
 }
 
+bool CountAggregator::BatchUpdateAggrVal(const codec::RowView& row_view, const std::vector<const int8_t*>& row_ptrs,
+                                         AggrBuffer* aggr_buffer) {
+    if (count_all) {
+        aggr_buffer->non_null_cnt_ += row_ptrs.size();
+        return true;
+    }
+    for (auto row_ptr : row_ptrs) {
+        if (!row_view.IsNULL(row_ptr, aggr_col_idx_)) {
+            aggr_buffer->non_null_cnt_++;
+        }
+    }
+    return true;
+}
+
 AvgAggregator::AvgAggregator(const ::openmldb::api::TableMeta& base_meta, std::shared_ptr<Table> base_table,
         const ::openmldb::api::TableMeta& aggr_meta, std::shared_ptr<Table> aggr_table,
         std::shared_ptr<LogReplicator> aggr_replicator,
         uint32_t index_pos, const std::string& aggr_col, const AggrType& aggr_type,
-        const std::string& ts_col, WindowType window_tpye, uint32_t window_size)
+        const std::string& ts_col, WindowType window_tpye, int64_t window_size)
     : Aggregator(base_meta, base_table, aggr_meta, aggr_table, aggr_replicator, index_pos,
             aggr_col, aggr_type, ts_col, window_tpye, window_size) {}
 
@@ -1216,6 +1413,32 @@ bool AvgAggregator::UpdateAggrVal(const codec::RowView& row_view, const int8_t*
     return true;
 }
 
+bool AvgAggregator::BatchUpdateAggrVal(const codec::RowView& row_view, const std::vector<const int8_t*>& row_ptrs,
+                                       AggrBuffer* aggr_buffer) {
+    auto& aggr_val = aggr_buffer->aggr_val_;
+    switch (aggr_col_type_) {
+        case DataType::kSmallInt:
+            return ReduceColumn<int16_t>(row_view, row_ptrs, aggr_col_idx_, aggr_col_type_, aggr_buffer,
+                                         [&aggr_val](const auto& vals) { SumValues(vals, &aggr_val.vdouble); });
+        case DataType::kInt:
+            return ReduceColumn<int32_t>(row_view, row_ptrs, aggr_col_idx_, aggr_col_type_, aggr_buffer,
+                                         [&aggr_val](const auto& vals) { SumValues(vals, &aggr_val.vdouble); });
+        case DataType::kBigInt:
+            return ReduceColumn<int64_t>(row_view, row_ptrs, aggr_col_idx_, aggr_col_type_, aggr_buffer,
+                                         [&aggr_val](const auto& vals) { SumValues(vals, &aggr_val.vdouble); });
+        case DataType::kFloat:
+            return ReduceColumn<float>(row_view, row_ptrs, aggr_col_idx_, aggr_col_type_, aggr_buffer,
+                                       [&aggr_val](const auto& vals) { SumValues(vals, &aggr_val.vdouble); });
+        case DataType::kDouble:
+            return ReduceColumn<double>(row_view, row_ptrs, aggr_col_idx_, aggr_col_type_, aggr_buffer,
+                                        [&aggr_val](const auto& vals) { SumValues(vals, &aggr_val.vdouble); });
+        default: {
+            PDLOG(ERROR, "Unsupported data type");
+            return false;
+        }
+    }
+}
+
 bool AvgAggregator::EncodeAggrVal(const AggrBuffer& buffer, std::string* aggr_val) {
     double tmp_val = buffer.aggr_val_.vdouble;
     aggr_val->assign(reinterpret_cast<char*>(&tmp_val), sizeof(double));
@@ -1245,7 +1468,7 @@ std::shared_ptr<Aggregator> CreateAggregator(const ::openmldb::api::TableMeta& b
                                              const std::string& filter_col) {
     std::string aggr_type = absl::AsciiStrToLower(aggr_func);
     WindowType window_type;
-    uint32_t window_size;
+    int64_t window_size;
     if (::openmldb::base::IsNumber(bucket_size)) {
         window_type = WindowType::kRowsNum;
         window_size = std::stoi(bucket_size);
@@ -1264,16 +1487,16 @@ std::shared_ptr<Aggregator> CreateAggregator(const ::openmldb::api::TableMeta& b
         }
         switch (time_unit) {
             case 's':
-                window_size = std::stoi(time_size) * 1000;
+                window_size = std::stoll(time_size) * 1000;
                 break;
             case 'm':
-                window_size = std::stoi(time_size) * 1000 * 60;
+                window_size = std::stoll(time_size) * 1000 * 60;
                 break;
             case 'h':
-                window_size = std::stoi(time_size) * 1000 * 60 * 60;
+                window_size = std::stoll(time_size) * 1000 * 60 * 60;
                 break;
             case 'd':
-                window_size = std::stoi(time_size) * 1000 * 60 * 60 * 24;
+                window_size = std::stoll(time_size) * 1000 * 60 * 60 * 24;
                 break;
             default: {
                 PDLOG(ERROR, "Unsupported time unit");
@@ -1320,5 +1543,94 @@ std::shared_ptr<Aggregator> CreateAggregator(const ::openmldb::api::TableMeta& b
     return agg;
 }
 
+AsyncAggrUpdater::AsyncAggrUpdater(uint32_t thread_num, uint64_t max_pending)
+    : max_pending_(max_pending), pools_(), pending_cnt_(0), failed_cnt_(0), blocked_cnt_(0), mu_(), cv_() {
+    for (uint32_t i = 0; i < std::max<uint32_t>(thread_num, 1); i++) {
+        pools_.emplace_back(std::make_unique<::baidu::common::ThreadPool>(1));
+    }
+}
+
+AsyncAggrUpdater::~AsyncAggrUpdater() {
+    for (auto& pool : pools_) {
+        pool->Stop(true);
+    }
+}
+
+::baidu::common::ThreadPool* AsyncAggrUpdater::GetPool(const std::string& key) {
+    return pools_[std::hash<std::string>()(key) % pools_.size()].get();
+}
+
+void AsyncAggrUpdater::Update(const std::shared_ptr<Aggrs>& aggrs, const std::string& value,
+                              const Dimensions& dimensions, uint64_t offset) {
+    if (!aggrs) {
+        return;
+    }
+    std::shared_ptr<std::string> shared_value;
+    for (const auto& dimension : dimensions) {
+        uint32_t idx = dimension.idx();
+        bool has_aggr = std::any_of(aggrs->begin(), aggrs->end(),
+                                    [idx](const auto& aggr) { return aggr->GetIndexPos() == idx; });
+        if (!has_aggr) {
+            continue;
+        }
+        if (!shared_value) {
+            shared_value = std::make_shared<std::string>(value);
+        }
+        WaitForSpace();
+        pending_cnt_.fetch_add(1, std::memory_order_relaxed);
+        GetPool(dimension.key())->AddTask([this, aggrs, shared_value, key = dimension.key(), idx, offset]() {
+            for (const auto& aggr : *aggrs) {
+                if (aggr->GetIndexPos() != idx) {
+                    continue;
+                }
+                if (!aggr->Update(key, *shared_value, offset)) {
+                    failed_cnt_.fetch_add(1, std::memory_order_relaxed);
+                    PDLOG(WARNING, "async update aggr failed. aggr table tid[%u] index[%u] key[%s] offset[%lu]",
+                          aggr->GetAggrTid(), idx, key.c_str(), offset);
+                }
+            }
+            Done();
+        });
+    }
+}
+
+void AsyncAggrUpdater::WaitForSpace() {
+    if (max_pending_ == 0 || pending_cnt_.load(std::memory_order_relaxed) < max_pending_) {
+        return;
+    }
+    blocked_cnt_.fetch_add(1, std::memory_order_relaxed);
+    std::unique_lock<std::mutex> lock(mu_);
+    cv_.wait(lock, [this]() { return pending_cnt_.load(std::memory_order_relaxed) < max_pending_; });
+}
+
+void AsyncAggrUpdater::Done() {
+    uint64_t pending = pending_cnt_.fetch_sub(1, std::memory_order_relaxed);
+    // only the update leaving the full queues wakes up the waiting puts. taking the lock makes sure a put checking
+    // the count is either waiting already or sees the new count
+    if (max_pending_ > 0 && pending >= max_pending_) {
+        { std::lock_guard<std::mutex> lock(mu_); }
+        cv_.notify_all();
+    }
+}
+
+bool AsyncAggrUpdater::Run(const std::string& key, const std::function<bool()>& fn) {
+    auto result = std::make_shared<std::promise<bool>>();
+    auto future = result->get_future();
+    GetPool(key)->AddTask([result, &fn]() { result->set_value(fn()); });
+    return future.get();
+}
+
+void AsyncAggrUpdater::Flush() {
+    std::vector<std::future<void>> futures;
+    for (auto& pool : pools_) {
+        auto done = std::make_shared<std::promise<void>>();
+        futures.push_back(done->get_future());
+        pool->AddTask([done]() { done->set_value(); });
+    }
+    for (auto& future : futures) {
+        future.wait();
+    }
+}
+
 }  // namespace storage
 }  // namespace openmldb
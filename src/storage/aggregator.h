@@ -17,6 +17,9 @@
 #ifndef SRC_STORAGE_AGGREGATOR_H_
 #define SRC_STORAGE_AGGREGATOR_H_
 
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -24,6 +27,7 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "codec/codec.h"
+#include "common/thread_pool.h"
 #include "proto/tablet.pb.h"
 #include "proto/type.pb.h"
 #include "replica/log_replicator.h"
@@ -124,7 +128,7 @@ class Aggregator {
             const ::openmldb::api::TableMeta& aggr_meta, std::shared_ptr<Table> aggr_table,
             std::shared_ptr<LogReplicator> aggr_replicator,
             uint32_t index_pos, const std::string& aggr_col, const AggrType& aggr_type,
-            const std::string& ts_col, WindowType window_tpye, uint32_t window_size);
+            const std::string& ts_col, WindowType window_tpye, int64_t window_size);
 
     ~Aggregator();
 
@@ -144,7 +148,7 @@ class Aggregator {
 
     WindowType GetWindowType() const { return window_type_; }
 
-    uint32_t GetWindowSize() const { return window_size_; }
+    int64_t GetWindowSize() const { return window_size_; }
 
     AggrStat GetStat() const { return status_.load(std::memory_order_relaxed); }
 
@@ -159,6 +163,18 @@ class Aggregator {
 
     std::shared_ptr<Table> GetAggTable() { return aggr_table_; }
 
+    // update the aggr value of buffer with the base rows, the same as updating it with the rows one by one.
+    // aggr_cnt_ of buffer is not changed
+    bool BatchUpdate(const std::vector<const int8_t*>& row_ptrs, AggrBuffer* aggr_buffer) {
+        return BatchUpdateAggrVal(base_row_view_, row_ptrs, aggr_buffer);
+    }
+
+    // update the aggr value of buffer with one base row, the row by row path of Update.
+    // aggr_cnt_ of buffer is not changed
+    bool UpdateRow(const int8_t* row_ptr, AggrBuffer* aggr_buffer) {
+        return UpdateAggrVal(base_row_view_, row_ptr, aggr_buffer);
+    }
+
  protected:
     codec::Schema base_table_schema_;
 
@@ -178,6 +194,11 @@ class Aggregator {
     bool UpdateFlushedBuffer(const std::string& key, const std::string& filter_key, const int8_t* base_row_ptr,
                              int64_t cur_ts, uint64_t offset);
     bool CheckBufferFilled(int64_t cur_ts, int64_t buffer_end, int32_t buffer_cnt);
+    // update the aggr value with the rows one by one by default. the aggregators of the fixed size types override it
+    // to decode the aggr column of all rows first and reduce the values in a tight loop. the rows must stay valid
+    // during the call
+    virtual bool BatchUpdateAggrVal(const codec::RowView& row_view, const std::vector<const int8_t*>& row_ptrs,
+                                    AggrBuffer* aggr_buffer);
 
  private:
     bool DeleteData(const std::string& key, const std::optional<uint64_t>& start_ts,
@@ -213,7 +234,7 @@ class Aggregator {
 
     // for kRowsNum, window_size_ is the rows num in mini window
     // for kRowsRange, window size is the time interval in mini window
-    int32_t window_size_;
+    int64_t window_size_;
 
     codec::RowView base_row_view_;
     codec::RowView aggr_row_view_;
@@ -226,13 +247,16 @@ class SumAggregator : public Aggregator {
             const ::openmldb::api::TableMeta& aggr_meta, std::shared_ptr<Table> aggr_table,
             std::shared_ptr<LogReplicator> aggr_replicator,
             uint32_t index_pos, const std::string& aggr_col, const AggrType& aggr_type,
-            const std::string& ts_col, WindowType window_tpye, uint32_t window_size);
+            const std::string& ts_col, WindowType window_tpye, int64_t window_size);
 
     ~SumAggregator() = default;
 
  private:
     bool UpdateAggrVal(const codec::RowView& row_view, const int8_t* row_ptr, AggrBuffer* aggr_buffer) override;
 
+    bool BatchUpdateAggrVal(const codec::RowView& row_view, const std::vector<const int8_t*>& row_ptrs,
+                            AggrBuffer* aggr_buffer) override;
+
     bool EncodeAggrVal(const AggrBuffer& buffer, std::string* aggr_val) override;
 
     bool DecodeAggrVal(const int8_t* row_ptr, AggrBuffer* buffer) override;
@@ -244,7 +268,7 @@ class MinMaxBaseAggregator : public Aggregator {
             const ::openmldb::api::TableMeta& aggr_meta, std::shared_ptr<Table> aggr_table,
             std::shared_ptr<LogReplicator> aggr_replicator,
             uint32_t index_pos, const std::string& aggr_col, const AggrType& aggr_type,
-            const std::string& ts_col, WindowType window_tpye, uint32_t window_size);
+            const std::string& ts_col, WindowType window_tpye, int64_t window_size);
 
     ~MinMaxBaseAggregator() = default;
 
@@ -259,12 +283,15 @@ class MinAggregator : public MinMaxBaseAggregator {
             const ::openmldb::api::TableMeta& aggr_meta, std::shared_ptr<Table> aggr_table,
             std::shared_ptr<LogReplicator> aggr_replicator,
             uint32_t index_pos, const std::string& aggr_col, const AggrType& aggr_type,
-            const std::string& ts_col, WindowType window_tpye, uint32_t window_size);
+            const std::string& ts_col, WindowType window_tpye, int64_t window_size);
 
     ~MinAggregator() = default;
 
  private:
     bool UpdateAggrVal(const codec::RowView& row_view, const int8_t* row_ptr, AggrBuffer* aggr_buffer) override;
+
+    bool BatchUpdateAggrVal(const codec::RowView& row_view, const std::vector<const int8_t*>& row_ptrs,
+                            AggrBuffer* aggr_buffer) override;
 };
 
 class MaxAggregator : public MinMaxBaseAggregator {
@@ -273,12 +300,15 @@ class MaxAggregator : public MinMaxBaseAggregator {
             const ::openmldb::api::TableMeta& aggr_meta, std::shared_ptr<Table> aggr_table,
             std::shared_ptr<LogReplicator> aggr_replicator,
             uint32_t index_pos, const std::string& aggr_col, const AggrType& aggr_type,
-            const std::string& ts_col, WindowType window_tpye, uint32_t window_size);
+            const std::string& ts_col, WindowType window_tpye, int64_t window_size);
 
     ~MaxAggregator() = default;
 
  private:
     bool UpdateAggrVal(const codec::RowView& row_view, const int8_t* row_ptr, AggrBuffer* aggr_buffer) override;
+
+    bool BatchUpdateAggrVal(const codec::RowView& row_view, const std::vector<const int8_t*>& row_ptrs,
+                            AggrBuffer* aggr_buffer) override;
 };
 
 class CountAggregator : public Aggregator {
@@ -287,13 +317,16 @@ class CountAggregator : public Aggregator {
             const ::openmldb::api::TableMeta& aggr_meta, std::shared_ptr<Table> aggr_table,
             std::shared_ptr<LogReplicator> aggr_replicator,
             uint32_t index_pos, const std::string& aggr_col, const AggrType& aggr_type,
-            const std::string& ts_col, WindowType window_tpye, uint32_t window_size);
+            const std::string& ts_col, WindowType window_tpye, int64_t window_size);
 
     ~CountAggregator() = default;
 
  private:
     bool UpdateAggrVal(const codec::RowView& row_view, const int8_t* row_ptr, AggrBuffer* aggr_buffer) override;
 
+    bool BatchUpdateAggrVal(const codec::RowView& row_view, const std::vector<const int8_t*>& row_ptrs,
+                            AggrBuffer* aggr_buffer) override;
+
     bool EncodeAggrVal(const AggrBuffer& buffer, std::string* aggr_val) override;
 
     bool DecodeAggrVal(const int8_t* row_ptr, AggrBuffer* buffer) override;
@@ -307,13 +340,16 @@ class AvgAggregator : public Aggregator {
             const ::openmldb::api::TableMeta& aggr_meta, std::shared_ptr<Table> aggr_table,
             std::shared_ptr<LogReplicator> aggr_replicator,
             uint32_t index_pos, const std::string& aggr_col, const AggrType& aggr_type,
-            const std::string& ts_col, WindowType window_tpye, uint32_t window_size);
+            const std::string& ts_col, WindowType window_tpye, int64_t window_size);
 
     ~AvgAggregator() = default;
 
  private:
     bool UpdateAggrVal(const codec::RowView& row_view, const int8_t* row_ptr, AggrBuffer* aggr_buffer) override;
 
+    bool BatchUpdateAggrVal(const codec::RowView& row_view, const std::vector<const int8_t*>& row_ptrs,
+                            AggrBuffer* aggr_buffer) override;
+
     bool EncodeAggrVal(const AggrBuffer& buffer, std::string* aggr_val) override;
 
     bool DecodeAggrVal(const int8_t* row_ptr, AggrBuffer* buffer) override;
@@ -329,6 +365,49 @@ std::shared_ptr<Aggregator> CreateAggregator(const ::openmldb::api::TableMeta& b
                                              const std::string& filter_col = "");
 
 using Aggrs = std::vector<std::shared_ptr<Aggregator>>;
+
+// Apply the updates of aggregators on dedicated threads instead of the put path.
+// The updates are partitioned by key onto single-thread pools, so the updates of a key are still applied in the
+// order of binlog offset. The pre-aggr table lags behind the base table, the rows newer than the last flushed bucket
+// are read from the base table by RequestAggUnionRunner, so the lag only costs the query more base rows.
+// The queued updates are not persisted, they are recovered from the binlog by Aggregator::Init after a restart.
+// A put waits for the queues to drain while max_pending updates are queued. It does not
+// update the aggregators itself, as that would overtake the queued updates of the same key.
+class AsyncAggrUpdater {
+ public:
+    // 0 max_pending means no limit
+    AsyncAggrUpdater(uint32_t thread_num, uint64_t max_pending);
+    ~AsyncAggrUpdater();
+
+    // queue the updates of all dimensions of a put, it must be called in the order of offset.
+    // it blocks while max_pending updates are queued
+    void Update(const std::shared_ptr<Aggrs>& aggrs, const std::string& value, const Dimensions& dimensions,
+                uint64_t offset);
+
+    // run `fn` after the queued updates of `key` and wait for the result, e.g. delete the key from aggregators
+    bool Run(const std::string& key, const std::function<bool()>& fn);
+
+    // wait until all updates queued before are applied
+    void Flush();
+
+    uint64_t GetPendingCnt() const { return pending_cnt_.load(std::memory_order_relaxed); }
+    uint64_t GetFailedCnt() const { return failed_cnt_.load(std::memory_order_relaxed); }
+    // the number of times a put waited for the full queues
+    uint64_t GetBlockedCnt() const { return blocked_cnt_.load(std::memory_order_relaxed); }
+
+ private:
+    ::baidu::common::ThreadPool* GetPool(const std::string& key);
+    void WaitForSpace();
+    void Done();
+
+    const uint64_t max_pending_;
+    std::vector<std::unique_ptr<::baidu::common::ThreadPool>> pools_;
+    std::atomic<uint64_t> pending_cnt_;
+    std::atomic<uint64_t> failed_cnt_;
+    std::atomic<uint64_t> blocked_cnt_;
+    std::mutex mu_;
+    std::condition_variable cv_;
+};
 }  // namespace storage
 }  // namespace openmldb
 
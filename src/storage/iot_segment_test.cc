@@ -223,7 +223,7 @@ TEST_F(IOTSegmentTest, TestGc4TTL) {
         segment->IncrGcVersion();  // delta default is 2, version should >=2, and node_cache free version should >= 3
         segment->GcFreeList(&statistics_info);
         // don't know why 197
-        ASSERT_TRUE(CheckStatisticsInfo({1}, 197, GetRecordSize(5), statistics_info));
+        ASSERT_TRUE(CheckStatisticsInfo({1}, 241, GetRecordSize(5), statistics_info));
     }
 }
 
@@ -72,7 +72,8 @@ struct TimeComparator {
 };
 
 static const TimeComparator tcmp;
-using TimeEntries = base::Skiplist<uint64_t, DataBlock*, TimeComparator>;
+// indexable, so the rows of a key are accessed by position and counted in O(log n)
+using TimeEntries = base::Skiplist<uint64_t, DataBlock*, TimeComparator, true>;
 struct StatisticsInfo;
 
 class KeyEntry {
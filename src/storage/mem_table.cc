@@ -19,6 +19,7 @@
 #include <snappy.h>
 
 #include <algorithm>
+#include <thread>  // NOLINT
 #include <utility>
 
 #include "base/glog_wrapper.h"
@@ -35,6 +36,7 @@ DECLARE_uint32(skiplist_max_height);
 DECLARE_uint32(key_entry_max_height);
 DECLARE_uint32(absolute_default_skiplist_height);
 DECLARE_uint32(latest_default_skiplist_height);
+DECLARE_uint32(bulk_load_thread_num);
 
 namespace openmldb {
 namespace storage {
@@ -316,6 +318,11 @@ uint64_t MemTable::Release() {
 }
 
 void MemTable::SchedGc() {
+    std::lock_guard<std::mutex> lock(gc_mu_);
+    FullGc();
+}
+
+void MemTable::FullGc() {
     uint64_t consumed = ::baidu::common::timer::get_micros();
     PDLOG(INFO, "start making gc for table %s, tid %u, pid %u", name_.c_str(), id_, pid_);
     auto inner_indexs = table_index_.GetAllInnerIndex();
@@ -390,9 +397,140 @@ void MemTable::SchedGc() {
     record_byte_size_.fetch_sub(gc_record_byte_size, std::memory_order_relaxed);
     PDLOG(INFO, "gc finished, gc_idx_cnt %lu, consumed %lu ms for table %s tid %u pid %u", gc_idx_cnt, consumed / 1000,
           name_.c_str(), id_, pid_);
+    // the full sweep supersedes the running incremental pass
+    gc_pass_running_ = false;
+    RecordGcPass(consumed / 1000, gc_record_byte_size, gc_idx_cnt);
     UpdateTTL();
 }
 
+bool MemTable::GetGcTTL(const std::shared_ptr<InnerIndexSt>& inner_index, std::map<uint32_t, TTLSt>* ttl_st_map) {
+    const std::vector<std::shared_ptr<IndexDef>>& real_index = inner_index->GetIndex();
+    size_t deleted_num = 0;
+    for (const auto& cur_index : real_index) {
+        auto ts_col = cur_index->GetTsColumn();
+        if (ts_col) {
+            ttl_st_map->emplace(ts_col->GetId(), *(cur_index->GetTTL()));
+        }
+        if (cur_index->GetStatus() == IndexStatus::kDeleted) {
+            deleted_num++;
+        }
+    }
+    return deleted_num != real_index.size() && !ttl_st_map->empty();
+}
+
+bool MemTable::IncrementalGc(uint64_t max_keys) {
+    std::lock_guard<std::mutex> lock(gc_mu_);
+    if (max_keys == 0) {
+        FullGc();
+        return true;
+    }
+    auto inner_indexs = table_index_.GetAllInnerIndex();
+    for (const auto& inner_index : *inner_indexs) {
+        for (const auto& index : inner_index->GetIndex()) {
+            // releasing the segments of a deleted index is done by the full gc
+            if (index->GetStatus() == IndexStatus::kWaiting || index->GetStatus() == IndexStatus::kDeleting) {
+                FullGc();
+                return true;
+            }
+        }
+    }
+    uint64_t consumed = ::baidu::common::timer::get_micros();
+    uint64_t gc_idx_cnt = 0;
+    uint64_t gc_record_byte_size = 0;
+    if (!gc_pass_running_ || gc_cursors_.size() != inner_indexs->size()) {
+        PDLOG(INFO, "start incremental gc for table %s, tid %u, pid %u", name_.c_str(), id_, pid_);
+        GcCursor cursor;
+        cursor.finished = false;
+        gc_cursors_.assign(inner_indexs->size(), std::vector<GcCursor>(seg_cnt_, cursor));
+        gc_budgets_.assign(inner_indexs->size(), max_keys);
+        gc_pass_running_ = true;
+        gc_pass_time_ = 0;
+        gc_pass_byte_size_ = 0;
+        gc_pass_idx_cnt_ = 0;
+        // the nodes unlinked in the last pass are freed once per pass as the full gc does
+        for (uint32_t i = 0; i < inner_indexs->size(); i++) {
+            if (segments_[i] == nullptr) {
+                continue;
+            }
+            for (uint32_t j = 0; j < seg_cnt_; j++) {
+                StatisticsInfo statistics_info(segments_[i][j]->GetTsCnt());
+                segments_[i][j]->IncrGcVersion();
+                segments_[i][j]->GcFreeList(&statistics_info);
+                gc_idx_cnt += statistics_info.GetTotalCnt();
+                gc_record_byte_size += statistics_info.record_byte_size;
+            }
+        }
+    }
+    bool finished = true;
+    for (uint32_t i = 0; i < inner_indexs->size() && enable_gc_.load(std::memory_order_relaxed); i++) {
+        std::map<uint32_t, TTLSt> ttl_st_map;
+        if (segments_[i] == nullptr || !GetGcTTL(inner_indexs->at(i), &ttl_st_map)) {
+            continue;
+        }
+        uint64_t budget = std::min(std::max<uint64_t>(gc_budgets_[i], 1), max_keys);
+        uint64_t visited = 0;
+        uint64_t index_idx_cnt = 0;
+        for (uint32_t j = 0; j < seg_cnt_; j++) {
+            GcCursor& cursor = gc_cursors_[i][j];
+            if (cursor.finished) {
+                continue;
+            }
+            Segment* segment = segments_[i][j];
+            StatisticsInfo statistics_info(segment->GetTsCnt());
+            cursor.max_keys = budget;
+            cursor.visited = 0;
+            // the segment is done if the gc returns before seeking, e.g. no ttl is set
+            cursor.finished = true;
+            if (ttl_st_map.size() == 1) {
+                segment->ExecuteGc(ttl_st_map.begin()->second, &statistics_info, &cursor);
+            } else {
+                segment->ExecuteGc(ttl_st_map, &statistics_info, std::nullopt, &cursor);
+            }
+            visited += cursor.visited;
+            index_idx_cnt += statistics_info.GetTotalCnt();
+            gc_record_byte_size += statistics_info.record_byte_size;
+            finished = finished && cursor.finished;
+        }
+        gc_idx_cnt += index_idx_cnt;
+        // sweep faster while most keys have expired data, and slower while few of them have
+        if (visited > 0) {
+            if (index_idx_cnt >= visited) {
+                budget = std::min(budget * 2, max_keys);
+            } else if (index_idx_cnt * 10 < visited) {
+                budget = std::max(budget / 2, std::max<uint64_t>(max_keys / 16, 1));
+            }
+        }
+        gc_budgets_[i] = budget;
+    }
+    record_byte_size_.fetch_sub(gc_record_byte_size, std::memory_order_relaxed);
+    gc_pass_time_ += ::baidu::common::timer::get_micros() - consumed;
+    gc_pass_byte_size_ += gc_record_byte_size;
+    gc_pass_idx_cnt_ += gc_idx_cnt;
+    if (!finished) {
+        return false;
+    }
+    gc_pass_running_ = false;
+    PDLOG(INFO, "incremental gc finished, gc_idx_cnt %lu, consumed %lu ms for table %s tid %u pid %u",
+          gc_pass_idx_cnt_, gc_pass_time_ / 1000, name_.c_str(), id_, pid_);
+    RecordGcPass(gc_pass_time_ / 1000, gc_pass_byte_size_, gc_pass_idx_cnt_);
+    UpdateTTL();
+    return true;
+}
+
+void MemTable::RecordGcPass(uint64_t latency_ms, uint64_t byte_size, uint64_t idx_cnt) {
+    gc_latency_ms_.store(latency_ms, std::memory_order_relaxed);
+    gc_reclaimed_byte_size_.store(byte_size, std::memory_order_relaxed);
+    gc_reclaimed_idx_cnt_.store(idx_cnt, std::memory_order_relaxed);
+}
+
+GcStats MemTable::GetGcStats() const {
+    GcStats stats;
+    stats.latency_ms = gc_latency_ms_.load(std::memory_order_relaxed);
+    stats.reclaimed_byte_size = gc_reclaimed_byte_size_.load(std::memory_order_relaxed);
+    stats.reclaimed_idx_cnt = gc_reclaimed_idx_cnt_.load(std::memory_order_relaxed);
+    return stats;
+}
+
 // tll as ms
 uint64_t MemTable::GetExpireTime(const TTLSt& ttl_st) {
     if (!enable_gc_.load(std::memory_order_relaxed) || ttl_st.abs_ttl == 0 ||
@@ -636,6 +774,7 @@ bool MemTable::AddIndexToTable(const std::shared_ptr<IndexDef>& index_def) {
     Segment** seg_arr = new Segment*[seg_cnt_];
     for (uint32_t j = 0; j < seg_cnt_; j++) {
         seg_arr[j] = new Segment(FLAGS_absolute_default_skiplist_height, ts_vec);
+        seg_arr[j]->SetWindowCache(window_cache_.get());
         PDLOG(INFO, "init %u, %u segment. height %u, ts col num %u. tid %u pid %u", inner_id, j,
               FLAGS_absolute_default_skiplist_height, ts_vec.size(), id_, pid_);
     }
@@ -650,6 +789,18 @@ uint32_t MemTable::SegIdx(const std::string& pk) {
     return 0;
 }
 
+void MemTable::SetWindowCache(std::shared_ptr<WindowCache> window_cache) {
+    window_cache_ = window_cache;
+    for (auto segments : segments_) {
+        if (segments == nullptr) {
+            continue;
+        }
+        for (uint32_t j = 0; j < seg_cnt_; j++) {
+            segments[j]->SetWindowCache(window_cache_.get());
+        }
+    }
+}
+
 ::hybridse::vm::WindowIterator* MemTable::NewWindowIterator(uint32_t index) {
     std::shared_ptr<IndexDef> index_def = table_index_.GetIndex(index);
     if (!index_def || !index_def->IsReady()) {
@@ -743,40 +894,86 @@ bool MemTable::GetBulkLoadInfo(::openmldb::api::BulkLoadInfoResponse* response)
 bool MemTable::BulkLoad(const std::vector<DataBlock*>& data_blocks,
                         const ::google::protobuf::RepeatedPtrField<::openmldb::api::BulkLoadIndex>& indexes) {
     // data_block[i] is the block which id == i
+    // segments are independent, check the whole index region first and then load the segments in parallel
+    std::vector<std::pair<Segment*, const ::openmldb::api::Segment*>> tasks;
+    std::vector<uint32_t> block_refs(data_blocks.size(), 0);
     for (int i = 0; i < indexes.size(); ++i) {
         const auto& inner_index = indexes.Get(i);
         auto real_idx = inner_index.inner_index_id();
+        if (real_idx >= segments_.size()) {
+            LOG(WARNING) << "invalid inner index id " << real_idx;
+            return false;
+        }
         for (int j = 0; j < inner_index.segment_size(); ++j) {
             const auto& segment_index = inner_index.segment(j);
             auto seg_idx = segment_index.id();
-            auto segment = segments_[real_idx][seg_idx];
-            for (int key_idx = 0; key_idx < segment_index.key_entries_size(); ++key_idx) {
-                const auto& key_entries = segment_index.key_entries(key_idx);
-                auto pk = Slice(key_entries.key());
-                for (int key_entry_idx = 0; key_entry_idx < key_entries.key_entry_size(); ++key_entry_idx) {
-                    const auto& key_entry = key_entries.key_entry(key_entry_idx);
-                    auto key_entry_id = key_entry.key_entry_id();
-                    for (int time_idx = 0; time_idx < key_entry.time_entry_size(); ++time_idx) {
-                        const auto& time_entry = key_entry.time_entry(time_idx);
-                        auto* block =
-                            time_entry.block_id() < data_blocks.size() ? data_blocks[time_entry.block_id()] : nullptr;
-                        if (block == nullptr) {
+            if (seg_idx >= seg_cnt_) {
+                LOG(WARNING) << "invalid segment id " << seg_idx;
+                return false;
+            }
+            auto* segment = segments_[real_idx][seg_idx];
+            for (const auto& key_entries : segment_index.key_entries()) {
+                for (const auto& key_entry : key_entries.key_entry()) {
+                    if (segment->GetTsCnt() > 1 && key_entry.key_entry_id() >= segment->GetTsCnt()) {
+                        LOG(WARNING) << "invalid key entry id " << key_entry.key_entry_id() << ", ts cnt "
+                                     << segment->GetTsCnt();
+                        return false;
+                    }
+                    for (const auto& time_entry : key_entry.time_entry()) {
+                        if (time_entry.block_id() >= data_blocks.size() ||
+                            data_blocks[time_entry.block_id()] == nullptr) {
                             // TODO(hw): error handle
                             LOG(INFO) << "block info mismatch";
                             return false;
                         }
+                        block_refs[time_entry.block_id()]++;
+                    }
+                }
+            }
+            tasks.emplace_back(segment, &segment_index);
+        }
+    }
+    // one block may be referenced by several segments, add the refs before loading
+    for (size_t i = 0; i < data_blocks.size(); ++i) {
+        data_blocks[i]->dim_cnt_down += block_refs[i];
+    }
 
-                        VLOG(1) << "do segment(" << real_idx << "-" << seg_idx << ") put, key" << pk.ToString()
-                                << ", time " << time_entry.time() << ", key_entry_id " << key_entry_id << ", block id "
-                                << time_entry.block_id();
-                        block->dim_cnt_down++;
-                        segment->BulkLoadPut(key_entry_id, pk, time_entry.time(), block);
+    std::atomic<bool> ok = true;
+    uint32_t thread_num = std::max<uint32_t>(1, std::min<uint32_t>(FLAGS_bulk_load_thread_num, tasks.size()));
+    auto load = [&](size_t start) {
+        std::vector<std::pair<uint64_t, DataBlock*>> rows;
+        for (size_t i = start; i < tasks.size(); i += thread_num) {
+            auto* segment = tasks[i].first;
+            for (const auto& key_entries : tasks[i].second->key_entries()) {
+                auto pk = Slice(key_entries.key());
+                for (const auto& key_entry : key_entries.key_entry()) {
+                    rows.clear();
+                    rows.reserve(key_entry.time_entry_size());
+                    for (const auto& time_entry : key_entry.time_entry()) {
+                        rows.emplace_back(time_entry.time(), data_blocks[time_entry.block_id()]);
+                    }
+                    VLOG(1) << "do segment put, key " << pk.ToString() << ", key_entry_id "
+                            << key_entry.key_entry_id() << ", rows " << rows.size();
+                    if (!segment->BulkLoadPut(key_entry.key_entry_id(), pk, rows)) {
+                        ok.store(false, std::memory_order_relaxed);
                     }
                 }
             }
         }
+    };
+    if (thread_num == 1) {
+        load(0);
+    } else {
+        std::vector<std::thread> workers;
+        for (uint32_t i = 1; i < thread_num; ++i) {
+            workers.emplace_back(load, i);
+        }
+        load(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
     }
-    return true;
+    return ok.load(std::memory_order_relaxed);
 }
 
 }  // namespace storage
@@ -20,6 +20,7 @@
 #include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 #include <vector>
 
@@ -37,6 +38,13 @@ typedef google::protobuf::RepeatedPtrField<::openmldb::api::Dimension> Dimension
 using ::openmldb::api::LogEntry;
 using ::openmldb::base::Slice;
 
+// the result of the last finished gc pass of a table
+struct GcStats {
+    uint64_t latency_ms = 0;  // the time spent in the pass, excluding the waits between incremental ticks
+    uint64_t reclaimed_byte_size = 0;
+    uint64_t reclaimed_idx_cnt = 0;
+};
+
 class MemTable : public Table {
  public:
     MemTable(const std::string& name, uint32_t id, uint32_t pid, uint32_t seg_cnt,
@@ -70,11 +78,20 @@ class MemTable : public Table {
 
     ::hybridse::vm::WindowIterator* NewWindowIterator(uint32_t index) override;
 
+    // cache the rows of hot keys read by window iterators. must be called before the table is visible
+    void SetWindowCache(std::shared_ptr<WindowCache> window_cache);
+
     // release all memory allocated
     uint64_t Release();
 
     void SchedGc() override;
 
+    // gc at most max_keys keys of every index in every segment, starting from where the last call stopped.
+    // the budget of an index shrinks when few of its keys have expired data. return true if the pass is finished
+    bool IncrementalGc(uint64_t max_keys);
+
+    GcStats GetGcStats() const;
+
     int GetCount(uint32_t index, const std::string& pk, uint64_t& count) override;  // NOLINT
 
     uint64_t GetRecordIdxCnt() override;
@@ -123,6 +140,12 @@ class MemTable : public Table {
     bool Delete(uint32_t idx, const std::string& key, const std::optional<uint64_t>& start_ts,
                 const std::optional<uint64_t>& end_ts);
 
+    // gc all the segments in one go, must hold gc_mu_
+    void FullGc();
+    // collect the ttl of an inner index, return false if it has no index to gc
+    bool GetGcTTL(const std::shared_ptr<InnerIndexSt>& inner_index, std::map<uint32_t, TTLSt>* ttl_st_map);
+    void RecordGcPass(uint64_t latency_ms, uint64_t byte_size, uint64_t idx_cnt);
+
  protected:
     uint32_t seg_cnt_;
     std::vector<Segment**> segments_;
@@ -131,6 +154,19 @@ class MemTable : public Table {
     bool segment_released_;
     std::atomic<uint64_t> record_byte_size_;
     uint32_t key_entry_max_height_;
+    std::shared_ptr<WindowCache> window_cache_;
+
+    std::mutex gc_mu_;
+    // the state of the running incremental gc pass, the cursors and budgets are indexed by inner index
+    bool gc_pass_running_ = false;
+    std::vector<std::vector<GcCursor>> gc_cursors_;
+    std::vector<uint64_t> gc_budgets_;
+    uint64_t gc_pass_time_ = 0;
+    uint64_t gc_pass_byte_size_ = 0;
+    uint64_t gc_pass_idx_cnt_ = 0;
+    std::atomic<uint64_t> gc_latency_ms_{0};
+    std::atomic<uint64_t> gc_reclaimed_byte_size_{0};
+    std::atomic<uint64_t> gc_reclaimed_idx_cnt_{0};
 };
 
 }  // namespace storage
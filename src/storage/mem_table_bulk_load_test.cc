@@ -0,0 +1,196 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gflags/gflags.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/glog_wrapper.h"
+#include "base/hash.h"
+#include "codec/schema_codec.h"
+#include "gtest/gtest.h"
+#include "storage/mem_table.h"
+
+DECLARE_uint32(bulk_load_thread_num);
+
+namespace openmldb {
+namespace storage {
+
+static const uint32_t SEED = 0xe17a1465;
+static const uint32_t SEG_CNT = 8;
+
+class MemTableBulkLoadTest : public ::testing::Test {
+ public:
+    MemTableBulkLoadTest() {}
+    ~MemTableBulkLoadTest() {}
+
+    void SetUp() override { old_thread_num_ = FLAGS_bulk_load_thread_num; }
+    void TearDown() override { FLAGS_bulk_load_thread_num = old_thread_num_; }
+
+    static std::shared_ptr<MemTable> CreateTable() {
+        std::map<std::string, uint32_t> mapping;
+        mapping.insert(std::make_pair("idx0", 0));
+        auto table = std::make_shared<MemTable>("t1", 1, 1, SEG_CNT, mapping, 0, ::openmldb::type::kAbsoluteTime);
+        table->Init();
+        return table;
+    }
+
+    // build the data region and the index region as the bulk load client does, every key has rows_per_key rows
+    static void BuildRegion(uint32_t key_cnt, uint32_t rows_per_key, std::vector<DataBlock*>* blocks,
+                            ::google::protobuf::RepeatedPtrField<::openmldb::api::BulkLoadIndex>* indexes) {
+        auto* inner_index = indexes->Add();
+        inner_index->set_inner_index_id(0);
+        std::vector<::openmldb::api::Segment*> segments;
+        for (uint32_t i = 0; i < SEG_CNT; i++) {
+            auto* segment = inner_index->add_segment();
+            segment->set_id(i);
+            segments.push_back(segment);
+        }
+        for (uint32_t k = 0; k < key_cnt; k++) {
+            std::string key = "key" + std::to_string(k);
+            uint32_t seg_idx = ::openmldb::base::hash(key.c_str(), key.length(), SEED) % SEG_CNT;
+            auto* key_entries = segments[seg_idx]->add_key_entries();
+            key_entries->set_key(key);
+            auto* key_entry = key_entries->add_key_entry();
+            key_entry->set_key_entry_id(0);
+            // the client sends the time entries in descending order
+            for (uint32_t r = rows_per_key; r > 0; r--) {
+                std::string value = key + "_" + std::to_string(r);
+                auto* buf = new char[value.size()];
+                memcpy(buf, value.data(), value.size());
+                auto* time_entry = key_entry->add_time_entry();
+                time_entry->set_time(1000 + r);
+                time_entry->set_block_id(blocks->size());
+                blocks->push_back(new DataBlock(1, buf, value.size(), true));
+            }
+        }
+    }
+
+    // release the refs of the receiver
+    static void ReleaseBlocks(std::vector<DataBlock*>* blocks) {
+        for (auto* block : *blocks) {
+            if ((--block->dim_cnt_down) == 0) {
+                delete block;
+            }
+        }
+        blocks->clear();
+    }
+
+ private:
+    uint32_t old_thread_num_ = 1;
+};
+
+TEST_F(MemTableBulkLoadTest, Load) {
+    for (uint32_t thread_num : {1, 4}) {
+        FLAGS_bulk_load_thread_num = thread_num;
+        auto table = CreateTable();
+        std::vector<DataBlock*> blocks;
+        ::google::protobuf::RepeatedPtrField<::openmldb::api::BulkLoadIndex> indexes;
+        BuildRegion(100, 10, &blocks, &indexes);
+        ASSERT_TRUE(table->BulkLoad(blocks, indexes));
+        ASSERT_EQ(1000u, table->GetRecordIdxCnt());
+        ASSERT_EQ(100u, table->GetRecordPkCnt());
+        for (uint32_t k = 0; k < 100; k += 7) {
+            std::string key = "key" + std::to_string(k);
+            Ticket ticket;
+            std::unique_ptr<TableIterator> it(table->NewIterator(0, key, ticket));
+            it->SeekToFirst();
+            uint32_t r = 10;
+            while (it->Valid()) {
+                ASSERT_EQ(1000u + r, it->GetKey());
+                ASSERT_EQ(key + "_" + std::to_string(r), it->GetValue().ToString());
+                r--;
+                it->Next();
+            }
+            ASSERT_EQ(0u, r);
+        }
+        ReleaseBlocks(&blocks);
+    }
+}
+
+TEST_F(MemTableBulkLoadTest, InvalidIndexRegion) {
+    auto table = CreateTable();
+    std::vector<DataBlock*> blocks;
+    ::google::protobuf::RepeatedPtrField<::openmldb::api::BulkLoadIndex> indexes;
+    BuildRegion(10, 2, &blocks, &indexes);
+    // the last block is missing, nothing should be loaded
+    auto* last = blocks.back();
+    blocks.pop_back();
+    ASSERT_FALSE(table->BulkLoad(blocks, indexes));
+    ASSERT_EQ(0u, table->GetRecordIdxCnt());
+    blocks.push_back(last);
+    indexes.Mutable(0)->mutable_segment(0)->set_id(SEG_CNT);
+    ASSERT_FALSE(table->BulkLoad(blocks, indexes));
+    ASSERT_EQ(0u, table->GetRecordIdxCnt());
+    ReleaseBlocks(&blocks);
+}
+
+TEST_F(MemTableBulkLoadTest, InvalidKeyEntryId) {
+    // index card and card1 share the key, so the inner index has two key entries per key
+    ::openmldb::api::TableMeta table_meta;
+    table_meta.set_name("t1");
+    table_meta.set_tid(1);
+    table_meta.set_pid(1);
+    table_meta.set_seg_cnt(SEG_CNT);
+    codec::SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "card", ::openmldb::type::kString);
+    codec::SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "ts1", ::openmldb::type::kBigInt);
+    codec::SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "ts2", ::openmldb::type::kBigInt);
+    codec::SchemaCodec::SetIndex(table_meta.add_column_key(), "card", "card", "ts1", ::openmldb::type::kAbsoluteTime,
+                                 0, 0);
+    codec::SchemaCodec::SetIndex(table_meta.add_column_key(), "card1", "card", "ts2", ::openmldb::type::kAbsoluteTime,
+                                 0, 0);
+    auto table = std::make_shared<MemTable>(table_meta);
+    ASSERT_TRUE(table->Init());
+    std::vector<DataBlock*> blocks;
+    ::google::protobuf::RepeatedPtrField<::openmldb::api::BulkLoadIndex> indexes;
+    BuildRegion(20, 2, &blocks, &indexes);
+    // the bad key entry is in the last segment with keys, the segments before it must not be loaded
+    auto* inner_index = indexes.Mutable(0);
+    ::openmldb::api::Segment_KeyEntries_KeyEntry* last_key_entry = nullptr;
+    for (int i = inner_index->segment_size() - 1; i >= 0 && last_key_entry == nullptr; i--) {
+        auto* segment = inner_index->mutable_segment(i);
+        if (segment->key_entries_size() > 0) {
+            last_key_entry = segment->mutable_key_entries(segment->key_entries_size() - 1)->mutable_key_entry(0);
+        }
+    }
+    ASSERT_TRUE(last_key_entry != nullptr);
+    last_key_entry->set_key_entry_id(2);
+    FLAGS_bulk_load_thread_num = 1;
+    ASSERT_FALSE(table->BulkLoad(blocks, indexes));
+    ASSERT_EQ(0u, table->GetRecordIdxCnt());
+    ASSERT_EQ(0u, table->GetRecordPkCnt());
+    // no refs are taken by the failed load
+    for (auto* block : blocks) {
+        ASSERT_EQ(1, block->dim_cnt_down);
+    }
+    last_key_entry->set_key_entry_id(1);
+    ASSERT_TRUE(table->BulkLoad(blocks, indexes));
+    ASSERT_EQ(20u, table->GetRecordPkCnt());
+    ReleaseBlocks(&blocks);
+}
+
+}  // namespace storage
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::openmldb::base::SetLogLevel(INFO);
+    ::google::ParseCommandLineFlags(&argc, &argv, true);
+    return RUN_ALL_TESTS();
+}
@@ -74,6 +74,11 @@ void MemTableWindowIterator::SeekToFirst() {
     it_->SeekToFirst();
 }
 
+void MemTableWindowIterator::SeekToPosition(uint64_t pos) {
+    record_idx_ = pos + 1;
+    it_->SeekToPosition(pos);
+}
+
 MemTableKeyIterator::MemTableKeyIterator(Segment** segments, uint32_t seg_cnt, ::openmldb::storage::TTLType ttl_type,
         uint64_t expire_time, uint64_t expire_cnt, uint32_t ts_index,
         type::CompressType compress_type)
@@ -87,7 +92,10 @@ MemTableKeyIterator::MemTableKeyIterator(Segment** segments, uint32_t seg_cnt, :
       expire_cnt_(expire_cnt),
       ticket_(),
       ts_idx_(0),
-      compress_type_(compress_type) {
+      compress_type_(compress_type),
+      seek_key_(),
+      cached_entry_(),
+      fill_token_(0) {
     uint32_t idx = 0;
     if (segments_[0]->GetTsIdx(ts_index, idx) == 0) {
         ts_idx_ = idx;
@@ -100,6 +108,8 @@ MemTableKeyIterator::~MemTableKeyIterator() {
 
 void MemTableKeyIterator::SeekToFirst() {
     ticket_.Pop();
+    cached_entry_.reset();
+    fill_token_ = 0;
     if (pk_it_ != nullptr) {
         delete pk_it_;
         pk_it_ = nullptr;
@@ -119,10 +129,21 @@ void MemTableKeyIterator::Seek(const std::string& key) {
         pk_it_ = nullptr;
     }
     ticket_.Pop();
+    cached_entry_.reset();
+    fill_token_ = 0;
+    seg_idx_ = 0;
     if (seg_cnt_ > 1) {
         seg_idx_ = ::openmldb::base::hash(key.c_str(), key.length(), SEED) % seg_cnt_;
     }
     Slice spk(key);
+    WindowCache* window_cache = segments_[seg_idx_]->GetWindowCache();
+    if (window_cache != nullptr) {
+        seek_key_ = key;
+        cached_entry_ = window_cache->Get(segments_[seg_idx_]->GetId(), ts_idx_, spk, &fill_token_);
+        if (cached_entry_) {
+            return;
+        }
+    }
     pk_it_ = segments_[seg_idx_]->GetKeyEntries()->NewIterator();
     pk_it_->Seek(spk);
     if (!pk_it_->Valid()) {
@@ -131,10 +152,20 @@ void MemTableKeyIterator::Seek(const std::string& key) {
 }
 
 bool MemTableKeyIterator::Valid() {
-    return pk_it_ != nullptr && pk_it_->Valid();
+    return cached_entry_ != nullptr || (pk_it_ != nullptr && pk_it_->Valid());
 }
 
 void MemTableKeyIterator::Next() {
+    if (cached_entry_) {
+        // position pk_it_ to the cached key, then move to the next key as usual
+        cached_entry_.reset();
+        Slice spk(seek_key_);
+        pk_it_ = segments_[seg_idx_]->GetKeyEntries()->NewIterator();
+        pk_it_->Seek(spk);
+        if (pk_it_->Valid() && pk_it_->GetKey().compare(spk) != 0) {
+            return;
+        }
+    }
     NextPK();
 }
 
@@ -154,15 +185,65 @@ TimeEntries::Iterator* MemTableKeyIterator::GetTimeIter() {
 }
 
 ::hybridse::vm::RowIterator* MemTableKeyIterator::GetRawValue() {
+    if (cached_entry_) {
+        return new WindowCacheIterator(cached_entry_, ttl_type_, expire_time_, expire_cnt_);
+    }
     TimeEntries::Iterator* it = GetTimeIter();
+    if (fill_token_ != 0 && pk_it_->GetKey().compare(Slice(seek_key_)) == 0) {
+        uint64_t token = fill_token_;
+        fill_token_ = 0;
+        Segment* segment = segments_[seg_idx_];
+        auto entry = Materialize(it, segment->GetWindowCache()->GetMaxRowsPerKey());
+        if (entry) {
+            segment->GetWindowCache()->Fill(segment->GetId(), ts_idx_, Slice(seek_key_), token, entry);
+            delete it;
+            return new WindowCacheIterator(entry, ttl_type_, expire_time_, expire_cnt_);
+        }
+    }
     return new MemTableWindowIterator(it, ttl_type_, expire_time_, expire_cnt_, compress_type_);
 }
 
+std::shared_ptr<const WindowCacheEntry> MemTableKeyIterator::Materialize(TimeEntries::Iterator* it,
+                                                                        uint32_t max_rows) {
+    auto entry = std::make_shared<WindowCacheEntry>();
+    ExpiredChecker expire_value(expire_time_, expire_cnt_, ttl_type_);
+    std::string tmp_buf;
+    uint32_t record_idx = 1;
+    // the expired rows are always at the tail, so only the valid prefix is cached
+    for (it->SeekToFirst(); it->Valid() && !expire_value.IsExpired(it->GetKey(), record_idx);
+         it->Next(), record_idx++) {
+        if (record_idx > max_rows) {
+            it->SeekToFirst();
+            return nullptr;
+        }
+        const char* data = it->GetValue()->data;
+        uint32_t size = it->GetValue()->size;
+        if (compress_type_ == type::CompressType::kSnappy) {
+            tmp_buf.clear();
+            snappy::Uncompress(data, size, &tmp_buf);
+            data = tmp_buf.data();
+            size = tmp_buf.size();
+        }
+        int8_t* row_data = reinterpret_cast<int8_t*>(malloc(size));
+        memcpy(row_data, data, size);
+        entry->rows.emplace_back(it->GetKey(),
+                                 ::hybridse::codec::Row(::hybridse::base::RefCountedSlice::CreateManaged(row_data, size)));
+        entry->byte_size += size + sizeof(std::pair<uint64_t, ::hybridse::codec::Row>);
+    }
+    it->SeekToFirst();
+    return entry;
+}
+
 std::unique_ptr<::hybridse::vm::RowIterator> MemTableKeyIterator::GetValue() {
     return std::unique_ptr<::hybridse::vm::RowIterator>(GetRawValue());
 }
 
 const hybridse::codec::Row MemTableKeyIterator::GetKey() {
+    if (cached_entry_) {
+        int8_t* key_data = reinterpret_cast<int8_t*>(malloc(seek_key_.size()));
+        memcpy(key_data, seek_key_.data(), seek_key_.size());
+        return hybridse::codec::Row(::hybridse::base::RefCountedSlice::CreateManaged(key_data, seek_key_.size()));
+    }
     return hybridse::codec::Row(
             ::hybridse::base::RefCountedSlice::Create(pk_it_->GetKey().data(), pk_it_->GetKey().size()));
 }
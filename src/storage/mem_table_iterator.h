@@ -51,6 +51,10 @@ class MemTableWindowIterator : public ::hybridse::vm::RowIterator {
 
     bool IsSeekable() const override { return true; }
 
+    void SeekToPosition(uint64_t pos) override;
+
+    bool IsPositionSeekable() const override { return true; }
+
  private:
     TimeEntries::Iterator* it_;
     uint32_t record_idx_;
@@ -85,6 +89,8 @@ class MemTableKeyIterator : public ::hybridse::vm::WindowIterator {
 
  private:
     void NextPK();
+    // materialize the rows of the current key for the window cache. return nullptr if there are too many rows
+    std::shared_ptr<const WindowCacheEntry> Materialize(TimeEntries::Iterator* it, uint32_t max_rows);
 
  protected:
     Segment** segments_;
@@ -98,6 +104,11 @@ class MemTableKeyIterator : public ::hybridse::vm::WindowIterator {
     Ticket ticket_;
     uint32_t ts_idx_;
     type::CompressType compress_type_;
+    // the key of the last Seek, if the segment has a window cache
+    std::string seek_key_;
+    // the cached rows of seek_key_. pk_it_ is not used on cache hit
+    std::shared_ptr<const WindowCacheEntry> cached_entry_;
+    uint64_t fill_token_;
 };
 
 class MemTableTraverseIterator : public TraverseIterator {
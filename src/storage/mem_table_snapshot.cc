@@ -30,7 +30,7 @@
 #include "base/hash.h"
 #include "base/slice.h"
 #include "base/strings.h"
-#include "base/taskpool.hpp"
+#include "base/work_stealing_pool.h"
 #include "boost/bind.hpp"
 #include "common/thread_pool.h"
 #include "common/timer.h"
@@ -350,7 +350,8 @@ void MemTableSnapshot::RecoverFromSnapshot(const std::string& snapshot_name, uin
 
 void MemTableSnapshot::RecoverSingleSnapshot(const std::string& path, std::shared_ptr<Table> table,
                                              std::atomic<uint64_t>* g_succ_cnt, std::atomic<uint64_t>* g_failed_cnt) {
-    ::openmldb::base::TaskPool load_pool_(FLAGS_load_table_thread_num, FLAGS_load_table_batch);
+    ::openmldb::base::WorkStealingPool load_pool_(absl::StrCat("tablet_load_table_", tid_, "_", pid_),
+                                                  FLAGS_load_table_thread_num, FLAGS_load_table_queue_size);
     std::atomic<uint64_t> succ_cnt, failed_cnt;
     succ_cnt = failed_cnt = 0;
 
@@ -404,6 +405,11 @@ void MemTableSnapshot::RecoverSingleSnapshot(const std::string& path, std::share
             load_pool_.AddTask(
                 boost::bind(&MemTableSnapshot::Put, this, path, table, recordPtr, &succ_cnt, &failed_cnt));
         }
+        // wait for all the records to be put before counting them
+        load_pool_.Stop();
+        auto stats = load_pool_.GetStats();
+        PDLOG(INFO, "%s put %lu batches, %lu are stolen by idle workers", load_pool_.GetName().c_str(),
+              stats.executed, stats.stolen);
         if (g_succ_cnt) {
             g_succ_cnt->fetch_add(succ_cnt, std::memory_order_relaxed);
         }
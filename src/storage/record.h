@@ -32,21 +32,26 @@ static const uint32_t KEY_ENTRY_BYTE_SIZE = sizeof(KeyEntry);
 static const uint32_t ENTRY_NODE_SIZE = sizeof(::openmldb::base::Node<::openmldb::base::Slice, void*>);
 static const uint32_t DATA_NODE_SIZE = sizeof(::openmldb::base::Node<uint64_t, void*>);
 static const uint32_t KEY_ENTRY_PTR_SIZE = sizeof(KeyEntry*);
+// a level of the time entries node, the next pointer and the span counter
+static const uint32_t TS_IDX_LEVEL_SIZE = sizeof(void*) + sizeof(uint32_t);
 
 static inline uint32_t GetRecordSize(uint32_t value_size) { return value_size + DATA_BLOCK_BYTE_SIZE; }
 
 // the input height which is the height of skiplist node
+// the head of the time entries has an extra level which keeps the size
 static inline uint32_t GetRecordPkIdxSize(uint8_t height, uint32_t key_size, uint8_t key_entry_max_height) {
-    return height * 8 + ENTRY_NODE_SIZE + KEY_ENTRY_BYTE_SIZE + key_size + key_entry_max_height * 8 + DATA_NODE_SIZE;
+    return height * 8 + ENTRY_NODE_SIZE + KEY_ENTRY_BYTE_SIZE + key_size +
+           (key_entry_max_height + 1) * TS_IDX_LEVEL_SIZE + DATA_NODE_SIZE;
 }
 
 static inline uint32_t GetRecordPkMultiIdxSize(uint8_t height, uint32_t key_size, uint8_t key_entry_max_height,
                                                uint32_t ts_cnt) {
     return height * 8 + ENTRY_NODE_SIZE + key_size +
-           (KEY_ENTRY_PTR_SIZE + KEY_ENTRY_BYTE_SIZE + key_entry_max_height * 8 + DATA_NODE_SIZE) * ts_cnt;
+           (KEY_ENTRY_PTR_SIZE + KEY_ENTRY_BYTE_SIZE + (key_entry_max_height + 1) * TS_IDX_LEVEL_SIZE +
+            DATA_NODE_SIZE) * ts_cnt;
 }
 
-static inline uint32_t GetRecordTsIdxSize(uint8_t height) { return height * 8 + DATA_NODE_SIZE; }
+static inline uint32_t GetRecordTsIdxSize(uint8_t height) { return height * TS_IDX_LEVEL_SIZE + DATA_NODE_SIZE; }
 
 struct StatisticsInfo {
     explicit StatisticsInfo(uint32_t idx_num) : idx_cnt_vec(idx_num, 0) {}
@@ -44,7 +44,9 @@ Segment::Segment(uint8_t height)
       ts_cnt_(1),
       gc_version_(0),
       ttl_offset_(FLAGS_gc_safe_offset * 60 * 1000),
-      node_cache_(1, height) {
+      node_cache_(1, height),
+      id_(WindowCache::NewSegmentId()),
+      window_cache_(nullptr) {
     entries_ = new KeyEntries((uint8_t)FLAGS_skiplist_max_height, 4, scmp);
     idx_cnt_vec_.push_back(std::make_shared<std::atomic<uint64_t>>(0));
 }
@@ -58,7 +60,9 @@ Segment::Segment(uint8_t height, const std::vector<uint32_t>& ts_idx_vec)
       ts_cnt_(ts_idx_vec.size()),
       gc_version_(0),
       ttl_offset_(FLAGS_gc_safe_offset * 60 * 1000),
-      node_cache_(ts_idx_vec.size(), height) {
+      node_cache_(ts_idx_vec.size(), height),
+      id_(WindowCache::NewSegmentId()),
+      window_cache_(nullptr) {
     entries_ = new KeyEntries((uint8_t)FLAGS_skiplist_max_height, 4, scmp);
     for (uint32_t i = 0; i < ts_idx_vec.size(); i++) {
         ts_idx_map_[ts_idx_vec[i]] = i;
@@ -176,36 +180,68 @@ bool Segment::PutUnlock(const Slice& key, uint64_t time, DataBlock* row, bool pu
     byte_size += GetRecordTsIdxSize(height);
     idx_byte_size_.fetch_add(byte_size, std::memory_order_relaxed);
     DLOG(INFO) << "idx_byte_size_ " << idx_byte_size_ << " after add " << byte_size;
+    InvalidateCache(key);
     return true;
 }
 
 void Segment::BulkLoadPut(unsigned int key_entry_id, const Slice& key, uint64_t time, DataBlock* row) {
+    BulkLoadPut(key_entry_id, key, {{time, row}});
+}
+
+bool Segment::BulkLoadPut(unsigned int key_entry_id, const Slice& key,
+                          const std::vector<std::pair<uint64_t, DataBlock*>>& rows) {
+    if (ts_cnt_ > 1 && key_entry_id >= ts_cnt_) {
+        LOG(WARNING) << "invalid key entry id " << key_entry_id << ", ts cnt " << ts_cnt_;
+        return false;
+    }
+    if (rows.empty()) {
+        return true;
+    }
     void* key_entry_or_list = nullptr;
     uint32_t byte_size = 0;
-    std::lock_guard<std::mutex> lock(mu_);  // TODO(hw): need lock?
+    std::lock_guard<std::mutex> lock(mu_);
     int ret = entries_->Get(key, key_entry_or_list);
-    if (ts_cnt_ == 1) {
-        PutUnlock(key, time, row);
-    } else {
-        if (ret < 0 || key_entry_or_list == nullptr) {
-            char* pk = new char[key.size()];
-            memcpy(pk, key.data(), key.size());
-            Slice skey(pk, key.size());
+    if (ret < 0 || key_entry_or_list == nullptr) {
+        char* pk = new char[key.size()];
+        memcpy(pk, key.data(), key.size());
+        Slice skey(pk, key.size());
+        if (ts_cnt_ == 1) {
+            key_entry_or_list = reinterpret_cast<void*>(new KeyEntry(key_entry_max_height_));
+            uint8_t height = entries_->Insert(skey, key_entry_or_list);
+            byte_size += GetRecordPkIdxSize(height, key.size(), key_entry_max_height_);
+        } else {
             auto** entry_arr_tmp = new KeyEntry*[ts_cnt_];
             for (uint32_t i = 0; i < ts_cnt_; i++) {
                 entry_arr_tmp[i] = new KeyEntry(key_entry_max_height_);
             }
-            auto entry_arr = reinterpret_cast<void*>(entry_arr_tmp);
-            uint8_t height = entries_->Insert(skey, entry_arr);
+            key_entry_or_list = reinterpret_cast<void*>(entry_arr_tmp);
+            uint8_t height = entries_->Insert(skey, key_entry_or_list);
             byte_size += GetRecordPkMultiIdxSize(height, key.size(), key_entry_max_height_, ts_cnt_);
-            pk_cnt_.fetch_add(1, std::memory_order_relaxed);
         }
-        uint8_t height = reinterpret_cast<KeyEntry**>(key_entry_or_list)[key_entry_id]->entries.Insert(time, row);
-        reinterpret_cast<KeyEntry**>(key_entry_or_list)[key_entry_id]->count_.fetch_add(1, std::memory_order_relaxed);
-        byte_size += GetRecordTsIdxSize(height);
-        idx_byte_size_.fetch_add(byte_size, std::memory_order_relaxed);
-        idx_cnt_vec_[key_entry_id]->fetch_add(1, std::memory_order_relaxed);
+        pk_cnt_.fetch_add(1, std::memory_order_relaxed);
+    }
+    uint32_t real_idx = ts_cnt_ == 1 ? 0 : key_entry_id;
+    KeyEntry* entry = ts_cnt_ == 1 ? reinterpret_cast<KeyEntry*>(key_entry_or_list)
+                                   : reinterpret_cast<KeyEntry**>(key_entry_or_list)[key_entry_id];
+    // the rows of bulk load are usually sorted and older than the existing rows, link them in one pass
+    std::vector<uint8_t> heights;
+    heights.reserve(rows.size());
+    if (entry->entries.BulkAppend(rows.begin(), rows.end(), &heights)) {
+        for (auto height : heights) {
+            byte_size += GetRecordTsIdxSize(height);
+        }
+    } else {
+        for (const auto& [time, row] : rows) {
+            DataBlock* block = row;
+            uint8_t height = entry->entries.Insert(time, block);
+            byte_size += GetRecordTsIdxSize(height);
+        }
     }
+    entry->count_.fetch_add(rows.size(), std::memory_order_relaxed);
+    idx_cnt_vec_[real_idx]->fetch_add(rows.size(), std::memory_order_relaxed);
+    idx_byte_size_.fetch_add(byte_size, std::memory_order_relaxed);
+    InvalidateCache(key);
+    return true;
 }
 
 bool Segment::Put(const Slice& key, const std::map<int32_t, uint64_t>& ts_map, DataBlock* row, bool put_if_absent) {
@@ -246,6 +282,8 @@ bool Segment::Put(const Slice& key, const std::map<int32_t, uint64_t>& ts_map, D
         }
         auto entry = reinterpret_cast<KeyEntry**>(entry_arr)[pos->second];
         if (put_if_absent && ListContains(entry, kv.second, row, pos->first == DEFAULT_TS_COL_ID)) {
+            // the entries of previous ts indexes may have been inserted
+            InvalidateCache(key);
             return false;
         }
         uint8_t height = entry->entries.Insert(kv.second, row);
@@ -255,6 +293,7 @@ bool Segment::Put(const Slice& key, const std::map<int32_t, uint64_t>& ts_map, D
         DLOG(INFO) << "idx_byte_size_ " << idx_byte_size_ << " after add " << byte_size;
         idx_cnt_vec_[pos->second]->fetch_add(1, std::memory_order_relaxed);
     }
+    InvalidateCache(key);
     return true;
 }
 
@@ -270,6 +309,7 @@ bool Segment::Delete(const std::optional<uint32_t>& idx, const Slice& key) {
             entry_node = entries_->Remove(key);
         }
         if (entry_node != nullptr) {
+            InvalidateCache(key);
             DLOG(INFO) << "add key " << key.ToString() << " to node cache. version " << gc_version_;
             node_cache_.AddKeyEntryNode(gc_version_.load(std::memory_order_relaxed), entry_node);
             return true;
@@ -301,6 +341,7 @@ bool Segment::Delete(const std::optional<uint32_t>& idx, const Slice& key) {
                 entry_node = entries_->Remove(key);
             }
         }
+        InvalidateCache(key);
         if (data_node != nullptr) {
             node_cache_.AddValueNodeList(ts_idx, gc_version_.load(std::memory_order_relaxed), data_node);
         }
@@ -364,6 +405,7 @@ bool Segment::Delete(const std::optional<uint32_t>& idx, const Slice& key, uint6
                 } else {
                     return true;
                 }
+                InvalidateCache(key);
                 node_cache_.AddSingleValueNode(ts_idx, gc_version_.load(std::memory_order_relaxed), data_node);
             }
             return true;
@@ -390,6 +432,7 @@ bool Segment::Delete(const std::optional<uint32_t>& idx, const Slice& key, uint6
             entry_node = entries_->Remove(key);
         }
     }
+    InvalidateCache(key);
     if (data_node != nullptr) {
         node_cache_.AddValueNodeList(ts_idx, gc_version_.load(std::memory_order_relaxed), data_node);
     }
@@ -439,7 +482,7 @@ void Segment::GcFreeList(StatisticsInfo* statistics_info) {
                << statistics_info->idx_byte_size - old.idx_byte_size;
 }
 
-void Segment::ExecuteGc(const TTLSt& ttl_st, StatisticsInfo* statistics_info) {
+void Segment::ExecuteGc(const TTLSt& ttl_st, StatisticsInfo* statistics_info, GcCursor* cursor) {
     uint64_t cur_time = ::baidu::common::timer::get_micros() / 1000;
     switch (ttl_st.ttl_type) {
         case ::openmldb::storage::TTLType::kAbsoluteTime: {
@@ -447,14 +490,14 @@ void Segment::ExecuteGc(const TTLSt& ttl_st, StatisticsInfo* statistics_info) {
                 return;
             }
             uint64_t expire_time = cur_time - ttl_offset_ - ttl_st.abs_ttl;
-            Gc4TTL(expire_time, statistics_info);
+            Gc4TTL(expire_time, statistics_info, cursor);
             break;
         }
         case ::openmldb::storage::TTLType::kLatestTime: {
             if (ttl_st.lat_ttl == 0) {
                 return;
             }
-            Gc4Head(ttl_st.lat_ttl, statistics_info);
+            Gc4Head(ttl_st.lat_ttl, statistics_info, cursor);
             break;
         }
         case ::openmldb::storage::TTLType::kAbsAndLat: {
@@ -462,7 +505,7 @@ void Segment::ExecuteGc(const TTLSt& ttl_st, StatisticsInfo* statistics_info) {
                 return;
             }
             uint64_t expire_time = cur_time - ttl_offset_ - ttl_st.abs_ttl;
-            Gc4TTLAndHead(expire_time, ttl_st.lat_ttl, statistics_info);
+            Gc4TTLAndHead(expire_time, ttl_st.lat_ttl, statistics_info, cursor);
             break;
         }
         case ::openmldb::storage::TTLType::kAbsOrLat: {
@@ -470,7 +513,7 @@ void Segment::ExecuteGc(const TTLSt& ttl_st, StatisticsInfo* statistics_info) {
                 return;
             }
             uint64_t expire_time = ttl_st.abs_ttl == 0 ? 0 : cur_time - ttl_offset_ - ttl_st.abs_ttl;
-            Gc4TTLOrHead(expire_time, ttl_st.lat_ttl, statistics_info);
+            Gc4TTLOrHead(expire_time, ttl_st.lat_ttl, statistics_info, cursor);
             break;
         }
         default:
@@ -479,7 +522,7 @@ void Segment::ExecuteGc(const TTLSt& ttl_st, StatisticsInfo* statistics_info) {
 }
 
 void Segment::ExecuteGc(const std::map<uint32_t, TTLSt>& ttl_st_map, StatisticsInfo* statistics_info,
-                        std::optional<uint32_t> clustered_ts_id) {
+                        std::optional<uint32_t> clustered_ts_id, GcCursor* cursor) {
     if (ttl_st_map.empty()) {
         return;
     }
@@ -488,7 +531,7 @@ void Segment::ExecuteGc(const std::map<uint32_t, TTLSt>& ttl_st_map, StatisticsI
             DLOG(INFO) << "skip normal gc in cidx";
             return;
         }
-        ExecuteGc(ttl_st_map.begin()->second, statistics_info);
+        ExecuteGc(ttl_st_map.begin()->second, statistics_info, cursor);
         return;
     }
     bool need_gc = false;
@@ -503,10 +546,10 @@ void Segment::ExecuteGc(const std::map<uint32_t, TTLSt>& ttl_st_map, StatisticsI
     if (!need_gc) {
         return;
     }
-    GcAllType(ttl_st_map, statistics_info, clustered_ts_id);
+    GcAllType(ttl_st_map, statistics_info, clustered_ts_id, cursor);
 }
 
-void Segment::Gc4Head(uint64_t keep_cnt, StatisticsInfo* statistics_info) {
+void Segment::Gc4Head(uint64_t keep_cnt, StatisticsInfo* statistics_info, GcCursor* cursor) {
     if (keep_cnt == 0) {
         PDLOG(WARNING, "[Gc4Head] segment gc4head is disabled");
         return;
@@ -514,8 +557,8 @@ void Segment::Gc4Head(uint64_t keep_cnt, StatisticsInfo* statistics_info) {
     uint64_t consumed = ::baidu::common::timer::get_micros();
     uint64_t old = statistics_info->GetIdxCnt(0);
     std::unique_ptr<KeyEntries::Iterator> it(entries_->NewIterator());
-    it->SeekToFirst();
-    while (it->Valid()) {
+    SeekGcCursor(it.get(), cursor);
+    while (it->Valid() && CheckGcBudget(it.get(), cursor)) {
         auto entry = reinterpret_cast<KeyEntry*>(it->GetValue());
         ::openmldb::base::Node<uint64_t, DataBlock*>* node = nullptr;
         {
@@ -535,16 +578,16 @@ void Segment::Gc4Head(uint64_t keep_cnt, StatisticsInfo* statistics_info) {
 }
 
 void Segment::GcAllType(const std::map<uint32_t, TTLSt>& ttl_st_map, StatisticsInfo* statistics_info,
-                        std::optional<uint32_t> clustered_ts_id) {
+                        std::optional<uint32_t> clustered_ts_id, GcCursor* cursor) {
     uint64_t old = statistics_info->GetTotalCnt();
     uint64_t consumed = ::baidu::common::timer::get_micros();
     std::unique_ptr<KeyEntries::Iterator> it(entries_->NewIterator());
-    it->SeekToFirst();
+    SeekGcCursor(it.get(), cursor);
     for (auto [ts, ttl_st] : ttl_st_map) {
         DLOG(INFO) << "ts " << ts << " ttl_st " << ttl_st.ToString() << " it will be current time - ttl?";
     }
 
-    while (it->Valid()) {
+    while (it->Valid() && CheckGcBudget(it.get(), cursor)) {
         KeyEntry** entry_arr = reinterpret_cast<KeyEntry**>(it->GetValue());
         Slice key = it->GetKey();
         it->Next();
@@ -660,6 +703,35 @@ void Segment::GcAllType(const std::map<uint32_t, TTLSt>& ttl_st_map, StatisticsI
                << "ms, count " << statistics_info->GetTotalCnt() - old;
 }
 
+void Segment::SeekGcCursor(KeyEntries::Iterator* it, GcCursor* cursor) {
+    if (cursor == nullptr) {
+        it->SeekToFirst();
+        return;
+    }
+    cursor->visited = 0;
+    cursor->finished = true;
+    if (cursor->has_key) {
+        it->Seek(Slice(cursor->key));
+    } else {
+        it->SeekToFirst();
+    }
+}
+
+bool Segment::CheckGcBudget(KeyEntries::Iterator* it, GcCursor* cursor) {
+    if (cursor == nullptr) {
+        return true;
+    }
+    if (cursor->max_keys > 0 && cursor->visited >= cursor->max_keys) {
+        cursor->key = it->GetKey().ToString();
+        cursor->has_key = true;
+        cursor->finished = false;
+        return false;
+    }
+    cursor->visited++;
+    cursor->has_key = false;
+    return true;
+}
+
 void Segment::SplitList(KeyEntry* entry, uint64_t ts, ::openmldb::base::Node<uint64_t, DataBlock*>** node) {
     // skip entry that ocupied by reader
     if (entry->refs_.load(std::memory_order_acquire) <= 0) {
@@ -697,12 +769,12 @@ bool Segment::ListContains(KeyEntry* entry, uint64_t time, DataBlock* row, bool
 }
 
 // fast gc with no global pause
-void Segment::Gc4TTL(const uint64_t time, StatisticsInfo* statistics_info) {
+void Segment::Gc4TTL(const uint64_t time, StatisticsInfo* statistics_info, GcCursor* cursor) {
     uint64_t consumed = ::baidu::common::timer::get_micros();
     uint64_t old = statistics_info->GetIdxCnt(0);
     std::unique_ptr<KeyEntries::Iterator> it(entries_->NewIterator());
-    it->SeekToFirst();
-    while (it->Valid()) {
+    SeekGcCursor(it.get(), cursor);
+    while (it->Valid() && CheckGcBudget(it.get(), cursor)) {
         KeyEntry* entry = reinterpret_cast<KeyEntry*>(it->GetValue());
         Slice key = it->GetKey();
         it->Next();
@@ -735,7 +807,8 @@ void Segment::Gc4TTL(const uint64_t time, StatisticsInfo* statistics_info) {
     idx_cnt_vec_[0]->fetch_sub(statistics_info->GetIdxCnt(0) - old, std::memory_order_relaxed);
 }
 
-void Segment::Gc4TTLAndHead(const uint64_t time, const uint64_t keep_cnt, StatisticsInfo* statistics_info) {
+void Segment::Gc4TTLAndHead(const uint64_t time, const uint64_t keep_cnt, StatisticsInfo* statistics_info,
+                            GcCursor* cursor) {
     if (time == 0 || keep_cnt == 0) {
         PDLOG(INFO, "[Gc4TTLAndHead] segment gc4ttlandhead is disabled");
         return;
@@ -743,8 +816,8 @@ void Segment::Gc4TTLAndHead(const uint64_t time, const uint64_t keep_cnt, Statis
     uint64_t consumed = ::baidu::common::timer::get_micros();
     uint64_t old = statistics_info->GetIdxCnt(0);
     std::unique_ptr<KeyEntries::Iterator> it(entries_->NewIterator());
-    it->SeekToFirst();
-    while (it->Valid()) {
+    SeekGcCursor(it.get(), cursor);
+    while (it->Valid() && CheckGcBudget(it.get(), cursor)) {
         KeyEntry* entry = reinterpret_cast<KeyEntry*>(it->GetValue());
         ::openmldb::base::Node<uint64_t, DataBlock*>* node = entry->entries.GetLast();
         it->Next();
@@ -770,22 +843,23 @@ void Segment::Gc4TTLAndHead(const uint64_t time, const uint64_t keep_cnt, Statis
     idx_cnt_vec_[0]->fetch_sub(statistics_info->GetIdxCnt(0) - old, std::memory_order_relaxed);
 }
 
-void Segment::Gc4TTLOrHead(const uint64_t time, const uint64_t keep_cnt, StatisticsInfo* statistics_info) {
+void Segment::Gc4TTLOrHead(const uint64_t time, const uint64_t keep_cnt, StatisticsInfo* statistics_info,
+                           GcCursor* cursor) {
     if (time == 0 && keep_cnt == 0) {
         PDLOG(INFO, "[Gc4TTLOrHead] segment gc4ttlorhead is disabled");
         return;
     } else if (time == 0) {
-        Gc4Head(keep_cnt, statistics_info);
+        Gc4Head(keep_cnt, statistics_info, cursor);
         return;
     } else if (keep_cnt == 0) {
-        Gc4TTL(time, statistics_info);
+        Gc4TTL(time, statistics_info, cursor);
         return;
     }
     uint64_t consumed = ::baidu::common::timer::get_micros();
     uint64_t old = statistics_info->GetIdxCnt(0);
     std::unique_ptr<KeyEntries::Iterator> it(entries_->NewIterator());
-    it->SeekToFirst();
-    while (it->Valid()) {
+    SeekGcCursor(it.get(), cursor);
+    while (it->Valid() && CheckGcBudget(it.get(), cursor)) {
         KeyEntry* entry = reinterpret_cast<KeyEntry*>(it->GetValue());
         Slice key = it->GetKey();
         it->Next();
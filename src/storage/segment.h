@@ -23,6 +23,7 @@
 #include <mutex>  // NOLINT
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/skiplist.h"
@@ -33,6 +34,7 @@
 #include "storage/node_cache.h"
 #include "storage/schema.h"
 #include "storage/ticket.h"
+#include "storage/window_cache.h"
 
 namespace openmldb {
 namespace storage {
@@ -65,6 +67,15 @@ struct SliceComparator {
 using KeyEntries = base::Skiplist<base::Slice, void*, SliceComparator>;
 using KeyEntryNodeList = base::Skiplist<uint64_t, base::Node<Slice, void*>*, TimeComparator>;
 
+// the position of an incremental gc in a segment
+struct GcCursor {
+    std::string key;  // the key to start from if has_key
+    bool has_key = false;
+    uint64_t max_keys = 0;  // the max number of keys to visit in one gc, 0 means no limit
+    uint64_t visited = 0;   // the number of keys visited by the last gc
+    bool finished = true;   // whether the last gc reached the end of the segment
+};
+
 class Segment {
  public:
     explicit Segment(uint8_t height);
@@ -78,6 +89,9 @@ class Segment {
     bool Put(const Slice& key, uint64_t time, DataBlock* row, bool put_if_absent = false, bool check_all_time = false);
 
     void BulkLoadPut(unsigned int key_entry_id, const Slice& key, uint64_t time, DataBlock* row);
+    // put all the time entries of one key in a batch, the key is looked up only once
+    bool BulkLoadPut(unsigned int key_entry_id, const Slice& key,
+                     const std::vector<std::pair<uint64_t, DataBlock*>>& rows);
     // main put method
     virtual bool Put(const Slice& key, const std::map<int32_t, uint64_t>& ts_map, DataBlock* row,
                      bool put_if_absent = false);
@@ -88,16 +102,19 @@ class Segment {
 
     void Release(StatisticsInfo* statistics_info);
 
-    void ExecuteGc(const TTLSt& ttl_st, StatisticsInfo* statistics_info);
+    // gc the whole segment, or only the keys from the cursor within its budget if cursor is not null
+    void ExecuteGc(const TTLSt& ttl_st, StatisticsInfo* statistics_info, GcCursor* cursor = nullptr);
     void ExecuteGc(const std::map<uint32_t, TTLSt>& ttl_st_map, StatisticsInfo* statistics_info,
-                   std::optional<uint32_t> clustered_ts_id = std::nullopt);
-
-    void Gc4TTL(const uint64_t time, StatisticsInfo* statistics_info);
-    void Gc4Head(uint64_t keep_cnt, StatisticsInfo* statistics_info);
-    void Gc4TTLAndHead(const uint64_t time, const uint64_t keep_cnt, StatisticsInfo* statistics_info);
-    void Gc4TTLOrHead(const uint64_t time, const uint64_t keep_cnt, StatisticsInfo* statistics_info);
+                   std::optional<uint32_t> clustered_ts_id = std::nullopt, GcCursor* cursor = nullptr);
+
+    void Gc4TTL(const uint64_t time, StatisticsInfo* statistics_info, GcCursor* cursor = nullptr);
+    void Gc4Head(uint64_t keep_cnt, StatisticsInfo* statistics_info, GcCursor* cursor = nullptr);
+    void Gc4TTLAndHead(const uint64_t time, const uint64_t keep_cnt, StatisticsInfo* statistics_info,
+                       GcCursor* cursor = nullptr);
+    void Gc4TTLOrHead(const uint64_t time, const uint64_t keep_cnt, StatisticsInfo* statistics_info,
+                      GcCursor* cursor = nullptr);
     void GcAllType(const std::map<uint32_t, TTLSt>& ttl_st_map, StatisticsInfo* statistics_info,
-                   std::optional<uint32_t> clustered_ts_id = std::nullopt);
+                   std::optional<uint32_t> clustered_ts_id = std::nullopt, GcCursor* cursor = nullptr);
 
     MemTableIterator* NewIterator(const Slice& key, Ticket& ticket, type::CompressType compress_type);  // NOLINT
     MemTableIterator* NewIterator(const Slice& key, uint32_t idx, Ticket& ticket,                       // NOLINT
@@ -145,13 +162,27 @@ class Segment {
 
     void ReleaseAndCount(const std::vector<size_t>& id_vec, StatisticsInfo* statistics_info);
 
+    // the cache must outlive the segment
+    void SetWindowCache(WindowCache* window_cache) { window_cache_ = window_cache; }
+    WindowCache* GetWindowCache() const { return window_cache_; }
+    uint64_t GetId() const { return id_; }
+
  protected:
+    inline void InvalidateCache(const Slice& key) {
+        if (window_cache_ != nullptr) {
+            window_cache_->Invalidate(id_, key);
+        }
+    }
     void FreeList(uint32_t ts_idx, ::openmldb::base::Node<uint64_t, DataBlock*>* node, StatisticsInfo* statistics_info);
     void SplitList(KeyEntry* entry, uint64_t ts, ::openmldb::base::Node<uint64_t, DataBlock*>** node);
     bool GetTsIdx(const std::optional<uint32_t>& idx, uint32_t* ts_idx);
 
     bool ListContains(KeyEntry* entry, uint64_t time, DataBlock* row, bool check_all_time);
 
+    void SeekGcCursor(KeyEntries::Iterator* it, GcCursor* cursor);
+    // return false and keep the current key in the cursor if the budget of the cursor is used up
+    bool CheckGcBudget(KeyEntries::Iterator* it, GcCursor* cursor);
+
     virtual bool PutUnlock(const Slice& key, uint64_t time, DataBlock* row, bool put_if_absent = false,
                            bool check_all_time = false);
 
@@ -168,6 +199,8 @@ class Segment {
     std::vector<std::shared_ptr<std::atomic<uint64_t>>> idx_cnt_vec_;
     uint64_t ttl_offset_;
     NodeCache node_cache_;
+    const uint64_t id_;
+    WindowCache* window_cache_;
 };
 
 }  // namespace storage
@@ -18,6 +18,8 @@
 
 #include <iostream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "base/glog_wrapper.h"
@@ -76,6 +78,36 @@ TEST_F(SegmentTest, PutAndScan) {
     ASSERT_TRUE(it->Valid());
 }
 
+TEST_F(SegmentTest, BulkLoadPut) {
+    Segment segment(8);
+    Slice pk("test1");
+    auto make_rows = [](const std::vector<uint64_t>& times) {
+        std::vector<std::pair<uint64_t, DataBlock*>> rows;
+        for (auto time : times) {
+            std::string value = "value" + std::to_string(time);
+            rows.emplace_back(time, new DataBlock(1, value.c_str(), value.size()));
+        }
+        return rows;
+    };
+    // sorted rows are appended, the others are inserted
+    ASSERT_TRUE(segment.BulkLoadPut(0, pk, make_rows({9530, 9529, 9528})));
+    ASSERT_TRUE(segment.BulkLoadPut(0, pk, make_rows({9527, 9526})));
+    ASSERT_TRUE(segment.BulkLoadPut(0, pk, make_rows({9520, 9535, 9525})));
+    ASSERT_EQ(1u, segment.GetPkCnt());
+    ASSERT_EQ(8u, segment.GetIdxCnt());
+    uint64_t count = 0;
+    ASSERT_EQ(0, segment.GetCount(pk, count));
+    ASSERT_EQ(8u, count);
+    Ticket ticket;
+    std::unique_ptr<MemTableIterator> it(segment.NewIterator("test1", ticket, type::CompressType::kNoCompress));
+    std::vector<uint64_t> times;
+    for (it->SeekToFirst(); it->Valid(); it->Next()) {
+        times.push_back(it->GetKey());
+        ASSERT_EQ("value" + std::to_string(it->GetKey()), it->GetValue().ToString());
+    }
+    ASSERT_EQ(std::vector<uint64_t>({9535, 9530, 9529, 9528, 9527, 9526, 9525, 9520}), times);
+}
+
 // report result, don't need to print args in here, just print the failure
 ::testing::AssertionResult CheckStatisticsInfo(const StatisticsInfo& expect, const StatisticsInfo& value) {
     if (expect.idx_cnt_vec.size() != value.idx_cnt_vec.size()) {
@@ -142,7 +174,7 @@ TEST_F(SegmentTest, Delete) {
     segment.IncrGcVersion();
     StatisticsInfo gc_info(1);
     segment.GcFreeList(&gc_info);
-    CheckStatisticsInfo(CreateStatisticsInfo(4, 365, 4 * (5 + sizeof(DataBlock))), gc_info);
+    CheckStatisticsInfo(CreateStatisticsInfo(4, 429, 4 * (5 + sizeof(DataBlock))), gc_info);
 }
 
 TEST_F(SegmentTest, GetCount) {
@@ -257,7 +289,7 @@ TEST_F(SegmentTest, TestGc4TTL) {
     segment.IncrGcVersion();
     segment.IncrGcVersion();
     segment.GcFreeList(&gc_info);
-    CheckStatisticsInfo(CreateStatisticsInfo(2, 194, 2 * GetRecordSize(5)), gc_info);
+    CheckStatisticsInfo(CreateStatisticsInfo(2, 238, 2 * GetRecordSize(5)), gc_info);
 }
 
 TEST_F(SegmentTest, TestGc4TTLAndHead) {
@@ -461,7 +493,7 @@ TEST_F(SegmentTest, TestDeleteRange) {
     segment.IncrGcVersion();
     StatisticsInfo gc_info(1);
     segment.GcFreeList(&gc_info);
-    CheckStatisticsInfo(CreateStatisticsInfo(20, 1012, 20 * (6 + sizeof(DataBlock))), gc_info);
+    CheckStatisticsInfo(CreateStatisticsInfo(20, 1148, 20 * (6 + sizeof(DataBlock))), gc_info);
 }
 
 TEST_F(SegmentTest, PutIfAbsent) {
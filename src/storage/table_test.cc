@@ -1625,6 +1625,45 @@ TEST_F(TableTest, Release) {
     delete table;
 }
 
+// IncrementalGc is only in memtable
+TEST_F(TableTest, IncrementalGc) {
+    std::map<std::string, uint32_t> mapping;
+    mapping.insert(std::make_pair("idx0", 0));
+    MemTable table("tx_log", 1, 1, 8, mapping, 1, ::openmldb::type::kLatestTime);
+    table.Init();
+    for (int i = 0; i < 1000; i++) {
+        std::string key = "key" + std::to_string(i);
+        table.Put(key, 1, "test1", 5);
+        table.Put(key, 2, "test2", 5);
+    }
+    ASSERT_EQ(2000u, table.GetRecordIdxCnt());
+    // 8 segments and at most 10 keys of each one per tick, so one pass takes many ticks
+    uint32_t ticks = 1;
+    while (!table.IncrementalGc(10)) {
+        ticks++;
+        ASSERT_LE(ticks, 1000u);
+    }
+    ASSERT_GE(ticks, 1000u / (8 * 10));
+    ASSERT_EQ(1000u, table.GetRecordIdxCnt());
+    auto stats = table.GetGcStats();
+    ASSERT_EQ(1000u, stats.reclaimed_idx_cnt);
+    ASSERT_GT(stats.reclaimed_byte_size, 0u);
+    for (int i = 0; i < 1000; i += 99) {
+        Ticket ticket;
+        std::unique_ptr<TableIterator> it(table.NewIterator("key" + std::to_string(i), ticket));
+        it->SeekToFirst();
+        ASSERT_TRUE(it->Valid());
+        ASSERT_EQ(2u, it->GetKey());
+        it->Next();
+        ASSERT_FALSE(it->Valid());
+    }
+    // nothing expired, the next pass finishes with a shrunk budget and reclaims nothing
+    while (!table.IncrementalGc(10)) {
+    }
+    ASSERT_EQ(1000u, table.GetRecordIdxCnt());
+    ASSERT_EQ(0u, table.GetGcStats().reclaimed_idx_cnt);
+}
+
 TEST_P(TableTest, TSColIDLength) {
     ::openmldb::common::StorageMode storageMode = GetParam();
     ::openmldb::api::TableMeta table_meta;
@@ -0,0 +1,186 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/window_cache.h"
+
+#include <algorithm>
+
+#include "base/hash.h"
+
+namespace openmldb {
+namespace storage {
+
+constexpr uint32_t WINDOW_CACHE_SEED = 0xe17a1465;
+
+std::atomic<uint64_t> WindowCache::next_segment_id_{1};
+
+WindowCache::WindowCache(uint64_t capacity, uint32_t max_rows_per_key, uint32_t shard_num)
+    : shard_capacity_(capacity / std::max<uint32_t>(shard_num, 1)),
+      max_rows_per_key_(max_rows_per_key),
+      shards_(),
+      admission_(),
+      hit_(0),
+      miss_(0),
+      fill_(0),
+      invalidate_(0),
+      evict_(0),
+      byte_size_(0) {
+    for (uint32_t i = 0; i < std::max<uint32_t>(shard_num, 1); i++) {
+        shards_.emplace_back(std::make_unique<Shard>());
+    }
+}
+
+std::string WindowCache::SlotKey(uint64_t segment_id, const base::Slice& key) {
+    std::string slot_key;
+    slot_key.reserve(sizeof(segment_id) + key.size());
+    slot_key.append(reinterpret_cast<const char*>(&segment_id), sizeof(segment_id));
+    slot_key.append(key.data(), key.size());
+    return slot_key;
+}
+
+WindowCache::Shard& WindowCache::GetShard(uint64_t segment_id, const base::Slice& key) {
+    uint32_t hash = ::openmldb::base::hash(key.data(), key.size(), WINDOW_CACHE_SEED);
+    return *shards_[(hash ^ segment_id) % shards_.size()];
+}
+
+std::shared_ptr<const WindowCacheEntry> WindowCache::Get(uint64_t segment_id, uint32_t ts_idx,
+                                                         const base::Slice& key, uint64_t* token) {
+    *token = 0;
+    Shard& shard = GetShard(segment_id, key);
+    bool cached_key = false;
+    {
+        std::lock_guard<std::mutex> lock(shard.mu);
+        auto iter = shard.slots.find(SlotKey(segment_id, key));
+        if (iter != shard.slots.end()) {
+            auto entry_iter = iter->second.entries.find(ts_idx);
+            if (entry_iter != iter->second.entries.end()) {
+                shard.lru.splice(shard.lru.begin(), shard.lru, iter->second.lru_pos);
+                hit_.fetch_add(1, std::memory_order_relaxed);
+                return entry_iter->second;
+            }
+            cached_key = true;
+        }
+    }
+    miss_.fetch_add(1, std::memory_order_relaxed);
+    // the other time indexes of a cached key are admitted already
+    if (!cached_key && admission_ && !admission_(key)) {
+        return nullptr;
+    }
+    // the caller reads the rows after the version, so a put of them is either seen or fails the fill
+    *token = shard.version.load(std::memory_order_seq_cst);
+    return nullptr;
+}
+
+bool WindowCache::Fill(uint64_t segment_id, uint32_t ts_idx, const base::Slice& key, uint64_t token,
+                       std::shared_ptr<const WindowCacheEntry> entry) {
+    if (token == 0 || !entry || entry->byte_size > shard_capacity_) {
+        return false;
+    }
+    Shard& shard = GetShard(segment_id, key);
+    std::lock_guard<std::mutex> lock(shard.mu);
+    std::string slot_key = SlotKey(segment_id, key);
+    auto iter = shard.slots.find(slot_key);
+    bool new_slot = iter == shard.slots.end();
+    if (new_slot) {
+        // count the slot before checking the version. Invalidate increases the version before checking slot_cnt,
+        // so either the fill sees the new version or the put sees the slot and erases it
+        shard.slot_cnt.fetch_add(1, std::memory_order_seq_cst);
+    }
+    if (shard.version.load(std::memory_order_seq_cst) != token) {
+        // a key of the shard is updated after the token is acquired
+        if (new_slot) {
+            shard.slot_cnt.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return false;
+    }
+    if (new_slot) {
+        shard.lru.push_front(slot_key);
+        Slot slot;
+        slot.lru_pos = shard.lru.begin();
+        iter = shard.slots.emplace(std::move(slot_key), std::move(slot)).first;
+    }
+    Slot& slot = iter->second;
+    uint64_t byte_size = entry->byte_size;
+    auto entry_iter = slot.entries.find(ts_idx);
+    if (entry_iter != slot.entries.end()) {
+        slot.byte_size -= entry_iter->second->byte_size;
+        shard.byte_size -= entry_iter->second->byte_size;
+        byte_size_.fetch_sub(entry_iter->second->byte_size, std::memory_order_relaxed);
+        entry_iter->second = std::move(entry);
+    } else {
+        slot.entries.emplace(ts_idx, std::move(entry));
+    }
+    slot.byte_size += byte_size;
+    shard.byte_size += byte_size;
+    byte_size_.fetch_add(byte_size, std::memory_order_relaxed);
+    fill_.fetch_add(1, std::memory_order_relaxed);
+    shard.lru.splice(shard.lru.begin(), shard.lru, slot.lru_pos);
+    while (shard.byte_size > shard_capacity_ && !shard.lru.empty()) {
+        auto evict_iter = shard.slots.find(shard.lru.back());
+        if (evict_iter == iter) {
+            break;
+        }
+        EraseUnlock(&shard, evict_iter);
+        evict_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void WindowCache::Invalidate(uint64_t segment_id, const base::Slice& key) {
+    Shard& shard = GetShard(segment_id, key);
+    // fail the fills of the rows read before the put
+    shard.version.fetch_add(1, std::memory_order_seq_cst);
+    if (shard.slot_cnt.load(std::memory_order_seq_cst) == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(shard.mu);
+    auto iter = shard.slots.find(SlotKey(segment_id, key));
+    if (iter != shard.slots.end()) {
+        EraseUnlock(&shard, iter);
+        invalidate_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void WindowCache::EraseUnlock(Shard* shard, std::unordered_map<std::string, Slot>::iterator iter) {
+    shard->byte_size -= iter->second.byte_size;
+    byte_size_.fetch_sub(iter->second.byte_size, std::memory_order_relaxed);
+    shard->lru.erase(iter->second.lru_pos);
+    shard->slots.erase(iter);
+    shard->slot_cnt.fetch_sub(1, std::memory_order_relaxed);
+}
+
+WindowCache::Stats WindowCache::GetStats() const {
+    Stats stats;
+    stats.hit = hit_.load(std::memory_order_relaxed);
+    stats.miss = miss_.load(std::memory_order_relaxed);
+    stats.fill = fill_.load(std::memory_order_relaxed);
+    stats.invalidate = invalidate_.load(std::memory_order_relaxed);
+    stats.evict = evict_.load(std::memory_order_relaxed);
+    stats.byte_size = byte_size_.load(std::memory_order_relaxed);
+    for (const auto& shard : shards_) {
+        stats.slot_cnt += shard->slot_cnt.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+void WindowCacheIterator::Seek(const uint64_t& key) {
+    const auto& rows = entry_->rows;
+    auto iter = std::partition_point(rows.begin(), rows.end(), [&key](const auto& row) { return row.first > key; });
+    pos_ = iter - rows.begin();
+}
+
+}  // namespace storage
+}  // namespace openmldb
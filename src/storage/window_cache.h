@@ -0,0 +1,159 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_STORAGE_WINDOW_CACHE_H_
+#define SRC_STORAGE_WINDOW_CACHE_H_
+
+#include <atomic>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/slice.h"
+#include "storage/schema.h"
+#include "vm/catalog.h"
+
+namespace openmldb {
+namespace storage {
+
+// the materialized rows of one key in one time index, ordered by ts desc like TimeEntries.
+// rows own their data, so they stay valid after the records are released by gc
+struct WindowCacheEntry {
+    std::vector<std::pair<uint64_t, ::hybridse::codec::Row>> rows;
+    uint64_t byte_size = 0;
+};
+
+// WindowCache keeps the rows of recently read hot keys, so that the request path does not need to seek
+// KeyEntries and decode the time list again for every request. A cache slot is identified by
+// <segment id, key> and holds the entries of all time indexes of the key. Segment::Put and Segment::Delete
+// invalidate the slot of the key, expired rows are filtered when reading.
+//
+// Get returns a fill token on miss, which is the invalidation version of the shard of the key. Fill only
+// succeeds if no key of the shard is invalidated since the token is acquired, so rows read concurrently with a
+// put are never cached. A slot is only created by Fill, so the misses which are never filled take no memory.
+class WindowCache {
+ public:
+    struct Stats {
+        uint64_t hit = 0;
+        uint64_t miss = 0;
+        uint64_t fill = 0;
+        uint64_t invalidate = 0;
+        uint64_t evict = 0;
+        uint64_t byte_size = 0;
+        uint64_t slot_cnt = 0;
+    };
+    // decide whether the key should be cached. all keys are admitted if not set
+    using AdmissionFunc = std::function<bool(const base::Slice& key)>;
+
+    WindowCache(uint64_t capacity, uint32_t max_rows_per_key, uint32_t shard_num = 64);
+    WindowCache(const WindowCache&) = delete;
+    WindowCache& operator=(const WindowCache&) = delete;
+    ~WindowCache() {}
+
+    void SetAdmission(AdmissionFunc admission) { admission_ = std::move(admission); }
+
+    // return the cached entry or nullptr. *token is set to non-zero if the caller should fill the entry
+    std::shared_ptr<const WindowCacheEntry> Get(uint64_t segment_id, uint32_t ts_idx, const base::Slice& key,
+                                                uint64_t* token);
+
+    bool Fill(uint64_t segment_id, uint32_t ts_idx, const base::Slice& key, uint64_t token,
+              std::shared_ptr<const WindowCacheEntry> entry);
+
+    void Invalidate(uint64_t segment_id, const base::Slice& key);
+
+    uint32_t GetMaxRowsPerKey() const { return max_rows_per_key_; }
+
+    Stats GetStats() const;
+
+    // every segment gets an unique id, so that one cache can be shared by all tables
+    static uint64_t NewSegmentId() { return next_segment_id_.fetch_add(1, std::memory_order_relaxed); }
+
+ private:
+    struct Slot {
+        uint64_t byte_size = 0;
+        std::map<uint32_t, std::shared_ptr<const WindowCacheEntry>> entries;
+        std::list<std::string>::iterator lru_pos;
+    };
+    struct Shard {
+        std::mutex mu;
+        // increased by every Invalidate, the token of the fills
+        std::atomic<uint64_t> version{1};
+        // fast path for Invalidate, puts to keys which are not cached do not need the lock
+        std::atomic<uint64_t> slot_cnt{0};
+        std::unordered_map<std::string, Slot> slots;
+        std::list<std::string> lru;
+        uint64_t byte_size = 0;
+    };
+
+    static std::string SlotKey(uint64_t segment_id, const base::Slice& key);
+    Shard& GetShard(uint64_t segment_id, const base::Slice& key);
+    void EraseUnlock(Shard* shard, std::unordered_map<std::string, Slot>::iterator iter);
+
+    const uint64_t shard_capacity_;
+    const uint32_t max_rows_per_key_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    AdmissionFunc admission_;
+    std::atomic<uint64_t> hit_;
+    std::atomic<uint64_t> miss_;
+    std::atomic<uint64_t> fill_;
+    std::atomic<uint64_t> invalidate_;
+    std::atomic<uint64_t> evict_;
+    std::atomic<uint64_t> byte_size_;
+    static std::atomic<uint64_t> next_segment_id_;
+};
+
+// iterate the rows of a WindowCacheEntry, the expired rows are skipped like MemTableWindowIterator
+class WindowCacheIterator : public ::hybridse::vm::RowIterator {
+ public:
+    WindowCacheIterator(std::shared_ptr<const WindowCacheEntry> entry, TTLType ttl_type, uint64_t expire_time,
+                        uint64_t expire_cnt)
+        : entry_(std::move(entry)), pos_(0), expire_value_(expire_time, expire_cnt, ttl_type) {}
+
+    ~WindowCacheIterator() override {}
+
+    bool Valid() const override {
+        return pos_ < entry_->rows.size() && !expire_value_.IsExpired(entry_->rows[pos_].first, pos_ + 1);
+    }
+
+    void Next() override { pos_++; }
+
+    const uint64_t& GetKey() const override { return entry_->rows[pos_].first; }
+
+    const ::hybridse::codec::Row& GetValue() override { return entry_->rows[pos_].second; }
+
+    // rows are ordered by ts desc, seek to the first row whose ts <= key
+    void Seek(const uint64_t& key) override;
+
+    void SeekToFirst() override { pos_ = 0; }
+
+    bool IsSeekable() const override { return true; }
+
+ private:
+    std::shared_ptr<const WindowCacheEntry> entry_;
+    uint32_t pos_;
+    ExpiredChecker expire_value_;
+};
+
+}  // namespace storage
+}  // namespace openmldb
+
+#endif  // SRC_STORAGE_WINDOW_CACHE_H_
@@ -0,0 +1,234 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/window_cache.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/glog_wrapper.h"
+#include "common/timer.h"
+#include "gtest/gtest.h"
+#include "storage/mem_table.h"
+
+namespace openmldb {
+namespace storage {
+
+class WindowCacheTest : public ::testing::Test {
+ public:
+    WindowCacheTest() {}
+    ~WindowCacheTest() {}
+
+    static std::unique_ptr<MemTable> CreateTable(uint64_t ttl, ::openmldb::type::TTLType ttl_type) {
+        std::map<std::string, uint32_t> mapping;
+        mapping.insert(std::make_pair("idx0", 0));
+        auto table = std::make_unique<MemTable>("t1", 1, 1, 8, mapping, ttl, ttl_type);
+        table->Init();
+        return table;
+    }
+
+    // read the window of key through the window iterator, return the number of rows or -1 if key is not found
+    static int ReadWindow(MemTable* table, const std::string& key, std::vector<std::string>* values) {
+        std::unique_ptr<::hybridse::vm::WindowIterator> it(table->NewWindowIterator(0));
+        it->Seek(key);
+        if (!it->Valid() || it->GetKey().ToString() != key) {
+            return -1;
+        }
+        std::unique_ptr<::hybridse::vm::RowIterator> wit = it->GetValue();
+        int cnt = 0;
+        for (wit->SeekToFirst(); wit->Valid(); wit->Next()) {
+            if (values != nullptr) {
+                values->push_back(wit->GetValue().ToString());
+            }
+            cnt++;
+        }
+        return cnt;
+    }
+};
+
+TEST_F(WindowCacheTest, HitAndInvalidate) {
+    auto table = CreateTable(0, ::openmldb::type::kAbsoluteTime);
+    auto cache = std::make_shared<WindowCache>(1024 * 1024, 100);
+    table->SetWindowCache(cache);
+    uint64_t now = ::baidu::common::timer::get_micros() / 1000;
+    for (int i = 0; i < 3; i++) {
+        std::string value = "value" + std::to_string(i);
+        table->Put("key1", now + i, value.c_str(), value.size());
+    }
+    table->Put("key2", now, "other", 5);
+
+    std::vector<std::string> values;
+    ASSERT_EQ(3, ReadWindow(table.get(), "key1", &values));
+    ASSERT_EQ(1u, cache->GetStats().fill);
+    ASSERT_EQ(0u, cache->GetStats().hit);
+    values.clear();
+    ASSERT_EQ(3, ReadWindow(table.get(), "key1", &values));
+    ASSERT_EQ(1u, cache->GetStats().hit);
+    ASSERT_EQ("value2", values[0]);
+    ASSERT_EQ("value0", values[2]);
+    ASSERT_GT(cache->GetStats().byte_size, 0u);
+
+    // iterating to the next key from a cached key
+    std::unique_ptr<::hybridse::vm::WindowIterator> it(table->NewWindowIterator(0));
+    it->Seek("key1");
+    ASSERT_TRUE(it->Valid());
+    ASSERT_EQ(2u, cache->GetStats().hit);
+    int key_cnt = 0;
+    while (it->Valid()) {
+        key_cnt++;
+        it->Next();
+    }
+    ASSERT_GE(key_cnt, 1);
+
+    // put invalidates the key
+    table->Put("key1", now + 10, "value10", 7);
+    ASSERT_EQ(1u, cache->GetStats().invalidate);
+    values.clear();
+    ASSERT_EQ(4, ReadWindow(table.get(), "key1", &values));
+    ASSERT_EQ("value10", values[0]);
+    ASSERT_EQ(4, ReadWindow(table.get(), "key1", nullptr));
+    ASSERT_EQ(-1, ReadWindow(table.get(), "key3", nullptr));
+}
+
+TEST_F(WindowCacheTest, Expire) {
+    // ttl is 1 minute
+    auto table = CreateTable(1, ::openmldb::type::kAbsoluteTime);
+    auto cache = std::make_shared<WindowCache>(1024 * 1024, 100);
+    table->SetWindowCache(cache);
+    uint64_t now = ::baidu::common::timer::get_micros() / 1000;
+    table->Put("key1", now, "value0", 6);
+    table->Put("key1", now - 1, "value1", 6);
+    table->Put("key1", now - 2 * 60 * 1000, "expired", 7);
+    ASSERT_EQ(2, ReadWindow(table.get(), "key1", nullptr));
+    ASSERT_EQ(2, ReadWindow(table.get(), "key1", nullptr));
+    ASSERT_EQ(1u, cache->GetStats().hit);
+}
+
+TEST_F(WindowCacheTest, Limit) {
+    auto table = CreateTable(0, ::openmldb::type::kAbsoluteTime);
+    auto cache = std::make_shared<WindowCache>(1024 * 1024, 2);
+    cache->SetAdmission([](const base::Slice& key) { return key.compare(base::Slice("cold")) != 0; });
+    table->SetWindowCache(cache);
+    uint64_t now = ::baidu::common::timer::get_micros() / 1000;
+    for (int i = 0; i < 3; i++) {
+        table->Put("big", now + i, "value", 5);
+    }
+    table->Put("cold", now, "value", 5);
+    // too many rows
+    ASSERT_EQ(3, ReadWindow(table.get(), "big", nullptr));
+    ASSERT_EQ(3, ReadWindow(table.get(), "big", nullptr));
+    // not admitted
+    ASSERT_EQ(1, ReadWindow(table.get(), "cold", nullptr));
+    ASSERT_EQ(1, ReadWindow(table.get(), "cold", nullptr));
+    ASSERT_EQ(0u, cache->GetStats().fill);
+    ASSERT_EQ(0u, cache->GetStats().hit);
+}
+
+TEST_F(WindowCacheTest, FillAfterInvalidate) {
+    WindowCache cache(1024 * 1024, 100);
+    uint64_t segment_id = WindowCache::NewSegmentId();
+    base::Slice key("key1");
+    uint64_t token = 0;
+    ASSERT_FALSE(cache.Get(segment_id, 0, key, &token));
+    ASSERT_NE(0u, token);
+    // a put happens between reading the rows and filling the cache
+    cache.Invalidate(segment_id, key);
+    auto entry = std::make_shared<WindowCacheEntry>();
+    entry->byte_size = 10;
+    ASSERT_FALSE(cache.Fill(segment_id, 0, key, token, entry));
+    ASSERT_FALSE(cache.Get(segment_id, 0, key, &token));
+    ASSERT_TRUE(cache.Fill(segment_id, 0, key, token, entry));
+    ASSERT_TRUE(cache.Get(segment_id, 0, key, &token));
+    // other segments and time indexes are isolated
+    ASSERT_FALSE(cache.Get(segment_id, 1, key, &token));
+    ASSERT_FALSE(cache.Get(WindowCache::NewSegmentId(), 0, key, &token));
+}
+
+TEST_F(WindowCacheTest, MissWithoutFill) {
+    auto table = CreateTable(0, ::openmldb::type::kAbsoluteTime);
+    auto cache = std::make_shared<WindowCache>(1024 * 1024, 2);
+    table->SetWindowCache(cache);
+    uint64_t now = ::baidu::common::timer::get_micros() / 1000;
+    for (int i = 0; i < 3; i++) {
+        table->Put("big", now + i, "value", 5);
+    }
+    // the misses of the keys which are absent or have too many rows leave no slots
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQ(3, ReadWindow(table.get(), "big", nullptr));
+        ASSERT_EQ(-1, ReadWindow(table.get(), "absent" + std::to_string(i), nullptr));
+    }
+    auto stats = cache->GetStats();
+    ASSERT_EQ(0u, stats.fill);
+    ASSERT_EQ(0u, stats.slot_cnt);
+    table->Put("key1", now, "value", 5);
+    ASSERT_EQ(1, ReadWindow(table.get(), "key1", nullptr));
+    ASSERT_EQ(1u, cache->GetStats().slot_cnt);
+    table->Put("key1", now + 1, "value", 5);
+    ASSERT_EQ(0u, cache->GetStats().slot_cnt);
+}
+
+TEST_F(WindowCacheTest, FillAfterShardInvalidate) {
+    WindowCache cache(1024 * 1024, 100, 1);
+    uint64_t segment_id = WindowCache::NewSegmentId();
+    uint64_t token = 0;
+    ASSERT_FALSE(cache.Get(segment_id, 0, base::Slice("key1"), &token));
+    ASSERT_NE(0u, token);
+    // the token is the version of the shard, a put to another key of the shard fails the fill too
+    cache.Invalidate(segment_id, base::Slice("key2"));
+    auto entry = std::make_shared<WindowCacheEntry>();
+    entry->byte_size = 10;
+    ASSERT_FALSE(cache.Fill(segment_id, 0, base::Slice("key1"), token, entry));
+    ASSERT_EQ(0u, cache.GetStats().slot_cnt);
+    ASSERT_FALSE(cache.Get(segment_id, 0, base::Slice("key1"), &token));
+    ASSERT_TRUE(cache.Fill(segment_id, 0, base::Slice("key1"), token, entry));
+    ASSERT_EQ(1u, cache.GetStats().slot_cnt);
+}
+
+TEST_F(WindowCacheTest, Evict) {
+    WindowCache cache(1000, 100, 1);
+    uint64_t segment_id = WindowCache::NewSegmentId();
+    for (int i = 0; i < 20; i++) {
+        std::string key = "key" + std::to_string(i);
+        uint64_t token = 0;
+        cache.Get(segment_id, 0, base::Slice(key), &token);
+        auto entry = std::make_shared<WindowCacheEntry>();
+        entry->byte_size = 100;
+        ASSERT_TRUE(cache.Fill(segment_id, 0, base::Slice(key), token, entry));
+    }
+    auto stats = cache.GetStats();
+    ASSERT_LE(stats.byte_size, 1000u);
+    ASSERT_EQ(10u, stats.evict);
+    uint64_t token = 0;
+    // the oldest keys are evicted and the latest keys are kept
+    ASSERT_FALSE(cache.Get(segment_id, 0, base::Slice("key0"), &token));
+    ASSERT_TRUE(cache.Get(segment_id, 0, base::Slice("key19"), &token));
+    // entry larger than the capacity is rejected
+    auto big = std::make_shared<WindowCacheEntry>();
+    big->byte_size = 2000;
+    cache.Get(segment_id, 0, base::Slice("big"), &token);
+    ASSERT_FALSE(cache.Fill(segment_id, 0, base::Slice("big"), token, big));
+}
+
+}  // namespace storage
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::openmldb::base::SetLogLevel(INFO);
+    return RUN_ALL_TESTS();
+}
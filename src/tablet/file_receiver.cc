@@ -16,6 +16,10 @@
 
 #include "tablet/file_receiver.h"
 
+#include <unistd.h>
+
+#include <cerrno>
+
 #include "base/file_util.h"
 #include "base/glog_wrapper.h"
 #include "base/strings.h"
@@ -50,11 +54,46 @@ bool FileReceiver::Init() {
     }
     file_ = file;
     block_id_ = 0;
+    size_ = 0;
+    received_offsets_.clear();
     return true;
 }
 
 uint64_t FileReceiver::GetBlockId() { return block_id_; }
 
+uint64_t FileReceiver::GetSize() {
+    std::lock_guard<std::mutex> lock(mu_);
+    return size_;
+}
+
+int FileReceiver::WriteBlock(const std::string& data, uint64_t offset) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (file_ == NULL) {
+        PDLOG(WARNING, "file is NULL");
+        return -1;
+    }
+    if (received_offsets_.count(offset) > 0) {
+        DEBUGLOG("block at offset %lu has been received", offset);
+        return 0;
+    }
+    int fd = fileno(file_);
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t r = pwrite(fd, data.data() + written, data.size() - written, offset + written);
+        if (r < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            PDLOG(WARNING, "write error. name %s%s offset %lu", path_.c_str(), file_name_.c_str(), offset);
+            return -1;
+        }
+        written += r;
+    }
+    received_offsets_.insert(offset);
+    size_ += written;
+    return 0;
+}
+
 int FileReceiver::WriteData(const std::string& data, uint64_t block_id) {
     if (file_ == NULL) {
         PDLOG(WARNING, "file is NULL");
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <mutex>  // NOLINT
+#include <set>
 #include <string>
 
 namespace openmldb {
@@ -29,8 +31,11 @@ class FileReceiver {
     FileReceiver& operator=(const FileReceiver&) = delete;
     bool Init();
     int WriteData(const std::string& data, uint64_t block_id);
+    // write the block at offset. blocks of pipelined transfer may arrive out of order or concurrently
+    int WriteBlock(const std::string& data, uint64_t offset);
     void SaveFile();
     uint64_t GetBlockId();
+    uint64_t GetSize();
 
  private:
     std::string file_name_;
@@ -39,6 +44,8 @@ class FileReceiver {
     uint64_t size_;
     uint64_t block_id_;
     FILE* file_;
+    std::mutex mu_;
+    std::set<uint64_t> received_offsets_;
 };
 
 }  // namespace tablet
@@ -16,6 +16,14 @@
 
 #include "tablet/file_sender.h"
 
+#include <fcntl.h>
+#include <snappy.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
 #include <thread>  // NOLINT
 #include <vector>
 
@@ -24,13 +32,15 @@
 #include "boost/algorithm/string/predicate.hpp"
 #include "common/timer.h"
 #include "gflags/gflags.h"
+#include "log/crc32c.h"
 #include "nameserver/system_table.h"
 
 DECLARE_int32(send_file_max_try);
 DECLARE_uint32(stream_block_size);
 DECLARE_int32(stream_bandwidth_limit);
-DECLARE_uint32(stream_block_size);
-DECLARE_int32(stream_bandwidth_limit);
+DECLARE_uint32(stream_max_inflight_blocks);
+DECLARE_uint32(stream_send_file_concurrency);
+DECLARE_string(stream_compression);
 DECLARE_int32(stream_close_wait_time_ms);
 DECLARE_int32(retry_send_file_wait_time_ms);
 DECLARE_int32(request_max_retry);
@@ -39,6 +49,26 @@ DECLARE_int32(request_timeout_ms);
 namespace openmldb {
 namespace tablet {
 
+void BandwidthLimiter::Acquire(uint64_t len) {
+    if (limit_ <= 0 || len == 0) {
+        return;
+    }
+    uint64_t wait_time = 0;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        uint64_t cur_time = ::baidu::common::timer::get_micros();
+        if (next_time_ < cur_time) {
+            next_time_ = cur_time;
+        }
+        wait_time = next_time_ - cur_time;
+        next_time_ += len * 1000000 / limit_;
+    }
+    if (wait_time > 0) {
+        DEBUGLOG("sleep %lu us for bandwidth limit", wait_time);
+        std::this_thread::sleep_for(std::chrono::microseconds(wait_time));
+    }
+}
+
 FileSender::FileSender(uint32_t tid, uint32_t pid, common::StorageMode storage_mode, const std::string& endpoint)
     : tid_(tid),
       pid_(pid),
@@ -46,7 +76,9 @@ FileSender::FileSender(uint32_t tid, uint32_t pid, common::StorageMode storage_m
       endpoint_(endpoint),
       cur_try_time_(0),
       max_try_time_(FLAGS_send_file_max_try),
-      limit_time_(0),
+      limiter_(FLAGS_stream_bandwidth_limit),
+      pipelined_(false),
+      compress_type_(::openmldb::type::kNoCompress),
       channel_(NULL),
       stub_(NULL) {}
 
@@ -56,12 +88,10 @@ FileSender::~FileSender() {
 }
 
 bool FileSender::Init() {
-    // compute the used time(microseconds) that send a block by limit bandwidth.
-    // limit_time = (FLAGS_stream_block_size / FLAGS_stream_bandwidth_limit) *
-    // 1000 * 1000
-    if (FLAGS_stream_bandwidth_limit > 0) {
-        limit_time_ = (FLAGS_stream_block_size * 1000000) / FLAGS_stream_bandwidth_limit;
+    if (FLAGS_stream_compression == "snappy") {
+        compress_type_ = ::openmldb::type::kSnappy;
     }
+    pipelined_ = FLAGS_stream_max_inflight_blocks > 1 || compress_type_ != ::openmldb::type::kNoCompress;
     channel_ = new brpc::Channel();
     brpc::ChannelOptions options;
     options.auth = &client_authenticator_;
@@ -81,7 +111,6 @@ int FileSender::WriteData(const std::string& file_name, const std::string& dir_n
     if (buffer == NULL) {
         return -1;
     }
-    uint64_t cur_time = ::baidu::common::timer::get_micros();
     ::openmldb::api::SendDataRequest request;
     request.set_tid(tid_);
     request.set_pid(pid_);
@@ -95,6 +124,7 @@ int FileSender::WriteData(const std::string& file_name, const std::string& dir_n
     brpc::Controller cntl;
     if (block_id > 0) {
         cntl.request_attachment().append(buffer, len);
+        limiter_.Acquire(len);
     }
     if (len > 0 && len < FLAGS_stream_block_size) {
         request.set_eof(true);
@@ -110,12 +140,6 @@ int FileSender::WriteData(const std::string& file_name, const std::string& dir_n
               response.msg().c_str());
         return -1;
     }
-    uint64_t time_used = ::baidu::common::timer::get_micros() - cur_time;
-    if (limit_time_ > time_used && len > FLAGS_stream_block_size / 2) {
-        uint64_t sleep_time = limit_time_ - time_used;
-        DEBUGLOG("sleep %lu us, limit_time %lu time_used %lu", sleep_time, limit_time_, time_used);
-        std::this_thread::sleep_for(std::chrono::microseconds(sleep_time));
-    }
     return 0;
 }
 
@@ -143,7 +167,11 @@ int FileSender::SendFile(const std::string& file_name, const std::string& dir_na
                   file_size);
         }
         try_times--;
-        if (SendFileInternal(file_name, dir_name, full_path, file_size) < 0) {
+        if (pipelined_) {
+            if (SendFilePipelined(file_name, dir_name, full_path, file_size) < 0) {
+                continue;
+            }
+        } else if (SendFileInternal(file_name, dir_name, full_path, file_size) < 0) {
             continue;
         }
         if (CheckFile(file_name, dir_name, file_size) < 0) {
@@ -208,6 +236,127 @@ int FileSender::SendFileInternal(const std::string& file_name, const std::string
     return ret;
 }
 
+int FileSender::SendFilePipelined(const std::string& file_name, const std::string& dir_name,
+                                  const std::string& full_path, uint64_t file_size) {
+    struct InflightBlock {
+        brpc::Controller cntl;
+        ::openmldb::api::SendDataRequest request;
+        ::openmldb::api::GeneralResponse response;
+    };
+    auto wait_block = [this, &file_name](const std::unique_ptr<InflightBlock>& block) {
+        brpc::Join(block->cntl.call_id());
+        if (block->cntl.Failed()) {
+            PDLOG(WARNING, "send data failed. tid %u pid %u file %s offset %lu error msg %s", tid_, pid_,
+                  file_name.c_str(), block->request.offset(), block->cntl.ErrorText().c_str());
+            return -1;
+        } else if (block->response.code() != 0) {
+            PDLOG(WARNING, "send data failed. tid %u pid %u file %s offset %lu error msg %s", tid_, pid_,
+                  file_name.c_str(), block->request.offset(), block->response.msg().c_str());
+            return -1;
+        }
+        return 0;
+    };
+    int fd = open(full_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        PDLOG(WARNING, "fail to open file %s", full_path.c_str());
+        return -1;
+    }
+    std::string buffer(FLAGS_stream_block_size, '\0');
+    if (WriteData(file_name, dir_name, buffer.data(), 0, 0) < 0) {
+        PDLOG(WARNING, "Init file receiver failed. tid[%u] pid[%u] file %s", tid_, pid_, file_name.c_str());
+        close(fd);
+        return -1;
+    }
+    uint32_t max_inflight = std::max(FLAGS_stream_max_inflight_blocks, 1u);
+    uint64_t block_num = file_size / FLAGS_stream_block_size + 1;
+    uint64_t report_block_num = block_num / 100;
+    uint64_t start_time = ::baidu::common::timer::get_micros();
+    std::deque<std::unique_ptr<InflightBlock>> inflight;
+    std::string compressed;
+    int ret = 0;
+    uint64_t block_count = 0;
+    for (uint64_t offset = 0; offset < file_size; offset += FLAGS_stream_block_size) {
+        size_t len = std::min<uint64_t>(FLAGS_stream_block_size, file_size - offset);
+        ssize_t read_len = pread(fd, &buffer[0], len, offset);
+        if (read_len != static_cast<ssize_t>(len)) {
+            PDLOG(WARNING, "read file %s error. error message: %s", file_name.c_str(), strerror(errno));
+            ret = -1;
+            break;
+        }
+        block_count++;
+        auto block = std::make_unique<InflightBlock>();
+        block->request.set_tid(tid_);
+        block->request.set_pid(pid_);
+        block->request.set_storage_mode(storage_mode_);
+        block->request.set_file_name(file_name);
+        if (!dir_name.empty()) {
+            block->request.set_dir_name(dir_name);
+        }
+        block->request.set_block_id(block_count);
+        block->request.set_offset(offset);
+        // the checksum is computed while the previous blocks are in flight
+        block->request.set_crc(::openmldb::log::Value(buffer.data(), len));
+        if (compress_type_ == ::openmldb::type::kSnappy) {
+            snappy::Compress(buffer.data(), len, &compressed);
+            block->request.set_compress_type(compress_type_);
+            block->request.set_block_size(compressed.size());
+            block->cntl.request_attachment().append(compressed);
+        } else {
+            block->request.set_block_size(len);
+            block->cntl.request_attachment().append(buffer.data(), len);
+        }
+        if (inflight.size() >= max_inflight) {
+            if (wait_block(inflight.front()) < 0) {
+                ret = -1;
+                break;
+            }
+            inflight.pop_front();
+        }
+        limiter_.Acquire(block->cntl.request_attachment().size());
+        stub_->SendData(&block->cntl, &block->request, &block->response, brpc::DoNothing());
+        inflight.push_back(std::move(block));
+        if (report_block_num == 0 || block_count % report_block_num == 0) {
+            PDLOG(INFO, "send block num[%lu] total block num[%lu]. tid[%u] pid[%u] file[%s] endpoint[%s]",
+                  block_count, block_num, tid_, pid_, file_name.c_str(), endpoint_.c_str());
+        }
+    }
+    close(fd);
+    while (!inflight.empty()) {
+        if (wait_block(inflight.front()) < 0) {
+            ret = -1;
+        }
+        inflight.pop_front();
+    }
+    if (ret < 0) {
+        return ret;
+    }
+    ::openmldb::api::SendDataRequest request;
+    request.set_tid(tid_);
+    request.set_pid(pid_);
+    request.set_storage_mode(storage_mode_);
+    request.set_file_name(file_name);
+    if (!dir_name.empty()) {
+        request.set_dir_name(dir_name);
+    }
+    request.set_block_id(block_count + 1);
+    request.set_block_size(0);
+    request.set_offset(file_size);
+    request.set_file_size(file_size);
+    request.set_eof(true);
+    brpc::Controller cntl;
+    ::openmldb::api::GeneralResponse response;
+    stub_->SendData(&cntl, &request, &response, NULL);
+    if (cntl.Failed() || response.code() != 0) {
+        PDLOG(WARNING, "send eof failed. tid %u pid %u file %s error msg %s", tid_, pid_, file_name.c_str(),
+              cntl.Failed() ? cntl.ErrorText().c_str() : response.msg().c_str());
+        return -1;
+    }
+    uint64_t time_used = ::baidu::common::timer::get_micros() - start_time;
+    PDLOG(INFO, "send file %s with %lu blocks in %lu us. tid[%u] pid[%u] endpoint[%s]", file_name.c_str(),
+          block_count, time_used, tid_, pid_, endpoint_.c_str());
+    return 0;
+}
+
 int FileSender::CheckFile(const std::string& file_name, const std::string& dir_name, uint64_t file_size) {
     ::openmldb::api::CheckFileRequest check_request;
     ::openmldb::api::GeneralResponse response;
@@ -237,12 +386,35 @@ int FileSender::CheckFile(const std::string& file_name, const std::string& dir_n
 int FileSender::SendDir(const std::string& dir_name, const std::string& full_path) {
     std::vector<std::string> file_vec;
     ::openmldb::base::GetFileName(full_path, file_vec);
-    for (const std::string& file : file_vec) {
-        if (SendFile(file.substr(file.find_last_of("/") + 1), dir_name, file) < 0) {
-            return -1;
+    uint32_t concurrency = std::min<uint32_t>(FLAGS_stream_send_file_concurrency, file_vec.size());
+    if (concurrency <= 1) {
+        for (const std::string& file : file_vec) {
+            if (SendFile(file.substr(file.find_last_of("/") + 1), dir_name, file) < 0) {
+                return -1;
+            }
         }
+        return 0;
     }
-    return 0;
+    // the stub is thread safe, files are sent by several threads sharing the channel
+    std::atomic<size_t> next_file(0);
+    std::atomic<bool> has_error(false);
+    std::vector<std::thread> threads;
+    threads.reserve(concurrency);
+    for (uint32_t i = 0; i < concurrency; i++) {
+        threads.emplace_back([&] {
+            for (size_t idx = next_file.fetch_add(1); idx < file_vec.size() && !has_error.load();
+                 idx = next_file.fetch_add(1)) {
+                const std::string& file = file_vec[idx];
+                if (SendFile(file.substr(file.find_last_of("/") + 1), dir_name, file) < 0) {
+                    has_error.store(true);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return has_error.load() ? -1 : 0;
 }
 
 }  // namespace tablet
@@ -16,9 +16,11 @@
 
 #pragma once
 
+#include <brpc/callback.h>
 #include <brpc/channel.h>
 #include <brpc/controller.h>
 
+#include <mutex>  // NOLINT
 #include <string>
 
 #include "proto/tablet.pb.h"
@@ -27,6 +29,20 @@
 namespace openmldb {
 namespace tablet {
 
+// paces the bytes sent by all threads sharing it to at most limit bytes per second
+class BandwidthLimiter {
+ public:
+    explicit BandwidthLimiter(int64_t limit) : limit_(limit), next_time_(0) {}
+    // block until len bytes may be sent. no limit if limit is not positive
+    void Acquire(uint64_t len);
+
+ private:
+    int64_t limit_;
+    std::mutex mu_;
+    // the time in micros from which the next bytes may be sent
+    uint64_t next_time_;
+};
+
 class FileSender {
  public:
     FileSender(uint32_t tid, uint32_t pid, common::StorageMode storage_mode, const std::string& endpoint);
@@ -39,6 +55,10 @@ class FileSender {
     int SendDir(const std::string& dir_name, const std::string& full_path);
     int WriteData(const std::string& file_name, const std::string& dir_name, const char* buffer, size_t len,
                   uint64_t block_id);
+    // send blocks with at most FLAGS_stream_max_inflight_blocks requests in flight. every block carries its
+    // offset and checksum, so the receiver can write blocks out of order and verify them on arrival
+    int SendFilePipelined(const std::string& file_name, const std::string& dir_name, const std::string& full_path,
+                          uint64_t file_size);
     int CheckFile(const std::string& file_name, const std::string& dir_name, uint64_t file_size);
 
  private:
@@ -48,7 +68,10 @@ class FileSender {
     std::string endpoint_;
     uint32_t cur_try_time_;
     uint32_t max_try_time_;
-    uint64_t limit_time_;
+    // shared by the threads of SendDir, so the bandwidth limit applies to the whole transfer
+    BandwidthLimiter limiter_;
+    bool pipelined_;
+    ::openmldb::type::CompressType compress_type_;
     brpc::Channel* channel_;
     ::openmldb::api::TabletServer_Stub* stub_;
     openmldb::authn::BRPCAuthenticator client_authenticator_;
@@ -0,0 +1,230 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/file_sender.h"
+
+#include <brpc/server.h>
+#include <gflags/gflags.h>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+#include "base/file_util.h"
+#include "base/glog_wrapper.h"
+#include "common/timer.h"
+#include "gtest/gtest.h"
+#include "tablet/tablet_impl.h"
+#include "test/util.h"
+
+DECLARE_string(db_root_path);
+DECLARE_string(endpoint);
+DECLARE_int32(stream_bandwidth_limit);
+DECLARE_uint32(stream_max_inflight_blocks);
+DECLARE_uint32(stream_send_file_concurrency);
+DECLARE_string(stream_compression);
+
+namespace openmldb {
+namespace tablet {
+
+static const char* kEndpoint = "127.0.0.1:9581";
+
+class FileSenderTest : public ::testing::Test {
+ public:
+    FileSenderTest() {}
+    ~FileSenderTest() {}
+
+    static void SetUpTestCase() {
+        FLAGS_endpoint = kEndpoint;
+        server_ = new brpc::Server();
+        TabletImpl* tablet = new TabletImpl();
+        ASSERT_TRUE(tablet->Init(""));
+        ASSERT_EQ(0, server_->AddService(tablet, brpc::SERVER_OWNS_SERVICE));
+        brpc::ServerOptions option;
+        ASSERT_EQ(0, server_->Start(kEndpoint, &option));
+    }
+
+    static void TearDownTestCase() {
+        server_->Stop(10);
+        server_->Join();
+        delete server_;
+        server_ = nullptr;
+    }
+
+    void SetUp() override {
+        old_limit_ = FLAGS_stream_bandwidth_limit;
+        old_inflight_ = FLAGS_stream_max_inflight_blocks;
+        old_concurrency_ = FLAGS_stream_send_file_concurrency;
+        old_compression_ = FLAGS_stream_compression;
+        FLAGS_stream_bandwidth_limit = 0;
+    }
+
+    void TearDown() override {
+        FLAGS_stream_bandwidth_limit = old_limit_;
+        FLAGS_stream_max_inflight_blocks = old_inflight_;
+        FLAGS_stream_send_file_concurrency = old_concurrency_;
+        FLAGS_stream_compression = old_compression_;
+    }
+
+    // half of the content is random and half is repeated so that compression has something to do
+    static void GenFile(const std::string& path, uint64_t size) {
+        std::mt19937_64 rng(size);
+        std::string buf;
+        buf.reserve(size);
+        while (buf.size() < size) {
+            if ((buf.size() / 4096) % 2 == 0) {
+                uint64_t v = rng();
+                buf.append(reinterpret_cast<const char*>(&v), sizeof(v));
+            } else {
+                buf.append("openmldb");
+            }
+        }
+        buf.resize(size);
+        std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+        ofs.write(buf.data(), buf.size());
+    }
+
+    static std::string ReadFile(const std::string& path) {
+        std::ifstream ifs(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+
+    static std::string SnapshotPath(uint32_t tid, uint32_t pid) {
+        return FLAGS_db_root_path + "/" + std::to_string(tid) + "_" + std::to_string(pid) + "/snapshot/";
+    }
+
+    // send the file and return the throughput in MB/s, or a negative value if the transfer failed
+    static double SendAndCheck(uint32_t tid, uint32_t pid, const std::string& file_name, const std::string& src) {
+        FileSender sender(tid, pid, common::kMemory, kEndpoint);
+        if (!sender.Init()) {
+            return -1;
+        }
+        uint64_t size = 0;
+        base::GetFileSize(src, size);
+        uint64_t start = ::baidu::common::timer::get_micros();
+        if (sender.SendFile(file_name, src) != 0) {
+            return -1;
+        }
+        uint64_t cost = ::baidu::common::timer::get_micros() - start;
+        if (ReadFile(SnapshotPath(tid, pid) + file_name) != ReadFile(src)) {
+            return -1;
+        }
+        return static_cast<double>(size) / (1024 * 1024) / (static_cast<double>(cost + 1) / 1000000);
+    }
+
+ protected:
+    static brpc::Server* server_;
+    int32_t old_limit_ = 0;
+    uint32_t old_inflight_ = 1;
+    uint32_t old_concurrency_ = 1;
+    std::string old_compression_;
+};
+
+brpc::Server* FileSenderTest::server_ = nullptr;
+
+TEST_F(FileSenderTest, SendFile) {
+    ::openmldb::test::TempPath tmp_path;
+    std::string dir = tmp_path.CreateTempPath("file_sender");
+    std::string src = dir + "/data_0.sdb";
+    GenFile(src, 32 * 1024 * 1024 + 123);
+
+    FLAGS_stream_max_inflight_blocks = 1;
+    FLAGS_stream_compression = "off";
+    double legacy = SendAndCheck(1001, 0, "data_0.sdb", src);
+    ASSERT_GT(legacy, 0);
+
+    FLAGS_stream_max_inflight_blocks = 8;
+    double pipelined = SendAndCheck(1001, 1, "data_0.sdb", src);
+    ASSERT_GT(pipelined, 0);
+
+    FLAGS_stream_compression = "snappy";
+    double compressed = SendAndCheck(1001, 2, "data_0.sdb", src);
+    ASSERT_GT(compressed, 0);
+    PDLOG(INFO, "legacy %.2f MB/s, pipelined %.2f MB/s, pipelined+snappy %.2f MB/s", legacy, pipelined, compressed);
+}
+
+TEST_F(FileSenderTest, SendSmallFile) {
+    ::openmldb::test::TempPath tmp_path;
+    std::string dir = tmp_path.CreateTempPath("file_sender");
+    FLAGS_stream_max_inflight_blocks = 4;
+    FLAGS_stream_compression = "snappy";
+    // empty file and a file smaller than one block
+    std::string empty = dir + "/empty.sdb";
+    GenFile(empty, 0);
+    ASSERT_GE(SendAndCheck(1002, 0, "empty.sdb", empty), 0);
+    std::string small = dir + "/small.sdb";
+    GenFile(small, 1000);
+    ASSERT_GT(SendAndCheck(1002, 1, "small.sdb", small), 0);
+}
+
+TEST_F(FileSenderTest, SendDir) {
+    ::openmldb::test::TempPath tmp_path;
+    std::string dir = tmp_path.CreateTempPath("file_sender") + "/20240101_1";
+    ASSERT_TRUE(base::MkdirRecur(dir));
+    for (int i = 0; i < 6; i++) {
+        GenFile(dir + "/" + std::to_string(i) + ".sst", (i + 1) * 1024 * 1024 + i);
+    }
+    FLAGS_stream_max_inflight_blocks = 4;
+    FLAGS_stream_send_file_concurrency = 3;
+    FLAGS_stream_compression = "off";
+    FileSender sender(1003, 0, common::kMemory, kEndpoint);
+    ASSERT_TRUE(sender.Init());
+    ASSERT_EQ(0, sender.SendDir("20240101_1", dir));
+    std::string des_dir = SnapshotPath(1003, 0) + "20240101_1/";
+    for (int i = 0; i < 6; i++) {
+        std::string name = std::to_string(i) + ".sst";
+        ASSERT_EQ(ReadFile(dir + "/" + name), ReadFile(des_dir + name));
+    }
+}
+
+TEST_F(FileSenderTest, SendDirWithBandwidthLimit) {
+    ::openmldb::test::TempPath tmp_path;
+    std::string dir = tmp_path.CreateTempPath("file_sender") + "/20240101_2";
+    ASSERT_TRUE(base::MkdirRecur(dir));
+    // every file fits in one block
+    for (int i = 0; i < 4; i++) {
+        GenFile(dir + "/" + std::to_string(i) + ".sst", 1024 * 1024);
+    }
+    FLAGS_stream_max_inflight_blocks = 4;
+    FLAGS_stream_send_file_concurrency = 4;
+    FLAGS_stream_compression = "off";
+    FLAGS_stream_bandwidth_limit = 2 * 1024 * 1024;
+    FileSender sender(1004, 0, common::kMemory, kEndpoint);
+    ASSERT_TRUE(sender.Init());
+    uint64_t start = ::baidu::common::timer::get_micros();
+    ASSERT_EQ(0, sender.SendDir("20240101_2", dir));
+    uint64_t cost = ::baidu::common::timer::get_micros() - start;
+    // the threads share the limit, so the last of 4MB may be sent after 1.5s
+    ASSERT_GE(cost, 1400000u);
+    std::string des_dir = SnapshotPath(1004, 0) + "20240101_2/";
+    for (int i = 0; i < 4; i++) {
+        std::string name = std::to_string(i) + ".sst";
+        ASSERT_EQ(ReadFile(dir + "/" + name), ReadFile(des_dir + name));
+    }
+}
+
+}  // namespace tablet
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::hybridse::vm::Engine::InitializeGlobalLLVM();
+    ::openmldb::base::SetLogLevel(INFO);
+    ::google::ParseCommandLineFlags(&argc, &argv, true);
+    ::openmldb::test::InitRandomDiskFlags("file_sender_test");
+    return RUN_ALL_TESTS();
+}
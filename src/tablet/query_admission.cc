@@ -0,0 +1,188 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/query_admission.h"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "common/timer.h"
+
+namespace openmldb::tablet {
+
+using ::hybridse::vm::PhysicalOpNode;
+
+// return the estimated output rows of the node
+static uint64_t EstimateRows(
+    const PhysicalOpNode* node,
+    const std::function<uint64_t(const std::shared_ptr<hybridse::vm::TableHandler>&)>& table_rows,
+    std::map<const PhysicalOpNode*, uint64_t>* visited, QueryCost* cost) {
+    if (node == nullptr) {
+        return 0;
+    }
+    auto it = visited->find(node);
+    if (it != visited->end()) {
+        return it->second;
+    }
+    std::vector<uint64_t> input_rows;
+    for (auto* producer : node->GetProducers()) {
+        input_rows.push_back(EstimateRows(producer, table_rows, visited, cost));
+    }
+    uint64_t rows = input_rows.empty() ? 0 : input_rows[0];
+    switch (node->GetOpType()) {
+        case hybridse::vm::kPhysicalOpDataProvider: {
+            auto provider = dynamic_cast<const hybridse::vm::PhysicalDataProviderNode*>(node);
+            if (provider->provider_type_ == hybridse::vm::kProviderTypeRequest) {
+                rows = 1;
+            } else {
+                rows = table_rows(provider->table_handler_);
+                cost->rows_scanned += rows;
+            }
+            break;
+        }
+        case hybridse::vm::kPhysicalOpProject: {
+            auto project = dynamic_cast<const hybridse::vm::PhysicalProjectNode*>(node);
+            if (project->project_type_ == hybridse::vm::kWindowAggregation) {
+                cost->windows_built += rows;
+            }
+            break;
+        }
+        case hybridse::vm::kPhysicalOpRequestUnion:
+        case hybridse::vm::kPhysicalOpRequestAggUnion: {
+            cost->windows_built += rows;
+            break;
+        }
+        case hybridse::vm::kPhysicalOpSetOperation: {
+            for (size_t i = 1; i < input_rows.size(); i++) {
+                rows += input_rows[i];
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    if (node->GetLimitCnt().has_value() && node->GetLimitCnt().value() >= 0) {
+        rows = std::min<uint64_t>(rows, node->GetLimitCnt().value());
+    }
+    visited->emplace(node, rows);
+    return rows;
+}
+
+QueryCost EstimateQueryCost(
+    const PhysicalOpNode* plan,
+    const std::function<uint64_t(const std::shared_ptr<hybridse::vm::TableHandler>&)>& table_rows) {
+    QueryCost cost;
+    std::map<const PhysicalOpNode*, uint64_t> visited;
+    EstimateRows(plan, table_rows, &visited, &cost);
+    return cost;
+}
+
+QueryAdmission::QueryAdmission(const std::string& prefix, uint32_t capacity, uint32_t adhoc_capacity)
+    : capacity_(std::max<uint32_t>(capacity, 1)),
+      adhoc_capacity_(std::min(adhoc_capacity == 0 ? std::max<uint32_t>(capacity_ / 2, 1) : adhoc_capacity,
+                               capacity_)),
+      deployment_wait_(prefix, "deployment_queue_wait"),
+      adhoc_wait_(prefix, "adhoc_queue_wait"),
+      expired_cnt_(prefix, "queue_expired") {}
+
+std::unique_ptr<QueryAdmission::Permit> QueryAdmission::Acquire(QueryClass query_class, uint32_t slots,
+                                                                uint64_t deadline_us) {
+    uint64_t start = ::baidu::common::timer::get_micros();
+    Waiter waiter;
+    waiter.query_class = query_class;
+    waiter.slots = std::clamp<uint32_t>(slots, 1, query_class == QueryClass::kAdhoc ? adhoc_capacity_ : capacity_);
+    auto& queue = queues_[static_cast<uint32_t>(query_class)];
+    std::unique_lock<bthread::Mutex> lock(mu_);
+    queue.push_back(&waiter);
+    Dispatch();
+    while (!waiter.admitted) {
+        if (deadline_us == 0) {
+            waiter.cv.wait(lock);
+            continue;
+        }
+        uint64_t now = ::baidu::common::timer::get_micros();
+        if (now >= deadline_us) {
+            queue.remove(&waiter);
+            // the queries behind it may fit now
+            Dispatch();
+            lock.unlock();
+            expired_cnt_ << 1;
+            return nullptr;
+        }
+        waiter.cv.wait_for(lock, deadline_us - now);
+    }
+    lock.unlock();
+    uint64_t wait_us = ::baidu::common::timer::get_micros() - start;
+    if (query_class == QueryClass::kDeployment) {
+        deployment_wait_ << wait_us;
+    } else {
+        adhoc_wait_ << wait_us;
+    }
+    return std::make_unique<Permit>(this, query_class, waiter.slots);
+}
+
+uint32_t QueryAdmission::AdhocSlots(const QueryCost& cost, uint64_t rows_per_slot) const {
+    uint64_t slots = 1 + (cost.rows_scanned + cost.windows_built) / std::max<uint64_t>(rows_per_slot, 1);
+    return std::min<uint64_t>(slots, adhoc_capacity_);
+}
+
+void QueryAdmission::Release(QueryClass query_class, uint32_t slots) {
+    std::lock_guard<bthread::Mutex> lock(mu_);
+    running_slots_ -= slots;
+    if (query_class == QueryClass::kAdhoc) {
+        running_adhoc_slots_ -= slots;
+    }
+    Dispatch();
+}
+
+bool QueryAdmission::Fit(QueryClass query_class, uint32_t slots) const {
+    if (running_slots_ + slots > capacity_) {
+        return false;
+    }
+    return query_class != QueryClass::kAdhoc || running_adhoc_slots_ + slots <= adhoc_capacity_;
+}
+
+void QueryAdmission::Dispatch() {
+    // the deployments come first
+    for (auto& queue : queues_) {
+        while (!queue.empty() && Fit(queue.front()->query_class, queue.front()->slots)) {
+            Waiter* waiter = queue.front();
+            queue.pop_front();
+            running_slots_ += waiter->slots;
+            if (waiter->query_class == QueryClass::kAdhoc) {
+                running_adhoc_slots_ += waiter->slots;
+            }
+            waiter->admitted = true;
+            waiter->cv.notify_one();
+        }
+        if (!queue.empty()) {
+            break;
+        }
+    }
+}
+
+QueryAdmissionStats QueryAdmission::GetStats() {
+    QueryAdmissionStats stats;
+    std::lock_guard<bthread::Mutex> lock(mu_);
+    stats.running_slots = running_slots_;
+    stats.waiting_deployment = queues_[static_cast<uint32_t>(QueryClass::kDeployment)].size();
+    stats.waiting_adhoc = queues_[static_cast<uint32_t>(QueryClass::kAdhoc)].size();
+    stats.expired = expired_cnt_.get_value();
+    return stats;
+}
+
+}  // namespace openmldb::tablet
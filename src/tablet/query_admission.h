@@ -0,0 +1,115 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_TABLET_QUERY_ADMISSION_H_
+#define SRC_TABLET_QUERY_ADMISSION_H_
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
+#include "bvar/bvar.h"
+#include "vm/physical_op.h"
+
+namespace openmldb::tablet {
+
+enum class QueryClass : uint32_t {
+    kDeployment = 0,  // procedures and request mode queries
+    kAdhoc = 1,       // batch and batch request mode queries
+};
+
+// the estimated work of a query
+struct QueryCost {
+    uint64_t rows_scanned = 0;
+    uint64_t windows_built = 0;
+};
+
+// walk the physical plan of a batch query, table_rows returns the estimated row count of a table
+QueryCost EstimateQueryCost(
+    const hybridse::vm::PhysicalOpNode* plan,
+    const std::function<uint64_t(const std::shared_ptr<hybridse::vm::TableHandler>&)>& table_rows);
+
+struct QueryAdmissionStats {
+    uint64_t running_slots = 0;
+    uint64_t waiting_deployment = 0;
+    uint64_t waiting_adhoc = 0;
+    uint64_t expired = 0;  // the queries whose deadline passed in the queue
+};
+
+// QueryAdmission bounds the work running on the tablet in slots. A deployment takes one slot, and an ad-hoc query
+// takes slots by its cost. The ad-hoc queries take at most adhoc_capacity slots in total, which leaves the rest to
+// the deployments. The waiting queries are admitted in fifo order per class, and no ad-hoc query is admitted while a
+// deployment waits.
+class QueryAdmission {
+ public:
+    // releases the slots of an admitted query on destruction
+    class Permit {
+     public:
+        Permit(QueryAdmission* admission, QueryClass query_class, uint32_t slots)
+            : admission_(admission), query_class_(query_class), slots_(slots) {}
+        ~Permit() { admission_->Release(query_class_, slots_); }
+        Permit(const Permit&) = delete;
+        Permit& operator=(const Permit&) = delete;
+
+     private:
+        QueryAdmission* admission_;
+        QueryClass query_class_;
+        uint32_t slots_;
+    };
+
+    // adhoc_capacity 0 means half of the capacity
+    QueryAdmission(const std::string& prefix, uint32_t capacity, uint32_t adhoc_capacity);
+
+    // wait for the slots until deadline_us, 0 means no deadline. return nullptr if the deadline passed in the queue
+    std::unique_ptr<Permit> Acquire(QueryClass query_class, uint32_t slots, uint64_t deadline_us);
+
+    // the slots an ad-hoc query of the cost takes
+    uint32_t AdhocSlots(const QueryCost& cost, uint64_t rows_per_slot) const;
+
+    QueryAdmissionStats GetStats();
+
+ private:
+    struct Waiter {
+        QueryClass query_class;
+        uint32_t slots;
+        bool admitted = false;
+        bthread::ConditionVariable cv;
+    };
+
+    void Release(QueryClass query_class, uint32_t slots);
+    // admit the heads of the queues while they fit, must hold mu_
+    void Dispatch();
+    bool Fit(QueryClass query_class, uint32_t slots) const;
+
+    const uint32_t capacity_;
+    const uint32_t adhoc_capacity_;
+    bthread::Mutex mu_;
+    uint32_t running_slots_ = 0;
+    uint32_t running_adhoc_slots_ = 0;
+    std::list<Waiter*> queues_[2];
+
+    // the time waited in the queue, in microseconds
+    bvar::LatencyRecorder deployment_wait_;
+    bvar::LatencyRecorder adhoc_wait_;
+    bvar::Adder<uint64_t> expired_cnt_;
+};
+
+}  // namespace openmldb::tablet
+#endif  // SRC_TABLET_QUERY_ADMISSION_H_
@@ -0,0 +1,145 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/query_admission.h"
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/timer.h"
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace tablet {
+
+class QueryAdmissionTest : public ::testing::Test {
+ public:
+    QueryAdmissionTest() {}
+    ~QueryAdmissionTest() {}
+
+    // wait until the admission has cnt waiting queries in total
+    static void WaitQueued(QueryAdmission* admission, uint64_t cnt) {
+        while (true) {
+            auto stats = admission->GetStats();
+            if (stats.waiting_deployment + stats.waiting_adhoc >= cnt) {
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+};
+
+TEST_F(QueryAdmissionTest, AdhocCapacity) {
+    QueryAdmission admission("query_admission_test_capacity", 4, 2);
+    auto adhoc = admission.Acquire(QueryClass::kAdhoc, 2, 0);
+    ASSERT_TRUE(adhoc);
+    // the ad-hoc slots are used up, the deployments can still run
+    uint64_t deadline = ::baidu::common::timer::get_micros() + 20 * 1000;
+    ASSERT_FALSE(admission.Acquire(QueryClass::kAdhoc, 1, deadline));
+    auto deployment1 = admission.Acquire(QueryClass::kDeployment, 1, 0);
+    auto deployment2 = admission.Acquire(QueryClass::kDeployment, 1, 0);
+    ASSERT_TRUE(deployment1 && deployment2);
+    ASSERT_EQ(4u, admission.GetStats().running_slots);
+    ASSERT_EQ(1u, admission.GetStats().expired);
+    adhoc.reset();
+    deployment1.reset();
+    deployment2.reset();
+    ASSERT_EQ(0u, admission.GetStats().running_slots);
+    // a query never takes more slots than its class has
+    ASSERT_TRUE(admission.Acquire(QueryClass::kAdhoc, 100, 0));
+}
+
+TEST_F(QueryAdmissionTest, DeploymentFirst) {
+    QueryAdmission admission("query_admission_test_priority", 1, 1);
+    auto running = admission.Acquire(QueryClass::kAdhoc, 1, 0);
+    std::vector<int> order;
+    std::mutex mu;
+    std::thread adhoc([&] {
+        auto permit = admission.Acquire(QueryClass::kAdhoc, 1, 0);
+        std::lock_guard<std::mutex> lock(mu);
+        order.push_back(1);
+    });
+    WaitQueued(&admission, 1);
+    std::thread deployment([&] {
+        auto permit = admission.Acquire(QueryClass::kDeployment, 1, 0);
+        std::lock_guard<std::mutex> lock(mu);
+        order.push_back(2);
+    });
+    WaitQueued(&admission, 2);
+    running.reset();
+    adhoc.join();
+    deployment.join();
+    // the deployment queued later is admitted first
+    ASSERT_EQ(std::vector<int>({2, 1}), order);
+}
+
+TEST_F(QueryAdmissionTest, Deadline) {
+    QueryAdmission admission("query_admission_test_deadline", 2, 2);
+    // a big ad-hoc query at the head expires, the small one behind it runs
+    auto running = admission.Acquire(QueryClass::kAdhoc, 1, 0);
+    std::atomic<bool> big_admitted(true);
+    std::thread big([&] {
+        uint64_t deadline = ::baidu::common::timer::get_micros() + 50 * 1000;
+        big_admitted = admission.Acquire(QueryClass::kAdhoc, 2, deadline) != nullptr;
+    });
+    WaitQueued(&admission, 1);
+    std::atomic<bool> small_admitted(false);
+    std::thread small([&] { small_admitted = admission.Acquire(QueryClass::kAdhoc, 1, 0) != nullptr; });
+    big.join();
+    small.join();
+    ASSERT_FALSE(big_admitted);
+    ASSERT_TRUE(small_admitted);
+    ASSERT_EQ(1u, admission.GetStats().expired);
+}
+
+TEST_F(QueryAdmissionTest, AdhocSlots) {
+    QueryAdmission admission("query_admission_test_slots", 16, 8);
+    QueryCost cost;
+    ASSERT_EQ(1u, admission.AdhocSlots(cost, 1000));
+    cost.rows_scanned = 2500;
+    cost.windows_built = 1000;
+    ASSERT_EQ(4u, admission.AdhocSlots(cost, 1000));
+    cost.rows_scanned = 100000;
+    ASSERT_EQ(8u, admission.AdhocSlots(cost, 1000));
+}
+
+TEST_F(QueryAdmissionTest, EstimateQueryCost) {
+    auto table_rows = [](const std::shared_ptr<hybridse::vm::TableHandler>&) -> uint64_t { return 1000; };
+    hybridse::vm::PhysicalTableProviderNode table(nullptr);
+    hybridse::vm::ColumnProjects projects;
+    hybridse::vm::PhysicalProjectNode window(&table, hybridse::vm::kWindowAggregation, projects, true);
+    auto cost = EstimateQueryCost(&window, table_rows);
+    ASSERT_EQ(1000u, cost.rows_scanned);
+    ASSERT_EQ(1000u, cost.windows_built);
+
+    // the limit bounds the rows of the nodes above it
+    hybridse::vm::PhysicalLimitNode limit(&table, 10);
+    hybridse::vm::PhysicalProjectNode window_on_limit(&limit, hybridse::vm::kWindowAggregation, projects, true);
+    cost = EstimateQueryCost(&window_on_limit, table_rows);
+    ASSERT_EQ(1000u, cost.rows_scanned);
+    ASSERT_EQ(10u, cost.windows_built);
+}
+
+}  // namespace tablet
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
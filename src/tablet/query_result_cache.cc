@@ -0,0 +1,139 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/query_result_cache.h"
+
+#include <utility>
+
+#include "common/timer.h"
+
+namespace openmldb::tablet {
+
+QueryResultCache::QueryResultCache(uint32_t max_results, uint64_t max_byte_size, uint64_t idle_timeout_ms)
+    : max_results_(max_results),
+      max_byte_size_(max_byte_size),
+      idle_timeout_us_(idle_timeout_ms * 1000),
+      rand_(std::random_device{}()) {}
+
+size_t QueryResultCache::AppendPage(std::vector<::hybridse::codec::Row>* rows, size_t pos, uint32_t page_byte_size,
+                                    butil::IOBuf* buf, uint32_t* count, uint32_t* byte_size) {
+    *count = 0;
+    *byte_size = 0;
+    while (pos < rows->size()) {
+        auto& row = (*rows)[pos];
+        uint32_t row_size = row.size();
+        if (*count > 0 && *byte_size + row_size > page_byte_size) {
+            break;
+        }
+        buf->append(reinterpret_cast<void*>(row.buf()), row_size);
+        *byte_size += row_size;
+        (*count)++;
+        // the row is copied into buf, release its buffer
+        row = ::hybridse::codec::Row();
+        pos++;
+    }
+    return pos;
+}
+
+uint64_t QueryResultCache::Put(const std::string& owner, const std::string& schema,
+                               std::vector<::hybridse::codec::Row>&& rows, size_t pos) {
+    auto result = std::make_shared<PendingResult>();
+    result->owner = owner;
+    result->schema = schema;
+    result->rows = std::move(rows);
+    result->pos = pos;
+    for (size_t i = pos; i < result->rows.size(); i++) {
+        result->byte_size += result->rows[i].size();
+    }
+    uint64_t now = ::baidu::common::timer::get_micros();
+    result->last_access_us = now;
+    std::lock_guard<std::mutex> lock(mu_);
+    DropExpired(now);
+    if (results_.size() >= max_results_) {
+        return 0;
+    }
+    if (max_byte_size_ > 0 && byte_size_ + result->byte_size > max_byte_size_) {
+        return 0;
+    }
+    byte_size_ += result->byte_size;
+    uint64_t id = 0;
+    do {
+        id = rand_();
+    } while (id == 0 || results_.count(id) > 0);
+    results_.emplace(id, std::move(result));
+    return id;
+}
+
+bool QueryResultCache::NextPage(uint64_t id, const std::string& owner, uint32_t page_byte_size, butil::IOBuf* buf,
+                                std::string* schema, uint32_t* count, uint32_t* byte_size, bool* finished) {
+    std::shared_ptr<PendingResult> result;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        DropExpired(::baidu::common::timer::get_micros());
+        auto it = results_.find(id);
+        if (it == results_.end() || it->second->owner != owner) {
+            return false;
+        }
+        // take the result out while copying its rows, so the other results are not blocked
+        result = std::move(it->second);
+        results_.erase(it);
+    }
+    result->pos = AppendPage(&result->rows, result->pos, page_byte_size, buf, count, byte_size);
+    *schema = result->schema;
+    *finished = result->pos >= result->rows.size();
+    result->byte_size -= *byte_size;
+    result->last_access_us = ::baidu::common::timer::get_micros();
+    std::lock_guard<std::mutex> lock(mu_);
+    byte_size_ -= *byte_size;
+    if (!*finished) {
+        results_.emplace(id, std::move(result));
+    }
+    return true;
+}
+
+bool QueryResultCache::Release(uint64_t id, const std::string& owner) {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = results_.find(id);
+    if (it == results_.end() || it->second->owner != owner) {
+        return false;
+    }
+    byte_size_ -= it->second->byte_size;
+    results_.erase(it);
+    return true;
+}
+
+size_t QueryResultCache::GetResultCnt() {
+    std::lock_guard<std::mutex> lock(mu_);
+    return results_.size();
+}
+
+uint64_t QueryResultCache::GetByteSize() {
+    std::lock_guard<std::mutex> lock(mu_);
+    return byte_size_;
+}
+
+void QueryResultCache::DropExpired(uint64_t now) {
+    for (auto it = results_.begin(); it != results_.end();) {
+        if (it->second->last_access_us + idle_timeout_us_ < now) {
+            byte_size_ -= it->second->byte_size;
+            it = results_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+}  // namespace openmldb::tablet
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_TABLET_QUERY_RESULT_CACHE_H_
+#define SRC_TABLET_QUERY_RESULT_CACHE_H_
+
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <random>
+#include <string>
+#include <vector>
+
+#include "butil/iobuf.h"
+#include "codec/row.h"
+
+namespace openmldb::tablet {
+
+// QueryResultCache keeps the rows of the batch query results which are sent in pages. The client fetches the next
+// page with the id of the result, and a result is dropped when its last page is sent or it is not fetched for
+// idle_timeout_ms. The ids are random so they can not be guessed, and a result is only sent to the requests of
+// its owner, e.g. the db of the query. The bytes of the rows not sent yet are bounded by max_byte_size, 0 means
+// unlimited.
+class QueryResultCache {
+ public:
+    QueryResultCache(uint32_t max_results, uint64_t max_byte_size, uint64_t idle_timeout_ms);
+
+    // append the rows from pos to buf until page_byte_size is reached, at least one row is appended.
+    // the appended rows are released. return the position of the first row not appended
+    static size_t AppendPage(std::vector<::hybridse::codec::Row>* rows, size_t pos, uint32_t page_byte_size,
+                             butil::IOBuf* buf, uint32_t* count, uint32_t* byte_size);
+
+    // keep the rows from pos, return the id of the result or 0 if too many results or bytes are kept
+    uint64_t Put(const std::string& owner, const std::string& schema, std::vector<::hybridse::codec::Row>&& rows,
+                 size_t pos);
+
+    // append the next page of the result to buf, set finished if it is the last page.
+    // return false if the result is not found, e.g. it expired or it belongs to another owner
+    bool NextPage(uint64_t id, const std::string& owner, uint32_t page_byte_size, butil::IOBuf* buf,
+                  std::string* schema, uint32_t* count, uint32_t* byte_size, bool* finished);
+
+    // drop the result before its last page is sent, e.g. the client stops reading it.
+    // return false if the result is not found
+    bool Release(uint64_t id, const std::string& owner);
+
+    size_t GetResultCnt();
+
+    // the bytes of the rows not sent yet
+    uint64_t GetByteSize();
+
+ private:
+    struct PendingResult {
+        std::string owner;
+        std::string schema;
+        std::vector<::hybridse::codec::Row> rows;
+        size_t pos = 0;
+        // the bytes of the rows from pos
+        uint64_t byte_size = 0;
+        uint64_t last_access_us = 0;
+    };
+
+    // must hold mu_
+    void DropExpired(uint64_t now);
+
+    const uint32_t max_results_;
+    const uint64_t max_byte_size_;
+    const uint64_t idle_timeout_us_;
+    std::mutex mu_;
+    // the sum of byte_size of the results, including the ones taken out by NextPage
+    uint64_t byte_size_ = 0;
+    std::mt19937_64 rand_;
+    std::map<uint64_t, std::shared_ptr<PendingResult>> results_;
+};
+
+}  // namespace openmldb::tablet
+#endif  // SRC_TABLET_QUERY_RESULT_CACHE_H_
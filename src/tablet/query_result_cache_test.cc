@@ -0,0 +1,197 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/query_result_cache.h"
+
+#include <chrono>  // NOLINT
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace tablet {
+
+class QueryResultCacheTest : public ::testing::Test {
+ public:
+    QueryResultCacheTest() {}
+    ~QueryResultCacheTest() {}
+
+    // cnt rows of 10 bytes each, the rows own their buffers
+    static std::vector<::hybridse::codec::Row> MakeRows(uint32_t cnt) {
+        std::vector<::hybridse::codec::Row> rows;
+        for (uint32_t i = 0; i < cnt; i++) {
+            int8_t* buf = reinterpret_cast<int8_t*>(malloc(10));
+            memset(buf, 'a' + i % 26, 10);
+            rows.emplace_back(::hybridse::base::RefCountedSlice::CreateManaged(buf, 10));
+        }
+        return rows;
+    }
+};
+
+TEST_F(QueryResultCacheTest, AppendPage) {
+    auto rows = MakeRows(5);
+    butil::IOBuf buf;
+    uint32_t count = 0;
+    uint32_t byte_size = 0;
+    size_t pos = QueryResultCache::AppendPage(&rows, 0, 25, &buf, &count, &byte_size);
+    ASSERT_EQ(2u, pos);
+    ASSERT_EQ(2u, count);
+    ASSERT_EQ(20u, byte_size);
+    ASSERT_EQ(20u, buf.size());
+    ASSERT_EQ(std::string(10, 'a') + std::string(10, 'b'), buf.to_string());
+    // the sent rows are released
+    ASSERT_EQ(0, rows[0].size());
+    ASSERT_EQ(10, rows[2].size());
+    // a row larger than the page is still sent
+    buf.clear();
+    pos = QueryResultCache::AppendPage(&rows, pos, 5, &buf, &count, &byte_size);
+    ASSERT_EQ(3u, pos);
+    ASSERT_EQ(1u, count);
+    ASSERT_EQ(10u, byte_size);
+}
+
+TEST_F(QueryResultCacheTest, NextPage) {
+    QueryResultCache cache(4, 0, 60000);
+    uint64_t id = cache.Put("db", "schema", MakeRows(5), 1);
+    ASSERT_NE(0u, id);
+    ASSERT_EQ(1u, cache.GetResultCnt());
+    std::string schema;
+    uint32_t count = 0;
+    uint32_t byte_size = 0;
+    bool finished = false;
+    butil::IOBuf buf;
+    ASSERT_EQ(40u, cache.GetByteSize());
+    ASSERT_TRUE(cache.NextPage(id, "db", 20, &buf, &schema, &count, &byte_size, &finished));
+    ASSERT_EQ(20u, cache.GetByteSize());
+    ASSERT_EQ("schema", schema);
+    ASSERT_EQ(2u, count);
+    ASSERT_FALSE(finished);
+    ASSERT_EQ(std::string(10, 'b') + std::string(10, 'c'), buf.to_string());
+    buf.clear();
+    ASSERT_TRUE(cache.NextPage(id, "db", 20, &buf, &schema, &count, &byte_size, &finished));
+    ASSERT_EQ(2u, count);
+    ASSERT_TRUE(finished);
+    // the result is dropped after the last page
+    ASSERT_EQ(0u, cache.GetResultCnt());
+    ASSERT_EQ(0u, cache.GetByteSize());
+    ASSERT_FALSE(cache.NextPage(id, "db", 20, &buf, &schema, &count, &byte_size, &finished));
+}
+
+TEST_F(QueryResultCacheTest, Full) {
+    QueryResultCache cache(2, 0, 60000);
+    ASSERT_NE(0u, cache.Put("db", "schema", MakeRows(2), 0));
+    uint64_t id = cache.Put("db", "schema", MakeRows(2), 0);
+    ASSERT_NE(0u, id);
+    ASSERT_EQ(0u, cache.Put("db", "schema", MakeRows(2), 0));
+    std::string schema;
+    uint32_t count = 0;
+    uint32_t byte_size = 0;
+    bool finished = false;
+    butil::IOBuf buf;
+    ASSERT_TRUE(cache.NextPage(id, "db", 100, &buf, &schema, &count, &byte_size, &finished));
+    ASSERT_TRUE(finished);
+    ASSERT_NE(0u, cache.Put("db", "schema", MakeRows(2), 0));
+}
+
+TEST_F(QueryResultCacheTest, ByteLimit) {
+    QueryResultCache cache(4, 50, 60000);
+    uint64_t id = cache.Put("db", "schema", MakeRows(4), 0);
+    ASSERT_NE(0u, id);
+    // 40 bytes are pending, 20 more exceed the limit
+    ASSERT_EQ(0u, cache.Put("db", "schema", MakeRows(2), 0));
+    ASSERT_NE(0u, cache.Put("db", "schema", MakeRows(2), 1));
+    ASSERT_EQ(50u, cache.GetByteSize());
+    std::string schema;
+    uint32_t count = 0;
+    uint32_t byte_size = 0;
+    bool finished = false;
+    butil::IOBuf buf;
+    // the sent rows free the budget
+    ASSERT_TRUE(cache.NextPage(id, "db", 20, &buf, &schema, &count, &byte_size, &finished));
+    ASSERT_EQ(30u, cache.GetByteSize());
+    ASSERT_NE(0u, cache.Put("db", "schema", MakeRows(2), 0));
+    ASSERT_EQ(50u, cache.GetByteSize());
+}
+
+TEST_F(QueryResultCacheTest, Release) {
+    QueryResultCache cache(4, 0, 60000);
+    uint64_t id = cache.Put("db", "schema", MakeRows(4), 0);
+    ASSERT_NE(0u, id);
+    ASSERT_EQ(40u, cache.GetByteSize());
+    // only the owner releases the result
+    ASSERT_FALSE(cache.Release(id, "db2"));
+    ASSERT_EQ(1u, cache.GetResultCnt());
+    ASSERT_TRUE(cache.Release(id, "db"));
+    ASSERT_EQ(0u, cache.GetResultCnt());
+    ASSERT_EQ(0u, cache.GetByteSize());
+    ASSERT_FALSE(cache.Release(id, "db"));
+    std::string schema;
+    uint32_t count = 0;
+    uint32_t byte_size = 0;
+    bool finished = false;
+    butil::IOBuf buf;
+    ASSERT_FALSE(cache.NextPage(id, "db", 100, &buf, &schema, &count, &byte_size, &finished));
+}
+
+TEST_F(QueryResultCacheTest, Owner) {
+    QueryResultCache cache(4, 0, 60000);
+    uint64_t id = cache.Put("db1", "schema", MakeRows(4), 0);
+    ASSERT_NE(0u, id);
+    // the ids are not sequential
+    uint64_t id2 = cache.Put("db1", "schema", MakeRows(4), 0);
+    ASSERT_NE(0u, id2);
+    ASSERT_NE(id, id2);
+    ASSERT_NE(id + 1, id2);
+    std::string schema;
+    uint32_t count = 0;
+    uint32_t byte_size = 0;
+    bool finished = false;
+    butil::IOBuf buf;
+    // the result of another db is not sent and kept for its owner
+    ASSERT_FALSE(cache.NextPage(id, "db2", 10, &buf, &schema, &count, &byte_size, &finished));
+    ASSERT_EQ(0u, buf.size());
+    ASSERT_EQ(2u, cache.GetResultCnt());
+    ASSERT_TRUE(cache.NextPage(id, "db1", 10, &buf, &schema, &count, &byte_size, &finished));
+    ASSERT_EQ(1u, count);
+    ASSERT_FALSE(finished);
+}
+
+TEST_F(QueryResultCacheTest, Expire) {
+    QueryResultCache cache(2, 0, 10);
+    uint64_t id = cache.Put("db", "schema", MakeRows(2), 0);
+    ASSERT_NE(0u, id);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::string schema;
+    uint32_t count = 0;
+    uint32_t byte_size = 0;
+    bool finished = false;
+    butil::IOBuf buf;
+    ASSERT_FALSE(cache.NextPage(id, "db", 100, &buf, &schema, &count, &byte_size, &finished));
+    ASSERT_EQ(0u, cache.GetResultCnt());
+    ASSERT_EQ(0u, cache.GetByteSize());
+}
+
+}  // namespace tablet
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
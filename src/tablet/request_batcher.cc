@@ -0,0 +1,116 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/request_batcher.h"
+
+#include <mutex>  // NOLINT
+
+#include "common/timer.h"
+
+namespace openmldb::tablet {
+
+RequestBatcher::RequestBatcher(const std::string& prefix)
+    : batch_cnt_(prefix, "batches"),
+      row_cnt_(prefix, "rows"),
+      failed_cnt_(prefix, "failed_batches"),
+      timeout_cnt_(prefix, "wait_timeouts"),
+      batch_size_(prefix, "batch_size") {}
+
+bool RequestBatcher::Run(const std::string& key, const hybridse::codec::Row& row, uint64_t window_us,
+                         uint32_t max_batch_size, uint64_t wait_us, const BatchRunner& run,
+                         hybridse::codec::Row* output) {
+    std::unique_lock<bthread::Mutex> lock(mu_);
+    auto it = batches_.find(key);
+    if (it != batches_.end()) {
+        // join the open batch and wait for its leader to run it
+        auto batch = it->second;
+        size_t idx = batch->rows.size();
+        batch->rows.push_back(row);
+        if (batch->rows.size() >= max_batch_size) {
+            batch->full = true;
+            batches_.erase(it);
+            batch->cv.notify_all();
+        }
+        // the leader may be stuck, e.g. in a slow remote read. the batch is shared, so the leader can still fill the
+        // output of the row after the wait times out
+        uint64_t deadline = wait_us > 0 ? ::baidu::common::timer::get_micros() + wait_us : 0;
+        while (!batch->done) {
+            if (deadline == 0) {
+                batch->cv.wait(lock);
+                continue;
+            }
+            uint64_t now = ::baidu::common::timer::get_micros();
+            if (now >= deadline) {
+                timeout_cnt_ << 1;
+                return false;
+            }
+            batch->cv.wait_for(lock, deadline - now);
+        }
+        if (batch->ok) {
+            *output = batch->outputs[idx];
+        }
+        return batch->ok;
+    }
+    auto batch = std::make_shared<Batch>();
+    batch->rows.push_back(row);
+    batch->full = max_batch_size <= 1;
+    if (!batch->full) {
+        batches_.emplace(key, batch);
+        uint64_t deadline = ::baidu::common::timer::get_micros() + window_us;
+        while (!batch->full) {
+            uint64_t now = ::baidu::common::timer::get_micros();
+            if (now >= deadline) {
+                break;
+            }
+            batch->cv.wait_for(lock, deadline - now);
+        }
+        if (!batch->full) {
+            batches_.erase(key);
+        }
+    }
+    // no row joins the batch any more
+    lock.unlock();
+    bool ok = run(batch->rows, &batch->outputs) && batch->outputs.size() == batch->rows.size();
+    batch_cnt_ << 1;
+    row_cnt_ << batch->rows.size();
+    batch_size_ << batch->rows.size();
+    if (!ok) {
+        failed_cnt_ << 1;
+    }
+    lock.lock();
+    batch->ok = ok;
+    batch->done = true;
+    batch->cv.notify_all();
+    if (ok) {
+        *output = batch->outputs[0];
+    }
+    return ok;
+}
+
+RequestBatcherStats RequestBatcher::GetStats() {
+    RequestBatcherStats stats;
+    {
+        std::lock_guard<bthread::Mutex> lock(mu_);
+        stats.open = batches_.size();
+    }
+    stats.batches = batch_cnt_.get_value();
+    stats.rows = row_cnt_.get_value();
+    stats.failed = failed_cnt_.get_value();
+    stats.timeouts = timeout_cnt_.get_value();
+    return stats;
+}
+
+}  // namespace openmldb::tablet
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_TABLET_REQUEST_BATCHER_H_
+#define SRC_TABLET_REQUEST_BATCHER_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
+#include "bvar/bvar.h"
+#include "codec/row.h"
+
+namespace openmldb::tablet {
+
+struct RequestBatcherStats {
+    uint64_t open = 0;     // the batches collecting rows
+    uint64_t batches = 0;  // the batches run
+    uint64_t rows = 0;     // the rows run in batches
+    uint64_t failed = 0;   // the batches failed
+    uint64_t timeouts = 0;  // the requests that gave up waiting for their batch
+};
+
+// RequestBatcher collects the single row requests of the same key arriving in a short window and runs them in one
+// batch. The first request of a key opens a batch and runs it when the window passes or the batch is full, the
+// requests arriving in the meantime join the batch and wait for their output rows.
+class RequestBatcher {
+ public:
+    // run the rows in one batch and fill one output row per input row, return false if the batch fails
+    using BatchRunner =
+        std::function<bool(const std::vector<hybridse::codec::Row>&, std::vector<hybridse::codec::Row>*)>;
+
+    explicit RequestBatcher(const std::string& prefix);
+
+    // run row in the batch of key, the batch collects rows for at most window_us and max_batch_size rows.
+    // a request joining the batch of another one waits for it at most wait_us, 0 means no limit.
+    // return false if the batch fails or the wait times out
+    bool Run(const std::string& key, const hybridse::codec::Row& row, uint64_t window_us, uint32_t max_batch_size,
+             uint64_t wait_us, const BatchRunner& run, hybridse::codec::Row* output);
+
+    RequestBatcherStats GetStats();
+
+ private:
+    struct Batch {
+        std::vector<hybridse::codec::Row> rows;
+        std::vector<hybridse::codec::Row> outputs;
+        bool full = false;
+        bool done = false;
+        bool ok = false;
+        bthread::ConditionVariable cv;
+    };
+
+    bthread::Mutex mu_;
+    // the open batches, a batch is removed when it starts running
+    std::unordered_map<std::string, std::shared_ptr<Batch>> batches_;
+
+    bvar::Adder<uint64_t> batch_cnt_;
+    bvar::Adder<uint64_t> row_cnt_;
+    bvar::Adder<uint64_t> failed_cnt_;
+    bvar::Adder<uint64_t> timeout_cnt_;
+    bvar::IntRecorder batch_size_;
+};
+
+}  // namespace openmldb::tablet
+#endif  // SRC_TABLET_REQUEST_BATCHER_H_
@@ -0,0 +1,166 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/request_batcher.h"
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace tablet {
+
+class RequestBatcherTest : public ::testing::Test {
+ public:
+    RequestBatcherTest() {}
+    ~RequestBatcherTest() {}
+};
+
+// a row owning a copy of str
+static hybridse::codec::Row MakeRow(const std::string& str) {
+    int8_t* buf = reinterpret_cast<int8_t*>(malloc(str.size()));
+    memcpy(buf, str.data(), str.size());
+    return hybridse::codec::Row(hybridse::base::RefCountedSlice::CreateManaged(buf, str.size()));
+}
+
+// the output of a row is the row itself with a suffix
+static bool Echo(const std::vector<hybridse::codec::Row>& rows, std::vector<hybridse::codec::Row>* outputs) {
+    for (const auto& row : rows) {
+        outputs->push_back(MakeRow(row.ToString() + "_out"));
+    }
+    return true;
+}
+
+TEST_F(RequestBatcherTest, FullBatch) {
+    RequestBatcher batcher("request_batcher_test_full");
+    std::atomic<int> run_cnt = 0;
+    auto run = [&](const std::vector<hybridse::codec::Row>& rows, std::vector<hybridse::codec::Row>* outputs) {
+        run_cnt++;
+        return Echo(rows, outputs);
+    };
+    // the window never passes, the batch runs when it is full
+    std::vector<std::string> outputs(4);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&, i] {
+            hybridse::codec::Row output;
+            ASSERT_TRUE(
+                batcher.Run("key", MakeRow("row" + std::to_string(i)), 3600 * 1000 * 1000ul, 4, 0, run, &output));
+            outputs[i] = output.ToString();
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    ASSERT_EQ(1, run_cnt);
+    for (int i = 0; i < 4; i++) {
+        ASSERT_EQ("row" + std::to_string(i) + "_out", outputs[i]);
+    }
+    auto stats = batcher.GetStats();
+    ASSERT_EQ(0u, stats.open);
+    ASSERT_EQ(1u, stats.batches);
+    ASSERT_EQ(4u, stats.rows);
+}
+
+TEST_F(RequestBatcherTest, Window) {
+    RequestBatcher batcher("request_batcher_test_window");
+    // a single request runs when the window passes
+    hybridse::codec::Row output;
+    ASSERT_TRUE(batcher.Run("key", MakeRow("row"), 1000, 64, 0, Echo, &output));
+    ASSERT_EQ("row_out", output.ToString());
+    // the keys are batched apart
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&, i] {
+            hybridse::codec::Row out;
+            std::string row = "row" + std::to_string(i);
+            ASSERT_TRUE(batcher.Run("key" + std::to_string(i % 2), MakeRow(row), 10 * 1000, 64, 0, Echo, &out));
+            ASSERT_EQ(row + "_out", out.ToString());
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    auto stats = batcher.GetStats();
+    ASSERT_EQ(0u, stats.open);
+    ASSERT_EQ(5u, stats.rows);
+    ASSERT_LE(3u, stats.batches);
+}
+
+TEST_F(RequestBatcherTest, Failure) {
+    RequestBatcher batcher("request_batcher_test_failure");
+    auto fail = [](const std::vector<hybridse::codec::Row>& rows, std::vector<hybridse::codec::Row>* outputs) {
+        return false;
+    };
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 2; i++) {
+        threads.emplace_back([&] {
+            hybridse::codec::Row output;
+            ASSERT_FALSE(batcher.Run("key", MakeRow("row"), 3600 * 1000 * 1000ul, 2, 0, fail, &output));
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    // a batch missing outputs fails too
+    auto missing = [](const std::vector<hybridse::codec::Row>& rows, std::vector<hybridse::codec::Row>* outputs) {
+        return true;
+    };
+    hybridse::codec::Row output;
+    ASSERT_FALSE(batcher.Run("key", MakeRow("row"), 0, 64, 0, missing, &output));
+    ASSERT_EQ(2u, batcher.GetStats().failed);
+}
+
+TEST_F(RequestBatcherTest, WaitTimeout) {
+    RequestBatcher batcher("request_batcher_test_wait_timeout");
+    std::atomic<bool> release = false;
+    auto stuck = [&](const std::vector<hybridse::codec::Row>& rows, std::vector<hybridse::codec::Row>* outputs) {
+        while (!release) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return Echo(rows, outputs);
+    };
+    // the leader is stuck in its batch, the follower gives up after the wait
+    std::thread leader([&] {
+        hybridse::codec::Row output;
+        ASSERT_TRUE(batcher.Run("key", MakeRow("row0"), 3600 * 1000 * 1000ul, 2, 0, stuck, &output));
+        ASSERT_EQ("row0_out", output.ToString());
+    });
+    while (batcher.GetStats().open == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    hybridse::codec::Row output;
+    ASSERT_FALSE(batcher.Run("key", MakeRow("row1"), 3600 * 1000 * 1000ul, 2, 10 * 1000, stuck, &output));
+    ASSERT_EQ(1u, batcher.GetStats().timeouts);
+    release = true;
+    leader.join();
+    auto stats = batcher.GetStats();
+    ASSERT_EQ(1u, stats.batches);
+    ASSERT_EQ(2u, stats.rows);
+}
+
+}  // namespace tablet
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/request_coalescer.h"
+
+#include <mutex>  // NOLINT
+
+#include "base/status.h"
+#include "common/timer.h"
+
+namespace openmldb::tablet {
+
+RequestCoalescer::RequestCoalescer(const std::string& prefix)
+    : executed_cnt_(prefix, "executed"),
+      coalesced_cnt_(prefix, "coalesced"),
+      timeout_cnt_(prefix, "wait_timeout"),
+      coalesced_wait_(prefix, "coalesced_wait") {}
+
+void RequestCoalescer::Execute(const std::string& key, uint64_t wait_us, const Executor& execute,
+                               ::openmldb::api::QueryResponse* response, butil::IOBuf* buf) {
+    std::shared_ptr<Flight> flight;
+    {
+        std::unique_lock<bthread::Mutex> lock(mu_);
+        auto it = flights_.find(key);
+        if (it == flights_.end()) {
+            flight = std::make_shared<Flight>();
+            flights_.emplace(key, flight);
+            lock.unlock();
+            execute(response, buf);
+            executed_cnt_ << 1;
+            Finish(key, flight, *response, *buf);
+            return;
+        }
+        flight = it->second;
+        uint64_t start = ::baidu::common::timer::get_micros();
+        uint64_t deadline = start + wait_us;
+        waiting_++;
+        while (!flight->done) {
+            uint64_t now = ::baidu::common::timer::get_micros();
+            if (now >= deadline) {
+                break;
+            }
+            flight->cv.wait_for(lock, deadline - now);
+        }
+        waiting_--;
+        if (flight->done && flight->ok) {
+            lock.unlock();
+            // IOBuf shares the blocks of the result instead of copying them
+            response->CopyFrom(flight->response);
+            buf->append(flight->buf);
+            coalesced_cnt_ << 1;
+            coalesced_wait_ << ::baidu::common::timer::get_micros() - start;
+            return;
+        }
+        if (!flight->done) {
+            timeout_cnt_ << 1;
+        }
+    }
+    // the result is not ready in time or the execution failed, e.g. its deadline passed in the admission queue
+    execute(response, buf);
+    executed_cnt_ << 1;
+}
+
+void RequestCoalescer::Finish(const std::string& key, const std::shared_ptr<Flight>& flight,
+                              const ::openmldb::api::QueryResponse& response, const butil::IOBuf& buf) {
+    bool ok = response.code() == ::openmldb::base::ReturnCode::kOk;
+    if (ok) {
+        flight->response.CopyFrom(response);
+        flight->buf.append(buf);
+    }
+    std::lock_guard<bthread::Mutex> lock(mu_);
+    flight->ok = ok;
+    flight->done = true;
+    flights_.erase(key);
+    flight->cv.notify_all();
+}
+
+RequestCoalescerStats RequestCoalescer::GetStats() {
+    RequestCoalescerStats stats;
+    {
+        std::lock_guard<bthread::Mutex> lock(mu_);
+        stats.running = flights_.size();
+        stats.waiting = waiting_;
+    }
+    stats.executed = executed_cnt_.get_value();
+    stats.coalesced = coalesced_cnt_.get_value();
+    stats.timeout = timeout_cnt_.get_value();
+    return stats;
+}
+
+}  // namespace openmldb::tablet
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_TABLET_REQUEST_COALESCER_H_
+#define SRC_TABLET_REQUEST_COALESCER_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
+#include "butil/iobuf.h"
+#include "bvar/bvar.h"
+#include "proto/tablet.pb.h"
+
+namespace openmldb::tablet {
+
+struct RequestCoalescerStats {
+    uint64_t running = 0;    // the keys being executed
+    uint64_t waiting = 0;    // the requests waiting for a running one
+    uint64_t executed = 0;   // the requests executed by themselves
+    uint64_t coalesced = 0;  // the requests which took the result of another one
+    uint64_t timeout = 0;    // the requests which gave up waiting and executed by themselves
+};
+
+// RequestCoalescer lets the identical requests arriving at the same time share one execution. The first request of
+// a key executes it, and the requests of the same key arriving before it finishes wait for its result. A waiting
+// request executes by itself if the result is not ready in its wait time or the execution fails.
+class RequestCoalescer {
+ public:
+    using Executor = std::function<void(::openmldb::api::QueryResponse*, butil::IOBuf*)>;
+
+    explicit RequestCoalescer(const std::string& prefix);
+
+    // fill response and buf by execute, or by the result of the running request of the same key.
+    // wait_us bounds the time waiting for the running request
+    void Execute(const std::string& key, uint64_t wait_us, const Executor& execute,
+                 ::openmldb::api::QueryResponse* response, butil::IOBuf* buf);
+
+    RequestCoalescerStats GetStats();
+
+ private:
+    struct Flight {
+        bool done = false;
+        bool ok = false;
+        ::openmldb::api::QueryResponse response;
+        butil::IOBuf buf;
+        bthread::ConditionVariable cv;
+    };
+
+    // must not hold mu_
+    void Finish(const std::string& key, const std::shared_ptr<Flight>& flight,
+                const ::openmldb::api::QueryResponse& response, const butil::IOBuf& buf);
+
+    bthread::Mutex mu_;
+    std::unordered_map<std::string, std::shared_ptr<Flight>> flights_;
+    uint64_t waiting_ = 0;
+
+    bvar::Adder<uint64_t> executed_cnt_;
+    bvar::Adder<uint64_t> coalesced_cnt_;
+    bvar::Adder<uint64_t> timeout_cnt_;
+    // the time a coalesced request waited for the result, in microseconds
+    bvar::LatencyRecorder coalesced_wait_;
+};
+
+}  // namespace openmldb::tablet
+#endif  // SRC_TABLET_REQUEST_COALESCER_H_
@@ -0,0 +1,169 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/request_coalescer.h"
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "base/status.h"
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace tablet {
+
+class RequestCoalescerTest : public ::testing::Test {
+ public:
+    RequestCoalescerTest() {}
+    ~RequestCoalescerTest() {}
+
+    // wait until the coalescer has cnt keys being executed
+    static void WaitRunning(RequestCoalescer* coalescer, uint64_t cnt) {
+        while (coalescer->GetStats().running < cnt) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // wait until cnt requests wait for the running ones
+    static void WaitWaiting(RequestCoalescer* coalescer, uint64_t cnt) {
+        while (coalescer->GetStats().waiting < cnt) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+};
+
+TEST_F(RequestCoalescerTest, ShareResult) {
+    RequestCoalescer coalescer("request_coalescer_test_share");
+    std::atomic<bool> release = false;
+    std::atomic<int> executed = 0;
+    auto execute = [&](::openmldb::api::QueryResponse* response, butil::IOBuf* buf) {
+        executed++;
+        while (!release) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        buf->append("result");
+        response->set_count(1);
+        response->set_code(::openmldb::base::ReturnCode::kOk);
+    };
+    ::openmldb::api::QueryResponse leader_response;
+    butil::IOBuf leader_buf;
+    std::thread leader([&] { coalescer.Execute("key", 0, execute, &leader_response, &leader_buf); });
+    WaitRunning(&coalescer, 1);
+    std::vector<::openmldb::api::QueryResponse> responses(4);
+    std::vector<butil::IOBuf> bufs(4);
+    std::vector<std::thread> followers;
+    for (int i = 0; i < 4; i++) {
+        followers.emplace_back(
+            [&, i] { coalescer.Execute("key", 10 * 1000 * 1000, execute, &responses[i], &bufs[i]); });
+    }
+    // another key is not blocked by the running one
+    ::openmldb::api::QueryResponse other_response;
+    butil::IOBuf other_buf;
+    std::thread other([&] { coalescer.Execute("other", 0, execute, &other_response, &other_buf); });
+    WaitRunning(&coalescer, 2);
+    WaitWaiting(&coalescer, 4);
+    release = true;
+    leader.join();
+    other.join();
+    for (auto& follower : followers) {
+        follower.join();
+    }
+    ASSERT_EQ(2, executed);
+    for (int i = 0; i < 4; i++) {
+        ASSERT_EQ(::openmldb::base::ReturnCode::kOk, responses[i].code());
+        ASSERT_EQ(1u, responses[i].count());
+        ASSERT_EQ("result", bufs[i].to_string());
+    }
+    auto stats = coalescer.GetStats();
+    ASSERT_EQ(0u, stats.running);
+    ASSERT_EQ(2u, stats.executed);
+    ASSERT_EQ(4u, stats.coalesced);
+    ASSERT_EQ(0u, stats.timeout);
+}
+
+TEST_F(RequestCoalescerTest, WaitTimeout) {
+    RequestCoalescer coalescer("request_coalescer_test_timeout");
+    std::atomic<bool> release = false;
+    auto slow = [&](::openmldb::api::QueryResponse* response, butil::IOBuf* buf) {
+        while (!release) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        response->set_code(::openmldb::base::ReturnCode::kOk);
+    };
+    ::openmldb::api::QueryResponse leader_response;
+    butil::IOBuf leader_buf;
+    std::thread leader([&] { coalescer.Execute("key", 0, slow, &leader_response, &leader_buf); });
+    WaitRunning(&coalescer, 1);
+    // the follower gives up waiting and executes by itself
+    ::openmldb::api::QueryResponse response;
+    butil::IOBuf buf;
+    auto fast = [](::openmldb::api::QueryResponse* response, butil::IOBuf* buf) {
+        buf->append("own");
+        response->set_code(::openmldb::base::ReturnCode::kOk);
+    };
+    coalescer.Execute("key", 10 * 1000, fast, &response, &buf);
+    ASSERT_EQ("own", buf.to_string());
+    release = true;
+    leader.join();
+    auto stats = coalescer.GetStats();
+    ASSERT_EQ(2u, stats.executed);
+    ASSERT_EQ(0u, stats.coalesced);
+    ASSERT_EQ(1u, stats.timeout);
+}
+
+TEST_F(RequestCoalescerTest, FailureNotShared) {
+    RequestCoalescer coalescer("request_coalescer_test_failure");
+    std::atomic<bool> release = false;
+    auto fail = [&](::openmldb::api::QueryResponse* response, butil::IOBuf* buf) {
+        while (!release) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        response->set_code(::openmldb::base::ReturnCode::kQueryDeadlineExceeded);
+    };
+    ::openmldb::api::QueryResponse leader_response;
+    butil::IOBuf leader_buf;
+    std::thread leader([&] { coalescer.Execute("key", 0, fail, &leader_response, &leader_buf); });
+    WaitRunning(&coalescer, 1);
+    ::openmldb::api::QueryResponse response;
+    butil::IOBuf buf;
+    std::thread follower([&] {
+        coalescer.Execute(
+            "key", 10 * 1000 * 1000,
+            [](::openmldb::api::QueryResponse* response, butil::IOBuf* buf) {
+                response->set_code(::openmldb::base::ReturnCode::kOk);
+            },
+            &response, &buf);
+    });
+    WaitWaiting(&coalescer, 1);
+    release = true;
+    leader.join();
+    follower.join();
+    // the follower executes by itself instead of taking the failure
+    ASSERT_EQ(::openmldb::base::ReturnCode::kQueryDeadlineExceeded, leader_response.code());
+    ASSERT_EQ(::openmldb::base::ReturnCode::kOk, response.code());
+    ASSERT_EQ(0u, coalescer.GetStats().coalesced);
+}
+
+}  // namespace tablet
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
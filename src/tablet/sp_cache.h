@@ -35,11 +35,13 @@ struct SQLProcedureCacheEntry {
     std::shared_ptr<hybridse::sdk::ProcedureInfo> procedure_info;
     std::shared_ptr<hybridse::vm::CompileInfo> request_info;
     std::shared_ptr<hybridse::vm::CompileInfo> batch_request_info;
+    // unique among the entries inserted into the cache, so a redeployed procedure of the same name gets a new one
+    uint64_t version;
 
     SQLProcedureCacheEntry(const std::shared_ptr<hybridse::sdk::ProcedureInfo> pinfo,
                            std::shared_ptr<hybridse::vm::CompileInfo> rinfo,
-                           std::shared_ptr<hybridse::vm::CompileInfo> brinfo)
-        : procedure_info(pinfo), request_info(rinfo), batch_request_info(brinfo) {}
+                           std::shared_ptr<hybridse::vm::CompileInfo> brinfo, uint64_t version)
+        : procedure_info(pinfo), request_info(rinfo), batch_request_info(brinfo), version(version) {}
 };
 
 class SpCache : public hybridse::vm::CompileInfoCache {
@@ -63,14 +65,29 @@ class SpCache : public hybridse::vm::CompileInfoCache {
         return sp_it->second.procedure_info;
     }
 
+    // find the procedure info for input db + sp_name and the version of its cache entry
+    absl::StatusOr<std::pair<std::shared_ptr<hybridse::sdk::ProcedureInfo>, uint64_t>> FindSpProcedureInfoWithVersion(
+        const std::string& db, const std::string& sp_name) const {
+        std::lock_guard<SpinMutex> spin_lock(spin_mutex_);
+        auto sp_map_of_db = db_sp_map_.find(db);
+        if (sp_map_of_db == db_sp_map_.end()) {
+            return absl::NotFoundError(absl::StrCat("db ", db, " not found in cache"));
+        }
+        auto sp_it = sp_map_of_db->second.find(sp_name);
+        if (sp_it == sp_map_of_db->second.end()) {
+            return absl::NotFoundError(absl::StrCat(db, ".", sp_name, " not found in cache"));
+        }
+        return std::make_pair(sp_it->second.procedure_info, sp_it->second.version);
+    }
+
     void InsertSQLProcedureCacheEntry(const std::string& db, const std::string& sp_name,
                                       std::shared_ptr<hybridse::sdk::ProcedureInfo> procedure_info,
                                       std::shared_ptr<hybridse::vm::CompileInfo> request_info,
                                       std::shared_ptr<hybridse::vm::CompileInfo> batch_request_info) {
         std::lock_guard<SpinMutex> spin_lock(spin_mutex_);
         auto& sp_map_of_db = db_sp_map_[db];
-        sp_map_of_db.insert(
-            std::make_pair(sp_name, SQLProcedureCacheEntry(procedure_info, request_info, batch_request_info)));
+        sp_map_of_db.insert(std::make_pair(
+            sp_name, SQLProcedureCacheEntry(procedure_info, request_info, batch_request_info, ++version_)));
     }
 
     void DropSQLProcedureCacheEntry(const std::string& db, const std::string& sp_name) {
@@ -132,6 +149,8 @@ class SpCache : public hybridse::vm::CompileInfoCache {
 
  private:
     std::map<std::string, std::map<std::string, SQLProcedureCacheEntry>> db_sp_map_;
+    // the version of the last inserted entry
+    uint64_t version_ = 0;
     mutable SpinMutex spin_mutex_;
 };
 
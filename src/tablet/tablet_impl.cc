@@ -47,8 +47,10 @@
 #include "boost/bind.hpp"
 #include "boost/container/deque.hpp"
 #include "brpc/controller.h"
+#include "brpc/http_status_code.h"
 #include "butil/iobuf.h"
 #include "codec/codec.h"
+#include "codec/fe_row_selector.h"
 #include "codec/row_codec.h"
 #include "codec/sql_rpc_row_codec.h"
 #include "common/timer.h"
@@ -60,6 +62,7 @@
 #endif
 #include "google/protobuf/io/zero_copy_stream_impl.h"
 #include "google/protobuf/text_format.h"
+#include "log/crc32c.h"
 #include "nameserver/task.h"
 #include "schema/schema_adapter.h"
 #include "storage/binlog.h"
@@ -77,9 +80,17 @@ using ::openmldb::storage::Table;
 DECLARE_int32(gc_interval);
 DECLARE_int32(gc_pool_size);
 DECLARE_int32(disk_gc_interval);
+DECLARE_uint64(gc_incremental_max_keys);
+DECLARE_uint32(gc_incremental_tick_ms);
 DECLARE_int32(statdb_ttl);
 DECLARE_uint32(scan_max_bytes_size);
 DECLARE_uint32(scan_reserve_size);
+DECLARE_uint32(query_admission_max_slots);
+DECLARE_uint32(query_admission_adhoc_max_slots);
+DECLARE_uint64(query_admission_rows_per_slot);
+DECLARE_uint32(query_result_max_pending);
+DECLARE_uint64(query_result_max_pending_byte_size);
+DECLARE_uint64(query_result_idle_timeout_ms);
 DECLARE_uint32(max_memory_mb);
 DECLARE_double(mem_release_rate);
 DECLARE_int32(get_sys_mem_interval);
@@ -104,6 +115,7 @@ DECLARE_uint32(task_check_interval);
 DECLARE_uint32(load_index_max_wait_time);
 DECLARE_bool(use_name);
 DECLARE_bool(enable_distsql);
+DECLARE_bool(enable_window_column_pruning);
 DECLARE_string(snapshot_compression);
 DECLARE_string(file_compression);
 DECLARE_int32(request_timeout_ms);
@@ -127,6 +139,22 @@ DECLARE_uint32(snapshot_ttl_check_interval);
 DECLARE_uint32(put_slow_log_threshold);
 DECLARE_uint32(query_slow_log_threshold);
 DECLARE_int32(snapshot_pool_size);
+DECLARE_bool(enable_hot_key_sampling);
+DECLARE_uint32(hot_key_sketch_width);
+DECLARE_uint32(hot_key_sketch_depth);
+DECLARE_uint32(hot_key_decay_interval);
+DECLARE_uint32(hot_key_threshold);
+DECLARE_uint32(hot_key_top_k);
+DECLARE_uint64(window_cache_capacity);
+DECLARE_uint32(window_cache_max_rows_per_key);
+DECLARE_bool(enable_async_aggr_update);
+DECLARE_uint32(aggr_update_thread_num);
+DECLARE_uint64(aggr_update_max_pending);
+DECLARE_uint32(request_coalesce_max_wait_ms);
+DECLARE_uint32(request_batch_window_us);
+DECLARE_uint32(request_batch_max_size);
+DECLARE_uint32(deploy_profile_sample_interval);
+DECLARE_uint32(result_compress_threshold);
 
 namespace openmldb {
 namespace tablet {
@@ -182,6 +210,8 @@ bool TabletImpl::Init(const std::string& zk_cluster, const std::string& zk_path,
     endpoint_ = endpoint;
     notify_path_ = zk_path + "/table/notify";
     sp_root_path_ = zk_path + "/store_procedure/db_sp_data";
+    table_nodes_ = std::make_unique<::openmldb::zk::ZkChildrenCache>(zk_path + "/table/db_table_data");
+    sp_nodes_ = std::make_unique<::openmldb::zk::ZkChildrenCache>(sp_root_path_);
     globalvar_changed_notify_path_ = zk_path + "/notify/global_variable";
     global_variables_ = std::make_shared<std::map<std::string, std::string>>();
     global_variables_->emplace("execute_mode", "online");
@@ -201,6 +231,68 @@ bool TabletImpl::Init(const std::string& zk_cluster, const std::string& zk_path,
     // rpc_server_<port> if standalone, diy
     deploy_collector_ = std::make_unique<::openmldb::statistics::DeploymentMetricCollector>(
         "rpc_server_" + endpoint.substr(endpoint.find(":") + 1));
+    if (FLAGS_enable_hot_key_sampling) {
+        hot_key_sampler_ = std::make_unique<::openmldb::statistics::HotKeySampler>(
+            "tablet", FLAGS_hot_key_sketch_width, FLAGS_hot_key_sketch_depth, FLAGS_hot_key_decay_interval,
+            FLAGS_hot_key_threshold, FLAGS_hot_key_top_k);
+    }
+    if (FLAGS_window_cache_capacity > 0) {
+        window_cache_ = std::make_shared<::openmldb::storage::WindowCache>(FLAGS_window_cache_capacity,
+                                                                         FLAGS_window_cache_max_rows_per_key);
+        if (hot_key_sampler_) {
+            // only the hot keys are admitted, the others are read from the segment directly. the cache is keyed
+            // by index key, so the misses are sampled by index key rather than by routing key
+            auto sampler = hot_key_sampler_.get();
+            window_cache_->SetAdmission([sampler](const base::Slice& key) {
+                return sampler->RecordIndexKey(std::string_view(key.data(), key.size()));
+            });
+        }
+        auto cache = window_cache_;
+        window_cache_metric_ = std::make_unique<::openmldb::statistics::CacheMetric>(
+            "tablet", "window_cache", [cache]() {
+                auto stats = cache->GetStats();
+                ::openmldb::statistics::CacheMetric::Stats result;
+                result.hit = stats.hit;
+                result.miss = stats.miss;
+                result.byte_size = stats.byte_size;
+                return result;
+            });
+        PDLOG(INFO, "window cache is enabled. capacity %lu max rows per key %u", FLAGS_window_cache_capacity,
+              FLAGS_window_cache_max_rows_per_key);
+    }
+    if (FLAGS_enable_async_aggr_update) {
+        aggr_updater_ = std::make_unique<::openmldb::storage::AsyncAggrUpdater>(FLAGS_aggr_update_thread_num,
+                                                                                FLAGS_aggr_update_max_pending);
+        aggr_update_pending_ = std::make_unique<bvar::PassiveStatus<uint64_t>>(
+            "tablet", "aggr_update_pending",
+            [](void* arg) -> uint64_t {
+                return static_cast<::openmldb::storage::AsyncAggrUpdater*>(arg)->GetPendingCnt();
+            },
+            aggr_updater_.get());
+        aggr_update_blocked_ = std::make_unique<bvar::PassiveStatus<uint64_t>>(
+            "tablet", "aggr_update_blocked",
+            [](void* arg) -> uint64_t {
+                return static_cast<::openmldb::storage::AsyncAggrUpdater*>(arg)->GetBlockedCnt();
+            },
+            aggr_updater_.get());
+        PDLOG(INFO, "async aggr update is enabled. thread num %u max pending %lu", FLAGS_aggr_update_thread_num,
+              FLAGS_aggr_update_max_pending);
+    }
+    query_result_cache_ =
+        std::make_unique<QueryResultCache>(FLAGS_query_result_max_pending, FLAGS_query_result_max_pending_byte_size,
+                                           FLAGS_query_result_idle_timeout_ms);
+    // the batcher is idle unless request_batch_window_us is set
+    request_batcher_ = std::make_unique<RequestBatcher>("tablet_request_batch");
+    if (FLAGS_request_coalesce_max_wait_ms > 0) {
+        request_coalescer_ = std::make_unique<RequestCoalescer>("tablet_request_coalesce");
+        PDLOG(INFO, "request coalescing is enabled. max wait %u ms", FLAGS_request_coalesce_max_wait_ms);
+    }
+    if (FLAGS_query_admission_max_slots > 0) {
+        query_admission_ = std::make_unique<QueryAdmission>("tablet_query_admission", FLAGS_query_admission_max_slots,
+                                                            FLAGS_query_admission_adhoc_max_slots);
+        PDLOG(INFO, "query admission is enabled. max slots %u, ad-hoc max slots %u", FLAGS_query_admission_max_slots,
+              FLAGS_query_admission_adhoc_max_slots);
+    }
 
     if (!zk_cluster.empty()) {
         zk_client_ = new ZkClient(zk_cluster, real_endpoint, FLAGS_zk_session_timeout, endpoint, zk_path,
@@ -222,7 +314,16 @@ bool TabletImpl::Init(const std::string& zk_cluster, const std::string& zk_path,
     } else {
         options.SetClusterOptimized(false);
     }
+    options.SetEnableWindowColumnPruning(FLAGS_enable_window_column_pruning);
     engine_ = std::make_unique<::hybridse::vm::Engine>(catalog_, options);
+    compile_cache_invalidations_ = std::make_unique<bvar::PassiveStatus<uint64_t>>(
+        "tablet", "compile_cache_invalidations",
+        [](void* arg) -> uint64_t { return static_cast<::hybridse::vm::Engine*>(arg)->GetCacheStats().invalidations; },
+        engine_.get());
+    compile_cache_recompiles_ = std::make_unique<bvar::PassiveStatus<uint64_t>>(
+        "tablet", "compile_cache_recompiles",
+        [](void* arg) -> uint64_t { return static_cast<::hybridse::vm::Engine*>(arg)->GetCacheStats().recompiles; },
+        engine_.get());
     catalog_->SetLocalTablet(std::make_shared<::hybridse::vm::LocalTablet>(engine_.get(), sp_cache_));
     std::set<std::string> snapshot_compression_set{"off", "zlib", "snappy"};
     if (snapshot_compression_set.find(FLAGS_snapshot_compression) == snapshot_compression_set.end()) {
@@ -1650,7 +1751,7 @@ void TabletImpl::Delete(RpcController* controller, const ::openmldb::api::Delete
             }
             auto aggr = get_aggregator(aggrs, idx);
             if (aggr) {
-                if (!aggr->Delete(key, start_ts, end_ts)) {
+                if (!DeleteAggr(aggr, key, start_ts, end_ts)) {
                     PDLOG(WARNING,
                           "delete from aggr failed. base table: tid[%u] pid[%u] index[%u] key[%s]. "
                           "aggr table: tid[%u]",
@@ -1690,7 +1791,7 @@ void TabletImpl::Delete(RpcController* controller, const ::openmldb::api::Delete
                     }
                     auto aggr = get_aggregator(aggrs, idx);
                     if (aggr) {
-                        if (!aggr->Delete(pk, start_ts, end_ts)) {
+                        if (!DeleteAggr(aggr, pk, start_ts, end_ts)) {
                             PDLOG(WARNING,
                                   "delete from aggr failed. base table: tid[%u] pid[%u] index[%u] key[%s]. "
                                   "aggr table: tid[%u]",
@@ -1721,11 +1822,136 @@ void TabletImpl::Query(RpcController* ctrl, const openmldb::api::QueryRequest* r
     brpc::Controller* cntl = static_cast<brpc::Controller*>(ctrl);
     butil::IOBuf& buf = cntl->response_attachment();
     ProcessQuery(true, ctrl, request, response, &buf);
+    if (FLAGS_result_compress_threshold > 0 && request->accept_compress_type() == ::openmldb::type::kSnappy &&
+        response->code() == ::openmldb::base::kOk && buf.size() >= FLAGS_result_compress_threshold &&
+        ::openmldb::codec::CompressRpcRows(&buf)) {
+        response->set_compress_type(::openmldb::type::kSnappy);
+    }
+}
+
+std::unique_ptr<QueryAdmission::Permit> TabletImpl::AcquireQueryPermit(
+    QueryClass query_class, const std::shared_ptr<hybridse::vm::CompileInfo>& info, uint64_t deadline_us) {
+    uint32_t slots = 1;
+    if (query_class == QueryClass::kAdhoc && info) {
+        auto cost = EstimateQueryCost(info->GetPhysicalPlan(), [this](const auto& table_handler) {
+            return EstimateTableRows(table_handler);
+        });
+        slots = query_admission_->AdhocSlots(cost, FLAGS_query_admission_rows_per_slot);
+        DLOG(INFO) << "ad-hoc query scans " << cost.rows_scanned << " rows and builds " << cost.windows_built
+                   << " windows, takes " << slots << " slots";
+    }
+    return query_admission_->Acquire(query_class, slots, deadline_us);
+}
+
+bool TabletImpl::AdmitQuery(QueryClass query_class, const std::shared_ptr<hybridse::vm::CompileInfo>& info,
+                            uint64_t deadline_us, ::openmldb::api::QueryResponse* response,
+                            std::unique_ptr<QueryAdmission::Permit>* permit) {
+    if (!query_admission_) {
+        return true;
+    }
+    *permit = AcquireQueryPermit(query_class, info, deadline_us);
+    if (!*permit) {
+        response->set_code(::openmldb::base::ReturnCode::kQueryDeadlineExceeded);
+        response->set_msg("query deadline exceeded while waiting for admission");
+        return false;
+    }
+    return true;
+}
+
+bool TabletImpl::AdmitQuery(QueryClass query_class, uint64_t deadline_us,
+                            ::openmldb::api::SQLBatchRequestQueryResponse* response,
+                            std::unique_ptr<QueryAdmission::Permit>* permit) {
+    if (!query_admission_) {
+        return true;
+    }
+    *permit = AcquireQueryPermit(query_class, nullptr, deadline_us);
+    if (!*permit) {
+        response->set_code(::openmldb::base::ReturnCode::kQueryDeadlineExceeded);
+        response->set_msg("query deadline exceeded while waiting for admission");
+        return false;
+    }
+    return true;
+}
+
+uint64_t TabletImpl::EstimateTableRows(const std::shared_ptr<hybridse::vm::TableHandler>& table_handler) {
+    auto handler = std::dynamic_pointer_cast<catalog::TabletTableHandler>(table_handler);
+    if (!handler) {
+        return 0;
+    }
+    uint64_t rows = 0;
+    uint32_t local_cnt = 0;
+    for (uint32_t pid = 0; pid < handler->GetPartitionNum(); pid++) {
+        auto table = GetTable(handler->GetTid(), pid);
+        if (table) {
+            rows += table->GetRecordCnt();
+            local_cnt++;
+        }
+    }
+    return local_cnt == 0 ? 0 : rows * handler->GetPartitionNum() / local_cnt;
+}
+
+void TabletImpl::SetQueryResult(const openmldb::api::QueryRequest& request, const std::string& schema,
+                                std::vector<::hybridse::codec::Row>* output_rows,
+                                ::openmldb::api::QueryResponse* response, butil::IOBuf* buf) {
+    response->set_schema(schema);
+    uint32_t byte_size = 0;
+    uint32_t count = 0;
+    if (request.page_byte_size() == 0) {
+        for (auto& output_row : *output_rows) {
+            if (FLAGS_scan_max_bytes_size > 0 && byte_size > FLAGS_scan_max_bytes_size) {
+                LOG(WARNING) << "reach the max byte size " << FLAGS_scan_max_bytes_size << " truncate result";
+                break;
+            }
+            byte_size += output_row.size();
+            buf->append(reinterpret_cast<void*>(output_row.buf()), output_row.size());
+            count += 1;
+        }
+    } else {
+        if (FLAGS_scan_max_bytes_size > 0) {
+            // the pages of a result are bounded as the unpaged result
+            uint64_t total_size = 0;
+            for (size_t i = 0; i < output_rows->size(); i++) {
+                if (total_size > FLAGS_scan_max_bytes_size) {
+                    LOG(WARNING) << "reach the max byte size " << FLAGS_scan_max_bytes_size << " truncate result";
+                    output_rows->resize(i);
+                    break;
+                }
+                total_size += (*output_rows)[i].size();
+            }
+        }
+        size_t pos = QueryResultCache::AppendPage(output_rows, 0, request.page_byte_size(), buf, &count, &byte_size);
+        if (pos < output_rows->size()) {
+            // keep the rest for the next pages, the client may stop fetching them any time
+            uint64_t result_id = query_result_cache_->Put(request.db(), schema, std::move(*output_rows), pos);
+            if (result_id == 0) {
+                buf->clear();
+                response->set_code(::openmldb::base::ReturnCode::kQueryResultCacheFull);
+                response->set_msg("too many paged query results or bytes are pending on the tablet");
+                return;
+            }
+            response->set_result_id(result_id);
+            response->set_is_finish(false);
+        }
+    }
+    response->set_byte_size(byte_size);
+    response->set_count(count);
+    response->set_code(::openmldb::base::kOk);
 }
 
 void TabletImpl::ProcessQuery(bool is_sub, RpcController* ctrl, const openmldb::api::QueryRequest* request,
                               ::openmldb::api::QueryResponse* response, butil::IOBuf* buf) {
     auto start = absl::Now();
+    // the client gives up the query after timeout_ms, so does the tablet
+    uint64_t deadline_us =
+        request->timeout_ms() > 0 ? ::baidu::common::timer::get_micros() + request->timeout_ms() * 1000 : 0;
+    auto deadline_exceeded = [deadline_us, response]() {
+        if (deadline_us > 0 && ::baidu::common::timer::get_micros() > deadline_us) {
+            response->set_code(::openmldb::base::ReturnCode::kQueryDeadlineExceeded);
+            response->set_msg("query deadline exceeded");
+            return true;
+        }
+        return false;
+    };
     absl::Cleanup deploy_collect_task = [this, is_sub, request, start]() {
         if (this->IsCollectDeployStatsEnabled()) {
             if (!is_sub && request->is_procedure() && request->has_db() && request->has_sp_name()) {
@@ -1734,6 +1960,35 @@ void TabletImpl::ProcessQuery(bool is_sub, RpcController* ctrl, const openmldb::
         }
     };
 
+    if (request->has_result_id() && request->release_result()) {
+        if (!query_result_cache_->Release(request->result_id(), request->db())) {
+            response->set_code(::openmldb::base::ReturnCode::kQueryResultNotFound);
+            response->set_msg("query result not found, it may be expired");
+            return;
+        }
+        response->set_code(::openmldb::base::kOk);
+        return;
+    }
+    if (request->has_result_id()) {
+        std::string schema;
+        uint32_t count = 0;
+        uint32_t byte_size = 0;
+        bool finished = true;
+        if (!query_result_cache_->NextPage(request->result_id(), request->db(), request->page_byte_size(), buf, &schema,
+                                           &count, &byte_size, &finished)) {
+            response->set_code(::openmldb::base::ReturnCode::kQueryResultNotFound);
+            response->set_msg("query result not found, it may be expired");
+            return;
+        }
+        response->set_schema(schema);
+        response->set_count(count);
+        response->set_byte_size(byte_size);
+        response->set_result_id(request->result_id());
+        response->set_is_finish(finished);
+        response->set_code(::openmldb::base::kOk);
+        return;
+    }
+
     hybridse::vm::EngineMode default_mode =
         request->is_batch() ? hybridse::vm::EngineMode::kBatchMode : hybridse::vm::EngineMode::kRequestMode;
     auto mode = hybridse::vm::Engine::TryDetermineEngineMode(request->sql(), default_mode);
@@ -1770,6 +2025,14 @@ void TabletImpl::ProcessQuery(bool is_sub, RpcController* ctrl, const openmldb::
                 }
             }
 
+            std::unique_ptr<QueryAdmission::Permit> permit;
+            // the sub tasks of a query admitted by another tablet are not queued again, or the tablets could wait
+            // for each other
+            if (!request->has_task_id() &&
+                !AdmitQuery(QueryClass::kAdhoc, session.GetCompileInfo(), deadline_us, response, &permit)) {
+                return;
+            }
+
             ::hybridse::codec::Row parameter_row;
             auto& request_buf = static_cast<brpc::Controller*>(ctrl)->request_attachment();
             if (request->parameter_row_size() > 0 &&
@@ -1787,61 +2050,37 @@ void TabletImpl::ProcessQuery(bool is_sub, RpcController* ctrl, const openmldb::
                 DLOG(WARNING) << "fail to run sql: " << request->sql();
                 return;
             }
-            uint32_t byte_size = 0;
-            uint32_t count = 0;
-            for (auto& output_row : output_rows) {
-                if (FLAGS_scan_max_bytes_size > 0 && byte_size > FLAGS_scan_max_bytes_size) {
-                    LOG(WARNING) << "reach the max byte size " << FLAGS_scan_max_bytes_size << " truncate result";
-                    response->set_schema(session.GetEncodedSchema());
-                    response->set_byte_size(byte_size);
-                    response->set_count(count);
-                    response->set_code(::openmldb::base::kOk);
-                    return;
-                }
-                byte_size += output_row.size();
-                buf->append(reinterpret_cast<void*>(output_row.buf()), output_row.size());
-                count += 1;
-            }
-            response->set_schema(session.GetEncodedSchema());
-            response->set_byte_size(byte_size);
-            response->set_count(count);
-            response->set_code(::openmldb::base::kOk);
-            DLOG(INFO) << "handle batch sql " << request->sql() << " with record cnt " << count << " byte size "
-                       << byte_size;
+            // nobody waits for the result any more, skip encoding it
+            if (deadline_exceeded()) {
+                return;
+            }
+            SetQueryResult(*request, session.GetEncodedSchema(), &output_rows, response, buf);
+            DLOG(INFO) << "handle batch sql " << request->sql() << " with record cnt " << response->count()
+                       << " byte size " << response->byte_size();
             break;
         }
         case hybridse::vm::kRequestMode: {
+            if (request->is_procedure()) {
+                RunProcedureRequest(ctrl, *request, deadline_us, response, buf);
+                break;
+            }
+            std::unique_ptr<QueryAdmission::Permit> permit;
+            if (!request->has_task_id() &&
+                !AdmitQuery(QueryClass::kDeployment, nullptr, deadline_us, response, &permit)) {
+                return;
+            }
             ::hybridse::vm::RequestRunSession session;
             if (request->is_debug()) {
                 session.EnableDebug();
             }
-            if (request->is_procedure()) {
-                const std::string& db_name = request->db();
-                const std::string& sp_name = request->sp_name();
-                std::shared_ptr<hybridse::vm::CompileInfo> request_compile_info;
-                {
-                    hybridse::base::Status status;
-                    request_compile_info = sp_cache_->GetRequestInfo(db_name, sp_name, status);
-                    if (!status.isOK()) {
-                        response->set_code(::openmldb::base::ReturnCode::kProcedureNotFound);
-                        response->set_msg(status.msg);
-                        PDLOG(WARNING, status.msg.c_str());
-                        return;
-                    }
-                }
-                session.SetCompileInfo(request_compile_info);
-                session.SetSpName(sp_name);
-                RunRequestQuery(ctrl, *request, session, *response, *buf);
-            } else {
-                bool ok = engine_->Get(request->sql(), request->db(), session, status);
-                if (!ok || session.GetCompileInfo() == nullptr) {
-                    response->set_msg(status.msg);
-                    response->set_code(::openmldb::base::kSQLCompileError);
-                    DLOG(WARNING) << "fail to compile sql in request mode:\n" << request->sql();
-                    return;
-                }
-                RunRequestQuery(ctrl, *request, session, *response, *buf);
+            bool ok = engine_->Get(request->sql(), request->db(), session, status);
+            if (!ok || session.GetCompileInfo() == nullptr) {
+                response->set_msg(status.msg);
+                response->set_code(::openmldb::base::kSQLCompileError);
+                DLOG(WARNING) << "fail to compile sql in request mode:\n" << request->sql();
+                return;
             }
+            RunRequestQuery(ctrl, *request, session, *response, *buf);
             const std::string& sql = session.GetCompileInfo()->GetSql();
             if (response->code() != ::openmldb::base::kOk) {
                 DLOG(WARNING) << "fail to run sql " << sql << " error msg: " << response->msg();
@@ -1873,6 +2112,11 @@ void TabletImpl::ProcessQuery(bool is_sub, RpcController* ctrl, const openmldb::
                 response->set_code(::openmldb::base::kSQLCompileError);
                 return;
             }
+            std::unique_ptr<QueryAdmission::Permit> permit;
+            if (!request->has_task_id() &&
+                !AdmitQuery(QueryClass::kAdhoc, session.GetCompileInfo(), deadline_us, response, &permit)) {
+                return;
+            }
             std::vector<::hybridse::codec::Row> output_rows;
             std::vector<::hybridse::codec::Row> empty_inputs;
             int32_t run_ret = session.Run(empty_inputs, output_rows);
@@ -1882,25 +2126,10 @@ void TabletImpl::ProcessQuery(bool is_sub, RpcController* ctrl, const openmldb::
                 DLOG(WARNING) << "fail to run batchrequest sql: " << request->sql();
                 return;
             }
-            uint32_t byte_size = 0;
-            uint32_t count = 0;
-            for (auto& output_row : output_rows) {
-                if (FLAGS_scan_max_bytes_size > 0 && byte_size > FLAGS_scan_max_bytes_size) {
-                    LOG(WARNING) << "reach the max byte size " << FLAGS_scan_max_bytes_size << " truncate result";
-                    response->set_schema(session.GetEncodedSchema());
-                    response->set_byte_size(byte_size);
-                    response->set_count(count);
-                    response->set_code(::openmldb::base::kOk);
-                    return;
-                }
-                byte_size += output_row.size();
-                buf->append(reinterpret_cast<void*>(output_row.buf()), output_row.size());
-                count += 1;
-            }
-            response->set_schema(session.GetEncodedSchema());
-            response->set_byte_size(byte_size);
-            response->set_count(count);
-            response->set_code(::openmldb::base::kOk);
+            if (deadline_exceeded()) {
+                return;
+            }
+            SetQueryResult(*request, session.GetEncodedSchema(), &output_rows, response, buf);
             break;
         }
         default: {
@@ -1941,6 +2170,16 @@ void TabletImpl::ProcessBatchRequestQuery(bool is_sub, RpcController* ctrl,
         }
     };
 
+    // the sub queries of a deployment run on the tablet that admitted the deployment
+    std::unique_ptr<QueryAdmission::Permit> permit;
+    if (!request->has_task_id()) {
+        uint64_t deadline_us =
+            request->timeout_ms() > 0 ? ::baidu::common::timer::get_micros() + request->timeout_ms() * 1000 : 0;
+        if (!AdmitQuery(QueryClass::kDeployment, deadline_us, response, &permit)) {
+            return;
+        }
+    }
+
     ::hybridse::base::Status status;
     ::hybridse::vm::BatchRequestRunSession session;
     // run session
@@ -2533,6 +2772,10 @@ void TabletImpl::GetTableStatus(RpcController* controller, const ::openmldb::api
                     status->set_record_idx_byte_size(mem_table->GetRecordIdxByteSize());
                     status->set_record_pk_cnt(mem_table->GetRecordPkCnt());
                     status->set_skiplist_height(mem_table->GetKeyEntryHeight());
+                    auto gc_stats = mem_table->GetGcStats();
+                    status->set_gc_latency_ms(gc_stats.latency_ms);
+                    status->set_gc_reclaimed_byte_size(gc_stats.reclaimed_byte_size);
+                    status->set_gc_reclaimed_idx_cnt(gc_stats.reclaimed_idx_cnt);
                     uint64_t record_idx_cnt = 0;
                     auto indexs = table->GetAllIndex();
                     for (const auto& index_def : indexs) {
@@ -2843,6 +3086,10 @@ void TabletImpl::SendData(RpcController* controller, const ::openmldb::api::Send
         response->set_msg("cannot find receiver");
         return;
     }
+    if (request->has_offset() && request->block_id() > 0) {
+        SendDataPipelined(request, cntl->request_attachment(), receiver, combine_key, response);
+        return;
+    }
     if (receiver->GetBlockId() == request->block_id()) {
         response->set_msg("ok");
         response->set_code(::openmldb::base::ReturnCode::kOk);
@@ -2883,6 +3130,64 @@ void TabletImpl::SendData(RpcController* controller, const ::openmldb::api::Send
     response->set_code(::openmldb::base::ReturnCode::kOk);
 }
 
+void TabletImpl::SendDataPipelined(const ::openmldb::api::SendDataRequest* request, const butil::IOBuf& attachment,
+                                   const std::shared_ptr<FileReceiver>& receiver, const std::string& combine_key,
+                                   ::openmldb::api::GeneralResponse* response) {
+    uint32_t tid = request->tid();
+    uint32_t pid = request->pid();
+    if (request->eof()) {
+        uint64_t size = receiver->GetSize();
+        if (size != request->file_size()) {
+            PDLOG(WARNING, "check size failed. tid %u, pid %u, file_name %s, cur_size %lu, expect_size %lu", tid, pid,
+                  request->file_name().c_str(), size, request->file_size());
+            response->set_code(::openmldb::base::ReturnCode::kReceiveDataError);
+            response->set_msg("check size failed");
+            return;
+        }
+        receiver->SaveFile();
+        std::lock_guard<std::mutex> lock(mu_);
+        file_receiver_map_.erase(combine_key);
+        response->set_code(::openmldb::base::ReturnCode::kOk);
+        response->set_msg("ok");
+        return;
+    }
+    if (attachment.size() != request->block_size()) {
+        PDLOG(WARNING, "receive data error. tid %u, pid %u, file_name %s, expected length %u real length %u", tid, pid,
+              request->file_name().c_str(), request->block_size(), attachment.size());
+        response->set_code(::openmldb::base::ReturnCode::kReceiveDataError);
+        response->set_msg("receive data error");
+        return;
+    }
+    std::string data = attachment.to_string();
+    if (request->compress_type() == ::openmldb::type::kSnappy) {
+        std::string uncompressed;
+        if (!snappy::Uncompress(data.data(), data.size(), &uncompressed)) {
+            PDLOG(WARNING, "uncompress data failed. tid %u, pid %u, file_name %s, offset %lu", tid, pid,
+                  request->file_name().c_str(), request->offset());
+            response->set_code(::openmldb::base::ReturnCode::kReceiveDataError);
+            response->set_msg("uncompress data failed");
+            return;
+        }
+        data.swap(uncompressed);
+    }
+    if (request->has_crc() && ::openmldb::log::Value(data.data(), data.size()) != request->crc()) {
+        PDLOG(WARNING, "checksum mismatch. tid %u, pid %u, file_name %s, offset %lu", tid, pid,
+              request->file_name().c_str(), request->offset());
+        response->set_code(::openmldb::base::ReturnCode::kReceiveDataError);
+        response->set_msg("checksum mismatch");
+        return;
+    }
+    if (receiver->WriteBlock(data, request->offset()) < 0) {
+        PDLOG(WARNING, "receiver write data failed. tid %u, pid %u, file_name %s", tid, pid,
+              request->file_name().c_str());
+        response->set_code(::openmldb::base::ReturnCode::kWriteDataFailed);
+        response->set_msg("write data failed");
+        return;
+    }
+    response->set_code(::openmldb::base::ReturnCode::kOk);
+    response->set_msg("ok");
+}
+
 void TabletImpl::SendSnapshot(RpcController* controller, const ::openmldb::api::SendSnapshotRequest* request,
                               ::openmldb::api::GeneralResponse* response, Closure* done) {
     brpc::ClosureGuard done_guard(done);
@@ -3444,7 +3749,7 @@ int32_t TabletImpl::DeleteTableInternal(uint32_t tid, uint32_t pid,
                 snapshots_.erase(tid);
             }
         }
-        engine_->ClearCacheLocked("");
+        engine_->InvalidateTable(table->GetDB(), table->GetName());
         if (replicator) {
             replicator->DelAllReplicateNode();
             PDLOG(INFO, "drop replicator for tid %u, pid %u", tid, pid);
@@ -3662,6 +3967,7 @@ base::Status TabletImpl::TruncateTableInternal(uint32_t tid, uint32_t pid) {
             PDLOG(WARNING, "fail to init table. tid %u, pid %u", tid, pid);
             return {::openmldb::base::ReturnCode::kTableMetaIsIllegal, "fail to init table"};
         }
+        SetWindowCache(new_table);
         new_table->SetTableStat(::openmldb::storage::kNormal);
         if (table_meta->mode() == ::openmldb::api::TableMode::kTableLeader) {
             if (catalog_->AddTable(*table_meta, new_table)) {
@@ -4135,6 +4441,7 @@ int TabletImpl::CreateTableInternal(const ::openmldb::api::TableMeta* table_meta
         msg.assign("fail to init table");
         return -1;
     }
+    SetWindowCache(table);
     PDLOG(INFO, "create table. tid %u pid %u", tid, pid);
 
     std::shared_ptr<LogReplicator> replicator;
@@ -4182,7 +4489,7 @@ int TabletImpl::CreateTableInternal(const ::openmldb::api::TableMeta* table_meta
         } else {
             LOG(WARNING) << "fail to add table " << table_meta->name() << " to catalog with db " << table_meta->db();
         }
-        engine_->ClearCacheLocked("");
+        engine_->InvalidateTable(table_meta->db(), table_meta->name());
 
         // we always refresh the aggr catalog in case zk notification arrives later than the `deploy` sql
         if (boost::iequals(table_meta->db(), openmldb::nameserver::PRE_AGG_DB)) {
@@ -4369,6 +4676,14 @@ void TabletImpl::GcTable(uint32_t tid, uint32_t pid, bool execute_once) {
             options.zk_path = zk_path_;
             auto router = sdk::NewClusterSQLRouter(options);
             iot->SchedGCByDelete(router);  // add a lock to avoid gc one table in the same time
+        } else if (auto mem_table = std::dynamic_pointer_cast<MemTable>(table);
+                   mem_table && !execute_once && FLAGS_gc_incremental_max_keys > 0) {
+            // sweep a slice of the table per tick, and wait for the next interval once the pass is finished
+            if (!mem_table->IncrementalGc(FLAGS_gc_incremental_max_keys)) {
+                gc_pool_.DelayTask(FLAGS_gc_incremental_tick_ms,
+                                   boost::bind(&TabletImpl::GcTable, this, tid, pid, false));
+                return;
+            }
         } else {
             table->SchedGc();
         }
@@ -4448,6 +4763,11 @@ bool TabletImpl::UpdateAggrs(uint32_t tid, uint32_t pid, const std::string& valu
     if (!aggrs) {
         return true;
     }
+    if (aggr_updater_) {
+        // the failures are logged by the updater and don't fail the put
+        aggr_updater_->Update(aggrs, value, dimensions, log_offset);
+        return true;
+    }
     for (auto iter = dimensions.begin(); iter != dimensions.end(); ++iter) {
         for (const auto& aggr : *aggrs) {
             if (aggr->GetIndexPos() != iter->idx()) {
@@ -4464,6 +4784,15 @@ bool TabletImpl::UpdateAggrs(uint32_t tid, uint32_t pid, const std::string& valu
     return true;
 }
 
+bool TabletImpl::DeleteAggr(const std::shared_ptr<::openmldb::storage::Aggregator>& aggr, const std::string& key,
+                            const std::optional<uint64_t>& start_ts, const std::optional<uint64_t>& end_ts) {
+    if (!aggr_updater_) {
+        return aggr->Delete(key, start_ts, end_ts);
+    }
+    // the delete must not overtake the queued updates of the key
+    return aggr_updater_->Run(key, [&aggr, &key, &start_ts, &end_ts]() { return aggr->Delete(key, start_ts, end_ts); });
+}
+
 void TabletImpl::ShowMemPool(RpcController* controller, const ::openmldb::api::HttpRequest* request,
                              ::openmldb::api::HttpResponse* response, Closure* done) {
     brpc::ClosureGuard done_guard(done);
@@ -4482,6 +4811,33 @@ void TabletImpl::ShowMemPool(RpcController* controller, const ::openmldb::api::H
 #endif
 }
 
+void TabletImpl::ShowDeploymentProfile(RpcController* controller, const ::openmldb::api::HttpRequest* request,
+                                       ::openmldb::api::HttpResponse* response, Closure* done) {
+    brpc::ClosureGuard done_guard(done);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(controller);
+    const std::string* db = cntl->http_request().uri().GetQuery("db");
+    const std::string* name = cntl->http_request().uri().GetQuery("deployment");
+    if (db == nullptr || name == nullptr) {
+        cntl->http_response().set_status_code(brpc::HTTP_STATUS_BAD_REQUEST);
+        cntl->response_attachment().append("usage: ShowDeploymentProfile?db=<db>&deployment=<deployment>\n");
+        return;
+    }
+    hybridse::base::Status status;
+    auto info = sp_cache_->GetRequestInfo(*db, *name, status);
+    if (!status.isOK() || !info) {
+        cntl->http_response().set_status_code(brpc::HTTP_STATUS_NOT_FOUND);
+        cntl->response_attachment().append("deployment " + *db + "." + *name + " not found\n");
+        return;
+    }
+    butil::IOBufBuilder os;
+    os << "deployment " << *db << "." << *name << ", one of every " << FLAGS_deploy_profile_sample_interval
+       << " requests profiled\n";
+    os << "the time of a runner excludes its producers and the runners it runs, the rows produced lazily are "
+          "billed to their consumer\n";
+    info->DumpClusterJob(os, "    ");
+    os.move_to(cntl->response_attachment());
+}
+
 void TabletImpl::CheckZkClient() {
     if (zk_client_) {
         if (!zk_client_->IsConnected()) {
@@ -4514,7 +4870,7 @@ bool TabletImpl::RefreshSingleTable(uint32_t tid) {
     if (bool index_updated = false; !catalog_->UpdateTableInfo(table_info, &index_updated)) {
         return false;
     } else if (index_updated) {
-        engine_->ClearCacheLocked("");
+        engine_->InvalidateTable(table_info.db(), table_info.name());
     }
     return true;
 }
@@ -4575,79 +4931,67 @@ void TabletImpl::RefreshTableInfo() {
     } catch (const std::exception& e) {
         LOG(WARNING) << "value is not integer";
     }
-    std::string db_table_data_path = zk_path_ + "/table/db_table_data";
-    std::vector<std::string> table_datas;
-    if (zk_client_->IsExistNode(db_table_data_path) == 0) {
-        bool ok = zk_client_->GetChildren(db_table_data_path, table_datas);
-        if (!ok) {
-            LOG(WARNING) << "fail to get table list with path " << db_table_data_path;
-            return;
+    std::lock_guard<std::mutex> refresh_lock(refresh_table_mu_);
+    // nothing is read yet, refresh with all the tables
+    bool full = table_nodes_->Size() == 0;
+    std::map<std::string, std::string> changed_table_nodes;
+    std::vector<std::string> removed_table_nodes;
+    std::map<std::string, std::string> changed_sp_nodes;
+    std::vector<std::string> removed_sp_nodes;
+    if (!table_nodes_->Refresh(zk_client_, &changed_table_nodes, &removed_table_nodes) ||
+        !sp_nodes_->Refresh(zk_client_, &changed_sp_nodes, &removed_sp_nodes)) {
+        // the nodes read are not applied, start over
+        table_nodes_->Clear();
+        sp_nodes_->Clear();
+        node_tables_.clear();
+        node_procedures_.clear();
+        return;
+    }
+    std::vector<std::pair<std::string, std::string>> removed_tables;
+    for (const auto& node : removed_table_nodes) {
+        auto it = node_tables_.find(node);
+        if (it != node_tables_.end()) {
+            removed_tables.push_back(it->second);
+            node_tables_.erase(it);
         }
-    } else {
-        LOG(INFO) << "no tables in db";
     }
     std::vector<::openmldb::nameserver::TableInfo> table_info_vec;
-    for (const auto& node : table_datas) {
-        std::string value;
-        if (!zk_client_->GetNodeValue(db_table_data_path + "/" + node, value)) {
-            LOG(WARNING) << "fail to get table data. node: " << node;
-            continue;
-        }
+    for (const auto& [node, value] : changed_table_nodes) {
         ::openmldb::nameserver::TableInfo table_info;
         if (!table_info.ParseFromString(value)) {
             LOG(WARNING) << "fail to parse table proto. node: " << node << " value: " << value;
             continue;
         }
+        node_tables_[node] = {table_info.db(), table_info.name()};
         table_info_vec.push_back(std::move(table_info));
     }
     // procedure part
-    std::vector<std::string> sp_datas;
-    if (zk_client_->IsExistNode(sp_root_path_) == 0) {
-        bool ok = zk_client_->GetChildren(sp_root_path_, sp_datas);
-        if (!ok) {
-            LOG(WARNING) << "fail to get procedure list with path " << sp_root_path_;
-            return;
-        }
-    } else {
-        DLOG(INFO) << "no procedures in db";
+    for (const auto& node : removed_sp_nodes) {
+        node_procedures_.erase(node);
     }
-    openmldb::catalog::Procedures db_sp_map;
-    for (const auto& node : sp_datas) {
-        if (node.empty()) continue;
-        std::string value;
-        bool ok = zk_client_->GetNodeValue(sp_root_path_ + "/" + node, value);
-        if (!ok) {
-            LOG(WARNING) << "fail to get procedure data. node: " << node;
-            continue;
-        }
+    for (const auto& [node, value] : changed_sp_nodes) {
         std::string uncompressed;
         ::snappy::Uncompress(value.c_str(), value.length(), &uncompressed);
         ::openmldb::api::ProcedureInfo sp_info_pb;
-        ok = sp_info_pb.ParseFromString(uncompressed);
-        if (!ok) {
+        if (!sp_info_pb.ParseFromString(uncompressed)) {
             LOG(WARNING) << "fail to parse procedure proto. node: " << node << " value: " << value;
             continue;
         }
-        auto sp_info = std::make_shared<openmldb::catalog::ProcedureInfoImpl>(sp_info_pb);
-        if (!sp_info) {
-            LOG(WARNING) << "convert procedure info failed, sp_name: " << sp_info_pb.sp_name()
-                         << " db: " << sp_info_pb.db_name();
-            continue;
-        }
-        auto it = db_sp_map.find(sp_info->GetDbName());
-        if (it == db_sp_map.end()) {
-            std::map<std::string, std::shared_ptr<hybridse::sdk::ProcedureInfo>> sp_in_db = {
-                {sp_info->GetSpName(), sp_info}};
-            db_sp_map.insert(std::make_pair(sp_info->GetDbName(), sp_in_db));
-        } else {
-            it->second.insert(std::make_pair(sp_info->GetSpName(), sp_info));
-        }
+        node_procedures_[node] = std::make_shared<openmldb::catalog::ProcedureInfoImpl>(sp_info_pb);
+    }
+    openmldb::catalog::Procedures db_sp_map;
+    for (const auto& kv : node_procedures_) {
+        db_sp_map[kv.second->GetDbName()][kv.second->GetSpName()] = kv.second;
     }
     auto old_db_sp_map = catalog_->GetProcedures();
-    bool updated = false;
-    catalog_->Refresh(table_info_vec, version, db_sp_map, &updated);
-    if (updated) {
-        engine_->ClearCacheLocked("");
+    std::set<std::pair<std::string, std::string>> updated_tables;
+    if (full) {
+        catalog_->Refresh(table_info_vec, version, db_sp_map, &updated_tables);
+    } else {
+        catalog_->RefreshDelta(table_info_vec, removed_tables, version, db_sp_map, &updated_tables);
+    }
+    for (const auto& [db, name] : updated_tables) {
+        engine_->InvalidateTable(db, name);
     }
     // skip exist procedure, don`t need recompile
     for (const auto& db_sp_map_kv : db_sp_map) {
@@ -4758,6 +5102,10 @@ void TabletImpl::SchedDelBinlog(uint32_t tid, uint32_t pid) {
         if (deleted) {
             auto aggrs = GetAggregators(tid, pid);
             if (aggrs) {
+                if (aggr_updater_) {
+                    // the queued updates may come from the deleted binlog
+                    aggr_updater_->Flush();
+                }
                 for (auto& aggr : *aggrs) {
                     aggr->FlushAll();
                 }
@@ -5541,6 +5889,9 @@ void TabletImpl::DropProcedure(RpcController* controller, const ::openmldb::api:
         } else {
             LOG(INFO) << "deleted deploy collector for " << collector_key;
         }
+        if (hot_key_sampler_) {
+            hot_key_sampler_->DeleteDeploy(collector_key);
+        }
     }
     response->set_code(::openmldb::base::ReturnCode::kOk);
     response->set_msg("ok");
@@ -5561,6 +5912,9 @@ void TabletImpl::RunRequestQuery(RpcController* ctrl, const openmldb::api::Query
         response.set_msg("fail to decode input row");
         return;
     }
+    if (hot_key_sampler_ && request.is_procedure() && request.has_sp_name()) {
+        SampleHotKey(request.db(), request.sp_name(), session.GetRequestSchema(), row);
+    }
     ::hybridse::codec::Row output;
     int32_t ret = 0;
     if (request.has_task_id()) {
@@ -5597,6 +5951,239 @@ void TabletImpl::RunRequestQuery(RpcController* ctrl, const openmldb::api::Query
     response.set_code(::openmldb::base::kOk);
 }
 
+void TabletImpl::RunProcedureRequest(RpcController* ctrl, const openmldb::api::QueryRequest& request,
+                                     uint64_t deadline_us, openmldb::api::QueryResponse* response,
+                                     butil::IOBuf* buf) {
+    auto run = [this, ctrl, &request, deadline_us](openmldb::api::QueryResponse* result, butil::IOBuf* result_buf) {
+        std::unique_ptr<QueryAdmission::Permit> permit;
+        if (!request.has_task_id() &&
+            !AdmitQuery(QueryClass::kDeployment, nullptr, deadline_us, result, &permit)) {
+            return;
+        }
+        hybridse::base::Status status;
+        auto request_compile_info = sp_cache_->GetRequestInfo(request.db(), request.sp_name(), status);
+        if (!status.isOK()) {
+            result->set_code(::openmldb::base::ReturnCode::kProcedureNotFound);
+            result->set_msg(status.msg);
+            PDLOG(WARNING, status.msg.c_str());
+            return;
+        }
+        if (FLAGS_request_batch_window_us > 0 && !request.has_task_id() && !request.is_debug() &&
+            RunBatchedProcedureRequest(ctrl, request, request_compile_info, deadline_us, result, result_buf)) {
+            return;
+        }
+        ::hybridse::vm::RequestRunSession session;
+        session.SetCompileInfo(request_compile_info);
+        session.SetSpName(request.sp_name());
+        if (FLAGS_deploy_profile_sample_interval > 0 &&
+            deploy_request_cnt_.fetch_add(1, std::memory_order_relaxed) % FLAGS_deploy_profile_sample_interval == 0) {
+            session.EnableProfile();
+        }
+        RunRequestQuery(ctrl, request, session, *result, *result_buf);
+        if (result->code() != ::openmldb::base::kOk) {
+            DLOG(WARNING) << "fail to run deployment " << request.db() << "." << request.sp_name()
+                          << " error msg: " << result->msg();
+        }
+    };
+    std::string key;
+    // the sub tasks of a deployment and the debug runs are never shared
+    if (!request_coalescer_ || request.has_task_id() || request.is_debug() || !GetCoalesceKey(ctrl, request, &key)) {
+        run(response, buf);
+        return;
+    }
+    uint64_t wait_us = static_cast<uint64_t>(FLAGS_request_coalesce_max_wait_ms) * 1000;
+    if (deadline_us > 0) {
+        uint64_t now = ::baidu::common::timer::get_micros();
+        wait_us = now >= deadline_us ? 0 : std::min(wait_us, deadline_us - now);
+    }
+    request_coalescer_->Execute(key, wait_us, run, response, buf);
+}
+
+// merge the common and non-common slices of the output rows of a batch request into one slice in the order of the
+// output schema
+static bool MergeOutputSlices(const hybridse::codec::Schema& schema, const std::set<size_t>& common_indices,
+                              std::vector<hybridse::codec::Row>* rows) {
+    hybridse::codec::Schema common_schema;
+    hybridse::codec::Schema non_common_schema;
+    std::vector<std::pair<size_t, size_t>> indices;
+    for (int i = 0; i < schema.size(); i++) {
+        if (common_indices.count(i) > 0) {
+            indices.emplace_back(0, common_schema.size());
+            *common_schema.Add() = schema.Get(i);
+        } else {
+            indices.emplace_back(1, non_common_schema.size());
+            *non_common_schema.Add() = schema.Get(i);
+        }
+    }
+    ::hybridse::codec::RowSelector selector({&common_schema, &non_common_schema}, indices);
+    for (auto& row : *rows) {
+        int8_t* buf = nullptr;
+        size_t size = 0;
+        if (!selector.Select(row, &buf, &size)) {
+            return false;
+        }
+        row = ::hybridse::codec::Row(::hybridse::base::RefCountedSlice::CreateManaged(buf, size));
+    }
+    return true;
+}
+
+bool TabletImpl::RunBatchedProcedureRequest(RpcController* ctrl, const openmldb::api::QueryRequest& request,
+                                            const std::shared_ptr<hybridse::vm::CompileInfo>& request_info,
+                                            uint64_t deadline_us, openmldb::api::QueryResponse* response,
+                                            butil::IOBuf* buf) {
+    hybridse::base::Status status;
+    auto batch_info = sp_cache_->GetBatchRequestInfo(request.db(), request.sp_name(), status);
+    if (!status.isOK()) {
+        return false;
+    }
+    ::hybridse::codec::Row row;
+    auto& request_buf = static_cast<brpc::Controller*>(ctrl)->request_attachment();
+    if (!codec::DecodeRpcRow(request_buf, 0, request.row_size(), request.row_slices(), &row) ||
+        row.GetRowPtrCnt() != 1 || row.size() <= 0) {
+        return false;
+    }
+    // the common columns of the rows in a batch must be the same, so the batches are keyed by their values
+    const auto& common_indices = batch_info->GetBatchRequestInfo().common_column_indices;
+    const auto& request_schema = batch_info->GetRequestSchema();
+    std::string key =
+        absl::StrCat(request.db().size(), ":", request.db(), request.sp_name().size(), ":", request.sp_name());
+    ::hybridse::codec::Row input = row;
+    if (common_indices.size() == static_cast<size_t>(request_schema.size())) {
+        key.append(reinterpret_cast<char*>(row.buf()), row.size());
+    } else if (!common_indices.empty()) {
+        std::vector<size_t> common_vec;
+        std::vector<size_t> non_common_vec;
+        for (int i = 0; i < request_schema.size(); i++) {
+            if (common_indices.count(i) > 0) {
+                common_vec.push_back(i);
+            } else {
+                non_common_vec.push_back(i);
+            }
+        }
+        ::hybridse::codec::RowSelector common_selector(&request_schema, common_vec);
+        ::hybridse::codec::RowSelector non_common_selector(&request_schema, non_common_vec);
+        int8_t* common_buf = nullptr;
+        size_t common_size = 0;
+        int8_t* non_common_buf = nullptr;
+        size_t non_common_size = 0;
+        if (!common_selector.Select(row, &common_buf, &common_size)) {
+            return false;
+        }
+        ::hybridse::codec::Row common_row(::hybridse::base::RefCountedSlice::CreateManaged(common_buf, common_size));
+        if (!non_common_selector.Select(row, &non_common_buf, &non_common_size)) {
+            return false;
+        }
+        ::hybridse::codec::Row non_common_row(
+            ::hybridse::base::RefCountedSlice::CreateManaged(non_common_buf, non_common_size));
+        key.append(reinterpret_cast<char*>(common_buf), common_size);
+        input = ::hybridse::codec::Row(1, common_row, 1, non_common_row);
+    }
+    auto run = [&request, &batch_info](const std::vector<::hybridse::codec::Row>& rows,
+                                       std::vector<::hybridse::codec::Row>* outputs) {
+        ::hybridse::vm::BatchRequestRunSession session;
+        session.SetCompileInfo(batch_info);
+        session.SetSpName(request.sp_name());
+        if (session.Run(rows, *outputs) != 0) {
+            return false;
+        }
+        const auto& output_common_indices = batch_info->GetBatchRequestInfo().output_common_column_indices;
+        if (!output_common_indices.empty() &&
+            output_common_indices.size() < static_cast<size_t>(session.GetSchema().size())) {
+            return MergeOutputSlices(session.GetSchema(), output_common_indices, outputs);
+        }
+        return true;
+    };
+    // a request joining the batch of another one waits for it until the deadline, or the rpc timeout if the
+    // request has none, and then runs by itself
+    uint64_t wait_us = static_cast<uint64_t>(FLAGS_request_timeout_ms) * 1000;
+    if (deadline_us > 0) {
+        uint64_t now = ::baidu::common::timer::get_micros();
+        if (now >= deadline_us) {
+            return false;
+        }
+        wait_us = deadline_us - now;
+    }
+    ::hybridse::codec::Row output;
+    if (!request_batcher_->Run(key, input, FLAGS_request_batch_window_us, FLAGS_request_batch_max_size, wait_us, run,
+                               &output)) {
+        return false;
+    }
+    size_t buf_total_size = 0;
+    if (!codec::EncodeRpcRow(output, buf, &buf_total_size)) {
+        buf->clear();
+        return false;
+    }
+    if (hot_key_sampler_ && request.has_sp_name()) {
+        SampleHotKey(request.db(), request.sp_name(), request_schema, row);
+    }
+    response->set_schema(request_info->GetEncodedSchema());
+    response->set_byte_size(buf_total_size);
+    response->set_count(1);
+    response->set_row_slices(1);
+    response->set_code(::openmldb::base::kOk);
+    return true;
+}
+
+bool TabletImpl::GetCoalesceKey(RpcController* ctrl, const openmldb::api::QueryRequest& request, std::string* key) {
+    auto sp_info = sp_cache_->FindSpProcedureInfoWithVersion(request.db(), request.sp_name());
+    if (!sp_info.ok()) {
+        return false;
+    }
+    const auto& dbs = sp_info.value().first->GetDbs();
+    const auto& tables = sp_info.value().first->GetTables();
+    if (tables.size() != dbs.size()) {
+        return false;
+    }
+    // the offsets of the partitions only grow, so their sum changes with every write. the writes to the partitions
+    // on the other tablets are not seen here, so only the deployments reading local partitions are coalesced
+    uint64_t version = 0;
+    for (size_t i = 0; i < tables.size(); i++) {
+        auto handler = std::dynamic_pointer_cast<catalog::TabletTableHandler>(catalog_->GetTable(dbs[i], tables[i]));
+        if (!handler) {
+            return false;
+        }
+        for (uint32_t pid = 0; pid < handler->GetPartitionNum(); pid++) {
+            auto replicator = GetReplicator(handler->GetTid(), pid);
+            if (!replicator) {
+                return false;
+            }
+            version += replicator->GetOffset();
+        }
+    }
+    // a redeployed deployment of the same name gets a new cache version, so the key never mixes the two
+    *key = absl::StrCat(request.db().size(), ":", request.db(), request.sp_name().size(), ":", request.sp_name(),
+                        sp_info.value().second, ":", version, ":");
+    auto& request_buf = static_cast<brpc::Controller*>(ctrl)->request_attachment();
+    std::string row;
+    request_buf.copy_to(&row, request.row_size(), 0);
+    key->append(row);
+    return true;
+}
+
+void TabletImpl::SampleHotKey(const std::string& db, const std::string& sp_name, const hybridse::codec::Schema& schema,
+                              const hybridse::codec::Row& row) {
+    auto sp_info = sp_cache_->FindSpProcedureInfo(db, sp_name);
+    if (!sp_info.ok()) {
+        return;
+    }
+    int router_col = sp_info.value()->GetRouterCol();
+    if (router_col < 0 || router_col >= schema.size() || row.size() <= 0) {
+        return;
+    }
+    ::hybridse::codec::RowView row_view(schema, row.buf(), row.size());
+    hot_key_sampler_->Record(absl::StrCat(db, ".", sp_name), row_view.GetAsString(router_col));
+}
+
+void TabletImpl::SetWindowCache(const std::shared_ptr<Table>& table) {
+    if (!window_cache_ || table->GetStorageMode() != ::openmldb::common::kMemory) {
+        return;
+    }
+    auto mem_table = std::dynamic_pointer_cast<MemTable>(table);
+    if (mem_table && !std::dynamic_pointer_cast<storage::IndexOrganizedTable>(table)) {
+        mem_table->SetWindowCache(window_cache_);
+    }
+}
+
 void TabletImpl::CreateProcedure(const std::shared_ptr<hybridse::sdk::ProcedureInfo>& sp_info) {
     const std::string& db_name = sp_info->GetDbName();
     const std::string& sp_name = sp_info->GetSpName();
@@ -5852,7 +6439,7 @@ void TabletImpl::DropFunction(RpcController* controller, const openmldb::api::Dr
         openmldb::schema::SchemaAdapter::ConvertType(fun.arg_type(idx), &data_type);
         arg_types.emplace_back(data_type);
     }
-    engine_->ClearCacheLocked("");
+    engine_->InvalidateFunction(fun.name());
     auto status = engine_->RemoveExternalFunction(fun.name(), arg_types, fun.file());
     if (status.isOK()) {
         LOG(INFO) << "Drop function success. name " << fun.name() << " path " << fun.file();
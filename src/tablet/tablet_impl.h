@@ -21,6 +21,7 @@
 #include <map>
 #include <memory>
 #include <mutex>  // NOLINT
+#include <optional>
 #include <set>
 #include <string>
 #include <utility>
@@ -35,15 +36,22 @@
 #include "proto/tablet.pb.h"
 #include "replica/log_replicator.h"
 #include "sdk/sql_cluster_router.h"
+#include "statistics/hot_key/hot_key_sampler.h"
 #include "statistics/query_response_time/deployment_metric_collector.h"
 #include "storage/aggregator.h"
 #include "storage/mem_table.h"
 #include "storage/mem_table_snapshot.h"
+#include "storage/window_cache.h"
 #include "tablet/bulk_load_mgr.h"
 #include "tablet/combine_iterator.h"
 #include "tablet/file_receiver.h"
+#include "tablet/query_admission.h"
+#include "tablet/query_result_cache.h"
+#include "tablet/request_batcher.h"
+#include "tablet/request_coalescer.h"
 #include "tablet/sp_cache.h"
 #include "vm/engine.h"
+#include "zk/zk_children_cache.h"
 #include "zk/zk_client.h"
 
 namespace openmldb {
@@ -171,6 +179,11 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     void ShowMemPool(RpcController* controller, const ::openmldb::api::HttpRequest* request,
                      ::openmldb::api::HttpResponse* response, Closure* done);
 
+    // the plan of a deployment with the time spent in each runner by the sampled requests,
+    // e.g. /TabletServer/ShowDeploymentProfile?db=db1&deployment=d1
+    void ShowDeploymentProfile(RpcController* controller, const ::openmldb::api::HttpRequest* request,
+                               ::openmldb::api::HttpResponse* response, Closure* done);
+
     void GetAllSnapshotOffset(RpcController* controller, const ::openmldb::api::EmptyRequest* request,
                               ::openmldb::api::TableSnapshotOffsetResponse* response, Closure* done);
 
@@ -270,6 +283,10 @@ class TabletImpl : public ::openmldb::api::TabletServer {
 
     std::shared_ptr<Aggrs> GetAggregators(uint32_t tid, uint32_t pid);
 
+    // the key of the identical deployment requests. it changes with the deployment and the writes to the tables it
+    // reads. return false if the deployment is not found or it reads a partition on another tablet
+    bool GetCoalesceKey(RpcController* controller, const openmldb::api::QueryRequest& request, std::string* key);
+
     void GetAndFlushDeployStats(::google::protobuf::RpcController* controller,
                                 const ::openmldb::api::GAFDeployStatsRequest* request,
                                 ::openmldb::api::DeployStatsResponse* response,
@@ -320,6 +337,11 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     void SendSnapshotInternal(const std::string& endpoint, uint32_t tid, uint32_t pid, uint32_t remote_tid,
                               std::shared_ptr<::openmldb::api::TaskInfo> task);
 
+    // handle the block of pipelined file transfer which carries offset and checksum
+    void SendDataPipelined(const ::openmldb::api::SendDataRequest* request, const butil::IOBuf& attachment,
+                           const std::shared_ptr<FileReceiver>& receiver, const std::string& combine_key,
+                           ::openmldb::api::GeneralResponse* response);
+
     void DumpIndexDataInternal(std::shared_ptr<::openmldb::storage::Table> table,
                                std::shared_ptr<::openmldb::storage::MemTableSnapshot> memtable_snapshot,
                                uint32_t partition_num, const std::vector<::openmldb::common::ColumnKey>& column_keys,
@@ -410,6 +432,25 @@ class TabletImpl : public ::openmldb::api::TabletServer {
 
     bool GetRealEp(uint64_t tid, uint64_t pid, std::map<std::string, std::string>* real_ep_map);
 
+    // wait for the admission of a query. return false and set the response if the deadline passed in the queue
+    bool AdmitQuery(QueryClass query_class, const std::shared_ptr<hybridse::vm::CompileInfo>& info,
+                    uint64_t deadline_us, ::openmldb::api::QueryResponse* response,
+                    std::unique_ptr<QueryAdmission::Permit>* permit);
+    bool AdmitQuery(QueryClass query_class, uint64_t deadline_us,
+                    ::openmldb::api::SQLBatchRequestQueryResponse* response,
+                    std::unique_ptr<QueryAdmission::Permit>* permit);
+    // return a null permit if the deadline passed in the queue
+    std::unique_ptr<QueryAdmission::Permit> AcquireQueryPermit(QueryClass query_class,
+                                                               const std::shared_ptr<hybridse::vm::CompileInfo>& info,
+                                                               uint64_t deadline_us);
+    // the estimated row count of a table, the partitions on the other tablets are assumed to be as large as the local
+    uint64_t EstimateTableRows(const std::shared_ptr<hybridse::vm::TableHandler>& table_handler);
+
+    // send the batch query result, in pages if the request asks for it
+    void SetQueryResult(const openmldb::api::QueryRequest& request, const std::string& schema,
+                        std::vector<::hybridse::codec::Row>* output_rows, ::openmldb::api::QueryResponse* response,
+                        butil::IOBuf* buf);
+
     void ProcessQuery(bool is_sub, RpcController* controller, const openmldb::api::QueryRequest* request,
                       ::openmldb::api::QueryResponse* response, butil::IOBuf* buf);
     void ProcessBatchRequestQuery(bool is_sub, RpcController* controller,
@@ -420,6 +461,9 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     bool UpdateAggrs(uint32_t tid, uint32_t pid, const std::string& value,
                      const ::openmldb::storage::Dimensions& dimensions, uint64_t log_offset);
 
+    bool DeleteAggr(const std::shared_ptr<::openmldb::storage::Aggregator>& aggr, const std::string& key,
+                    const std::optional<uint64_t>& start_ts, const std::optional<uint64_t>& end_ts);
+
     bool CreateAggregatorInternal(const ::openmldb::api::CreateAggregatorRequest* request,
                                   std::string& msg);  // NOLINT
 
@@ -438,6 +482,22 @@ class TabletImpl : public ::openmldb::api::TabletServer {
                          ::hybridse::vm::RequestRunSession& session,                  // NOLINT
                          openmldb::api::QueryResponse& response, butil::IOBuf& buf);  // NOLINT
 
+    // admit and run the request of a deployment, the identical requests share one run if coalescing is enabled
+    void RunProcedureRequest(RpcController* controller, const openmldb::api::QueryRequest& request,
+                             uint64_t deadline_us, openmldb::api::QueryResponse* response, butil::IOBuf* buf);
+    // run the request of a deployment in a batch with the concurrent requests of the same deployment. return false
+    // if the batch fails or is not done before the deadline, then the request should run by itself
+    bool RunBatchedProcedureRequest(RpcController* controller, const openmldb::api::QueryRequest& request,
+                                    const std::shared_ptr<hybridse::vm::CompileInfo>& request_info,
+                                    uint64_t deadline_us, openmldb::api::QueryResponse* response, butil::IOBuf* buf);
+
+    // record the routing key of the deployment request into hot_key_sampler_
+    void SampleHotKey(const std::string& db, const std::string& sp_name, const hybridse::codec::Schema& schema,
+                      const hybridse::codec::Row& row);
+
+    // set the window cache to the memory table. the index organized table is not supported
+    void SetWindowCache(const std::shared_ptr<Table>& table);
+
     void CreateProcedure(const std::shared_ptr<hybridse::sdk::ProcedureInfo>& sp_info);
     base::Status CheckTable(uint32_t tid, uint32_t pid, bool check_leader, const std::shared_ptr<Table>& table);
 
@@ -486,12 +546,39 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     std::shared_ptr<SpCache> sp_cache_;
     std::string notify_path_;
     std::string sp_root_path_;
+    // RefreshTableInfo reads only the table and procedure nodes changed since the last one, guarded by
+    // refresh_table_mu_
+    std::mutex refresh_table_mu_;
+    std::unique_ptr<::openmldb::zk::ZkChildrenCache> table_nodes_;
+    std::unique_ptr<::openmldb::zk::ZkChildrenCache> sp_nodes_;
+    std::map<std::string, std::pair<std::string, std::string>> node_tables_;
+    std::map<std::string, std::shared_ptr<::hybridse::sdk::ProcedureInfo>> node_procedures_;
     std::string globalvar_changed_notify_path_;
     ::openmldb::type::StartupMode startup_mode_;
 
     std::shared_ptr<std::map<std::string, std::string>> global_variables_;
 
     std::unique_ptr<openmldb::statistics::DeploymentMetricCollector> deploy_collector_;
+    std::unique_ptr<openmldb::statistics::HotKeySampler> hot_key_sampler_;
+    std::shared_ptr<::openmldb::storage::WindowCache> window_cache_;
+    // update the pre-aggr tables out of the put path if enable_async_aggr_update is set
+    std::unique_ptr<::openmldb::storage::AsyncAggrUpdater> aggr_updater_;
+    // the queued updates of aggr_updater_ and the puts waited for the full queues
+    std::unique_ptr<bvar::PassiveStatus<uint64_t>> aggr_update_pending_;
+    std::unique_ptr<bvar::PassiveStatus<uint64_t>> aggr_update_blocked_;
+    std::unique_ptr<openmldb::statistics::CacheMetric> window_cache_metric_;
+    // null if query_admission_max_slots is 0
+    std::unique_ptr<QueryAdmission> query_admission_;
+    std::unique_ptr<QueryResultCache> query_result_cache_;
+    // null if request_coalesce_max_wait_ms is 0
+    std::unique_ptr<RequestCoalescer> request_coalescer_;
+    // used only if request_batch_window_us is not 0
+    std::unique_ptr<RequestBatcher> request_batcher_;
+    // the deployment requests run, one of every deploy_profile_sample_interval is profiled
+    std::atomic<uint64_t> deploy_request_cnt_ = 0;
+    // the counters of the compiling result cache of engine_
+    std::unique_ptr<bvar::PassiveStatus<uint64_t>> compile_cache_invalidations_;
+    std::unique_ptr<bvar::PassiveStatus<uint64_t>> compile_cache_recompiles_;
     std::atomic<uint64_t> memory_used_ = 0;
     std::atomic<uint32_t> system_memory_usage_rate_ = 0;  // [0, 100]
     openmldb::auth::UserAccessManager user_access_manager_;
@@ -6286,7 +6286,7 @@ TEST_F(TabletImplTest, DeleteRange) {
         ASSERT_EQ(record_byte_size, g_response.all_table_status(0).record_byte_size());
         ASSERT_EQ(record_idx_byte_size, g_response.all_table_status(0).record_idx_byte_size());
     };
-    assert_status(100, 3400, 5786);
+    assert_status(100, 3400, 6546);
 
     ::openmldb::api::DeleteRequest delete_request;
     ::openmldb::api::GeneralResponse gen_response;
@@ -6303,7 +6303,7 @@ TEST_F(TabletImplTest, DeleteRange) {
     tablet.ExecuteGc(NULL, &e_request, &gen_response, &closure);
     ASSERT_EQ(0, gen_response.code()) << gen_response.ShortDebugString();
     sleep(2);
-    assert_status(100, 3400, 5786);  // before node cache gc, status will be the same
+    assert_status(100, 3400, 6546);  // before node cache gc, status will be the same
     // gc node cache
     tablet.ExecuteGc(NULL, &e_request, &gen_response, &closure);
     ASSERT_EQ(0, gen_response.code()) << gen_response.ShortDebugString();
@@ -6311,6 +6311,127 @@ TEST_F(TabletImplTest, DeleteRange) {
     assert_status(0, 0, 0);
 }
 
+void AddCoalesceTableSchema(const std::string& name, uint32_t tid, uint32_t partition_num,
+                            ::openmldb::api::TableMeta* table_meta) {
+    table_meta->set_db("db_coalesce");
+    table_meta->set_name(name);
+    table_meta->set_tid(tid);
+    table_meta->set_pid(0);
+    table_meta->set_mode(::openmldb::api::TableMode::kTableLeader);
+    SchemaCodec::SetColumnDesc(table_meta->add_column_desc(), "id", openmldb::type::DataType::kString);
+    SchemaCodec::SetColumnDesc(table_meta->add_column_desc(), "ts_col", openmldb::type::DataType::kTimestamp);
+    SchemaCodec::SetColumnDesc(table_meta->add_column_desc(), "col3", openmldb::type::DataType::kInt);
+    SchemaCodec::SetColumnDesc(table_meta->add_column_desc(), "col4", openmldb::type::DataType::kDouble);
+    SchemaCodec::SetIndex(table_meta->add_column_key(), "idx1", "id", "ts_col", ::openmldb::type::kAbsoluteTime, 0, 0);
+    for (uint32_t pid = 0; pid < partition_num; pid++) {
+        table_meta->add_table_partition()->set_pid(pid);
+    }
+}
+
+void CreateCoalesceProcedure(TabletImpl* tablet, const ::openmldb::api::TableMeta& table_meta,
+                             const std::string& sp_name) {
+    ::openmldb::api::CreateProcedureRequest request;
+    auto sp_info = request.mutable_sp_info();
+    sp_info->set_db_name(table_meta.db());
+    sp_info->set_sp_name(sp_name);
+    sp_info->set_sql("SELECT id, sum(col3) OVER w AS s FROM " + table_meta.name() +
+                     " WINDOW w AS (PARTITION BY id ORDER BY ts_col ROWS BETWEEN 2 PRECEDING AND CURRENT ROW);");
+    sp_info->set_main_db(table_meta.db());
+    sp_info->set_main_table(table_meta.name());
+    sp_info->set_type(::openmldb::type::ProcedureType::kReqDeployment);
+    sp_info->mutable_input_schema()->CopyFrom(table_meta.column_desc());
+    auto pair = sp_info->add_tables();
+    pair->set_db_name(table_meta.db());
+    pair->set_table_name(table_meta.name());
+    ::openmldb::api::GeneralResponse response;
+    MockClosure closure;
+    tablet->CreateProcedure(NULL, &request, &response, &closure);
+    ASSERT_EQ(0, response.code()) << response.msg();
+}
+
+TEST_F(TabletImplTest, CoalesceKey) {
+    TabletImpl tablet;
+    tablet.Init("");
+    ::openmldb::api::TableMeta local_meta;
+    ::openmldb::api::TableMeta remote_meta;
+    {
+        ::openmldb::api::CreateTableRequest request;
+        AddCoalesceTableSchema("t_local", counter++, 1, request.mutable_table_meta());
+        local_meta.CopyFrom(request.table_meta());
+        ::openmldb::api::CreateTableResponse response;
+        MockClosure closure;
+        tablet.CreateTable(NULL, &request, &response, &closure);
+        ASSERT_EQ(0, response.code());
+        // only the partition 0 of t_remote is on the tablet
+        request.Clear();
+        AddCoalesceTableSchema("t_remote", counter++, 2, request.mutable_table_meta());
+        remote_meta.CopyFrom(request.table_meta());
+        tablet.CreateTable(NULL, &request, &response, &closure);
+        ASSERT_EQ(0, response.code());
+    }
+    CreateCoalesceProcedure(&tablet, local_meta, "sp_local");
+    CreateCoalesceProcedure(&tablet, remote_meta, "sp_remote");
+
+    auto get_key = [&tablet](const std::string& sp_name, const std::string& row, std::string* key) {
+        ::openmldb::api::QueryRequest request;
+        request.set_db("db_coalesce");
+        request.set_sp_name(sp_name);
+        request.set_is_procedure(true);
+        request.set_row_size(row.size());
+        brpc::Controller cntl;
+        cntl.request_attachment().append(row);
+        return tablet.GetCoalesceKey(&cntl, request, key);
+    };
+    std::string row = EncodeAggrRow("id1", 100, 1);
+    std::string key1;
+    std::string key2;
+    // the identical requests share the key
+    ASSERT_TRUE(get_key("sp_local", row, &key1));
+    ASSERT_TRUE(get_key("sp_local", row, &key2));
+    ASSERT_EQ(key1, key2);
+    // the sql is not a part of the key
+    ASSERT_EQ(std::string::npos, key1.find("SELECT"));
+    ASSERT_TRUE(get_key("sp_local", EncodeAggrRow("id2", 100, 1), &key2));
+    ASSERT_NE(key1, key2);
+
+    // a put to the table the deployment reads changes the key
+    {
+        ::openmldb::api::PutRequest prequest;
+        ::openmldb::test::SetDimension(0, "id1", prequest.add_dimensions());
+        prequest.set_time(50);
+        prequest.set_value(EncodeAggrRow("id1", 50, 1));
+        prequest.set_tid(local_meta.tid());
+        prequest.set_pid(0);
+        ::openmldb::api::PutResponse presponse;
+        MockClosure closure;
+        tablet.Put(NULL, &prequest, &presponse, &closure);
+        ASSERT_EQ(0, presponse.code());
+    }
+    ASSERT_TRUE(get_key("sp_local", row, &key2));
+    ASSERT_NE(key1, key2);
+    key1 = key2;
+    ASSERT_TRUE(get_key("sp_local", row, &key2));
+    ASSERT_EQ(key1, key2);
+
+    // the writes to the partitions on the other tablets are not seen, so the deployment is never coalesced
+    ASSERT_FALSE(get_key("sp_remote", row, &key2));
+
+    // a redeployed deployment of the same name gets a new key
+    {
+        ::openmldb::api::DropProcedureRequest request;
+        request.set_db_name("db_coalesce");
+        request.set_sp_name("sp_local");
+        ::openmldb::api::GeneralResponse response;
+        MockClosure closure;
+        tablet.DropProcedure(NULL, &request, &response, &closure);
+        ASSERT_EQ(0, response.code());
+    }
+    ASSERT_FALSE(get_key("sp_local", row, &key2));
+    CreateCoalesceProcedure(&tablet, local_meta, "sp_local");
+    ASSERT_TRUE(get_key("sp_local", row, &key2));
+    ASSERT_NE(key1, key2);
+}
+
 }  // namespace tablet
 }  // namespace openmldb
 
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "zk/zk_children_cache.h"
+
+#include <set>
+#include <utility>
+
+#include "glog/logging.h"
+
+namespace openmldb {
+namespace zk {
+
+bool ZkChildrenCache::Refresh(ZkClient* zk_client, std::map<std::string, std::string>* changed,
+                              std::vector<std::string>* removed) {
+    changed->clear();
+    removed->clear();
+    std::vector<std::string> children;
+    if (zk_client->IsExistNode(path_) == 0 && !zk_client->GetChildren(path_, children)) {
+        LOG(WARNING) << "fail to get children of " << path_;
+        return false;
+    }
+    std::set<std::string> alive(children.begin(), children.end());
+    for (const auto& child : children) {
+        if (child.empty()) {
+            continue;
+        }
+        std::string node = path_ + "/" + child;
+        auto it = mzxids_.find(child);
+        if (it != mzxids_.end()) {
+            Stat stat;
+            if (!zk_client->GetNodeStat(node, &stat) || stat.mzxid == it->second) {
+                continue;
+            }
+        }
+        std::string value;
+        Stat stat;
+        if (!zk_client->GetNodeValueAndStat(node.c_str(), &value, &stat)) {
+            LOG(WARNING) << "fail to get value of " << node;
+            continue;
+        }
+        // the mzxid read along with the value, a modification after it is found in the next refresh
+        mzxids_[child] = stat.mzxid;
+        changed->emplace(child, std::move(value));
+    }
+    for (auto it = mzxids_.begin(); it != mzxids_.end();) {
+        if (alive.count(it->first) == 0) {
+            removed->push_back(it->first);
+            it = mzxids_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return true;
+}
+
+}  // namespace zk
+}  // namespace openmldb
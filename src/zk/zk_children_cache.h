@@ -0,0 +1,51 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_ZK_ZK_CHILDREN_CACHE_H_
+#define SRC_ZK_ZK_CHILDREN_CACHE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "zk/zk_client.h"
+
+namespace openmldb {
+namespace zk {
+
+// ZkChildrenCache tracks the children of a zk node by the mzxid of their last modification, so a refresh only reads
+// the values of the children created or modified since the last refresh. It is not thread safe.
+class ZkChildrenCache {
+ public:
+    explicit ZkChildrenCache(const std::string& path) : path_(path) {}
+
+    // set changed to the values of the children created or modified, and removed to the children deleted.
+    // return false if the children can not be listed, and the cache is not changed
+    bool Refresh(ZkClient* zk_client, std::map<std::string, std::string>* changed, std::vector<std::string>* removed);
+
+    // forget all the children, the next refresh reads all of them
+    void Clear() { mzxids_.clear(); }
+
+    size_t Size() const { return mzxids_.size(); }
+
+ private:
+    std::string path_;
+    std::map<std::string, int64_t> mzxids_;
+};
+
+}  // namespace zk
+}  // namespace openmldb
+#endif  // SRC_ZK_ZK_CHILDREN_CACHE_H_
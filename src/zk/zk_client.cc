@@ -396,6 +396,12 @@ bool ZkClient::GetNodeValueAndStat(const char* node, std::string* value, Stat* s
     return false;
 }
 
+bool ZkClient::GetNodeStat(const std::string& node, Stat* stat) {
+    std::lock_guard<std::mutex> lock(mu_);
+    DCHECK(stat != nullptr);
+    return zoo_exists(zk_, node.c_str(), 0, stat) == ZOK;
+}
+
 bool ZkClient::DeleteNode(const std::string& node) {
     std::lock_guard<std::mutex> lock(mu_);
     int ret = zoo_delete(zk_, node.c_str(), -1);
@@ -96,6 +96,9 @@ class ZkClient {
 
     bool GetNodeValueAndStat(const char* node, std::string* value, Stat* stat);
 
+    // get the stat of the node without its value
+    bool GetNodeStat(const std::string& node, Stat* stat);
+
     bool SetNodeValue(const std::string& node, const std::string& value);
 
     bool SetNodeWatcher(const std::string& node, watcher_fn watcher, void* watcherCtx);
@@ -23,6 +23,7 @@
 #include <boost/bind.hpp>
 
 #include "base/glog_wrapper.h"  // NOLINT
+#include "zk/zk_children_cache.h"
 extern "C" {
 #include "zookeeper/zookeeper.h"
 }
@@ -146,6 +147,33 @@ TEST_F(ZkClientTest, ZkNodeChange) {
     ASSERT_TRUE(detect.load());
 }
 
+TEST_F(ZkClientTest, ChildrenCache) {
+    ZkClient client("127.0.0.1:6181", "", session_timeout, "127.0.0.1:9527", "/openmldb1", "", "");
+    ASSERT_TRUE(client.Init());
+    std::string path = "/openmldb1/children" + GenRand();
+    ASSERT_TRUE(client.CreateNode(path + "/1", "a"));
+    ASSERT_TRUE(client.CreateNode(path + "/2", "b"));
+
+    ZkChildrenCache cache(path);
+    std::map<std::string, std::string> changed;
+    std::vector<std::string> removed;
+    ASSERT_TRUE(cache.Refresh(&client, &changed, &removed));
+    ASSERT_EQ((std::map<std::string, std::string>{{"1", "a"}, {"2", "b"}}), changed);
+    ASSERT_TRUE(removed.empty());
+    // nothing changed
+    ASSERT_TRUE(cache.Refresh(&client, &changed, &removed));
+    ASSERT_TRUE(changed.empty());
+    ASSERT_TRUE(removed.empty());
+
+    ASSERT_TRUE(client.SetNodeValue(path + "/2", "c"));
+    ASSERT_TRUE(client.CreateNode(path + "/3", "d"));
+    ASSERT_TRUE(client.DeleteNode(path + "/1"));
+    ASSERT_TRUE(cache.Refresh(&client, &changed, &removed));
+    ASSERT_EQ((std::map<std::string, std::string>{{"2", "c"}, {"3", "d"}}), changed);
+    ASSERT_EQ(std::vector<std::string>{"1"}, removed);
+    ASSERT_EQ(2u, cache.Size());
+}
+
 TEST_F(ZkClientTest, Auth) {
     std::string node = "/openmldb_auth/node1";
     {